@@ -21,6 +21,8 @@ extern "C" {
 
 #include "cmsis_os.h"
 
+#include "audio_engine.h"
+
 /* Private includes ----------------------------------------------------------*/
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
@@ -40,6 +42,13 @@ extern "C" {
   */
 void AudioTask_Init(void);
 
+/**
+  * @brief  Get engine instance played on audio output.
+  * @param  None
+  * @retval Pointer to engine instance.
+  */
+audio_engine_t *AudioTask_get_engine(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,41 @@
+/**
+ * @file    midi_song.h
+ * @author  Sebastián Del Moral
+ * @brief   Standard MIDI File stored in flash, played by sequencer.
+ * @version 0.1
+ * @date    2021-12-04
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_SONG_
+#define __MIDI_SONG_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/* Private includes ----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+
+/* Demo song, format 0, 4 bars of arpeggios at 120 bpm */
+extern const uint8_t MidiSongFlash[];
+extern const uint32_t u32MidiSongFlashLen;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions prototypes ---------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_SONG_ */
+
+/* EOF */
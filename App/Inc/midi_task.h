@@ -21,13 +21,30 @@ extern "C" {
 
 #include "cmsis_os.h"
 
+#include "midi_seq.h"
+#include "midi_out.h"
+#include "audio_param.h"
+
 /* Private includes ----------------------------------------------------------*/
 /* Exported types ------------------------------------------------------------*/
+
+/* Sources of files played by sequencer */
+typedef enum {
+    MIDI_TASK_SEQ_FLASH = 0x00,     /**< Song stored in flash. */
+    MIDI_TASK_SEQ_USER,             /**< File uploaded over sys ex. */
+    MIDI_TASK_SEQ_NUM
+} midi_task_seq_src_t;
+
 /* Exported constants --------------------------------------------------------*/
 #define MIDI_TASK_STACK     ( 128 * 4 )
 #define MIDI_TASK_NAME      ( "Midi Task" )
 #define MIDI_TASK_PRIORITY  ( osPriorityNormal )
 
+/* Midi out sources, merged in one stream */
+#define MIDI_TASK_OUT_THRU  ( 0x01U )   /**< Messages received on midi in. */
+#define MIDI_TASK_OUT_SEQ   ( 0x02U )   /**< Sequencer events and start/stop. */
+#define MIDI_TASK_OUT_ALL   ( MIDI_TASK_OUT_THRU | MIDI_TASK_OUT_SEQ )
+
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions prototypes ---------------------------------------------*/
 /* Private defines -----------------------------------------------------------*/
@@ -40,6 +57,71 @@ extern "C" {
   */
 void MidiTask_Init(void);
 
+/**
+ * @brief Request sequencer playback, handled in midi task.
+ * 
+ * @param eSrc file source.
+ * @param bLoop restart file once finished.
+ * @return true if request was queued.
+ */
+bool MidiTask_seq_play(midi_task_seq_src_t eSrc, bool bLoop);
+
+/**
+ * @brief Request sequencer stop, active notes are released.
+ * 
+ * @return true if request was queued.
+ */
+bool MidiTask_seq_stop(void);
+
+/**
+ * @brief Get sequencer state.
+ * 
+ * @return midi_seq_state_t current state.
+ */
+midi_seq_state_t MidiTask_seq_get_state(void);
+
+/**
+ * @brief Assign realtime parameter to midi CC, values 0-127 cover the whole
+ *        parameter range.
+ * 
+ * @param u8Cc controller number, 0-127.
+ * @param eParam parameter to drive, AUDIO_PARAM_NUM to clear assignment.
+ * @return true on success, false on invalid controller or parameter.
+ */
+bool MidiTask_cc_map_set(uint8_t u8Cc, audio_param_id_t eParam);
+
+/**
+ * @brief Get parameter assigned to midi CC.
+ * 
+ * @param u8Cc controller number, 0-127.
+ * @return audio_param_id_t assigned parameter, AUDIO_PARAM_NUM if none.
+ */
+audio_param_id_t MidiTask_cc_map_get(uint8_t u8Cc);
+
+/**
+ * @brief Select sources sent on midi out and running status compression,
+ *        applied in midi task.
+ * 
+ * @param u32SrcMask MIDI_TASK_OUT_x sources, 0 mutes midi out.
+ * @param bRunningStatus omit repeated channel status bytes.
+ * @return true if request was queued.
+ */
+bool MidiTask_out_config(uint32_t u32SrcMask, bool bRunningStatus);
+
+/**
+ * @brief Get sources sent on midi out.
+ * 
+ * @return uint32_t MIDI_TASK_OUT_x mask.
+ */
+uint32_t MidiTask_out_get_src(void);
+
+/**
+ * @brief Get midi out counters.
+ * 
+ * @param pxStats output counters.
+ */
+void MidiTask_out_get_stats(midi_out_stats_t *pxStats);
+
 #ifdef __cplusplus
 }
 #endif
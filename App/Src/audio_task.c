@@ -18,8 +18,6 @@
 
 #include "sys_log.h"
 
-#include "audio_engine.h"
-
 /* Private includes ----------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -30,6 +28,9 @@
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 
+/* Engine instance driven by I2S output */
+audio_engine_t xAudioEngine;
+
 /* Definitions for testTask */
 osThreadId_t AudioTaskHandle;
 const osThreadAttr_t AudioTask_attributes = {
@@ -60,7 +61,7 @@ static void AudioTask_main(void *argument)
         xAudioCmd.xCmdPayload.xSetWave.eVoiceId = AUDIO_VOICE_NUM;
         xAudioCmd.xCmdPayload.xSetWave.eWaveId = AUDIO_WAVE_TRI;
 
-        (void)AUDIO_handle_cmd(xAudioCmd);
+        (void)AUDIO_handle_cmd(&xAudioEngine, xAudioCmd);
     }
 
     /* Infinite loop */
@@ -84,7 +85,12 @@ void AudioTask_Init(void)
     AudioTaskHandle = osThreadNew(AudioTask_main, NULL, &AudioTask_attributes);
     ERR_ASSERT(AudioTaskHandle != NULL);
 
-    ERR_ASSERT(AUDIO_init() == AUDIO_OK);
+    ERR_ASSERT(AUDIO_init(&xAudioEngine) == AUDIO_OK);
+}
+
+audio_engine_t *AudioTask_get_engine(void)
+{
+    return &xAudioEngine;
 }
 
 /* EOF */
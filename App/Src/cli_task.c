@@ -21,8 +21,6 @@
 
 #include "shell.h"
 
-#include "circular_buffer.h"
-
 /* Private includes ----------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -42,9 +40,8 @@
 /* Serial interface use for CLI */
 #define CLI_USART       ( SYS_USART_0 )
 
-/* Buffer parameters */
-#define SER_BUFF_SIZE   ( 32U )
-#define SER_CBUFF_SIZE  ( 128U )
+/* Circular DMA buffer, read in place by task */
+#define SER_BUFF_SIZE   ( 128U )
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -60,10 +57,8 @@ const osThreadAttr_t CliTask_attributes = {
 /* Event flags */
 osEventFlagsId_t evt_id;
 
-/* Serial reception buffers */
+/* Serial reception buffer */
 uint8_t pu8SerialBuffData[SER_BUFF_SIZE];
-uint8_t pu8CbuffData[SER_CBUFF_SIZE];
-circular_buf_t xCliCBuff = { 0U };
 
 /* Private function prototypes -----------------------------------------------*/
 
@@ -82,36 +77,9 @@ void cli_serial_cb(sys_usart_event_t event)
 {
     switch (event)
     {
-        case SYS_USART_EVENT_RX_IDLE:
-            /* Reload reception */
-            sys_usart_read(CLI_USART, pu8SerialBuffData, SER_BUFF_SIZE);
-            break;
-
-        case SYS_USART_EVENT_RX_DONE:
-            {
-                /* Get data from serial buff */
-                uint16_t u16RxCount = sys_usart_get_read_count(CLI_USART);
-                for (uint16_t i = 0U; i < u16RxCount; i++)
-                {
-                    circular_buf_put2(&xCliCBuff, pu8SerialBuffData[i]);
-                }
-                /* Set data available flag */
-                osEventFlagsSet(evt_id, EVT_RX_DATA);
-            }
-            break;
-
-        case SYS_USART_EVENT_RX_BUFF_FULL:
-            {
-                /* Get data from serial buff */
-                for (uint16_t i = 0U; i < SER_BUFF_SIZE; i++)
-                {
-                    circular_buf_put2(&xCliCBuff, pu8SerialBuffData[i]);
-                }
-                /* Enable reception */
-                sys_usart_read(CLI_USART, pu8SerialBuffData, SER_BUFF_SIZE);
-                /* Set data available flag */
-                osEventFlagsSet(evt_id, EVT_RX_DATA);
-            }
+        case SYS_USART_EVENT_RX_DATA:
+            /* Set data available flag */
+            osEventFlagsSet(evt_id, EVT_RX_DATA);
             break;
 
         case SYS_USART_EVENT_TX_DONE:
@@ -119,8 +87,7 @@ void cli_serial_cb(sys_usart_event_t event)
             break;
 
         case SYS_USART_EVENT_ERROR:
-            /* Enable reception */
-            sys_usart_read(CLI_USART, pu8SerialBuffData, SER_BUFF_SIZE);
+            /* Reception restarted by driver */
             osEventFlagsSet(evt_id, EVT_COM_ERR);
             break;
 
@@ -156,8 +123,6 @@ static int app_cli_send_chr_wrapper(char c)
   */
 static void CliTask_main(void *argument)
 {
-    uint8_t u8RxData = 0;
-
     /* Shell send mapping */
     sShellImpl shell_impl = {
         .send_char = app_cli_send_chr_wrapper,
@@ -168,8 +133,8 @@ static void CliTask_main(void *argument)
 
     shell_put_line("START CLI...");
 
-    /* Init reception */
-    (void)sys_usart_read(CLI_USART, &u8RxData, SER_BUFF_SIZE);
+    /* Init endless reception */
+    ERR_ASSERT(sys_usart_read_circular(CLI_USART, pu8SerialBuffData, SER_BUFF_SIZE) == SYS_SUCCESS);
 
     /* Infinite loop */
     for(;;)
@@ -178,11 +143,17 @@ static void CliTask_main(void *argument)
 
         if ( SYS_CHECK_EVT(u32Flags, EVT_RX_DATA) )
         {
-            uint8_t u8RxData = 0U;
+            uint8_t *pu8Data = NULL;
+            uint16_t u16Len = 0U;
 
-            while ( circular_buf_get(&xCliCBuff, &u8RxData) == 0U )
+            while ( (u16Len = sys_usart_rx_peek(CLI_USART, &pu8Data)) != 0U )
             {
-                shell_receive_char(u8RxData);
+                for ( uint16_t i = 0U; i < u16Len; i++ )
+                {
+                    shell_receive_char((char)pu8Data[i]);
+                }
+
+                sys_usart_rx_consume(CLI_USART, u16Len);
             }
         }
     }
@@ -204,8 +175,6 @@ void CliTask_Init(void)
     ERR_ASSERT(evt_id != NULL);
 
     ERR_ASSERT(sys_usart_init(CLI_USART, cli_serial_cb) == SYS_SUCCESS);
-
-    circular_buf_init(&xCliCBuff, pu8CbuffData, SER_CBUFF_SIZE);
 }
 
 /* EOF */
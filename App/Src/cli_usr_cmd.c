@@ -19,8 +19,12 @@
 
 #include "sys_mcu.h"
 #include "sys_log.h"
+#include "sys_usart.h"
+#include "printf.h"
 
 #include "audio_engine.h"
+#include "audio_task.h"
+#include "midi_task.h"
 
 /* Private defines ---------------------------------------------------------*/
 
@@ -44,23 +48,47 @@ int cli_cmd_logOff(int argc, char *argv[]);
 int cli_cmd_setLogLvl(int argc, char *argv[]);
 int cli_cmd_wave(int argc, char *argv[]);
 int cli_cmd_detune(int argc, char *argv[]);
+int cli_cmd_morph(int argc, char *argv[]);
 int cli_cmd_midi(int argc, char *argv[]);
 int cli_cmd_delay(int argc, char *argv[]);
 int cli_cmd_filter(int argc, char *argv[]);
 int cli_cmd_effect_slot(int argc, char *argv[]);
 int cli_cmd_effect_enable(int argc, char *argv[]);
+int cli_cmd_limiter(int argc, char *argv[]);
+int cli_cmd_compressor(int argc, char *argv[]);
+int cli_cmd_render(int argc, char *argv[]);
+int cli_cmd_seq(int argc, char *argv[]);
+int cli_cmd_uart(int argc, char *argv[]);
+int cli_cmd_ccmap(int argc, char *argv[]);
+int cli_cmd_bend(int argc, char *argv[]);
+int cli_cmd_tuning(int argc, char *argv[]);
+int cli_cmd_velocity(int argc, char *argv[]);
+int cli_cmd_mpe(int argc, char *argv[]);
+int cli_cmd_midiout(int argc, char *argv[]);
 
 /* Private variable --------------------------------------------------------*/
 
 /* List of commands implemented */
 static const sShellCommand s_shell_commands[] = {
-    { "wave", cli_cmd_wave, "Select output waveform. WaveId [0-4]" },
+    { "wave", cli_cmd_wave, "Select output waveform. WaveId [0-4] factory, [5-8] user" },
+    { "morph", cli_cmd_morph, "Set wavetable morph position. VoiceId [0-8], Position [0.0-4.0]" },
     { "detune", cli_cmd_detune, "Update voice detuning parameter. VoiceId [0-7], DetuneLvl [-1.0, 1.0]" },
     { "midi", cli_cmd_midi, "Activate midi note. Voice [0-7], Note [0-126], State [0-1]" },
-    { "delay", cli_cmd_delay, "Update DELAY section. Time (seconds), Feedback (0-1)" },
-    { "filter", cli_cmd_filter, "Update FILTER section. Frquency (Hz), Q" },
-    { "effect_slot", cli_cmd_effect_slot, "Config effect slot. SlotId [0-1], EffectId [0-2]" },
-    { "effect_enable", cli_cmd_effect_enable, "Enable effect slot. SlotId [0-1], Enable [0-1]" },
+    { "delay", cli_cmd_delay, "Update DELAY section. Time (seconds), Feedback (0-1), [SlotId [0-3]]" },
+    { "filter", cli_cmd_filter, "Update FILTER section. Frquency (Hz), Q, [SlotId [0-3]]" },
+    { "effect_slot", cli_cmd_effect_slot, "Config effect slot. SlotId [0-3], EffectId [0-2]" },
+    { "effect_enable", cli_cmd_effect_enable, "Enable effect slot. SlotId [0-3], Enable [0-1]" },
+    { "limiter", cli_cmd_limiter, "Update master LIMITER. Enable [0-1], Threshold (0.1-1), Release (seconds)" },
+    { "compressor", cli_cmd_compressor, "Update master COMPRESSOR. Threshold (dB), Ratio [1-20], Attack (seconds), Release (seconds), Makeup (dB)" },
+    { "render", cli_cmd_render, "Show render cycles per block (last, avg, max, budget). [Reset [0-1]]" },
+    { "seq", cli_cmd_seq, "Sequencer control, no args show state. Play [0-1], [Source [0 flash, 1 sysex]], [Loop [0-1]]" },
+    { "uart", cli_cmd_uart, "Show serial RX overrun count of each interface" },
+    { "bend", cli_cmd_bend, "Pitch modulation. BendRange (semitones), [VibratoRate (Hz), VibratoDepth (semitones)]" },
+    { "tuning", cli_cmd_tuning, "Note tuning, no args restore equal temperament. Note [0-127], [Pitch (semitones, 69.0 is A4 440 Hz)]" },
+    { "velocity", cli_cmd_velocity, "Velocity response. Curve [0 off, 1 linear, 2 dB, 3 power, 4 user], [AttackSens (0-1)], [Exponent (0.1-10)]" },
+    { "mpe", cli_cmd_mpe, "Per note expression response, zone set by MPE config message. BendRange (semitones), PressureDepth (0-1), TimbreDepth (0-1)" },
+    { "midiout", cli_cmd_midiout, "Midi out, no args show counters. Thru [0-1], Seq [0-1], [RunningStatus [0-1]]" },
+    { "ccmap", cli_cmd_ccmap, "Midi CC to parameter map, no args show map. CC [0-127], ParamId [0-11], other clears" },
     { "logon", cli_cmd_logOn, "Enable global log" },
     { "logoff", cli_cmd_logOff, "Disable global log" },
     { "setloglvl", cli_cmd_setLogLvl, "Set new log level for defined interface. Interface [0-7], Level [0-3]" },
@@ -155,7 +183,7 @@ int cli_cmd_wave(int argc, char *argv[])
             xAudioCmd.xCmdPayload.xSetWave.eVoiceId = AUDIO_VOICE_NUM;
             xAudioCmd.xCmdPayload.xSetWave.eWaveId = u32WaveId;
 
-            if (AUDIO_handle_cmd(xAudioCmd) != AUDIO_OK)
+            if (AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd) != AUDIO_OK)
             {
                 iRetCode = SHELL_RET_ERR;
             }
@@ -206,7 +234,7 @@ int cli_cmd_detune(int argc, char *argv[])
         xAudioCmd.xCmdPayload.xSetDetune.eVoiceId = (audio_voice_id_t)u8VoiceId;
         xAudioCmd.xCmdPayload.xSetDetune.fDetuneLvl = fDetuneLvl;
 
-        if (AUDIO_handle_cmd(xAudioCmd) != AUDIO_OK)
+        if (AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd) != AUDIO_OK)
         {
             iRetCode = SHELL_RET_ERR;
         }
@@ -224,6 +252,59 @@ int cli_cmd_detune(int argc, char *argv[])
     return iRetCode;
 }
 
+/**
+ * @brief Update wavetable morph position.
+ * 
+ * @param argc number of arguments, 3.
+ * @param argv List of arguments, argv[0]: cmd name, argv[1] voice_id, 8 for all voices, argv[2] morph position.
+ * @return int Status:  0, OK, !0, ERROR.
+ */
+int cli_cmd_morph(int argc, char *argv[])
+{
+    int iRetCode = SHELL_RET_OK;
+
+    if ( argc != 3U )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+    else
+    {
+        /* Check interface */
+        uint8_t u8VoiceId = (uint8_t)atoi(argv[1U]);
+        float fMorph = (float)atof(argv[2U]);
+
+        if ( u8VoiceId <= AUDIO_VOICE_NUM )
+        {
+            audio_cmd_t xAudioCmd = { 0U };
+
+            xAudioCmd.eCmdId = AUDIO_CMD_SET_MORPH;
+            xAudioCmd.xCmdPayload.xSetMorph.eVoiceId = (audio_voice_id_t)u8VoiceId;
+            xAudioCmd.xCmdPayload.xSetMorph.fMorph = fMorph;
+
+            if (AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd) != AUDIO_OK)
+            {
+                iRetCode = SHELL_RET_ERR;
+            }
+        }
+        else
+        {
+            shell_put_line("Wrong voice id value!");
+            iRetCode = SHELL_RET_ERR;
+        }
+    }
+
+    if ( iRetCode == SHELL_RET_OK )
+    {
+        shell_put_line(SHELL_STR_OK);
+    }
+    else
+    {
+        shell_put_line(SHELL_STR_ERR);
+    }
+
+    return iRetCode;
+}
+
 /**
  * @brief Simulate midi note activation.
  * 
@@ -256,7 +337,7 @@ int cli_cmd_midi(int argc, char *argv[])
             xAudioCmd.xCmdPayload.xSetMidiNote.u8Velocity = 120U;
             xAudioCmd.xCmdPayload.xSetMidiNote.bActive = (bool)u8State;
 
-            if (AUDIO_handle_cmd(xAudioCmd) != AUDIO_OK)
+            if (AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd) != AUDIO_OK)
             {
                 iRetCode = SHELL_RET_ERR;
             }
@@ -283,8 +364,9 @@ int cli_cmd_midi(int argc, char *argv[])
 /**
  * @brief Update parameters for delay section
  * 
- * @param argc Number of arguments, 3
- * @param argv List of arguments, argv[0]: cmd name, argv[1] delay time in seconds , argv[2] feedback level (<1)
+ * @param argc Number of arguments, 3 or 4
+ * @param argv List of arguments, argv[0]: cmd name, argv[1] delay time in seconds , argv[2] feedback level (<1),
+ *             argv[3] optional slot id, all delay slots if not set
  * @return int Status:  0, OK, !0, ERROR
  */
 int cli_cmd_delay(int argc, char *argv[])
@@ -300,22 +382,24 @@ int cli_cmd_delay(int argc, char *argv[])
         /* Check interface */
         float fTime = (float)atof(argv[1U]);
         float fFeedback = (float)atof(argv[2U]);
+        uint8_t u8Slot = ( argc == 4U ) ? (uint8_t)atoi(argv[3U]) : AUDIO_EFFECT_SLOT_NUM;
 
         if ( fFeedback < 1.0F )
         {
             audio_cmd_t xAudioCmd = { 0U };
 
             xAudioCmd.eCmdId = AUDIO_CMD_EFFECT_UPDATE;
+            xAudioCmd.xCmdPayload.xEffectUpdate.eSlot = u8Slot;
             xAudioCmd.xCmdPayload.xEffectUpdate.eParamId = AUDIO_EFFECT_PARAMETER_DELAY_TIME;
             xAudioCmd.xCmdPayload.xEffectUpdate.fNewValue = fTime;
 
-            if (AUDIO_handle_cmd(xAudioCmd) == AUDIO_OK)
+            if (AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd) == AUDIO_OK)
             {
                 xAudioCmd.eCmdId = AUDIO_CMD_EFFECT_UPDATE;
                 xAudioCmd.xCmdPayload.xEffectUpdate.eParamId = AUDIO_EFFECT_PARAMETER_DELAY_FB;
                 xAudioCmd.xCmdPayload.xEffectUpdate.fNewValue = fFeedback;
 
-                if (AUDIO_handle_cmd(xAudioCmd) != AUDIO_OK)
+                if (AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd) != AUDIO_OK)
                 {
                     iRetCode = SHELL_RET_ERR;
                 }
@@ -346,8 +430,9 @@ int cli_cmd_delay(int argc, char *argv[])
 /**
  * @brief Update parameters for filter section
  * 
- * @param argc Number of arguments, 3
- * @param argv List of arguments, argv[0]: cmd name, argv[1] cutof frequency, argv[2] filter Q
+ * @param argc Number of arguments, 3 or 4
+ * @param argv List of arguments, argv[0]: cmd name, argv[1] cutof frequency, argv[2] filter Q,
+ *             argv[3] optional slot id, all filter slots if not set
  * @return int Status:  0, OK, !0, ERROR
  */
 int cli_cmd_filter(int argc, char *argv[])
@@ -363,20 +448,22 @@ int cli_cmd_filter(int argc, char *argv[])
         /* Check interface */
         float fFreqCutoff = (float)atof(argv[1U]);
         float fQ = (float)atof(argv[2U]);
+        uint8_t u8Slot = ( argc == 4U ) ? (uint8_t)atoi(argv[3U]) : AUDIO_EFFECT_SLOT_NUM;
 
         audio_cmd_t xAudioCmd = { 0U };
 
         xAudioCmd.eCmdId = AUDIO_CMD_EFFECT_UPDATE;
+        xAudioCmd.xCmdPayload.xEffectUpdate.eSlot = u8Slot;
         xAudioCmd.xCmdPayload.xEffectUpdate.eParamId = AUDIO_EFFECT_PARAMETER_FILTER_FREQ;
         xAudioCmd.xCmdPayload.xEffectUpdate.fNewValue = fFreqCutoff;
 
-        if (AUDIO_handle_cmd(xAudioCmd) == AUDIO_OK)
+        if (AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd) == AUDIO_OK)
         {
             xAudioCmd.eCmdId = AUDIO_CMD_EFFECT_UPDATE;
             xAudioCmd.xCmdPayload.xEffectUpdate.eParamId = AUDIO_EFFECT_PARAMETER_FILTER_Q;
             xAudioCmd.xCmdPayload.xEffectUpdate.fNewValue = fQ;
 
-            if (AUDIO_handle_cmd(xAudioCmd) != AUDIO_OK)
+            if (AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd) != AUDIO_OK)
             {
                 iRetCode = SHELL_RET_ERR;
             }
@@ -426,7 +513,7 @@ int cli_cmd_effect_slot(int argc, char *argv[])
         xAudioCmd.xCmdPayload.xSetSlot.eSlot = u8Slot;
         xAudioCmd.xCmdPayload.xSetSlot.eEffectId = u8Effect;
 
-        if (AUDIO_handle_cmd(xAudioCmd) != AUDIO_OK)
+        if (AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd) != AUDIO_OK)
         {
             iRetCode = SHELL_RET_ERR;
         }
@@ -471,7 +558,7 @@ int cli_cmd_effect_enable(int argc, char *argv[])
         xAudioCmd.xCmdPayload.xActivateSlot.eSlot = u8Slot;
         xAudioCmd.xCmdPayload.xActivateSlot.bActive = (bool)u8Activate;
 
-        if (AUDIO_handle_cmd(xAudioCmd) != AUDIO_OK)
+        if (AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd) != AUDIO_OK)
         {
             iRetCode = SHELL_RET_ERR;
         }
@@ -489,6 +576,114 @@ int cli_cmd_effect_enable(int argc, char *argv[])
     return iRetCode;
 }
 
+/**
+ * @brief Update parameters for master limiter
+ * 
+ * @param argc Number of arguments, 4
+ * @param argv List of arguments, argv[0]: cmd name, argv[1] enable state, argv[2] threshold in full scale units,
+ *             argv[3] release time in seconds
+ * @return int Status:  0, OK, !0, ERROR
+ */
+int cli_cmd_limiter(int argc, char *argv[])
+{
+    int iRetCode = SHELL_RET_OK;
+
+    if ( argc != 4U )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+    else
+    {
+        /* Check interface */
+        audio_master_parameter_id_t pxParamList[] = {
+            AUDIO_MASTER_PARAMETER_LIMITER_ENABLE,
+            AUDIO_MASTER_PARAMETER_LIMITER_THRESHOLD,
+            AUDIO_MASTER_PARAMETER_LIMITER_RELEASE,
+        };
+
+        audio_cmd_t xAudioCmd = { 0U };
+
+        xAudioCmd.eCmdId = AUDIO_CMD_MASTER_UPDATE;
+
+        for ( uint32_t i = 0U; (i < ARRAY_SIZE(pxParamList)) && (iRetCode == SHELL_RET_OK); i++ )
+        {
+            xAudioCmd.xCmdPayload.xMasterUpdate.eParamId = pxParamList[i];
+            xAudioCmd.xCmdPayload.xMasterUpdate.fNewValue = (float)atof(argv[i + 1U]);
+
+            if (AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd) != AUDIO_OK)
+            {
+                iRetCode = SHELL_RET_ERR;
+            }
+        }
+    }
+
+    if ( iRetCode == SHELL_RET_OK )
+    {
+        shell_put_line(SHELL_STR_OK);
+    }
+    else
+    {
+        shell_put_line(SHELL_STR_ERR);
+    }
+
+    return iRetCode;
+}
+
+/**
+ * @brief Update parameters for master compressor
+ * 
+ * @param argc Number of arguments, 6
+ * @param argv List of arguments, argv[0]: cmd name, argv[1] threshold in dB, argv[2] ratio, argv[3] attack time in seconds,
+ *             argv[4] release time in seconds, argv[5] makeup gain in dB
+ * @return int Status:  0, OK, !0, ERROR
+ */
+int cli_cmd_compressor(int argc, char *argv[])
+{
+    int iRetCode = SHELL_RET_OK;
+
+    if ( argc != 6U )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+    else
+    {
+        /* Check interface */
+        audio_master_parameter_id_t pxParamList[] = {
+            AUDIO_MASTER_PARAMETER_COMP_THRESHOLD,
+            AUDIO_MASTER_PARAMETER_COMP_RATIO,
+            AUDIO_MASTER_PARAMETER_COMP_ATTACK,
+            AUDIO_MASTER_PARAMETER_COMP_RELEASE,
+            AUDIO_MASTER_PARAMETER_COMP_MAKEUP,
+        };
+
+        audio_cmd_t xAudioCmd = { 0U };
+
+        xAudioCmd.eCmdId = AUDIO_CMD_MASTER_UPDATE;
+
+        for ( uint32_t i = 0U; (i < ARRAY_SIZE(pxParamList)) && (iRetCode == SHELL_RET_OK); i++ )
+        {
+            xAudioCmd.xCmdPayload.xMasterUpdate.eParamId = pxParamList[i];
+            xAudioCmd.xCmdPayload.xMasterUpdate.fNewValue = (float)atof(argv[i + 1U]);
+
+            if (AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd) != AUDIO_OK)
+            {
+                iRetCode = SHELL_RET_ERR;
+            }
+        }
+    }
+
+    if ( iRetCode == SHELL_RET_OK )
+    {
+        shell_put_line(SHELL_STR_OK);
+    }
+    else
+    {
+        shell_put_line(SHELL_STR_ERR);
+    }
+
+    return iRetCode;
+}
+
 /**
  * @brief Enable log interface.
  * 
@@ -605,6 +800,413 @@ int cli_cmd_setLogLvl(int argc, char *argv[])
     return iRetCode;
 }
 
+/**
+ * @brief Show audio render profiling.
+ * 
+ * @param argc Number of arguments.
+ * @param argv List of arguments, argv[0]: cmd name, argv[1] optional reset.
+ * @return int Status:  0, OK, !0, ERROR.
+ */
+int cli_cmd_render(int argc, char *argv[])
+{
+    int iRetCode = SHELL_RET_OK;
+
+    if ( argc > 2U )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+    else
+    {
+        char pcLine[96];
+        audio_render_stats_t xStats = { 0U };
+
+        AUDIO_get_render_stats(AudioTask_get_engine(), &xStats);
+
+        uint32_t u32Load = ( xStats.u32BudgetCycles != 0U ) ? ((xStats.u32AvgCycles * 100U) / xStats.u32BudgetCycles) : 0U;
+
+        snprintf(pcLine, sizeof(pcLine), "Cycles last %lu, avg %lu, max %lu, budget %lu, load %lu%%, blocks %lu",
+                 (unsigned long)xStats.u32LastCycles, (unsigned long)xStats.u32AvgCycles,
+                 (unsigned long)xStats.u32MaxCycles, (unsigned long)xStats.u32BudgetCycles,
+                 (unsigned long)u32Load, (unsigned long)xStats.u32BlockCount);
+        shell_put_line(pcLine);
+
+        if ( (argc == 2U) && (atoi(argv[1U]) != 0) )
+        {
+            AUDIO_reset_render_stats(AudioTask_get_engine());
+        }
+    }
+
+    if ( iRetCode == SHELL_RET_OK )
+    {
+        shell_put_line(SHELL_STR_OK);
+    }
+    else
+    {
+        shell_put_line(SHELL_STR_ERR);
+    }
+
+    return iRetCode;
+}
+
+/**
+ * @brief Control SMF sequencer.
+ * 
+ * @param argc Number of arguments.
+ * @param argv List of arguments, argv[0]: cmd name, argv[1] play, argv[2] source, argv[3] loop.
+ * @return int Status:  0, OK, !0, ERROR.
+ */
+int cli_cmd_seq(int argc, char *argv[])
+{
+    int iRetCode = SHELL_RET_OK;
+
+    if ( argc > 4U )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+    else if ( argc == 1U )
+    {
+        static const char * const pcStateName[] = { "idle", "play", "end" };
+        midi_seq_state_t eState = MidiTask_seq_get_state();
+
+        shell_put_line(( (uint32_t)eState < ARRAY_SIZE(pcStateName) ) ? pcStateName[eState] : "unknown");
+    }
+    else if ( atoi(argv[1U]) == 0 )
+    {
+        iRetCode = MidiTask_seq_stop() ? SHELL_RET_OK : SHELL_RET_ERR;
+    }
+    else
+    {
+        uint32_t u32Src = ( argc > 2U ) ? (uint32_t)atoi(argv[2U]) : (uint32_t)MIDI_TASK_SEQ_FLASH;
+        bool bLoop = ( argc > 3U ) && ( atoi(argv[3U]) != 0 );
+
+        if ( u32Src < (uint32_t)MIDI_TASK_SEQ_NUM )
+        {
+            iRetCode = MidiTask_seq_play((midi_task_seq_src_t)u32Src, bLoop) ? SHELL_RET_OK : SHELL_RET_ERR;
+        }
+        else
+        {
+            iRetCode = SHELL_RET_ERR;
+        }
+    }
+
+    if ( iRetCode == SHELL_RET_OK )
+    {
+        shell_put_line(SHELL_STR_OK);
+    }
+    else
+    {
+        shell_put_line(SHELL_STR_ERR);
+    }
+
+    return iRetCode;
+}
+
+/**
+ * @brief Show serial reception overruns.
+ * 
+ * @param argc Number of arguments.
+ * @param argv List of arguments, argv[0]: cmd name.
+ * @return int Status:  0, OK, !0, ERROR.
+ */
+int cli_cmd_uart(int argc, char *argv[])
+{
+    int iRetCode = SHELL_RET_OK;
+
+    if ( argc != 1U )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+    else
+    {
+        char pcLine[48];
+
+        for ( uint32_t i = 0U; i < (uint32_t)SYS_USART_NUM; i++ )
+        {
+            snprintf(pcLine, sizeof(pcLine), "USART %lu overrun %lu",
+                     (unsigned long)i, (unsigned long)sys_usart_get_overrun((sys_usart_id_t)i));
+            shell_put_line(pcLine);
+        }
+    }
+
+    if ( iRetCode == SHELL_RET_OK )
+    {
+        shell_put_line(SHELL_STR_OK);
+    }
+    else
+    {
+        shell_put_line(SHELL_STR_ERR);
+    }
+
+    return iRetCode;
+}
+
+/**
+ * @brief Show midi out counters or select forwarded sources.
+ * 
+ * @param argc Number of arguments.
+ * @param argv List of arguments, argv[0]: cmd name, argv[1] thru enable, argv[2] sequencer enable, argv[3] running status.
+ * @return int Status:  0, OK, !0, ERROR.
+ */
+int cli_cmd_midiout(int argc, char *argv[])
+{
+    int iRetCode = SHELL_RET_OK;
+
+    if ( argc == 1U )
+    {
+        char pcLine[64];
+        midi_out_stats_t xStats;
+        uint32_t u32Src = MidiTask_out_get_src();
+
+        MidiTask_out_get_stats(&xStats);
+        snprintf(pcLine, sizeof(pcLine), "Thru %u seq %u",
+                 ( (u32Src & MIDI_TASK_OUT_THRU) != 0U ) ? 1U : 0U,
+                 ( (u32Src & MIDI_TASK_OUT_SEQ) != 0U ) ? 1U : 0U);
+        shell_put_line(pcLine);
+        snprintf(pcLine, sizeof(pcLine), "Batches %lu saved %lu dropped %lu pending %lu",
+                 (unsigned long)xStats.u32Batches, (unsigned long)xStats.u32Saved,
+                 (unsigned long)xStats.u32Dropped, (unsigned long)xStats.u32Pending);
+        shell_put_line(pcLine);
+    }
+    else if ( (argc == 3U) || (argc == 4U) )
+    {
+        uint32_t u32Src = 0U;
+        bool bRunning = ( argc == 4U ) ? (atoi(argv[3U]) != 0) : true;
+
+        u32Src |= ( atoi(argv[1U]) != 0 ) ? MIDI_TASK_OUT_THRU : 0U;
+        u32Src |= ( atoi(argv[2U]) != 0 ) ? MIDI_TASK_OUT_SEQ : 0U;
+
+        if ( !MidiTask_out_config(u32Src, bRunning) )
+        {
+            iRetCode = SHELL_RET_ERR;
+        }
+    }
+    else
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+
+    if ( iRetCode == SHELL_RET_OK )
+    {
+        shell_put_line(SHELL_STR_OK);
+    }
+    else
+    {
+        shell_put_line(SHELL_STR_ERR);
+    }
+
+    return iRetCode;
+}
+
+/**
+ * @brief Show or update midi CC to parameter map.
+ * 
+ * @param argc Number of arguments.
+ * @param argv List of arguments, argv[0]: cmd name, argv[1] CC number, argv[2] parameter id.
+ * @return int Status:  0, OK, !0, ERROR.
+ */
+int cli_cmd_ccmap(int argc, char *argv[])
+{
+    int iRetCode = SHELL_RET_OK;
+
+    if ( argc == 1U )
+    {
+        char pcLine[32];
+
+        for ( uint32_t u32Cc = 0U; u32Cc < 128U; u32Cc++ )
+        {
+            audio_param_id_t eParam = MidiTask_cc_map_get((uint8_t)u32Cc);
+
+            if ( eParam < AUDIO_PARAM_NUM )
+            {
+                snprintf(pcLine, sizeof(pcLine), "CC %lu %s (%lu)",
+                         (unsigned long)u32Cc, AUDIO_PARAM_get_name(eParam), (unsigned long)eParam);
+                shell_put_line(pcLine);
+            }
+        }
+    }
+    else if ( argc == 3U )
+    {
+        int iCc = atoi(argv[1U]);
+        int iParam = atoi(argv[2U]);
+        audio_param_id_t eParam = ( (iParam >= 0) && (iParam < (int)AUDIO_PARAM_NUM) ) ? (audio_param_id_t)iParam : AUDIO_PARAM_NUM;
+
+        if ( (iCc < 0) || (iCc > 127) || !MidiTask_cc_map_set((uint8_t)iCc, eParam) )
+        {
+            iRetCode = SHELL_RET_ERR;
+        }
+    }
+    else
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+
+    if ( iRetCode == SHELL_RET_OK )
+    {
+        shell_put_line(SHELL_STR_OK);
+    }
+    else
+    {
+        shell_put_line(SHELL_STR_ERR);
+    }
+
+    return iRetCode;
+}
+
+/**
+ * @brief Update pitch bend range and vibrato.
+ * 
+ * @param argc Number of arguments.
+ * @param argv List of arguments, argv[0]: cmd name, argv[1] bend range, argv[2] vibrato rate,
+ *             argv[3] vibrato depth at full mod wheel.
+ * @return int Status:  0, OK, !0, ERROR.
+ */
+int cli_cmd_bend(int argc, char *argv[])
+{
+    int iRetCode = SHELL_RET_OK;
+
+    if ( (argc != 2U) && (argc != 4U) )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+    else if ( AUDIO_set_bend_range(AudioTask_get_engine(), (float)atof(argv[1U])) != AUDIO_OK )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+    else if ( (argc == 4U) && (AUDIO_set_vibrato(AudioTask_get_engine(), (float)atof(argv[2U]), (float)atof(argv[3U])) != AUDIO_OK) )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+
+    if ( iRetCode == SHELL_RET_OK )
+    {
+        shell_put_line(SHELL_STR_OK);
+    }
+    else
+    {
+        shell_put_line(SHELL_STR_ERR);
+    }
+
+    return iRetCode;
+}
+
+/**
+ * @brief Show or update note tuning table.
+ * 
+ * @param argc Number of arguments.
+ * @param argv List of arguments, argv[0]: cmd name, argv[1] midi note, argv[2] pitch in semitones.
+ * @return int Status:  0, OK, !0, ERROR.
+ */
+int cli_cmd_tuning(int argc, char *argv[])
+{
+    int iRetCode = SHELL_RET_OK;
+    int iNote = ( argc > 1U ) ? atoi(argv[1U]) : 0;
+
+    if ( argc == 1U )
+    {
+        AUDIO_reset_tuning(AudioTask_get_engine());
+    }
+    else if ( (iNote < 0) || (iNote > 127) )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+    else if ( argc == 2U )
+    {
+        char pcLine[32];
+
+        snprintf(pcLine, sizeof(pcLine), "Note %d %d mHz", iNote,
+                 (int)(AUDIO_get_note_freq(AudioTask_get_engine(), (uint8_t)iNote) * 1000.0F));
+        shell_put_line(pcLine);
+    }
+    else if ( (argc != 3U) || (AUDIO_set_note_tuning(AudioTask_get_engine(), (uint8_t)iNote, (float)atof(argv[2U])) != AUDIO_OK) )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+
+    if ( iRetCode == SHELL_RET_OK )
+    {
+        shell_put_line(SHELL_STR_OK);
+    }
+    else
+    {
+        shell_put_line(SHELL_STR_ERR);
+    }
+
+    return iRetCode;
+}
+
+/**
+ * @brief Select velocity curve and attack sensitivity.
+ * 
+ * @param argc Number of arguments.
+ * @param argv List of arguments, argv[0]: cmd name, argv[1] curve id, argv[2] attack sensitivity,
+ *             argv[3] exponent of power curve.
+ * @return int Status:  0, OK, !0, ERROR.
+ */
+int cli_cmd_velocity(int argc, char *argv[])
+{
+    int iRetCode = SHELL_RET_OK;
+    int iCurve = ( argc > 1U ) ? atoi(argv[1U]) : -1;
+    float fSens = ( argc > 2U ) ? (float)atof(argv[2U]) : 0.0F;
+    float fExponent = ( argc > 3U ) ? (float)atof(argv[3U]) : 2.0F;
+
+    if ( (argc < 2U) || (argc > 4U) || (iCurve < 0) || (iCurve >= (int)AUDIO_VEL_CURVE_NUM) )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+    else if ( AUDIO_set_vel_curve(AudioTask_get_engine(), (audio_vel_curve_t)iCurve, fExponent) != AUDIO_OK )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+    else if ( AUDIO_set_vel_attack(AudioTask_get_engine(), fSens) != AUDIO_OK )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+
+    if ( iRetCode == SHELL_RET_OK )
+    {
+        shell_put_line(SHELL_STR_OK);
+    }
+    else
+    {
+        shell_put_line(SHELL_STR_ERR);
+    }
+
+    return iRetCode;
+}
+
+/**
+ * @brief Set response of MPE per note expression.
+ * 
+ * @param argc Number of arguments.
+ * @param argv List of arguments, argv[0]: cmd name, argv[1] bend range, argv[2] pressure depth,
+ *             argv[3] timbre depth.
+ * @return int Status:  0, OK, !0, ERROR.
+ */
+int cli_cmd_mpe(int argc, char *argv[])
+{
+    int iRetCode = SHELL_RET_OK;
+
+    if ( argc != 4U )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+    else if ( AUDIO_set_expr_depth(AudioTask_get_engine(), (float)atof(argv[1U]), (float)atof(argv[2U]), (float)atof(argv[3U])) != AUDIO_OK )
+    {
+        iRetCode = SHELL_RET_ERR;
+    }
+
+    if ( iRetCode == SHELL_RET_OK )
+    {
+        shell_put_line(SHELL_STR_OK);
+    }
+    else
+    {
+        shell_put_line(SHELL_STR_ERR);
+    }
+
+    return iRetCode;
+}
+
 /* Public definition -------------------------------------------------------*/
 
-/* EOF */
\ No newline at end of file
+/* EOF */
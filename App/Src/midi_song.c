@@ -0,0 +1,53 @@
+/**
+ * @file    midi_song.c
+ * @author  Sebastián Del Moral
+ * @brief   Standard MIDI File stored in flash, played by sequencer.
+ * @version 0.1
+ * @date    2021-12-04
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "midi_song.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Public variables ----------------------------------------------------------*/
+
+/* Am, F, C, G arpeggios in eighth notes, division 96 */
+const uint8_t MidiSongFlash[] = {
+    0x4D, 0x54, 0x68, 0x64, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x01,
+    0x00, 0x60, 0x4D, 0x54, 0x72, 0x6B, 0x00, 0x00, 0x01, 0x0B, 0x00, 0xFF,
+    0x51, 0x03, 0x07, 0xA1, 0x20, 0x00, 0x90, 0x39, 0x64, 0x28, 0x80, 0x39,
+    0x00, 0x08, 0x90, 0x3C, 0x64, 0x28, 0x80, 0x3C, 0x00, 0x08, 0x90, 0x40,
+    0x64, 0x28, 0x80, 0x40, 0x00, 0x08, 0x90, 0x45, 0x64, 0x28, 0x80, 0x45,
+    0x00, 0x08, 0x90, 0x45, 0x64, 0x28, 0x80, 0x45, 0x00, 0x08, 0x90, 0x40,
+    0x64, 0x28, 0x80, 0x40, 0x00, 0x08, 0x90, 0x3C, 0x64, 0x28, 0x80, 0x3C,
+    0x00, 0x08, 0x90, 0x39, 0x64, 0x28, 0x80, 0x39, 0x00, 0x08, 0x90, 0x35,
+    0x64, 0x28, 0x80, 0x35, 0x00, 0x08, 0x90, 0x39, 0x64, 0x28, 0x80, 0x39,
+    0x00, 0x08, 0x90, 0x3C, 0x64, 0x28, 0x80, 0x3C, 0x00, 0x08, 0x90, 0x41,
+    0x64, 0x28, 0x80, 0x41, 0x00, 0x08, 0x90, 0x41, 0x64, 0x28, 0x80, 0x41,
+    0x00, 0x08, 0x90, 0x3C, 0x64, 0x28, 0x80, 0x3C, 0x00, 0x08, 0x90, 0x39,
+    0x64, 0x28, 0x80, 0x39, 0x00, 0x08, 0x90, 0x35, 0x64, 0x28, 0x80, 0x35,
+    0x00, 0x08, 0x90, 0x30, 0x64, 0x28, 0x80, 0x30, 0x00, 0x08, 0x90, 0x34,
+    0x64, 0x28, 0x80, 0x34, 0x00, 0x08, 0x90, 0x37, 0x64, 0x28, 0x80, 0x37,
+    0x00, 0x08, 0x90, 0x3C, 0x64, 0x28, 0x80, 0x3C, 0x00, 0x08, 0x90, 0x3C,
+    0x64, 0x28, 0x80, 0x3C, 0x00, 0x08, 0x90, 0x37, 0x64, 0x28, 0x80, 0x37,
+    0x00, 0x08, 0x90, 0x34, 0x64, 0x28, 0x80, 0x34, 0x00, 0x08, 0x90, 0x30,
+    0x64, 0x28, 0x80, 0x30, 0x00, 0x08, 0x90, 0x37, 0x64, 0x28, 0x80, 0x37,
+    0x00, 0x08, 0x90, 0x3B, 0x64, 0x28, 0x80, 0x3B, 0x00, 0x08, 0x90, 0x3E,
+    0x64, 0x28, 0x80, 0x3E, 0x00, 0x08, 0x90, 0x43, 0x64, 0x28, 0x80, 0x43,
+    0x00, 0x08, 0x90, 0x43, 0x64, 0x28, 0x80, 0x43, 0x00, 0x08, 0x90, 0x3E,
+    0x64, 0x28, 0x80, 0x3E, 0x00, 0x08, 0x90, 0x3B, 0x64, 0x28, 0x80, 0x3B,
+    0x00, 0x08, 0x90, 0x37, 0x64, 0x28, 0x80, 0x37, 0x00, 0x08, 0xFF, 0x2F,
+    0x00,
+};
+
+const uint32_t u32MidiSongFlashLen = sizeof(MidiSongFlash);
+
+/* EOF */
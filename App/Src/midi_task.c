@@ -12,12 +12,17 @@
 /* Includes ------------------------------------------------------------------*/
 #include "midi_task.h"
 
-#include "circular_buffer.h"
-
 #include "audio_engine.h"
+#include "audio_task.h"
+#include "audio_wavetable.h"
 
 #include "midi_lib.h"
 #include "midi_voice.h"
+#include "midi_sysex.h"
+#include "midi_mts.h"
+#include "midi_seq.h"
+#include "midi_song.h"
+#include "midi_out.h"
 
 #include "sys_log.h"
 #include "sys_usart.h"
@@ -39,9 +44,14 @@
 /* Status gpio output */
 #define MIDI_STATUS_LED             ( SYS_GPIO_1 )
 
-/* Serial buff size for midi RX channel */
-#define MIDI_CBUFF_RX_SIZE          ( 256U )
-#define MIDI_DMA_BUFF_RX_SIZE       ( 128U )
+/* Circular DMA buffer for midi RX channel, parsed in place by task */
+#define MIDI_DMA_BUFF_RX_SIZE       ( 256U )
+
+/* Midi out queue, DMA reads it in place, power of two */
+#define MIDI_OUT_BUFF_SIZE          ( 1024U )
+
+/* Words of note bit map kept for each channel */
+#define MIDI_SEQ_NOTE_WORDS         ( 128U / 32U )
 
 /* Nuber of voices to control over midi */
 #define MIDI_NUM_VOICE              ( 8U )  // Call to voice lib to get num voices?
@@ -49,8 +59,35 @@
 /* Init midi channel */
 #define MIDI_CH_DEFAULT             ( 0U )
 
+/* Sys ex reception buffer, fits one wave data chunk and a tuning bulk dump */
+#define MIDI_SYSEX_BUFF_SIZE        ( 512U )
+
+/* Sys ex device id of this unit */
+#define MIDI_SYSEX_DEV_ID           ( 0x00U )
+
+/* User wave upload, one frame sent in fixed size chunks */
+#define MIDI_WAVE_FRAME_SIZE        ( 256U )
+#define MIDI_WAVE_CHUNK_NUM         ( MIDI_WAVE_FRAME_SIZE / SYSEX_WAVE_CHUNK_SAMPLES )
+#define MIDI_WAVE_CHUNK_ALL         ( (1U << MIDI_WAVE_CHUNK_NUM) - 1U )
+#define MIDI_WAVE_SLOT_NONE         ( 0xFFU )
+
+/* RAM buffer for files uploaded over sys ex */
+#define MIDI_SEQ_USER_SIZE          ( 4096U )
+
+/* Controller map, one entry per CC number */
+#define MIDI_CC_NUM                 ( 128U )
+#define MIDI_CC_VALUE_MAX           ( 127.0F )
+
+/* CC 74 scale, controller center 64 maps to timbre at rest */
+#define MIDI_TIMBRE_SPAN            ( 128.0F )
+
 /* Task defined events */
 #define MIDI_EVT_DATA_IN            (uint32_t)( 1 << 0 )
+#define MIDI_EVT_SEQ_TICK           (uint32_t)( 1 << 1 )
+#define MIDI_EVT_SEQ_CTRL           (uint32_t)( 1 << 2 )
+#define MIDI_EVT_TX_DONE            (uint32_t)( 1 << 3 )
+#define MIDI_EVT_OUT_CTRL           (uint32_t)( 1 << 4 )
+#define MIDI_EVT_ALL                ( MIDI_EVT_DATA_IN | MIDI_EVT_SEQ_TICK | MIDI_EVT_SEQ_CTRL | MIDI_EVT_TX_DONE | MIDI_EVT_OUT_CTRL )
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -73,18 +110,103 @@ midi_handler_t MidiEngine;
 midi_voice_handler_t MidiVoiceEngine;
 midi_voice_t MidiVoiceList[MIDI_NUM_VOICE];
 
-/* Midi Rx buffer */
-circular_buf_t MidiCBuff = { 0U };
-uint8_t MidiRxCBuff[MIDI_CBUFF_RX_SIZE] = { 0U };
+/* Midi Rx buffer, written by DMA */
 uint8_t MidiRxDMABuff[MIDI_DMA_BUFF_RX_SIZE] = { 0U };
 
+/* Midi sys ex buffer */
+uint8_t MidiSysExBuff[MIDI_SYSEX_BUFF_SIZE] = { 0U };
+
+/* User wave upload staging, frame is handed to audio engine once complete */
+int16_t MidiWaveStage[MIDI_WAVE_FRAME_SIZE] = { 0 };
+uint32_t u32MidiWaveChunkMask = 0U;
+uint8_t u8MidiWaveSlot = MIDI_WAVE_SLOT_NONE;
+
+/* Sequencer, clocked by audio engine blocks */
+midi_seq_t MidiSeq;
+midi_task_seq_src_t eMidiSeqSrc = MIDI_TASK_SEQ_FLASH;
+
+/* Sequencer file uploaded over sys ex */
+uint8_t MidiSeqUserBuff[MIDI_SEQ_USER_SIZE] = { 0U };
+uint32_t u32MidiSeqUserLen = 0U;
+bool bMidiSeqUserReady = false;
+
+/* Sequencer request from other tasks, handled in midi task */
+volatile bool bMidiSeqReqPlay = false;
+volatile bool bMidiSeqReqLoop = false;
+volatile midi_task_seq_src_t eMidiSeqReqSrc = MIDI_TASK_SEQ_FLASH;
+
+/* Parameter driven by each CC, AUDIO_PARAM_NUM if not mapped */
+uint8_t MidiCcMap[MIDI_CC_NUM] = { 0U };
+
+/* Default controller assignment */
+static const struct {
+    uint8_t u8Cc;
+    audio_param_id_t eParam;
+} MidiCcDefault[] = {
+    { 74U, AUDIO_PARAM_FILTER_FREQ },   /* Brightness */
+    { 71U, AUDIO_PARAM_FILTER_Q },      /* Resonance */
+    { 12U, AUDIO_PARAM_DELAY_TIME },    /* Effect control 1 */
+    { 13U, AUDIO_PARAM_DELAY_FB },      /* Effect control 2 */
+    { 94U, AUDIO_PARAM_DETUNE },        /* Detune depth */
+    { 73U, AUDIO_PARAM_ATTACK },        /* Attack time */
+    { 75U, AUDIO_PARAM_DECAY },         /* Decay time */
+    { 79U, AUDIO_PARAM_SUSTAIN },       /* Sound controller 10 */
+    { 72U, AUDIO_PARAM_RELEASE },       /* Release time */
+    { 70U, AUDIO_PARAM_MORPH },         /* Sound variation */
+    { 1U,  AUDIO_PARAM_MOD_WHEEL },     /* Modulation wheel, vibrato depth */
+};
+
+/* Midi out, written only from midi task */
+midi_out_t MidiOut;
+uint8_t MidiOutBuff[MIDI_OUT_BUFF_SIZE] = { 0U };
+
+/* Midi out config from other tasks, applied in midi task */
+volatile uint32_t u32MidiOutSrcMask = MIDI_TASK_OUT_THRU | MIDI_TASK_OUT_SEQ;
+volatile bool bMidiOutReqRunning = true;
+
+/* Channels with notes sent by sequencer, bit n for channel n */
+uint32_t u32MidiOutSeqChMask = 0U;
+
+/* Notes and pedals held by sequencer, released on stop */
+uint32_t pu32MidiSeqNotes[MIDI_CHANNEL_MAX_VALUE + 1U][MIDI_SEQ_NOTE_WORDS] = { 0U };
+bool bMidiSeqSustain = false;
+bool bMidiSeqSostenuto = false;
+
+/* Registered parameter selected for data entry */
+uint8_t u8MidiRpnMsb = MIDI_RPN_NULL;
+uint8_t u8MidiRpnLsb = MIDI_RPN_NULL;
+
+/* Pitch bend range set over RPN 0 */
+uint8_t u8MidiBendSemi = 2U;
+uint8_t u8MidiBendCent = 0U;
+
 /* Private function prototypes -----------------------------------------------*/
 
 static void midi_cmd_1_cb(uint8_t cmd, uint8_t data);
 static void midi_cmd_2_cb(uint8_t cmd, uint8_t data0, uint8_t data1);
+static void midi_in_cmd_1_cb(uint8_t cmd, uint8_t data);
+static void midi_in_cmd_2_cb(uint8_t cmd, uint8_t data0, uint8_t data1);
 static void midi_rt_cb(uint8_t rt_data);
+static void midi_cc_cb(uint8_t u8Cc, uint8_t u8Value);
+static void midi_sysex_cb(uint8_t *pdata, uint32_t len_data);
+static void midi_sysex_tuning(const uint8_t *pdata, uint32_t len_data);
+static void midi_mts_note_cb(uint8_t u8Note, float fPitch, void *pvArg);
+static void midi_sysex_wave(uint8_t u8Cmd, const uint8_t *pu8Payload, uint32_t u32Len);
+static void midi_sysex_seq(uint8_t u8Cmd, const uint8_t *pu8Payload, uint32_t u32Len);
+static void midi_seq_play(midi_task_seq_src_t eSrc, bool bLoop);
+static void midi_seq_stop(void);
+static void midi_seq_track(const uint8_t *pu8Msg);
+static void midi_seq_release(void);
+static void midi_seq_event_cb(const midi_smf_event_t *pxEvent, void *pvArg);
+static void midi_seq_block_cb(uint32_t u32SampleClock, void *pvArg);
 static void midi_serial_cb(sys_usart_event_t event);
+static bool midi_out_send(const uint8_t *pu8Data, uint32_t u32Len);
+static void midi_out_forward(uint32_t u32Src, const uint8_t *pu8Msg, uint32_t u32Len);
+static void midi_out_seq_notes_off(void);
+static void midi_rx_process(void);
 static void midi_voice_cb(uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity, midi_voice_state_t eAction);
+static void midi_voice_release_cb(uint32_t u32VoiceMask);
+static void midi_voice_expr_cb(uint8_t u8Voice, midi_voice_expr_t eExpr, uint16_t u16Value);
 static void MidiTask_main(void *argument);
 
 /* Private function definition -----------------------------------------------*/
@@ -99,10 +221,11 @@ static void MidiTask_main(void *argument);
  */
 static void midi_cmd_1_cb(uint8_t cmd, uint8_t data)
 {
-    (void)cmd;
-    (void)data;
-
     static uint32_t u32Cmd1Cnt = 0U;
+
+    /* Channel pressure of MPE member channels, ignored on other channels */
+    (void)VOICE_update_expression(&MidiVoiceEngine, cmd, data, 0U);
+
     u32Cmd1Cnt++;
 }
 
@@ -132,10 +255,129 @@ static void midi_cmd_2_cb(uint8_t cmd, uint8_t data0, uint8_t data1)
     {
         (void)VOICE_update_note(&MidiVoiceEngine, cmd, data0, data1);
     }
+    else if ( VOICE_update_expression(&MidiVoiceEngine, cmd, data0, data1) == midiOk )
+    {
+        /* Bend and timbre of MPE member channel, routed to its voices */
+    }
+    else if ( MIDI_CMD_GET_CH(cmd) != MidiVoiceEngine.u8MidiCh )
+    {
+        /* Controllers only on voice channel */
+    }
+    else if ( u8Status == MIDI_STATUS_CC )
+    {
+        midi_cc_cb(data0, data1);
+    }
+    else if ( u8Status == MIDI_STATUS_PITCH_BEND )
+    {
+        uint32_t u32Bend = ((uint32_t)data1 << 7U) | (uint32_t)data0;
+
+        /* Center maps to 0.5 exactly, engine applies one multiplier to all voices per block */
+        (void)AUDIO_set_param(AudioTask_get_engine(), AUDIO_PARAM_PITCH_BEND, (float)u32Bend / (float)MIDI_PITCH_BEND_SPAN);
+    }
 
     u32Cmd2Cnt++;
 }
 
+/**
+ * @brief Handler for one data byte commands from midi input, forwarded to
+ *        midi out before local handling.
+ * 
+ * @param cmd midi command.
+ * @param data midi data.
+ */
+static void midi_in_cmd_1_cb(uint8_t cmd, uint8_t data)
+{
+    uint8_t pu8Msg[2U] = { cmd, data };
+
+    midi_out_forward(MIDI_TASK_OUT_THRU, pu8Msg, sizeof(pu8Msg));
+    midi_cmd_1_cb(cmd, data);
+}
+
+/**
+ * @brief Handler for two data bytes commands from midi input, forwarded to
+ *        midi out before local handling.
+ * 
+ * @param cmd midi command.
+ * @param data0 midi data0
+ * @param data1 midi data1
+ */
+static void midi_in_cmd_2_cb(uint8_t cmd, uint8_t data0, uint8_t data1)
+{
+    uint8_t pu8Msg[3U] = { cmd, data0, data1 };
+
+    midi_out_forward(MIDI_TASK_OUT_THRU, pu8Msg, sizeof(pu8Msg));
+    midi_cmd_2_cb(cmd, data0, data1);
+}
+
+/**
+ * @brief Handler for control change on voice channel.
+ * 
+ * @param u8Cc controller number.
+ * @param u8Value controller value.
+ */
+static void midi_cc_cb(uint8_t u8Cc, uint8_t u8Value)
+{
+    bool bBendRpn = (u8MidiRpnMsb == 0U) && (u8MidiRpnLsb == MIDI_RPN_BEND_RANGE);
+    bool bMpeRpn = (u8MidiRpnMsb == 0U) && (u8MidiRpnLsb == MIDI_RPN_MPE_CONFIG);
+
+    switch ( u8Cc )
+    {
+        case MIDI_CC_RPN_MSB:
+            u8MidiRpnMsb = u8Value;
+            break;
+
+        case MIDI_CC_RPN_LSB:
+            u8MidiRpnLsb = u8Value;
+            break;
+
+        case MIDI_CC_NRPN_MSB:
+        case MIDI_CC_NRPN_LSB:
+            /* Data entry goes to NRPN, not supported */
+            u8MidiRpnMsb = MIDI_RPN_NULL;
+            u8MidiRpnLsb = MIDI_RPN_NULL;
+            break;
+
+        case MIDI_CC_SUSTAIN:
+            (void)VOICE_set_sustain(&MidiVoiceEngine, u8Value >= MIDI_CC_PEDAL_ON);
+            break;
+
+        case MIDI_CC_SOSTENUTO:
+            (void)VOICE_set_sostenuto(&MidiVoiceEngine, u8Value >= MIDI_CC_PEDAL_ON);
+            break;
+
+        case MIDI_CC_DATA_MSB:
+        case MIDI_CC_DATA_LSB:
+            if ( bBendRpn )
+            {
+                if ( u8Cc == MIDI_CC_DATA_MSB )
+                {
+                    u8MidiBendSemi = u8Value;
+                    u8MidiBendCent = 0U;
+                }
+                else
+                {
+                    u8MidiBendCent = u8Value;
+                }
+
+                (void)AUDIO_set_bend_range(AudioTask_get_engine(), (float)u8MidiBendSemi + ((float)u8MidiBendCent / 100.0F));
+            }
+            else if ( bMpeRpn && (u8Cc == MIDI_CC_DATA_MSB) )
+            {
+                /* MPE configuration, voice channel is zone master, only channel 0 or 15 accepted */
+                (void)VOICE_set_mpe_zone(&MidiVoiceEngine, MidiVoiceEngine.u8MidiCh, u8Value);
+            }
+            break;
+
+        default:
+            if ( (u8Cc < MIDI_CC_NUM) && (MidiCcMap[u8Cc] < (uint8_t)AUDIO_PARAM_NUM) )
+            {
+                /* Only target is stored, engine glides to it once per block */
+                (void)AUDIO_set_param(AudioTask_get_engine(), (audio_param_id_t)MidiCcMap[u8Cc], (float)u8Value / MIDI_CC_VALUE_MAX);
+            }
+            break;
+    }
+}
+
 /**
  * @brief Handler for midi RT commands
  * 
@@ -143,7 +385,434 @@ static void midi_cmd_2_cb(uint8_t cmd, uint8_t data0, uint8_t data1)
  */
 static void midi_rt_cb(uint8_t rt_data)
 {
-    (void)rt_data;
+    midi_out_forward(MIDI_TASK_OUT_THRU, &rt_data, 1U);
+}
+
+/**
+ * @brief Handler for midi sys ex messages.
+ * 
+ * @param pdata sys ex data, without start and end bytes.
+ * @param len_data number of data bytes.
+ */
+static void midi_sysex_cb(uint8_t *pdata, uint32_t len_data)
+{
+    midi_sysex_msg_t xMsg = { 0U };
+    midiStatus_t eStatus = midiBadParam;
+
+    if ( (u32MidiOutSrcMask & MIDI_TASK_OUT_THRU) != 0U )
+    {
+        (void)MIDI_OUT_send_sysex(&MidiOut, pdata, len_data);
+    }
+
+    if ( (len_data > 0U) && ((pdata[0U] == MTS_UNIVERSAL_NON_RT) || (pdata[0U] == MTS_UNIVERSAL_RT)) )
+    {
+        midi_sysex_tuning(pdata, len_data);
+    }
+    else
+    {
+        eStatus = SYSEX_parse(pdata, len_data, MIDI_SYSEX_DEV_ID, &xMsg);
+    }
+
+    if ( eStatus == midiOk )
+    {
+        switch ( xMsg.u8Cmd )
+        {
+            case SYSEX_CMD_WAVE_BEGIN:
+            case SYSEX_CMD_WAVE_DATA:
+            case SYSEX_CMD_WAVE_END:
+                midi_sysex_wave(xMsg.u8Cmd, xMsg.pu8Payload, xMsg.u32PayloadLen);
+                break;
+
+            case SYSEX_CMD_SEQ_BEGIN:
+            case SYSEX_CMD_SEQ_DATA:
+            case SYSEX_CMD_SEQ_END:
+            case SYSEX_CMD_SEQ_PLAY:
+            case SYSEX_CMD_SEQ_STOP:
+                midi_sysex_seq(xMsg.u8Cmd, xMsg.pu8Payload, xMsg.u32PayloadLen);
+                break;
+
+            default:
+                break;
+        }
+    }
+    else if ( eStatus == midiError )
+    {
+        sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "SysEx checksum error");
+    }
+}
+
+/**
+ * @brief Handle MIDI Tuning Standard messages. Tuning table is only read on
+ *        note on, sounding notes keep their pitch until retriggered.
+ * 
+ * @param pdata universal sys ex data.
+ * @param len_data number of data bytes.
+ */
+static void midi_sysex_tuning(const uint8_t *pdata, uint32_t len_data)
+{
+    midiStatus_t eStatus = MTS_parse(pdata, len_data, MIDI_SYSEX_DEV_ID, MidiVoiceEngine.u8MidiCh, midi_mts_note_cb, AudioTask_get_engine());
+
+    if ( eStatus == midiOk )
+    {
+        sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "SysEx tuning %02X updated", pdata[3U]);
+    }
+    else if ( eStatus == midiError )
+    {
+        sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "SysEx tuning malformed");
+    }
+}
+
+/**
+ * @brief Store note decoded from tuning message in engine tuning table.
+ * 
+ * @param u8Note midi note.
+ * @param fPitch pitch in equal tempered semitones.
+ * @param pvArg audio engine.
+ */
+static void midi_mts_note_cb(uint8_t u8Note, float fPitch, void *pvArg)
+{
+    (void)AUDIO_set_note_tuning((audio_engine_t *)pvArg, u8Note, fPitch);
+}
+
+/**
+ * @brief Handle user wave upload commands. Chunks are unpacked in staging
+ *        buffer, audio engine is only touched once the whole frame arrived.
+ * 
+ * @param u8Cmd wave upload command.
+ * @param pu8Payload command payload.
+ * @param u32Len payload length.
+ */
+static void midi_sysex_wave(uint8_t u8Cmd, const uint8_t *pu8Payload, uint32_t u32Len)
+{
+    uint8_t u8Slot = ( u32Len > 0U ) ? pu8Payload[0U] : MIDI_WAVE_SLOT_NONE;
+
+    if ( u8Slot >= (uint8_t)AUDIO_WAVE_USER_NUM )
+    {
+        sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "SysEx wave bad slot");
+    }
+    else if ( u8Cmd == SYSEX_CMD_WAVE_BEGIN )
+    {
+        u8MidiWaveSlot = u8Slot;
+        u32MidiWaveChunkMask = 0U;
+    }
+    else if ( u8Slot != u8MidiWaveSlot )
+    {
+        sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "SysEx wave slot not open");
+    }
+    else if ( u8Cmd == SYSEX_CMD_WAVE_DATA )
+    {
+        uint8_t pu8Raw[SYSEX_WAVE_CHUNK_BYTES];
+        uint8_t u8Chunk = ( u32Len > 1U ) ? pu8Payload[1U] : MIDI_WAVE_CHUNK_NUM;
+        uint32_t u32RawLen = 0U;
+
+        if ( (u8Chunk < MIDI_WAVE_CHUNK_NUM) && (u32Len == (2U + SYSEX_PACKED_SIZE(SYSEX_WAVE_CHUNK_BYTES))) )
+        {
+            u32RawLen = SYSEX_unpack(&pu8Payload[2U], u32Len - 2U, pu8Raw, SYSEX_WAVE_CHUNK_BYTES);
+        }
+
+        if ( u32RawLen == SYSEX_WAVE_CHUNK_BYTES )
+        {
+            int16_t *pi16Dst = &MidiWaveStage[u8Chunk * SYSEX_WAVE_CHUNK_SAMPLES];
+
+            for ( uint32_t i = 0U; i < SYSEX_WAVE_CHUNK_SAMPLES; i++ )
+            {
+                pi16Dst[i] = (int16_t)((uint16_t)pu8Raw[2U * i] | ((uint16_t)pu8Raw[(2U * i) + 1U] << 8U));
+            }
+
+            u32MidiWaveChunkMask |= (1U << u8Chunk);
+        }
+        else
+        {
+            sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "SysEx wave bad chunk");
+        }
+    }
+    else
+    {
+        if ( u32MidiWaveChunkMask == MIDI_WAVE_CHUNK_ALL )
+        {
+            audio_cmd_t xAudioCmd = { 0U };
+            xAudioCmd.eCmdId = AUDIO_CMD_LOAD_USER_WAVE;
+            xAudioCmd.xCmdPayload.xLoadUserWave.eWaveId = (audio_wave_id_t)(AUDIO_WAVE_USER_0 + u8Slot);
+            xAudioCmd.xCmdPayload.xLoadUserWave.pi16Data = MidiWaveStage;
+
+            if ( AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd) == AUDIO_OK )
+            {
+                sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "SysEx wave %d loaded", u8Slot);
+            }
+        }
+        else
+        {
+            sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "SysEx wave incomplete %02X", (unsigned int)u32MidiWaveChunkMask);
+        }
+
+        u8MidiWaveSlot = MIDI_WAVE_SLOT_NONE;
+        u32MidiWaveChunkMask = 0U;
+    }
+}
+
+/**
+ * @brief Handle sequencer commands. File chunks must arrive in order, offset
+ *        of each chunk is checked against data already received.
+ * 
+ * @param u8Cmd sequencer command.
+ * @param pu8Payload command payload.
+ * @param u32Len payload length.
+ */
+static void midi_sysex_seq(uint8_t u8Cmd, const uint8_t *pu8Payload, uint32_t u32Len)
+{
+    switch ( u8Cmd )
+    {
+        case SYSEX_CMD_SEQ_BEGIN:
+            {
+                /* Any playback ends through task stop path, user buffer is going to be overwritten */
+                midi_seq_stop();
+
+                SEQ_unload(&MidiSeq);
+
+                u32MidiSeqUserLen = 0U;
+                bMidiSeqUserReady = false;
+            }
+            break;
+
+        case SYSEX_CMD_SEQ_DATA:
+            {
+                uint32_t u32Offset = ( u32Len > 2U ) ? ((uint32_t)pu8Payload[0U] | ((uint32_t)pu8Payload[1U] << 7U)) : SYSEX_SEQ_OFFSET_MAX;
+                uint32_t u32RawLen = 0U;
+
+                if ( (u32Offset == u32MidiSeqUserLen) && (u32Len <= (2U + SYSEX_PACKED_SIZE(SYSEX_SEQ_CHUNK_BYTES))) )
+                {
+                    u32RawLen = SYSEX_unpack(&pu8Payload[2U], u32Len - 2U, &MidiSeqUserBuff[u32Offset], MIDI_SEQ_USER_SIZE - u32Offset);
+                }
+
+                if ( u32RawLen != 0U )
+                {
+                    u32MidiSeqUserLen += u32RawLen;
+                }
+                else
+                {
+                    sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "SysEx seq bad chunk at %d", (int)u32Offset);
+                }
+            }
+            break;
+
+        case SYSEX_CMD_SEQ_END:
+            {
+                /* Load stops sequencer, release notes and send stop first */
+                midi_seq_stop();
+
+                bMidiSeqUserReady = ( SEQ_load(&MidiSeq, MidiSeqUserBuff, u32MidiSeqUserLen) == midiOk );
+
+                if ( bMidiSeqUserReady )
+                {
+                    eMidiSeqSrc = MIDI_TASK_SEQ_USER;
+                    sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "SysEx seq loaded %d bytes", (int)u32MidiSeqUserLen);
+                }
+                else
+                {
+                    sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "SysEx seq invalid file");
+                }
+            }
+            break;
+
+        case SYSEX_CMD_SEQ_PLAY:
+            {
+                midi_task_seq_src_t eSrc = ( (u32Len > 0U) && (pu8Payload[0U] == SYSEX_SEQ_SRC_USER) ) ? MIDI_TASK_SEQ_USER : MIDI_TASK_SEQ_FLASH;
+                bool bLoop = ( u32Len > 1U ) && ( pu8Payload[1U] != 0U );
+
+                midi_seq_play(eSrc, bLoop);
+            }
+            break;
+
+        case SYSEX_CMD_SEQ_STOP:
+            midi_seq_stop();
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* Sequencer -----------------------------------------------------------------*/
+
+/**
+ * @brief Load selected file and start playback on next audio block.
+ * 
+ * @param eSrc file source.
+ * @param bLoop restart file once finished.
+ */
+static void midi_seq_play(midi_task_seq_src_t eSrc, bool bLoop)
+{
+    midiStatus_t eStatus = midiError;
+
+    midi_seq_stop();
+
+    if ( eSrc == MIDI_TASK_SEQ_FLASH )
+    {
+        eStatus = SEQ_load(&MidiSeq, MidiSongFlash, u32MidiSongFlashLen);
+    }
+    else if ( bMidiSeqUserReady )
+    {
+        eStatus = SEQ_load(&MidiSeq, MidiSeqUserBuff, u32MidiSeqUserLen);
+    }
+
+    eMidiSeqSrc = eSrc;
+
+    if ( eStatus == midiOk )
+    {
+        SEQ_set_loop(&MidiSeq, bLoop);
+        eStatus = SEQ_start(&MidiSeq, AUDIO_get_sample_clock(AudioTask_get_engine()));
+    }
+
+    if ( eStatus == midiOk )
+    {
+        uint8_t u8Rt = MIDI_RT_START;
+
+        midi_out_forward(MIDI_TASK_OUT_SEQ, &u8Rt, 1U);
+    }
+
+    if ( eStatus != midiOk )
+    {
+        sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "Seq no valid file");
+    }
+}
+
+/**
+ * @brief Stop playback and release notes left active by sequencer.
+ */
+static void midi_seq_stop(void)
+{
+    /* Nothing played by sequencer when idle, live notes are never touched */
+    if ( SEQ_get_state(&MidiSeq) != SEQ_STATE_IDLE )
+    {
+        uint8_t u8Rt = MIDI_RT_STOP;
+
+        SEQ_stop(&MidiSeq);
+
+        midi_out_forward(MIDI_TASK_OUT_SEQ, &u8Rt, 1U);
+        midi_out_seq_notes_off();
+        midi_seq_release();
+    }
+}
+
+/**
+ * @brief Keep track of notes and pedals held by sequencer.
+ * 
+ * @param pu8Msg channel message sent by sequencer.
+ */
+static void midi_seq_track(const uint8_t *pu8Msg)
+{
+    uint8_t u8Status = MIDI_CMD_GET_STATUS(pu8Msg[0U]);
+    uint32_t *pu32Notes = pu32MidiSeqNotes[MIDI_CMD_GET_CH(pu8Msg[0U])];
+    uint32_t u32Bit = 1UL << (pu8Msg[1U] & 0x1FU);
+
+    if ( (u8Status == MIDI_STATUS_NOTE_ON) && (pu8Msg[2U] != 0U) )
+    {
+        pu32Notes[pu8Msg[1U] >> 5U] |= u32Bit;
+    }
+    else if ( (u8Status == MIDI_STATUS_NOTE_ON) || (u8Status == MIDI_STATUS_NOTE_OFF) )
+    {
+        pu32Notes[pu8Msg[1U] >> 5U] &= ~u32Bit;
+    }
+    else if ( (u8Status == MIDI_STATUS_CC) && (MIDI_CMD_GET_CH(pu8Msg[0U]) == MidiVoiceEngine.u8MidiCh) )
+    {
+        if ( pu8Msg[1U] == MIDI_CC_SUSTAIN )
+        {
+            bMidiSeqSustain = ( pu8Msg[2U] >= MIDI_CC_PEDAL_ON );
+        }
+        else if ( pu8Msg[1U] == MIDI_CC_SOSTENUTO )
+        {
+            bMidiSeqSostenuto = ( pu8Msg[2U] >= MIDI_CC_PEDAL_ON );
+        }
+    }
+}
+
+/**
+ * @brief Release notes and pedals held by sequencer, notes played live keep
+ *        sounding.
+ */
+static void midi_seq_release(void)
+{
+    for ( uint8_t u8Ch = 0U; u8Ch <= MIDI_CHANNEL_MAX_VALUE; u8Ch++ )
+    {
+        for ( uint8_t u8Note = 0U; u8Note < 128U; u8Note++ )
+        {
+            if ( (pu32MidiSeqNotes[u8Ch][u8Note >> 5U] & (1UL << (u8Note & 0x1FU))) != 0U )
+            {
+                (void)VOICE_update_note(&MidiVoiceEngine, (uint8_t)(MIDI_STATUS_NOTE_OFF | u8Ch), u8Note, 0U);
+            }
+        }
+
+        for ( uint32_t i = 0U; i < MIDI_SEQ_NOTE_WORDS; i++ )
+        {
+            pu32MidiSeqNotes[u8Ch][i] = 0U;
+        }
+    }
+
+    if ( bMidiSeqSustain )
+    {
+        (void)VOICE_set_sustain(&MidiVoiceEngine, false);
+        bMidiSeqSustain = false;
+    }
+
+    if ( bMidiSeqSostenuto )
+    {
+        (void)VOICE_set_sostenuto(&MidiVoiceEngine, false);
+        bMidiSeqSostenuto = false;
+    }
+}
+
+/**
+ * @brief Handler for sequencer events, channel messages follow the same path
+ *        as data received on midi input.
+ * 
+ * @param pxEvent due file event.
+ * @param pvArg not used.
+ */
+static void midi_seq_event_cb(const midi_smf_event_t *pxEvent, void *pvArg)
+{
+    (void)pvArg;
+
+    if ( pxEvent->eType == SMF_EVT_MIDI )
+    {
+        if ( MIDI_CMD_GET_STATUS(pxEvent->pu8Msg[0U]) == MIDI_STATUS_NOTE_ON )
+        {
+            u32MidiOutSeqChMask |= (1UL << MIDI_CMD_GET_CH(pxEvent->pu8Msg[0U]));
+        }
+
+        if ( pxEvent->u8MsgLen == 3U )
+        {
+            midi_seq_track(pxEvent->pu8Msg);
+        }
+
+        midi_out_forward(MIDI_TASK_OUT_SEQ, pxEvent->pu8Msg, pxEvent->u8MsgLen);
+
+        if ( pxEvent->u8MsgLen == 3U )
+        {
+            midi_cmd_2_cb(pxEvent->pu8Msg[0U], pxEvent->pu8Msg[1U], pxEvent->pu8Msg[2U]);
+        }
+        else if ( pxEvent->u8MsgLen == 2U )
+        {
+            midi_cmd_1_cb(pxEvent->pu8Msg[0U], pxEvent->pu8Msg[1U]);
+        }
+    }
+}
+
+/**
+ * @brief Audio block callback, run in audio ISR. Wakes midi task while
+ *        sequencer is playing, events are scheduled on the sample clock.
+ * 
+ * @param u32SampleClock samples rendered by engine.
+ * @param pvArg not used.
+ */
+static void midi_seq_block_cb(uint32_t u32SampleClock, void *pvArg)
+{
+    (void)u32SampleClock;
+    (void)pvArg;
+
+    if ( SEQ_get_state(&MidiSeq) == SEQ_STATE_PLAY )
+    {
+        osEventFlagsSet(midi_evt_handler, MIDI_EVT_SEQ_TICK);
+    }
 }
 
 /* Callbacks for serial interface engine -------------------------------------*/
@@ -157,44 +826,22 @@ void midi_serial_cb(sys_usart_event_t event)
 {
     switch (event)
     {
-        case SYS_USART_EVENT_RX_IDLE:
+        case SYS_USART_EVENT_RX_DATA:
             {
-                /* Get all data from DMA buffer */
-                uint16_t u16RxCount = sys_usart_get_read_count(MIDI_USART);
-                for (uint16_t i = 0U; i < u16RxCount; i++)
-                {
-                    circular_buf_put2(&MidiCBuff, MidiRxDMABuff[i]);
-                }
-                /* Enable reception */
-                sys_usart_read(MIDI_USART, MidiRxDMABuff, MIDI_DMA_BUFF_RX_SIZE);
-                /* Set data available flag */
+                /* Data stays in DMA buffer, task reads it in place */
                 osEventFlagsSet(midi_evt_handler, MIDI_EVT_DATA_IN);
             }
             break;
 
         case SYS_USART_EVENT_TX_DONE:
-            break;
-
-        case SYS_USART_EVENT_RX_DONE:
-        case SYS_USART_EVENT_RX_BUFF_FULL:
             {
-                /* Get all data from DMA buffer */
-                for (uint16_t i = 0U; i < MIDI_DMA_BUFF_RX_SIZE; i++)
-                {
-                    circular_buf_put2(&MidiCBuff, MidiRxDMABuff[i]);
-                }
-                /* Enable reception */
-                sys_usart_read(MIDI_USART, MidiRxDMABuff, MIDI_DMA_BUFF_RX_SIZE);
-                /* Set data available flag */
-                osEventFlagsSet(midi_evt_handler, MIDI_EVT_DATA_IN);
+                /* Queue is only touched by task, next batch started there */
+                osEventFlagsSet(midi_evt_handler, MIDI_EVT_TX_DONE);
             }
             break;
 
         case SYS_USART_EVENT_ERROR:
-            {
-                /* Enable reception */
-                sys_usart_read(MIDI_USART, MidiRxDMABuff, MIDI_DMA_BUFF_RX_SIZE);
-            }
+            /* Reception restarted by driver */
             break;
 
         default:
@@ -202,6 +849,75 @@ void midi_serial_cb(sys_usart_event_t event)
     }
 }
 
+/**
+ * @brief Midi out transport, starts DMA transfer of queued bytes.
+ * 
+ * @param pu8Data first byte to send, kept in queue until transfer ends.
+ * @param u32Len number of bytes.
+ * @return true if transfer was started.
+ */
+static bool midi_out_send(const uint8_t *pu8Data, uint32_t u32Len)
+{
+    return ( sys_usart_send(MIDI_USART, (uint8_t *)pu8Data, (uint16_t)u32Len) == SYS_SUCCESS );
+}
+
+/**
+ * @brief Queue message on midi out if its source is enabled. Sent on next
+ *        flush of task loop.
+ * 
+ * @param u32Src message source, MIDI_TASK_OUT_THRU or MIDI_TASK_OUT_SEQ.
+ * @param pu8Msg message starting with status byte.
+ * @param u32Len message size.
+ */
+static void midi_out_forward(uint32_t u32Src, const uint8_t *pu8Msg, uint32_t u32Len)
+{
+    if ( (u32MidiOutSrcMask & u32Src) != 0U )
+    {
+        (void)MIDI_OUT_send_msg(&MidiOut, pu8Msg, u32Len);
+    }
+}
+
+/**
+ * @brief Send all notes off on channels played by sequencer, so external
+ *        gear is released as local voices are.
+ */
+static void midi_out_seq_notes_off(void)
+{
+    for ( uint8_t u8Ch = 0U; u8Ch <= MIDI_CHANNEL_MAX_VALUE; u8Ch++ )
+    {
+        if ( (u32MidiOutSeqChMask & (1UL << u8Ch)) != 0U )
+        {
+            uint8_t pu8Msg[3U] = { (uint8_t)(MIDI_STATUS_CC | u8Ch), MIDI_CC_NOTE_OFF, 0U };
+
+            midi_out_forward(MIDI_TASK_OUT_SEQ, pu8Msg, sizeof(pu8Msg));
+        }
+    }
+
+    u32MidiOutSeqChMask = 0U;
+}
+
+/**
+ * @brief Parse all pending bytes in place from DMA buffer.
+ */
+static void midi_rx_process(void)
+{
+    uint8_t *pu8Data = NULL;
+    uint16_t u16Len = 0U;
+
+    while ( (u16Len = sys_usart_rx_peek(MIDI_USART, &pu8Data)) != 0U )
+    {
+        for ( uint16_t i = 0U; i < u16Len; i++ )
+        {
+            if ( midi_update_fsm(&MidiEngine, pu8Data[i]) != midiOk )
+            {
+                sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "ERROR processing midi FSM");
+            }
+        }
+
+        sys_usart_rx_consume(MIDI_USART, u16Len);
+    }
+}
+
 /**
  * @brief Callback to handle midi voice actions.
  * 
@@ -221,14 +937,60 @@ void midi_voice_cb(uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity, midi_voi
         xAudioCmd.xCmdPayload.xSetMidiNote.u8Note = u8Note;
         xAudioCmd.xCmdPayload.xSetMidiNote.u8Velocity = u8Velocity;
         xAudioCmd.xCmdPayload.xSetMidiNote.bActive = true;
-        (void)AUDIO_handle_cmd(xAudioCmd);
+        (void)AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd);
     }
     else if ( eAction == VOICE_STATE_OFF )
     {
         xAudioCmd.eCmdId = AUDIO_CMD_ACTIVATE_VOICE;
         xAudioCmd.xCmdPayload.xActVoice.eVoiceId = (audio_voice_id_t)u8Voice;
         xAudioCmd.xCmdPayload.xActVoice.bState = false;
-        (void)AUDIO_handle_cmd(xAudioCmd);
+        (void)AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd);
+    }
+}
+
+/**
+ * @brief Callback to release voices held by pedals, one engine command for
+ *        all of them.
+ * 
+ * @param u32VoiceMask bit n set for voice n.
+ */
+static void midi_voice_release_cb(uint32_t u32VoiceMask)
+{
+    audio_cmd_t xAudioCmd = { 0U };
+
+    xAudioCmd.eCmdId = AUDIO_CMD_RELEASE_VOICES;
+    xAudioCmd.xCmdPayload.xReleaseVoices.u32VoiceMask = u32VoiceMask;
+    (void)AUDIO_handle_cmd(AudioTask_get_engine(), xAudioCmd);
+}
+
+/**
+ * @brief Callback to route MPE per note expression to one engine voice.
+ * 
+ * @param u8Voice voice to update.
+ * @param eExpr expression id.
+ * @param u16Value raw midi value.
+ */
+static void midi_voice_expr_cb(uint8_t u8Voice, midi_voice_expr_t eExpr, uint16_t u16Value)
+{
+    audio_engine_t *pxEngine = AudioTask_get_engine();
+
+    if ( eExpr == VOICE_EXPR_RESET )
+    {
+        AUDIO_reset_voice_expr(pxEngine, (audio_voice_id_t)u8Voice);
+    }
+    else if ( eExpr == VOICE_EXPR_BEND )
+    {
+        float fBend = ((float)u16Value - (float)MIDI_PITCH_BEND_CENTER) / (float)MIDI_PITCH_BEND_CENTER;
+
+        (void)AUDIO_set_voice_expr(pxEngine, (audio_voice_id_t)u8Voice, AUDIO_EXPR_BEND, fBend);
+    }
+    else if ( eExpr == VOICE_EXPR_PRESSURE )
+    {
+        (void)AUDIO_set_voice_expr(pxEngine, (audio_voice_id_t)u8Voice, AUDIO_EXPR_PRESSURE, (float)u16Value / MIDI_CC_VALUE_MAX);
+    }
+    else if ( eExpr == VOICE_EXPR_TIMBRE )
+    {
+        (void)AUDIO_set_voice_expr(pxEngine, (audio_voice_id_t)u8Voice, AUDIO_EXPR_TIMBRE, (float)u16Value / MIDI_TIMBRE_SPAN);
     }
 }
 
@@ -245,27 +1007,61 @@ static void MidiTask_main(void *argument)
 
     sys_gpio_set_level(MIDI_STATUS_LED, SYS_GPIO_STATE_SET);
 
-    /* Enable reception */
-    sys_usart_read(MIDI_USART, MidiRxDMABuff, MIDI_DMA_BUFF_RX_SIZE);
+    /* Enable endless reception */
+    ERR_ASSERT(sys_usart_read_circular(MIDI_USART, MidiRxDMABuff, MIDI_DMA_BUFF_RX_SIZE) == SYS_SUCCESS);
+
+    /* Sequencer tick source */
+    AUDIO_set_block_cb(AudioTask_get_engine(), midi_seq_block_cb, NULL);
 
     /* Infinite loop */
     for(;;)
     {
-        uint32_t u32Flags = osEventFlagsWait(midi_evt_handler, MIDI_EVT_DATA_IN, osFlagsWaitAny, osWaitForever);
+        uint32_t u32Flags = osEventFlagsWait(midi_evt_handler, MIDI_EVT_ALL, osFlagsWaitAny, osWaitForever);
 
-        if ( SYS_CHECK_EVT(u32Flags, MIDI_EVT_DATA_IN) )
+        if ( SYS_CHECK_EVT(u32Flags, MIDI_EVT_SEQ_CTRL) )
         {
-            /* Clear rx buffer */
-            uint8_t u8RxData = 0U;
+            if ( bMidiSeqReqPlay )
+            {
+                midi_seq_play(eMidiSeqReqSrc, bMidiSeqReqLoop);
+            }
+            else
+            {
+                midi_seq_stop();
+            }
+        }
 
-            while ( circular_buf_get(&MidiCBuff, &u8RxData) == 0U )
+        if ( SYS_CHECK_EVT(u32Flags, MIDI_EVT_SEQ_TICK) )
+        {
+            if ( SEQ_update(&MidiSeq, AUDIO_get_sample_clock(AudioTask_get_engine())) != midiOk )
             {
-                if ( midi_update_fsm(&MidiEngine, u8RxData) != midiOk )
-                {
-                    sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "ERROR processing midi FSM");
-                }
+                sys_log_print(MIDI_DBG_IF, MIDI_DBG_LVL, "Seq malformed track");
+            }
+
+            if ( SEQ_get_state(&MidiSeq) == SEQ_STATE_END )
+            {
+                midi_seq_stop();
             }
         }
+
+        if ( SYS_CHECK_EVT(u32Flags, MIDI_EVT_DATA_IN) )
+        {
+            midi_rx_process();
+        }
+
+        if ( SYS_CHECK_EVT(u32Flags, MIDI_EVT_OUT_CTRL) )
+        {
+            MIDI_OUT_set_running_status(&MidiOut, bMidiOutReqRunning);
+        }
+
+        /* Messages queued in this pass leave in one transfer */
+        if ( SYS_CHECK_EVT(u32Flags, MIDI_EVT_TX_DONE) )
+        {
+            MIDI_OUT_tx_done(&MidiOut);
+        }
+        else
+        {
+            MIDI_OUT_flush(&MidiOut);
+        }
     }
 }
 
@@ -288,12 +1084,85 @@ void MidiTask_Init(void)
 
     ERR_ASSERT(sys_gpio_init(MIDI_STATUS_LED, SYS_GPIO_MODE_OUT) == SYS_SUCCESS);
 
-    ERR_ASSERT(midi_init(&MidiEngine, NULL, 0U, NULL, midi_cmd_1_cb, midi_cmd_2_cb, midi_rt_cb) == midiOk);
+    ERR_ASSERT(midi_init(&MidiEngine, MidiSysExBuff, MIDI_SYSEX_BUFF_SIZE, midi_sysex_cb, midi_in_cmd_1_cb, midi_in_cmd_2_cb, midi_rt_cb) == midiOk);
+
+    ERR_ASSERT(AUDIO_WAVE_get_frame_size() == MIDI_WAVE_FRAME_SIZE);
 
     ERR_ASSERT(VOICE_init(&MidiVoiceEngine, MidiVoiceList, MIDI_NUM_VOICE, MIDI_CH_DEFAULT, midi_voice_cb) == midiOk);
+    ERR_ASSERT(VOICE_set_release_cb(&MidiVoiceEngine, midi_voice_release_cb) == midiOk);
+    ERR_ASSERT(VOICE_set_expr_cb(&MidiVoiceEngine, midi_voice_expr_cb) == midiOk);
+
+    ERR_ASSERT(MIDI_OUT_init(&MidiOut, MidiOutBuff, MIDI_OUT_BUFF_SIZE, midi_out_send) == midiOk);
+
+    ERR_ASSERT(SEQ_init(&MidiSeq, AUDIO_ENGINE_SAMPLE_RATE, midi_seq_event_cb, NULL) == midiOk);
+
+    for (uint32_t u32Cc = 0U; u32Cc < MIDI_CC_NUM; u32Cc++)
+    {
+        MidiCcMap[u32Cc] = (uint8_t)AUDIO_PARAM_NUM;
+    }
+
+    for (uint32_t i = 0U; i < (sizeof(MidiCcDefault) / sizeof(MidiCcDefault[0])); i++)
+    {
+        MidiCcMap[MidiCcDefault[i].u8Cc] = (uint8_t)MidiCcDefault[i].eParam;
+    }
+}
+
+bool MidiTask_seq_play(midi_task_seq_src_t eSrc, bool bLoop)
+{
+    eMidiSeqReqSrc = eSrc;
+    bMidiSeqReqLoop = bLoop;
+    bMidiSeqReqPlay = true;
 
-    /* Init rx buffer */
-    circular_buf_init(&MidiCBuff, MidiRxCBuff, MIDI_CBUFF_RX_SIZE);
+    return ( (osEventFlagsSet(midi_evt_handler, MIDI_EVT_SEQ_CTRL) & osFlagsError) == 0U );
+}
+
+bool MidiTask_seq_stop(void)
+{
+    bMidiSeqReqPlay = false;
+
+    return ( (osEventFlagsSet(midi_evt_handler, MIDI_EVT_SEQ_CTRL) & osFlagsError) == 0U );
+}
+
+midi_seq_state_t MidiTask_seq_get_state(void)
+{
+    return SEQ_get_state(&MidiSeq);
+}
+
+bool MidiTask_cc_map_set(uint8_t u8Cc, audio_param_id_t eParam)
+{
+    bool bRetval = false;
+
+    if ( (u8Cc < MIDI_CC_NUM) && (eParam <= AUDIO_PARAM_NUM) )
+    {
+        /* Single byte store, safe against midi task reading it */
+        MidiCcMap[u8Cc] = (uint8_t)eParam;
+        bRetval = true;
+    }
+
+    return bRetval;
+}
+
+audio_param_id_t MidiTask_cc_map_get(uint8_t u8Cc)
+{
+    return ( u8Cc < MIDI_CC_NUM ) ? (audio_param_id_t)MidiCcMap[u8Cc] : AUDIO_PARAM_NUM;
+}
+
+bool MidiTask_out_config(uint32_t u32SrcMask, bool bRunningStatus)
+{
+    u32MidiOutSrcMask = u32SrcMask & MIDI_TASK_OUT_ALL;
+    bMidiOutReqRunning = bRunningStatus;
+
+    return ( (osEventFlagsSet(midi_evt_handler, MIDI_EVT_OUT_CTRL) & osFlagsError) == 0U );
+}
+
+uint32_t MidiTask_out_get_src(void)
+{
+    return u32MidiOutSrcMask;
+}
+
+void MidiTask_out_get_stats(midi_out_stats_t *pxStats)
+{
+    MIDI_OUT_get_stats(&MidiOut, pxStats);
 }
 
 /* EOF */
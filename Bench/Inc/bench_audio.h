@@ -0,0 +1,43 @@
+/**
+ * @file    bench_audio.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Cycle benchmarks of audio_lib primitives.
+ * @version 0.1
+ * @date    2021-11-21
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BENCH_AUDIO_H__
+#define __BENCH_AUDIO_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+
+/* Samples processed by each benchmark, 100ms at 48kHz */
+#define BENCH_AUDIO_SAMPLES         ( 4800U )
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Run all audio benchmarks and report cycles per sample over sys_log.
+ *
+ */
+void BENCH_AUDIO_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /*__BENCH_AUDIO_H__ */
+
+/* EOF */
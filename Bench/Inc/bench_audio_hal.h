@@ -0,0 +1,48 @@
+/**
+ * @file    bench_audio_hal.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Offline audio HAL, render events are triggered by the bench.
+ * @version 0.1
+ * @date    2021-11-21
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BENCH_AUDIO_HAL_H__
+#define __BENCH_AUDIO_HAL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "audio_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Deliver event to engine as the I2S DMA would do.
+ *
+ * @param eEvent event to deliver.
+ */
+void BENCH_HAL_trigger(audio_hal_event_t eEvent);
+
+/**
+ * @brief Get buffer handed by engine in last send call.
+ *
+ * @param pu16Size output, number of elements of buffer.
+ * @return uint16_t* engine output buffer, NULL if not started.
+ */
+uint16_t *BENCH_HAL_get_buffer(uint16_t *pu16Size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /*__BENCH_AUDIO_HAL_H__ */
+
+/* EOF */
@@ -0,0 +1,309 @@
+/**
+ * @file    bench_audio.c
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Cycle benchmarks of audio_lib primitives.
+ * @version 0.1
+ * @date    2021-11-21
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "bench_audio.h"
+#include "bench_audio_hal.h"
+
+#include "audio_engine.h"
+#include "audio_wavetable.h"
+#include "audio_env_adsr.h"
+#include "audio_filter.h"
+#include "audio_delay.h"
+#include "audio_effect.h"
+#include "audio_master.h"
+
+#include "sys_mcu.h"
+#include "sys_log.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+
+/* Logging interface */
+#define BENCH_IF                    ( SYS_LOG_IF_0 )
+#define BENCH_LVL                   ( SYS_LOG_LEVEL_INF )
+
+/* Bench sample rate in Hz, same as engine */
+#define BENCH_SAMPLE_RATE           ( 48000U )
+
+/* Engine renders 16 samples each half transfer */
+#define BENCH_BLOCK_SIZE            ( 16U )
+#define BENCH_ENGINE_BLOCKS         ( BENCH_AUDIO_SAMPLES / BENCH_BLOCK_SIZE )
+
+/* Delay line used in delay benchmark */
+#define BENCH_DELAY_SIZE            ( 4096U )
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+
+/* Keeps results alive so loops are not optimised out */
+volatile float fBenchSink = 0.0F;
+
+/* Delay line for delay benchmark */
+float pfBenchDelayBuff[BENCH_DELAY_SIZE];
+
+/* Engine instance for chain and end to end benchmarks */
+audio_engine_t xBenchEngine;
+
+/* Input block for master benchmark */
+float pfBenchBlock[BENCH_BLOCK_SIZE];
+
+/* Names of factory waves */
+static const char *pcBenchWaveName[AUDIO_WAVE_FACTORY_NUM] = {
+    [AUDIO_WAVE_SAW] = "saw",
+    [AUDIO_WAVE_RSAW] = "rsaw",
+    [AUDIO_WAVE_SQR] = "sqr",
+    [AUDIO_WAVE_SIN] = "sin",
+    [AUDIO_WAVE_TRI] = "tri",
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void bench_report(const char *pcName, const char *pcVariant, uint32_t u32Cycles, uint32_t u32Samples);
+static uint32_t bench_osc(audio_wave_id_t eWave, float fDetune);
+static uint32_t bench_adsr(void);
+static uint32_t bench_filter(void);
+static uint32_t bench_delay(void);
+static uint32_t bench_effect_chain(void);
+static uint32_t bench_master(void);
+static uint32_t bench_engine(uint32_t u32Voices);
+
+/* Private function definition -----------------------------------------------*/
+
+/**
+ * @brief Print cycles per sample with two decimals.
+ *
+ * @param pcName benchmark name.
+ * @param pcVariant benchmark variant.
+ * @param u32Cycles total cycles.
+ * @param u32Samples samples processed.
+ */
+static void bench_report(const char *pcName, const char *pcVariant, uint32_t u32Cycles, uint32_t u32Samples)
+{
+    uint32_t u32Centi = (uint32_t)(((uint64_t)u32Cycles * 100U) / u32Samples);
+
+    sys_log_print(BENCH_IF, BENCH_LVL, "%s %s: %lu.%02lu cyc/smp",
+                  pcName, pcVariant,
+                  (unsigned long)(u32Centi / 100U), (unsigned long)(u32Centi % 100U));
+}
+
+static uint32_t bench_osc(audio_wave_id_t eWave, float fDetune)
+{
+    AudioWaveTableVoice_t xVoice;
+    float fAcc = 0.0F;
+
+    AUDIO_WAVE_init_voice(&xVoice, BENCH_SAMPLE_RATE, 1.0F);
+    AUDIO_WAVE_change_wave(&xVoice, eWave);
+    AUDIO_WAVE_update_freq(&xVoice, 440.0F);
+    AUDIO_WAVE_update_detune(&xVoice, fDetune);
+    AUDIO_WAVE_set_active(&xVoice, true);
+
+    uint32_t u32Start = sys_mcu_get_cycles();
+
+    for ( uint32_t i = 0U; i < BENCH_AUDIO_SAMPLES; i++ )
+    {
+        fAcc += AUDIO_WAVE_get_next_sample(&xVoice);
+    }
+
+    uint32_t u32Cycles = sys_mcu_get_cycles() - u32Start;
+
+    fBenchSink = fAcc;
+
+    return u32Cycles;
+}
+
+static uint32_t bench_adsr(void)
+{
+    env_adsr_ctrl_t xAdsr;
+    float fAcc = 0.0F;
+
+    ADSR_init(&xAdsr, (float)BENCH_SAMPLE_RATE);
+    ADSR_trigger(&xAdsr);
+
+    uint32_t u32Start = sys_mcu_get_cycles();
+
+    for ( uint32_t i = 0U; i < BENCH_AUDIO_SAMPLES; i++ )
+    {
+        fAcc += ADSR_process(&xAdsr);
+    }
+
+    uint32_t u32Cycles = sys_mcu_get_cycles() - u32Start;
+
+    fBenchSink = fAcc;
+
+    return u32Cycles;
+}
+
+static uint32_t bench_filter(void)
+{
+    AudioFilterLP_t xFilter;
+    float fAcc = 0.0F;
+    float fIn = 1.0F;
+
+    AUDIO_FILTER_LP_init(&xFilter);
+    AUDIO_FILTER_LP_set_samplerate(&xFilter, (float)BENCH_SAMPLE_RATE);
+    AUDIO_FILTER_LP_set_frequency(&xFilter, 1000.0F);
+    AUDIO_FILTER_LP_set_q(&xFilter, 0.707F);
+
+    uint32_t u32Start = sys_mcu_get_cycles();
+
+    for ( uint32_t i = 0U; i < BENCH_AUDIO_SAMPLES; i++ )
+    {
+        fAcc += AUDIO_FILTER_LP_process(&xFilter, fIn);
+        fIn = -fIn;
+    }
+
+    uint32_t u32Cycles = sys_mcu_get_cycles() - u32Start;
+
+    fBenchSink = fAcc;
+
+    return u32Cycles;
+}
+
+static uint32_t bench_delay(void)
+{
+    AudioDelayCtrl_t xDelay;
+    float fAcc = 0.0F;
+    float fIn = 1.0F;
+
+    AUDIO_DELAY_init(&xDelay, BENCH_SAMPLE_RATE, pfBenchDelayBuff, BENCH_DELAY_SIZE);
+    AUDIO_DELAY_update_delay(&xDelay, 0.05F);
+    AUDIO_DELAY_update_feedback(&xDelay, 0.5F);
+
+    uint32_t u32Start = sys_mcu_get_cycles();
+
+    for ( uint32_t i = 0U; i < BENCH_AUDIO_SAMPLES; i++ )
+    {
+        fAcc += AUDIO_DELAY_process(&xDelay, fIn);
+        fIn = -fIn;
+    }
+
+    uint32_t u32Cycles = sys_mcu_get_cycles() - u32Start;
+
+    fBenchSink = fAcc;
+
+    return u32Cycles;
+}
+
+static uint32_t bench_effect_chain(void)
+{
+    float fAcc = 0.0F;
+    float fIn = 0.5F;
+
+    /* Default engine chain: filter on slot 0, delay on slot 1 */
+    (void)AUDIO_init(&xBenchEngine);
+
+    uint32_t u32Start = sys_mcu_get_cycles();
+
+    for ( uint32_t i = 0U; i < BENCH_AUDIO_SAMPLES; i++ )
+    {
+        fAcc += AUDIO_EFFECT_render(&xBenchEngine.xEffects, fIn);
+        fIn = -fIn;
+    }
+
+    uint32_t u32Cycles = sys_mcu_get_cycles() - u32Start;
+
+    fBenchSink = fAcc;
+
+    return u32Cycles;
+}
+
+static uint32_t bench_master(void)
+{
+    AudioMaster_t xMasterBench;
+    uint32_t u32Cycles = 0U;
+
+    AUDIO_MASTER_init(&xMasterBench, (float)BENCH_SAMPLE_RATE, BENCH_BLOCK_SIZE);
+    AUDIO_MASTER_parameter_update(&xMasterBench, AUDIO_MASTER_PARAMETER_COMP_RATIO, 4.0F);
+
+    for ( uint32_t u32Block = 0U; u32Block < BENCH_ENGINE_BLOCKS; u32Block++ )
+    {
+        /* Hot signal so compressor and limiter are working */
+        for ( uint32_t i = 0U; i < BENCH_BLOCK_SIZE; i++ )
+        {
+            pfBenchBlock[i] = ( (i & 1U) != 0U ) ? 1.5F : -1.5F;
+        }
+
+        uint32_t u32Start = sys_mcu_get_cycles();
+
+        AUDIO_MASTER_process(&xMasterBench, pfBenchBlock, BENCH_BLOCK_SIZE);
+
+        u32Cycles += sys_mcu_get_cycles() - u32Start;
+    }
+
+    fBenchSink = pfBenchBlock[0U];
+
+    return u32Cycles;
+}
+
+static uint32_t bench_engine(uint32_t u32Voices)
+{
+    audio_cmd_t xAudioCmd = { 0U };
+
+    (void)AUDIO_init(&xBenchEngine);
+
+    xAudioCmd.eCmdId = AUDIO_CMD_SET_WAVEFORM;
+    xAudioCmd.xCmdPayload.xSetWave.eVoiceId = AUDIO_VOICE_NUM;
+    xAudioCmd.xCmdPayload.xSetWave.eWaveId = AUDIO_WAVE_SAW;
+    (void)AUDIO_handle_cmd(&xBenchEngine, xAudioCmd);
+
+    for ( uint32_t u32Voice = 0U; u32Voice < u32Voices; u32Voice++ )
+    {
+        xAudioCmd.eCmdId = AUDIO_CMD_SET_MIDI_NOTE;
+        xAudioCmd.xCmdPayload.xSetMidiNote.eVoiceId = (audio_voice_id_t)u32Voice;
+        xAudioCmd.xCmdPayload.xSetMidiNote.u8Note = (uint8_t)(48U + (u32Voice * 4U));
+        xAudioCmd.xCmdPayload.xSetMidiNote.u8Velocity = 100U;
+        xAudioCmd.xCmdPayload.xSetMidiNote.bActive = true;
+        (void)AUDIO_handle_cmd(&xBenchEngine, xAudioCmd);
+    }
+
+    /* Same path as DMA interrupt, cycles include render profiling */
+    uint32_t u32Start = sys_mcu_get_cycles();
+
+    for ( uint32_t u32Block = 0U; u32Block < BENCH_ENGINE_BLOCKS; u32Block++ )
+    {
+        BENCH_HAL_trigger(( (u32Block & 1U) != 0U ) ? AUDIO_HAL_EVENT_TX_DONE : AUDIO_HAL_EVENT_HALF_TX_DONE);
+    }
+
+    return sys_mcu_get_cycles() - u32Start;
+}
+
+/* Public function definition ------------------------------------------------*/
+
+void BENCH_AUDIO_run(void)
+{
+    sys_log_print(BENCH_IF, BENCH_LVL, "Bench %lu smp, core %lu Hz",
+                  (unsigned long)BENCH_AUDIO_SAMPLES, (unsigned long)sys_mcu_get_core_clock());
+
+    for ( uint32_t u32Wave = 0U; u32Wave < (uint32_t)AUDIO_WAVE_FACTORY_NUM; u32Wave++ )
+    {
+        bench_report("osc", pcBenchWaveName[u32Wave], bench_osc((audio_wave_id_t)u32Wave, AUDIO_WAVE_NON_DETUNE), BENCH_AUDIO_SAMPLES);
+        bench_report("osc_dt", pcBenchWaveName[u32Wave], bench_osc((audio_wave_id_t)u32Wave, 0.01F), BENCH_AUDIO_SAMPLES);
+    }
+
+    bench_report("adsr", "-", bench_adsr(), BENCH_AUDIO_SAMPLES);
+    bench_report("filter", "lp", bench_filter(), BENCH_AUDIO_SAMPLES);
+    bench_report("delay", "-", bench_delay(), BENCH_AUDIO_SAMPLES);
+    bench_report("fx", "chain", bench_effect_chain(), BENCH_AUDIO_SAMPLES);
+    bench_report("master", "-", bench_master(), BENCH_AUDIO_SAMPLES);
+
+    for ( uint32_t u32Voices = 1U; u32Voices <= (uint32_t)AUDIO_VOICE_NUM; u32Voices++ )
+    {
+        static const char *pcVoices[AUDIO_VOICE_NUM] = { "1v", "2v", "3v", "4v", "5v", "6v", "7v", "8v" };
+
+        bench_report("engine", pcVoices[u32Voices - 1U], bench_engine(u32Voices), BENCH_ENGINE_BLOCKS * BENCH_BLOCK_SIZE);
+    }
+
+    sys_log_print(BENCH_IF, BENCH_LVL, "Bench done");
+}
+
+/* EOF */
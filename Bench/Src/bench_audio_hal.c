@@ -0,0 +1,102 @@
+/**
+ * @file    bench_audio_hal.c
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Offline audio HAL, render events are triggered by the bench.
+ * @version 0.1
+ * @date    2021-11-21
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "bench_audio_hal.h"
+
+#include "sys_mcu.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+
+/* Engine event handler */
+audio_hal_event_cb pBenchEventCallBack = NULL;
+void *pvBenchEventCallBackArg = NULL;
+
+/* Buffer handed by engine */
+uint16_t *pu16BenchBuffer = NULL;
+uint16_t u16BenchBufferSize = 0U;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private function definition -----------------------------------------------*/
+/* Public function definition ------------------------------------------------*/
+
+audio_ret_t AUDIO_HAL_init(audio_hal_event_cb pEventCB, void *pvArg)
+{
+    ERR_ASSERT(pEventCB != NULL);
+
+    pBenchEventCallBack = pEventCB;
+    pvBenchEventCallBackArg = pvArg;
+
+    return AUDIO_OK;
+}
+
+void AUDIO_HAL_deinit(void)
+{
+    pBenchEventCallBack = NULL;
+    pvBenchEventCallBackArg = NULL;
+    pu16BenchBuffer = NULL;
+    u16BenchBufferSize = 0U;
+}
+
+audio_ret_t AUDIO_HAL_send_buffer(uint16_t *pu16Data, uint16_t u16DataLen)
+{
+    ERR_ASSERT(pu16Data != NULL);
+    ERR_ASSERT(u16DataLen != 0U);
+
+    pu16BenchBuffer = pu16Data;
+    u16BenchBufferSize = u16DataLen;
+
+    return AUDIO_OK;
+}
+
+void AUDIO_HAL_isr_ctrl(bool bIsrEnable)
+{
+    (void)bIsrEnable;
+}
+
+void AUDIO_HAL_gpio_ctrl(bool bSetState)
+{
+    (void)bSetState;
+}
+
+uint32_t AUDIO_HAL_get_cycles(void)
+{
+    return sys_mcu_get_cycles();
+}
+
+uint32_t AUDIO_HAL_get_core_clock(void)
+{
+    return sys_mcu_get_core_clock();
+}
+
+void BENCH_HAL_trigger(audio_hal_event_t eEvent)
+{
+    if ( pBenchEventCallBack != NULL )
+    {
+        pBenchEventCallBack(eEvent, pvBenchEventCallBackArg);
+    }
+}
+
+uint16_t *BENCH_HAL_get_buffer(uint16_t *pu16Size)
+{
+    if ( pu16Size != NULL )
+    {
+        *pu16Size = u16BenchBufferSize;
+    }
+
+    return pu16BenchBuffer;
+}
+
+/* EOF */
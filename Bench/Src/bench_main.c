@@ -0,0 +1,90 @@
+/**
+ * @file    bench_main.c
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Entry point of benchmark firmware.
+ * @version 0.1
+ * @date    2021-11-21
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "cmsis_os.h"
+
+#include "sys_mcu.h"
+#include "sys_log.h"
+
+#include "bench_audio.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+
+#define BENCH_TASK_STACK            ( 256 * 4 )
+#define BENCH_TASK_NAME             ( "Bench Task" )
+#define BENCH_TASK_PRIORITY         ( osPriorityRealtime )
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+
+/* Definitions for bench task */
+osThreadId_t BenchTaskHandle;
+const osThreadAttr_t BenchTask_attributes = {
+    .name = BENCH_TASK_NAME,
+    .stack_size = BENCH_TASK_STACK,
+    .priority = (osPriority_t)BENCH_TASK_PRIORITY,
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void BenchTask_main(void *argument);
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+  * @brief  Run benchmarks once. Task has the highest priority, only the
+  *         system tick interrupt competes with measurements.
+  * @param  argument: Not used
+  * @retval None
+  */
+static void BenchTask_main(void *argument)
+{
+    (void)argument;
+
+    BENCH_AUDIO_run();
+
+    /* Infinite loop */
+    for(;;)
+    {
+        osDelay(1000U);
+    }
+}
+
+/**
+  * @brief  The application entry point.
+  * @retval int
+  */
+int main(void)
+{
+    /* SYS Configuration--------------------------------------------------------*/
+    (void)sys_mcu_init();
+    (void)sys_log_init();
+
+    /* RTOS init */
+    osKernelInitialize();
+
+    BenchTaskHandle = osThreadNew(BenchTask_main, NULL, &BenchTask_attributes);
+    ERR_ASSERT(BenchTaskHandle != NULL);
+
+    /* Start scheduler */
+    osKernelStart();
+
+    /* We should never get here as control is now taken by the scheduler */
+    while (1)
+    {
+    }
+}
+
+/* EOF */
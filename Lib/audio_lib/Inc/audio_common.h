@@ -41,6 +41,10 @@ typedef enum {
     AUDIO_WAVE_SQR    = 2U,
     AUDIO_WAVE_SIN    = 3U,
     AUDIO_WAVE_TRI    = 4U,
+    AUDIO_WAVE_USER_0 = 5U,
+    AUDIO_WAVE_USER_1 = 6U,
+    AUDIO_WAVE_USER_2 = 7U,
+    AUDIO_WAVE_USER_3 = 8U,
     AUDIO_WAVE_NUM
 } audio_wave_id_t;
 
@@ -58,7 +62,27 @@ typedef enum audio_voice_id {
 } audio_voice_id_t;
 
 /* Exported constants --------------------------------------------------------*/
+
+/** Number of wave ids stored in flash, user waves follow them */
+#define AUDIO_WAVE_FACTORY_NUM      ( AUDIO_WAVE_USER_0 )
+#define AUDIO_WAVE_USER_NUM         ( AUDIO_WAVE_NUM - AUDIO_WAVE_USER_0 )
+
 /* Exported macro ------------------------------------------------------------*/
+
+/**
+ * Placement of render path in SRAM. Code tagged with AUDIO_RAMFUNC and const
+ * data tagged with AUDIO_FASTDATA go to .ramfunc/.fastdata, copied from flash
+ * by startup together with .data. This avoids flash wait states and ART cache
+ * misses when other tasks evict render code. Host builds keep default sections.
+ */
+#if defined(__arm__) && !defined(AUDIO_NO_RAM_PLACEMENT)
+#define AUDIO_RAMFUNC               __attribute__((section(".ramfunc"), noinline))
+#define AUDIO_FASTDATA              __attribute__((section(".fastdata")))
+#else
+#define AUDIO_RAMFUNC
+#define AUDIO_FASTDATA
+#endif
+
 /* Exported functions prototypes ---------------------------------------------*/
 
 #ifdef __cplusplus
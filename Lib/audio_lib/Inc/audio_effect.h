@@ -19,13 +19,22 @@ extern "C" {
 
 /* Includes ------------------------------------------------------------------*/
 #include "audio_common.h"
+#include "audio_pool.h"
 
 /* Exported types ------------------------------------------------------------*/
 
+/* Effect arena size for each chain, room for one delay and filters on the
+   other slots. Builds with spare RAM may raise it for more delays */
+#ifndef AUDIO_EFFECT_POOL_SIZE
+#define AUDIO_EFFECT_POOL_SIZE      ( 40U * 1024U )
+#endif
+
 /* Defined slots */
 typedef enum {
     AUDIO_EFFECT_SLOT_0 = 0U,
     AUDIO_EFFECT_SLOT_1,
+    AUDIO_EFFECT_SLOT_2,
+    AUDIO_EFFECT_SLOT_3,
     AUDIO_EFFECT_SLOT_NUM,
 } audio_effect_slot_t;
 
@@ -46,76 +55,128 @@ typedef enum {
     AUDIO_EFFECT_PARAMETER_NUM,
 } audio_effect_parameter_id_t;
 
+/* Effect instance, defined in effect module */
+struct audio_effect_instance;
+
+/* Keep render out while slot instances change, true to lock */
+typedef void (*audio_effect_lock_cb_t)(bool bLock);
+
+/* Effect slot */
+typedef struct audio_effect_handler {
+    bool bActive;
+    struct audio_effect_instance * volatile pxInstance;
+} audio_effect_handler_t;
+
+/* Effect chain, instances are taken from the chain own arena */
+typedef struct audio_effect_chain {
+    audio_effect_handler_t pxSlot[AUDIO_EFFECT_SLOT_NUM];
+    audio_pool_t xPool;
+    float fSampleRate;
+    audio_effect_lock_cb_t xLockCB;
+    uint64_t pu64Arena[AUDIO_EFFECT_POOL_SIZE / sizeof(uint64_t)];
+} audio_effect_chain_t;
+
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions prototypes ---------------------------------------------*/
 
 /**
- * @brief Init effect section
+ * @brief Init effect chain, all slots empty and disabled.
  * 
+ * @param pxChain effect chain to init.
  * @param fSampleRate system sample rate in Hz.
  */
-void AUDIO_EFFECT_init(float fSampleRate);
+void AUDIO_EFFECT_init(audio_effect_chain_t *pxChain, float fSampleRate);
 
 /**
- * @brief Set effect to effect slot.
+ * @brief Set lock used while slot instances are detached or published, so
+ *        render runs on other context. Without lock render and slot changes
+ *        must run on the same context.
  * 
+ * @param pxChain effect chain.
+ * @param xLockCB lock callback, NULL for none.
+ */
+void AUDIO_EFFECT_set_lock_cb(audio_effect_chain_t *pxChain, audio_effect_lock_cb_t xLockCB);
+
+/**
+ * @brief Set effect to effect slot. A new effect instance is taken from the
+ *        effect pool and the previous one, if any, is given back. Instance
+ *        is allocated and initialised unlocked, lock is only held to detach
+ *        and publish it.
+ * 
+ * @param pxChain effect chain.
  * @param eSlot effect slot to use.
  * @param eId Effect to assign to effect slot.
- * @return audio_ret_t operation result.
+ * @return audio_ret_t operation result, AUDIO_ERR if pool has no room for effect.
  */
-audio_ret_t AUDIO_EFFECT_set_slot(audio_effect_slot_t eSlot, audio_effect_id_t eId);
+audio_ret_t AUDIO_EFFECT_set_slot(audio_effect_chain_t *pxChain, audio_effect_slot_t eSlot, audio_effect_id_t eId);
 
 /**
  * @brief Enable effect slot.
  * 
+ * @param pxChain effect chain.
  * @param eSlot effect slot to use.
  * @param bActive new activation state to assign to effect slot.
  * @return audio_ret_t operation result.
  */
-audio_ret_t AUDIO_EFFECT_activate_slot(audio_effect_slot_t eSlot, bool bActive);
+audio_ret_t AUDIO_EFFECT_activate_slot(audio_effect_chain_t *pxChain, audio_effect_slot_t eSlot, bool bActive);
 
 /**
  * @brief Get current effect assigned to effect slot.
  * 
+ * @param pxChain effect chain.
  * @param eSlot effect slot to retrieve.
  * @return audio_effect_id_t current effect assigned to slot eSlot.
  */
-audio_effect_id_t AUDIO_EFFECT_get_slot(audio_effect_slot_t eSlot);
+audio_effect_id_t AUDIO_EFFECT_get_slot(audio_effect_chain_t *pxChain, audio_effect_slot_t eSlot);
 
 /**
  * @brief Get current activation state to a determine slot.
  * 
+ * @param pxChain effect chain.
  * @param eSlot slot to check.
  * @return true effect slot active.
  * @return false effect slot deactivated.
  */
-bool AUDIO_EFFECT_get_slot_act(audio_effect_slot_t eSlot);
+bool AUDIO_EFFECT_get_slot_act(audio_effect_chain_t *pxChain, audio_effect_slot_t eSlot);
 
 /**
  * @brief Update effect parameter from parameter list.
  * 
+ * @param pxChain effect chain.
+ * @param eSlot slot to update, AUDIO_EFFECT_SLOT_NUM to update all slots using the parameter.
  * @param eId parameter id
  * @param fNewValue new value to assign.
  * @return audio_ret_t operation result.
  */
-audio_ret_t AUDIO_EFFECT_parameter_update(audio_effect_parameter_id_t eId, float fNewValue);
+audio_ret_t AUDIO_EFFECT_parameter_update(audio_effect_chain_t *pxChain, audio_effect_slot_t eSlot, audio_effect_parameter_id_t eId, float fNewValue);
 
 /**
  * @brief Get current value of effect parameter.
  * 
+ * @param pxChain effect chain.
+ * @param eSlot slot to check, AUDIO_EFFECT_SLOT_NUM to get value from first slot using the parameter.
  * @param eId parameter id to check.
  * @return float parameter value.
  */
-float AUDIO_EFFECT_parameter_get(audio_effect_parameter_id_t eId);
+float AUDIO_EFFECT_parameter_get(audio_effect_chain_t *pxChain, audio_effect_slot_t eSlot, audio_effect_parameter_id_t eId);
+
+/**
+ * @brief Get free memory in effect instance pool.
+ * 
+ * @param pxChain effect chain.
+ * @return uint32_t number of free bytes.
+ */
+uint32_t AUDIO_EFFECT_get_free_mem(audio_effect_chain_t *pxChain);
 
 /**
  * @brief Render all activate effects from effect list.
  * 
+ * @param pxChain effect chain.
  * @param fInputData input data to effect engine.
  * @return float output data after pass throught all effects.
  */
-float AUDIO_EFFECT_render(float fInputData);
+float AUDIO_EFFECT_render(audio_effect_chain_t *pxChain, float fInputData);
 
 #ifdef __cplusplus
 }
@@ -19,10 +19,29 @@ extern "C" {
 
 /* Includes ------------------------------------------------------------------*/
 #include "audio_common.h"
+#include "audio_wavetable.h"
+#include "audio_env_adsr.h"
 #include "audio_effect.h"
+#include "audio_master.h"
+#include "audio_param.h"
 
 /* Exported types ------------------------------------------------------------*/
 
+/* Output sample rate */
+#define AUDIO_ENGINE_SAMPLE_RATE    ( 48000U )
+
+/* Audio out sample buffer, 2 channels, 1 position for channel (16b) */
+#define AUDIO_ENGINE_BUFF_SIZE      ( 64U )
+
+/* Number of samples rendered each half transfer, same data on L and R */
+#define AUDIO_ENGINE_BLOCK_SIZE     ( AUDIO_ENGINE_BUFF_SIZE / 4U )
+
+/* Entries of note tuning table, one per midi note */
+#define AUDIO_ENGINE_NOTE_NUM       ( 128U )
+
+/* Entries of velocity gain table, one per midi velocity */
+#define AUDIO_ENGINE_VEL_NUM        ( 128U )
+
 /* Defined engine commands  */
 typedef enum {
     AUDIO_CMD_ACTIVATE_VOICE = 0x00,
@@ -30,10 +49,14 @@ typedef enum {
     AUDIO_CMD_SET_MIDI_NOTE,
     AUDIO_CMD_SET_WAVEFORM,
     AUDIO_CMD_SET_DETUNE,
+    AUDIO_CMD_SET_MORPH,
     AUDIO_CMD_SET_ADSR,
     AUDIO_CMD_EFFECT_UPDATE,
     AUDIO_CMD_EFFECT_SET_SLOT,
     AUDIO_CMD_EFFECT_ACTIVATE,
+    AUDIO_CMD_MASTER_UPDATE,
+    AUDIO_CMD_LOAD_USER_WAVE,
+    AUDIO_CMD_RELEASE_VOICES,
     AUDIO_CMD_NUM_CMD
 } audio_cmd_id_t;
 
@@ -66,6 +89,11 @@ typedef struct audio_cmd_set_detune {
     float fDetuneLvl;
 } audio_cmd_set_detune_t;
 
+typedef struct audio_cmd_set_morph {
+    audio_voice_id_t eVoiceId;
+    float fMorph;
+} audio_cmd_set_morph_t;
+
 typedef struct audio_cmd_set_adsr {
     audio_voice_id_t eVoiceId;
     float fAttackTime;
@@ -76,6 +104,7 @@ typedef struct audio_cmd_set_adsr {
 } audio_cmd_set_adsr_t;
 
 typedef struct audio_cmd_effect_update {
+    audio_effect_slot_t eSlot;
     audio_effect_parameter_id_t eParamId;
     float fNewValue;
 } audio_cmd_effect_update_t;
@@ -90,6 +119,20 @@ typedef struct audio_cmd_effect_activate_slot {
     bool bActive;
 } audio_cmd_effect_activate_slot_t;
 
+typedef struct audio_cmd_master_update {
+    audio_master_parameter_id_t eParamId;
+    float fNewValue;
+} audio_cmd_master_update_t;
+
+typedef struct audio_cmd_load_user_wave {
+    audio_wave_id_t eWaveId;
+    const int16_t *pi16Data;
+} audio_cmd_load_user_wave_t;
+
+typedef struct audio_cmd_release_voices {
+    uint32_t u32VoiceMask;          /**< Bit n set to release voice n */
+} audio_cmd_release_voices_t;
+
 /* Gather all commands in same structure */
 
 typedef union audio_cmd_payload {
@@ -98,10 +141,14 @@ typedef union audio_cmd_payload {
     audio_cmd_payload_set_midi_note_t  xSetMidiNote;
     audio_cmd_payload_set_wave_t       xSetWave;
     audio_cmd_set_detune_t             xSetDetune;
+    audio_cmd_set_morph_t              xSetMorph;
     audio_cmd_set_adsr_t               xSetAdsr;
     audio_cmd_effect_update_t          xEffectUpdate;
     audio_cmd_effect_set_slot_t        xSetSlot;
     audio_cmd_effect_activate_slot_t   xActivateSlot;
+    audio_cmd_master_update_t          xMasterUpdate;
+    audio_cmd_load_user_wave_t         xLoadUserWave;
+    audio_cmd_release_voices_t         xReleaseVoices;
 } audio_cmd_payload_t;
 
 /* Command base structure */
@@ -111,31 +158,291 @@ typedef struct audio_cmd {
     audio_cmd_payload_t xCmdPayload;
 } audio_cmd_t;
 
+/* Render profiling, in CPU cycles per block */
+
+typedef struct audio_render_stats {
+    uint32_t u32LastCycles;         /**< Cycles used by last block */
+    uint32_t u32MaxCycles;          /**< Worst block since last reset */
+    uint32_t u32AvgCycles;          /**< Running average of block cycles */
+    uint32_t u32BudgetCycles;       /**< Cycles available for each block */
+    uint32_t u32BlockCount;         /**< Blocks rendered since last reset */
+} audio_render_stats_t;
+
+/* Pitch modulation shared by all voices, evaluated once per block */
+
+typedef struct audio_pitch_ctrl {
+    volatile float fBendRange;      /**< Semitones at full pitch bend */
+    volatile float fVibratoRate;    /**< Vibrato LFO rate in Hz */
+    volatile float fVibratoDepth;   /**< Semitones of vibrato at full mod wheel */
+    float fVibratoPhase;            /**< LFO phase in cycles, 0.0 to 1.0 */
+    float fPitchMod;                /**< Multiplier applied to voices on last block */
+} audio_pitch_ctrl_t;
+
+/* Velocity to gain curves */
+
+typedef enum {
+    AUDIO_VEL_CURVE_OFF = 0x00,     /**< Velocity ignored, full gain */
+    AUDIO_VEL_CURVE_LINEAR,         /**< Gain proportional to velocity */
+    AUDIO_VEL_CURVE_DB,             /**< Linear in dB, -40 dB to 0 dB */
+    AUDIO_VEL_CURVE_POWER,          /**< Velocity raised to user exponent */
+    AUDIO_VEL_CURVE_USER,           /**< Table loaded by user */
+    AUDIO_VEL_CURVE_NUM
+} audio_vel_curve_t;
+
+/* Velocity response, curve is evaluated when selected and only read on note on */
+
+typedef struct audio_vel_ctrl {
+    audio_vel_curve_t eCurve;               /**< Selected curve */
+    float fAttackSens;                      /**< Attack time cut at full velocity, 0.0 to 1.0 */
+    float fGain[AUDIO_ENGINE_VEL_NUM];      /**< Gain of each velocity, 0.0 to 1.0 */
+} audio_vel_ctrl_t;
+
+/* Per note expression, MPE */
+
+typedef enum {
+    AUDIO_EXPR_BEND = 0x00,         /**< Per voice pitch bend, -1.0 to 1.0 of expression bend range */
+    AUDIO_EXPR_PRESSURE,            /**< Per voice pressure, 0.0 to 1.0 */
+    AUDIO_EXPR_TIMBRE,              /**< Per voice timbre (CC 74), 0.0 to 1.0, 0.5 at rest */
+    AUDIO_EXPR_NUM
+} audio_expr_id_t;
+
+/* Expression state of one voice, targets written by control side, applied once per block */
+
+typedef struct audio_voice_expr {
+    volatile float fBend;           /**< Bend target, -1.0 to 1.0 */
+    volatile float fPressure;       /**< Pressure target, 0.0 to 1.0 */
+    volatile float fTimbre;         /**< Timbre target, 0.0 to 1.0 */
+    float fBendApplied;             /**< Bend used to compute pitch multiplier */
+    float fPitchMod;                /**< Pitch multiplier applied to voice */
+    float fVelAmp;                  /**< Amplitude set by last note on */
+    float fGain;                    /**< Pressure gain applied to voice */
+    float fTimbreApplied;           /**< Timbre applied to morph, below 0.0 forces update */
+    float fMorphOffset;             /**< Frames added to voice morph by timbre */
+} audio_voice_expr_t;
+
+typedef struct audio_expr_ctrl {
+    volatile float fBendRange;      /**< Semitones at full per voice bend */
+    volatile float fPressureDepth;  /**< Gain cut at zero pressure, 0.0 to 1.0 */
+    volatile float fTimbreDepth;    /**< Morph span of full timbre swing, fraction of bank */
+    audio_voice_expr_t xVoice[AUDIO_VOICE_NUM];
+} audio_expr_ctrl_t;
+
+/* Called from render context after each block, sample clock already updated */
+
+typedef void (*audio_block_cb_t)(uint32_t u32SampleClock, void *pvArg);
+
+/* Engine instance, all state used to render one output stream */
+
+typedef struct audio_engine {
+    AudioWaveTableVoice_t xVoiceList[AUDIO_VOICE_NUM];  /**< Voice oscillators */
+    env_adsr_ctrl_t xAdsrEnvList[AUDIO_VOICE_NUM];      /**< Voice envelopes */
+    audio_effect_chain_t xEffects;                      /**< Effect slots and instance arena */
+    AudioMaster_t xMaster;                              /**< Master bus */
+    audio_param_bank_t xParams;                         /**< Realtime parameters, smoothed per block */
+    audio_pitch_ctrl_t xPitch;                          /**< Pitch bend and vibrato */
+    float fNoteFreq[AUDIO_ENGINE_NOTE_NUM];             /**< Tuning table, note frequency in Hz */
+    audio_vel_ctrl_t xVelocity;                         /**< Velocity response */
+    audio_expr_ctrl_t xExpr;                            /**< Per voice expression */
+    float fRenderBlock[AUDIO_ENGINE_BLOCK_SIZE];        /**< Render block before master stage */
+    uint16_t u16AudioBuffer[AUDIO_ENGINE_BUFF_SIZE];    /**< Output buffer, both DMA halves */
+    audio_render_stats_t xRenderStats;                  /**< Render profiling counters */
+    volatile uint32_t u32SampleClock;                   /**< Samples rendered since init, wraps */
+    audio_block_cb_t pBlockCB;                          /**< Optional block callback */
+    void *pvBlockArg;                                   /**< Argument of block callback */
+} audio_engine_t;
+
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions prototypes ---------------------------------------------*/
 
 /**
- * @brief Initiate audio engine resources.
+ * @brief Initiate engine instance and start its output on audio HAL.
  * 
+ * @param pxEngine engine instance, must stay valid while running.
  * @return audio_ret_t operation result.
  */
-audio_ret_t AUDIO_init(void);
+audio_ret_t AUDIO_init(audio_engine_t *pxEngine);
 
 /**
  * @brief Release audio engine resources.
  * 
+ * @param pxEngine engine instance.
  * @return audio_ret_t operation result.
  */
-audio_ret_t AUDIO_deinit(void);
+audio_ret_t AUDIO_deinit(audio_engine_t *pxEngine);
 
 /**
  * @brief Handle new command in audio engine
  * 
+ * @param pxEngine engine instance.
  * @param xAudioCmd Command payload.
  * @return audio_ret_t Operation result.
  */
-audio_ret_t AUDIO_handle_cmd(audio_cmd_t xAudioCmd);
+audio_ret_t AUDIO_handle_cmd(audio_engine_t *pxEngine, audio_cmd_t xAudioCmd);
+
+/**
+ * @brief Get render profiling counters.
+ * 
+ * @param pxEngine engine instance.
+ * @param pxStats output structure.
+ */
+void AUDIO_get_render_stats(audio_engine_t *pxEngine, audio_render_stats_t *pxStats);
+
+/**
+ * @brief Clear max and average render counters.
+ * 
+ * @param pxEngine engine instance.
+ */
+void AUDIO_reset_render_stats(audio_engine_t *pxEngine);
+
+/**
+ * @brief Get number of samples rendered since engine init. Counter wraps
+ *        around, use differences between two readings.
+ * 
+ * @param pxEngine engine instance.
+ * @return uint32_t sample clock.
+ */
+uint32_t AUDIO_get_sample_clock(audio_engine_t *pxEngine);
+
+/**
+ * @brief Register callback run after each rendered block, in render context
+ *        (audio ISR on target). Used as sample accurate tick source.
+ * 
+ * @param pxEngine engine instance.
+ * @param pBlockCB callback, NULL to remove it.
+ * @param pvArg argument given to callback.
+ */
+void AUDIO_set_block_cb(audio_engine_t *pxEngine, audio_block_cb_t pBlockCB, void *pvArg);
+
+/**
+ * @brief Set target of realtime parameter. Value is only stored, render
+ *        context glides to it and updates the DSP at most once per block, so
+ *        it is safe to call at controller rate from any task.
+ * 
+ * @param pxEngine engine instance.
+ * @param eParam parameter id.
+ * @param fNorm target in range 0.0 to 1.0.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_set_param(audio_engine_t *pxEngine, audio_param_id_t eParam, float fNorm);
+
+/**
+ * @brief Set pitch bend range. Bend itself is AUDIO_PARAM_PITCH_BEND.
+ * 
+ * @param pxEngine engine instance.
+ * @param fSemitones range in semitones for full bend, 0.0 to 24.0.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_set_bend_range(audio_engine_t *pxEngine, float fSemitones);
+
+/**
+ * @brief Set vibrato LFO. Depth is scaled by AUDIO_PARAM_MOD_WHEEL.
+ * 
+ * @param pxEngine engine instance.
+ * @param fRate LFO rate in Hz, 0.0 to 20.0.
+ * @param fDepth semitones at full mod wheel, 0.0 to 2.0.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_set_vibrato(audio_engine_t *pxEngine, float fRate, float fDepth);
+
+/**
+ * @brief Retune one note of tuning table, used on next note on. Frequencies
+ *        are kept in Hz so table does not depend on sample rate or wave size.
+ * 
+ * @param pxEngine engine instance.
+ * @param u8Note midi note to retune.
+ * @param fPitch pitch in equal tempered semitones, 69.0 is A4 at 440 Hz,
+ *        range 0.0 to 128.0.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_set_note_tuning(audio_engine_t *pxEngine, uint8_t u8Note, float fPitch);
+
+/**
+ * @brief Restore equal temperament with A4 at 440 Hz.
+ * 
+ * @param pxEngine engine instance.
+ */
+void AUDIO_reset_tuning(audio_engine_t *pxEngine);
+
+/**
+ * @brief Get frequency assigned to note in tuning table.
+ * 
+ * @param pxEngine engine instance.
+ * @param u8Note midi note.
+ * @return float frequency in Hz, 0.0 if note is out of range.
+ */
+float AUDIO_get_note_freq(audio_engine_t *pxEngine, uint8_t u8Note);
+
+/**
+ * @brief Select velocity curve. Table is built here, note on only reads it.
+ * 
+ * @param pxEngine engine instance.
+ * @param eCurve curve id, AUDIO_VEL_CURVE_USER keeps last loaded table.
+ * @param fExponent exponent of AUDIO_VEL_CURVE_POWER, 0.1 to 10.0, ignored
+ *        by other curves.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_set_vel_curve(audio_engine_t *pxEngine, audio_vel_curve_t eCurve, float fExponent);
+
+/**
+ * @brief Load user velocity table and select AUDIO_VEL_CURVE_USER.
+ * 
+ * @param pxEngine engine instance.
+ * @param pfGain AUDIO_ENGINE_VEL_NUM gains in range 0.0 to 1.0.
+ * @return audio_ret_t operation result, table is not changed on error.
+ */
+audio_ret_t AUDIO_set_vel_table(audio_engine_t *pxEngine, const float *pfGain);
+
+/**
+ * @brief Set velocity to attack time sensitivity, attack of each note is
+ *        scaled by 1.0 - fSens * gain of its velocity.
+ * 
+ * @param pxEngine engine instance.
+ * @param fSens sensitivity, 0.0 (off) to 1.0.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_set_vel_attack(audio_engine_t *pxEngine, float fSens);
+
+/**
+ * @brief Get selected velocity curve.
+ * 
+ * @param pxEngine engine instance.
+ * @return audio_vel_curve_t curve id.
+ */
+audio_vel_curve_t AUDIO_get_vel_curve(audio_engine_t *pxEngine);
+
+/**
+ * @brief Set expression target of one voice, applied on next block. Values
+ *        are kept across notes, control side sets them before note on.
+ * 
+ * @param pxEngine engine instance.
+ * @param eVoice voice id.
+ * @param eExpr expression id.
+ * @param fValue bend -1.0 to 1.0, pressure and timbre 0.0 to 1.0.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_set_voice_expr(audio_engine_t *pxEngine, audio_voice_id_t eVoice, audio_expr_id_t eExpr, float fValue);
+
+/**
+ * @brief Return voice to neutral expression: no bend, full pressure and
+ *        timbre at rest. Neutral voices render as without expression.
+ * 
+ * @param pxEngine engine instance.
+ * @param eVoice voice id, AUDIO_VOICE_NUM for all voices.
+ */
+void AUDIO_reset_voice_expr(audio_engine_t *pxEngine, audio_voice_id_t eVoice);
+
+/**
+ * @brief Set response of per voice expression.
+ * 
+ * @param pxEngine engine instance.
+ * @param fBendRange semitones at full bend, 0.0 to 96.0.
+ * @param fPressureDepth gain cut at zero pressure, 0.0 to 1.0.
+ * @param fTimbreDepth morph span of full timbre swing as fraction of bank,
+ *        0.0 to 1.0.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_set_expr_depth(audio_engine_t *pxEngine, float fBendRange, float fPressureDepth, float fTimbreDepth);
 
 #ifdef __cplusplus
 }
@@ -49,6 +49,7 @@ typedef struct env_adsr_ctrl {
 void ADSR_init(env_adsr_ctrl_t *pxAdsrCtrl, float fSampleRate);
 
 void ADSR_trigger(env_adsr_ctrl_t *pxAdsrCtrl);
+void ADSR_trigger_scaled(env_adsr_ctrl_t *pxAdsrCtrl, float fTimeScale);
 void ADSR_release(env_adsr_ctrl_t *pxAdsrCtrl);
 
 float ADSR_process(env_adsr_ctrl_t *pxAdsrCtrl);
@@ -30,8 +30,8 @@ typedef enum {
     AUDIO_HAL_EVENT_NUM,
 } audio_hal_event_t;
 
-/** User callback for async events */
-typedef void (*audio_hal_event_cb)(audio_hal_event_t event);
+/** User callback for async events, pvArg is the value given on init */
+typedef void (*audio_hal_event_cb)(audio_hal_event_t event, void *pvArg);
 
 /* Exported constants --------------------------------------------------------*/
 
@@ -48,9 +48,10 @@ typedef void (*audio_hal_event_cb)(audio_hal_event_t event);
  * @brief Enable I2S peripheral and async callback function.
  * 
  * @param pEventCB pointer to handler async events.
+ * @param pvArg argument passed to handler on each event.
  * @return audio_ret_t operation result.
  */
-audio_ret_t AUDIO_HAL_init(audio_hal_event_cb pEventCB);
+audio_ret_t AUDIO_HAL_init(audio_hal_event_cb pEventCB, void *pvArg);
 
 /**
  * @brief Deinit I2S peripheral.
@@ -81,6 +82,20 @@ void AUDIO_HAL_isr_ctrl(bool bIsrEnable);
  */
 void AUDIO_HAL_gpio_ctrl(bool bSetState);
 
+/**
+ * @brief Get CPU cycle counter, used to profile render path.
+ * 
+ * @return uint32_t current cycle count, wraps around.
+ */
+uint32_t AUDIO_HAL_get_cycles(void);
+
+/**
+ * @brief Get CPU core clock.
+ * 
+ * @return uint32_t core clock in Hz.
+ */
+uint32_t AUDIO_HAL_get_core_clock(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,119 @@
+/**
+ * @file    audio_master.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Master bus stage, compressor, soft clipper and look-ahead limiter.
+ * @version 0.1
+ * @date    2021-11-13
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __AUDIO_MASTER_H__
+#define __AUDIO_MASTER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "audio_common.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Max number of samples handled in one master process call */
+#define AUDIO_MASTER_MAX_BLOCK_SIZE     ( 64U )
+
+/* Points of soft clipper table, positive inputs */
+#define AUDIO_MASTER_CLIP_TABLE_SIZE    ( 256U )
+
+/* Master bus parameters */
+typedef enum {
+    AUDIO_MASTER_PARAMETER_LIMITER_ENABLE = 0U,
+    AUDIO_MASTER_PARAMETER_LIMITER_THRESHOLD,
+    AUDIO_MASTER_PARAMETER_LIMITER_RELEASE,
+    AUDIO_MASTER_PARAMETER_COMP_THRESHOLD,
+    AUDIO_MASTER_PARAMETER_COMP_RATIO,
+    AUDIO_MASTER_PARAMETER_COMP_ATTACK,
+    AUDIO_MASTER_PARAMETER_COMP_RELEASE,
+    AUDIO_MASTER_PARAMETER_COMP_MAKEUP,
+    AUDIO_MASTER_PARAMETER_NUM,
+} audio_master_parameter_id_t;
+
+/**
+ * @brief Master bus control structure. Samples are handled in full scale
+ *        units, output of process is always bounded to range -1.0 to 1.0.
+ * 
+ */
+typedef struct AudioMaster {
+    float pfLookAhead[AUDIO_MASTER_MAX_BLOCK_SIZE];     /**< Previous input block, limiter look-ahead */
+    float pfClipTable[AUDIO_MASTER_CLIP_TABLE_SIZE + 1U];   /**< Soft clipper curve, filled on init */
+    float fSampleRate;                                  /**< Master sample rate */
+    float fLimiterGain;                                 /**< Gain applied at the end of last block */
+    float fLimiterThreshold;                            /**< Limiter ceiling in full scale units */
+    float fLimiterRelease;                              /**< Limiter release time in seconds */
+    float fLimiterReleaseCoef;                          /**< Per block release coefficient */
+    float fCompEnv;                                     /**< Compressor envelope follower state */
+    float fCompGain;                                    /**< Compressor gain at the end of last block */
+    float fCompThreshold;                               /**< Compressor threshold in dB full scale */
+    float fCompRatio;                                   /**< Compressor ratio, 1.0 bypass */
+    float fCompSlope;                                   /**< Gain reduction per dB over threshold */
+    float fCompAttack;                                  /**< Envelope attack time in seconds */
+    float fCompAttackCoef;                              /**< Per sample attack coefficient */
+    float fCompRelease;                                 /**< Envelope release time in seconds */
+    float fCompReleaseCoef;                             /**< Per sample release coefficient */
+    float fCompMakeup;                                  /**< Makeup gain in dB */
+    uint32_t u32BlockSize;                              /**< Size of blocks processed */
+    bool bLimiterEnable;                                /**< Limiter activation */
+} AudioMaster_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Init master bus structure.
+ * 
+ * @param pxMaster pointer to master structure.
+ * @param fSampleRate system sample rate in Hz.
+ * @param u32BlockSize number of samples in each process call, up to AUDIO_MASTER_MAX_BLOCK_SIZE.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_MASTER_init(AudioMaster_t *pxMaster, float fSampleRate, uint32_t u32BlockSize);
+
+/**
+ * @brief Update master parameter.
+ * 
+ * @param pxMaster pointer to master structure.
+ * @param eId parameter id.
+ * @param fNewValue new value to assign.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_MASTER_parameter_update(AudioMaster_t *pxMaster, audio_master_parameter_id_t eId, float fNewValue);
+
+/**
+ * @brief Get current value of master parameter.
+ * 
+ * @param pxMaster pointer to master structure.
+ * @param eId parameter id.
+ * @return float parameter value.
+ */
+float AUDIO_MASTER_parameter_get(AudioMaster_t *pxMaster, audio_master_parameter_id_t eId);
+
+/**
+ * @brief Process a block of samples in place: compressor, limiter and soft
+ *        clipper. When limiter is enabled the output is delayed by one block.
+ * 
+ * @param pxMaster pointer to master structure.
+ * @param pfData block of samples in full scale units.
+ * @param u32Size number of samples, must match block size used in init.
+ */
+void AUDIO_MASTER_process(AudioMaster_t *pxMaster, float *pfData, uint32_t u32Size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /*__AUDIO_MASTER_H__ */
+
+/* EOF */
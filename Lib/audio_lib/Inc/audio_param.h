@@ -0,0 +1,121 @@
+/**
+ * @file    audio_param.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Realtime parameter bank with per block smoothing.
+ * @version 0.1
+ * @date    2021-12-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Control side only writes targets in normalized range 0.0 to 1.0, the render
+ * context advances all smoothers once per block and gets a mask of parameters
+ * whose value moved enough to be applied. Any number of writes between two
+ * blocks ends in at most one DSP update per parameter.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __AUDIO_PARAM_H__
+#define __AUDIO_PARAM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "audio_common.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Realtime parameters */
+typedef enum {
+    AUDIO_PARAM_FILTER_FREQ = 0U,
+    AUDIO_PARAM_FILTER_Q,
+    AUDIO_PARAM_DELAY_TIME,
+    AUDIO_PARAM_DELAY_FB,
+    AUDIO_PARAM_DETUNE,
+    AUDIO_PARAM_ATTACK,
+    AUDIO_PARAM_DECAY,
+    AUDIO_PARAM_SUSTAIN,
+    AUDIO_PARAM_RELEASE,
+    AUDIO_PARAM_MORPH,
+    AUDIO_PARAM_PITCH_BEND,
+    AUDIO_PARAM_MOD_WHEEL,
+    AUDIO_PARAM_NUM,
+} audio_param_id_t;
+
+/* Smoother state of one parameter, values in normalized range */
+typedef struct audio_param_smooth {
+    volatile float fTarget;         /**< Value to reach, written by control side */
+    float fValue;                   /**< Smoothed value */
+    float fApplied;                 /**< Last value reported to be applied */
+    float fCoef;                    /**< One pole coefficient per block */
+} audio_param_smooth_t;
+
+/* Parameter bank */
+typedef struct audio_param_bank {
+    audio_param_smooth_t xParam[AUDIO_PARAM_NUM];
+} audio_param_bank_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Init parameter bank, all smoothers idle at 0.0.
+ *
+ * @param pxBank parameter bank.
+ * @param fBlockRate rate of AUDIO_PARAM_process calls, in Hz.
+ */
+void AUDIO_PARAM_init(audio_param_bank_t *pxBank, float fBlockRate);
+
+/**
+ * @brief Jump parameter to value without smoothing, no update is reported.
+ *        Used to track values set by other paths.
+ *
+ * @param pxBank parameter bank.
+ * @param eParam parameter id.
+ * @param fValue value in parameter units.
+ */
+void AUDIO_PARAM_reset(audio_param_bank_t *pxBank, audio_param_id_t eParam, float fValue);
+
+/**
+ * @brief Set new target of parameter, control side. Only stores value.
+ *
+ * @param pxBank parameter bank.
+ * @param eParam parameter id.
+ * @param fNorm target in range 0.0 to 1.0.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_PARAM_set_target(audio_param_bank_t *pxBank, audio_param_id_t eParam, float fNorm);
+
+/**
+ * @brief Advance all smoothers one block, render side.
+ *
+ * @param pxBank parameter bank.
+ * @return uint32_t mask of parameters to apply, bit n for parameter n.
+ */
+uint32_t AUDIO_PARAM_process(audio_param_bank_t *pxBank);
+
+/**
+ * @brief Get smoothed value in parameter units.
+ *
+ * @param pxBank parameter bank.
+ * @param eParam parameter id.
+ * @return float current value.
+ */
+float AUDIO_PARAM_get_value(audio_param_bank_t *pxBank, audio_param_id_t eParam);
+
+/**
+ * @brief Get parameter name, used on user interfaces.
+ *
+ * @param eParam parameter id.
+ * @return const char* parameter name.
+ */
+const char *AUDIO_PARAM_get_name(audio_param_id_t eParam);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /*__AUDIO_PARAM_H__ */
+
+/* EOF */
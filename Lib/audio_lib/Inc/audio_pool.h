@@ -0,0 +1,86 @@
+/**
+ * @file    audio_pool.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Fixed arena allocator for audio module instances.
+ * @version 0.1
+ * @date    2021-11-06
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __AUDIO_POOL_H__
+#define __AUDIO_POOL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "audio_common.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * @brief Arena control structure.
+ * 
+ */
+typedef struct audio_pool {
+    uint8_t *pu8Arena;          /**< Memory backing the pool */
+    uint32_t u32ArenaSize;      /**< Size of arena in bytes */
+    uint32_t u32FreeSize;       /**< Bytes available for new allocations */
+} audio_pool_t;
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Alignment granted to every allocated block */
+#define AUDIO_POOL_ALIGN            ( 8U )
+
+/* Pool bookkeeping bytes ahead of every allocated block */
+#define AUDIO_POOL_BLOCK_HDR_SIZE   ( 8U )
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Init pool over a memory arena.
+ * 
+ * @param pxPool pointer to pool control structure.
+ * @param pvArena memory used as arena, must be aligned to AUDIO_POOL_ALIGN.
+ * @param u32ArenaSize size of arena in bytes.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_POOL_init(audio_pool_t *pxPool, void *pvArena, uint32_t u32ArenaSize);
+
+/**
+ * @brief Get a block from the pool, first fit.
+ * 
+ * @param pxPool pointer to pool control structure.
+ * @param u32Size number of bytes requested.
+ * @return void* pointer to allocated block, NULL if there is no room.
+ */
+void *AUDIO_POOL_alloc(audio_pool_t *pxPool, uint32_t u32Size);
+
+/**
+ * @brief Return block to pool, adjacent free blocks are merged.
+ * 
+ * @param pxPool pointer to pool control structure.
+ * @param pvBlock block returned by AUDIO_POOL_alloc.
+ */
+void AUDIO_POOL_free(audio_pool_t *pxPool, void *pvBlock);
+
+/**
+ * @brief Get number of free bytes in pool.
+ * 
+ * @param pxPool pointer to pool control structure.
+ * @return uint32_t free bytes, sum of all free blocks.
+ */
+uint32_t AUDIO_POOL_get_free(audio_pool_t *pxPool);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /*__AUDIO_POOL_H__ */
+
+/* EOF */
@@ -37,6 +37,38 @@ extern "C" {
  */
 float AUDIO_TOOL_lin_map(float x, float in_min, float in_max, float out_min, float out_max);
 
+/**
+ * @brief Fast base 2 logarithm approximation, max error around 0.005.
+ * 
+ * @param x input value, must be greater than 0.
+ * @return float approximation of log2(x).
+ */
+float AUDIO_TOOL_fast_log2(float x);
+
+/**
+ * @brief Fast base 2 exponential approximation, relative error around 0.02%.
+ * 
+ * @param x input value, clamped to range -126.0 to 126.0.
+ * @return float approximation of 2^x.
+ */
+float AUDIO_TOOL_fast_exp2(float x);
+
+/**
+ * @brief Convert linear amplitude to dB using fast log2.
+ * 
+ * @param x linear amplitude, must be greater than 0.
+ * @return float amplitude in dB.
+ */
+float AUDIO_TOOL_lin_to_db(float x);
+
+/**
+ * @brief Convert dB to linear amplitude using fast exp2.
+ * 
+ * @param x amplitude in dB.
+ * @return float linear amplitude.
+ */
+float AUDIO_TOOL_db_to_lin(float x);
+
 #ifdef __cplusplus
 }
 #endif
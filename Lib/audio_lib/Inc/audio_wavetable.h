@@ -22,6 +22,28 @@ extern "C" {
 
 /* Exported types ------------------------------------------------------------*/
 
+/**
+ * @brief Wavetable sample storage. Samples are Q15 values, kept in int16 by
+ *        default to halve flash use and bus traffic. Defining
+ *        AUDIO_WAVE_FLOAT_STORAGE stores the same values as float.
+ * 
+ */
+#ifdef AUDIO_WAVE_FLOAT_STORAGE
+typedef float audio_wave_sample_t;
+#else
+typedef int16_t audio_wave_sample_t;
+#endif
+
+/**
+ * @brief Wavetable bank, frames of same size stored one after the other.
+ * 
+ */
+typedef struct AudioWaveBank {
+    const audio_wave_sample_t *pxFrames;    /**< First sample of first frame */
+    uint32_t u32FrameNum;           /**< Number of frames in bank */
+    uint32_t u32FrameSize;          /**< Samples per frame, power of 2 */
+} AudioWaveBank_t;
+
 /**
  * @brief Voice control structure.
  * 
@@ -31,12 +53,25 @@ typedef struct AudiowaveTableVoice {
     float fFreq;                    /**< Current frequency in Hz */
     float fCurrentSample;           /**< Index of current sample */
     float fSubCurrentSample;        /**< Index of current sub-oscilator sample */
+    float fPhaseInc;                /**< Index increment per sample */
+    float fSubPhaseInc;             /**< Sub-oscilator index increment per sample */
+    float fPitchMod;                /**< Pitch multiplier shared by all voices, bend and vibrato */
+    float fPhaseStep;               /**< Index increment with pitch multiplier applied */
+    float fSubPhaseStep;            /**< Sub-oscilator increment with pitch multiplier applied */
     float fMaxAmplitude;            /**< Max signal amplitude */
     float fAmplitude;               /**< Current amplitude */
+    float fOutGain;                 /**< Amplitude with Q15 sample scale folded in */
     float fDetune;                  /**< Detune factor */
+    float fMorph;                   /**< Current position in bank, in frames */
+    float fMorphTarget;             /**< Morph position to reach */
+    float fMorphInc;                /**< Morph increment per sample while gliding */
+    uint32_t u32MorphSteps;         /**< Samples left to reach morph target */
+    const audio_wave_sample_t *pxFadeFrameA;    /**< Lower frame faded out after wave select */
+    const audio_wave_sample_t *pxFadeFrameB;    /**< Upper frame faded out after wave select */
+    float fFadeFraction;            /**< Weight of upper faded frame */
+    uint32_t u32FadeSteps;          /**< Samples left of crossfade */
     uint32_t u32SampleRate;         /**< Signal sample rate */
-    const float *pu32WaveTable;     /**< Pointer to wave table in flash */
-    uint32_t u32WaveTableSize;      /**< Size of wave table */
+    const AudioWaveBank_t *pxBank;  /**< Wavetable bank in use */
     audio_wave_id_t eWaveId;        /**< Selector of wave table */
 } AudioWaveTableVoice_t;
 
@@ -52,6 +87,8 @@ typedef struct AudiowaveTableVoice {
 #define AUDIO_WAVE_NON_DETUNE       ( 0.0F )
 #define AUDIO_WAVE_MIN_DETUNE       ( -1.0F )
 
+#define AUDIO_WAVE_MIN_MORPH        ( 0.0F )
+
 /* Exported functions prototypes ---------------------------------------------*/
 
 /**
@@ -64,7 +101,10 @@ typedef struct AudiowaveTableVoice {
 audio_ret_t AUDIO_WAVE_init_voice(AudioWaveTableVoice_t *pVoice, uint32_t u32SampleRate, float fMaxAmplitude );
 
 /**
- * @brief Select waveform for voice.
+ * @brief Select waveform for voice. A playing voice crossfades from its
+ *        current frames to the selected one, morph position jumps to it
+ *        without gliding through frames in between. Selecting a user wave
+ *        switches voice to the RAM bank.
  * 
  * @param pVoice pointer to control structure to apply new wave table.
  * @param eWave wave id to use.
@@ -72,6 +112,33 @@ audio_ret_t AUDIO_WAVE_init_voice(AudioWaveTableVoice_t *pVoice, uint32_t u32Sam
  */
 audio_ret_t AUDIO_WAVE_change_wave(AudioWaveTableVoice_t *pVoice, audio_wave_id_t eWave);
 
+/**
+ * @brief Load user wave frame in RAM bank from Q15 samples.
+ * 
+ * @param eWave user wave id, AUDIO_WAVE_USER_0 and following.
+ * @param pi16Data Q15 samples of frame.
+ * @param u32Size number of samples, must match frame size.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_WAVE_load_user_frame(audio_wave_id_t eWave, const int16_t *pi16Data, uint32_t u32Size);
+
+/**
+ * @brief Get number of samples of each wavetable frame.
+ * 
+ * @return uint32_t samples per frame.
+ */
+uint32_t AUDIO_WAVE_get_frame_size(void);
+
+/**
+ * @brief Set morph position inside current bank. Position glides from the
+ *        current one in a few milliseconds to avoid clicks.
+ * 
+ * @param pVoice pointer to control structure to update.
+ * @param fMorph new position in frames, 0.0 to number of frames - 1.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_WAVE_update_morph(AudioWaveTableVoice_t *pVoice, float fMorph);
+
 /**
  * @brief Update output frequency of wavetable voice.
  * 
@@ -99,6 +166,16 @@ audio_ret_t AUDIO_WAVE_update_amp(AudioWaveTableVoice_t *pVoice, float fAmp);
  */
 audio_ret_t AUDIO_WAVE_update_detune(AudioWaveTableVoice_t *pVoice, float fDetuneLvl);
 
+/**
+ * @brief Update pitch multiplier applied on top of voice frequency. Meant to
+ *        be updated once per block, also applies to notes started later.
+ * 
+ * @param pVoice pointer of control structure to update.
+ * @param fPitchMod frequency ratio, 1.0 for no modulation.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t AUDIO_WAVE_update_pitch_mod(AudioWaveTableVoice_t *pVoice, float fPitchMod);
+
 /**
  * @brief Set active state in provided voice.
  * 
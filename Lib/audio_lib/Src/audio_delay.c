@@ -88,7 +88,7 @@ float AUDIO_DELAY_get_max_delay(AudioDelayCtrl_t *pxDelayCtrl)
     return pxDelayCtrl->u32SampleRate * (float)pxDelayCtrl->u32BufferSize;
 }
 
-float AUDIO_DELAY_process(AudioDelayCtrl_t *pxDelayCtrl, float fInputSample)
+AUDIO_RAMFUNC float AUDIO_DELAY_process(AudioDelayCtrl_t *pxDelayCtrl, float fInputSample)
 {
     ERR_ASSERT( pxDelayCtrl != NULL );
     ERR_ASSERT( pxDelayCtrl->fFeedback < 1.0F );
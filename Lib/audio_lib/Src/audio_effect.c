@@ -15,136 +15,363 @@
 #include "audio_filter.h"
 #include "audio_delay.h"
 
+#include <string.h>
+
 /* Private typedef -----------------------------------------------------------*/
 
+/* Effect init function format */
+typedef audio_ret_t (*effect_init)(void *pvEffect, float fSampleRate);
+
 /* Effect render function format */
-typedef float (*effect_render)(float fInputData);
+typedef float (*effect_render)(void *pvEffect, float fInputData);
 
-/* Handler structure for effects */
-typedef struct effect_handler {
-    audio_effect_id_t eId;
-    bool bActive;
+/* Effect parameter set function format */
+typedef audio_ret_t (*effect_set_param)(void *pvEffect, audio_effect_parameter_id_t eId, float fNewValue);
+
+/* Effect parameter get function format */
+typedef audio_ret_t (*effect_get_param)(void *pvEffect, audio_effect_parameter_id_t eId, float *pfValue);
+
+/* Effect description, one for each effect id */
+typedef struct effect_desc {
+    uint32_t u32InstanceSize;
+    effect_init Init;
     effect_render Render;
-} effect_handler_t;
+    effect_set_param SetParam;
+    effect_get_param GetParam;
+} effect_desc_t;
+
+/* Effect instance, data of effect follows the header in the same pool block */
+typedef struct audio_effect_instance {
+    const effect_desc_t *pxDesc;
+    void *pvData;
+    audio_effect_id_t eId;
+} effect_instance_t;
+
+/* Delay effect data */
+typedef struct effect_delay {
+    AudioDelayCtrl_t xCtrl;
+    float fBuffer[];
+} effect_delay_t;
 
 /* Private define ------------------------------------------------------------*/
 
 #define AUDIO_DELAY_BUFF_SIZE       ( 9600U ) // Max 0.2s delay
 
+/* Size of instance header inside pool block */
+#define EFFECT_HDR_SIZE             ( (sizeof(effect_instance_t) + (AUDIO_POOL_ALIGN - 1U)) & ~(AUDIO_POOL_ALIGN - 1U) )
+
+/* Arena bytes taken by an effect instance */
+#define EFFECT_BLOCK_SIZE(size)     ( AUDIO_POOL_BLOCK_HDR_SIZE + EFFECT_HDR_SIZE + \
+                                      (((size) + (AUDIO_POOL_ALIGN - 1U)) & ~(AUDIO_POOL_ALIGN - 1U)) )
+
+/* Default chain, one delay and filters on the other slots, must always fit */
+_Static_assert(AUDIO_EFFECT_POOL_SIZE >= (EFFECT_BLOCK_SIZE(sizeof(effect_delay_t) + (AUDIO_DELAY_BUFF_SIZE * sizeof(float))) +
+                                          ((AUDIO_EFFECT_SLOT_NUM - 1U) * EFFECT_BLOCK_SIZE(sizeof(AudioFilterLP_t)))),
+               "AUDIO_EFFECT_POOL_SIZE too small for default effect chain");
+
 /* Private macro -------------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+static audio_ret_t init_filter(void *pvEffect, float fSampleRate);
+static float render_filter(void *pvEffect, float fInputData);
+static audio_ret_t set_param_filter(void *pvEffect, audio_effect_parameter_id_t eId, float fNewValue);
+static audio_ret_t get_param_filter(void *pvEffect, audio_effect_parameter_id_t eId, float *pfValue);
+
+static audio_ret_t init_delay(void *pvEffect, float fSampleRate);
+static float render_delay(void *pvEffect, float fInputData);
+static audio_ret_t set_param_delay(void *pvEffect, audio_effect_parameter_id_t eId, float fNewValue);
+static audio_ret_t get_param_delay(void *pvEffect, audio_effect_parameter_id_t eId, float *pfValue);
+
+/**
+ * @brief Take or give chain lock, if any.
+ * 
+ * @param pxChain effect chain.
+ * @param bLock true to lock.
+ */
+static inline void effect_lock(audio_effect_chain_t *pxChain, bool bLock);
+
 /* Private variables ---------------------------------------------------------*/
 
-/* Filter */
-AudioFilterLP_t xFilterLP = { 0U };
+/* Effect descriptions, AUDIO_EFFECT_NONE has no instance */
+const effect_desc_t pxEffectDescList[AUDIO_EFFECT_NUM] = {
+    [AUDIO_EFFECT_NONE] = {
+        .u32InstanceSize = 0U,
+        .Init = NULL,
+        .Render = NULL,
+        .SetParam = NULL,
+        .GetParam = NULL,
+    },
+    [AUDIO_EFFECT_FILTER_LP] = {
+        .u32InstanceSize = sizeof(AudioFilterLP_t),
+        .Init = init_filter,
+        .Render = render_filter,
+        .SetParam = set_param_filter,
+        .GetParam = get_param_filter,
+    },
+    [AUDIO_EFFECT_DELAY] = {
+        .u32InstanceSize = sizeof(effect_delay_t) + (AUDIO_DELAY_BUFF_SIZE * sizeof(float)),
+        .Init = init_delay,
+        .Render = render_delay,
+        .SetParam = set_param_delay,
+        .GetParam = get_param_delay,
+    },
+};
 
-/* Delay */
-float fDelayBuffer[AUDIO_DELAY_BUFF_SIZE] = { 0.0F };
-AudioDelayCtrl_t xDelayCtrl = { 0U };
+/* Private function definition -----------------------------------------------*/
 
-/* List of effect handlers */
-effect_handler_t pxEffectList[AUDIO_EFFECT_SLOT_NUM] = { 0U };
+static inline void effect_lock(audio_effect_chain_t *pxChain, bool bLock)
+{
+    if ( pxChain->xLockCB != NULL )
+    {
+        pxChain->xLockCB(bLock);
+    }
+}
 
-/* Private function prototypes -----------------------------------------------*/
+static audio_ret_t init_filter(void *pvEffect, float fSampleRate)
+{
+    AudioFilterLP_t *pxFilter = (AudioFilterLP_t *)pvEffect;
+
+    audio_ret_t eRetVal = AUDIO_FILTER_LP_init(pxFilter);
+
+    if ( eRetVal == AUDIO_OK )
+    {
+        eRetVal = AUDIO_FILTER_LP_set_samplerate(pxFilter, fSampleRate);
+    }
+
+    return eRetVal;
+}
 
-static float render_none(float fInputData)
+AUDIO_RAMFUNC static float render_filter(void *pvEffect, float fInputData)
 {
-    return 0.0F;
+    return AUDIO_FILTER_LP_process((AudioFilterLP_t *)pvEffect, fInputData);
 }
 
-static float render_filter(float fInputData)
+static audio_ret_t set_param_filter(void *pvEffect, audio_effect_parameter_id_t eId, float fNewValue)
 {
-    return AUDIO_FILTER_LP_process(&xFilterLP, fInputData);
+    AudioFilterLP_t *pxFilter = (AudioFilterLP_t *)pvEffect;
+    audio_ret_t eRetVal = AUDIO_PARAM_ERROR;
+
+    if ( eId == AUDIO_EFFECT_PARAMETER_FILTER_FREQ )
+    {
+        eRetVal = AUDIO_FILTER_LP_set_frequency(pxFilter, fNewValue);
+    }
+    else if ( eId == AUDIO_EFFECT_PARAMETER_FILTER_Q )
+    {
+        eRetVal = AUDIO_FILTER_LP_set_q(pxFilter, fNewValue);
+    }
+    else
+    {
+        // None
+    }
+
+    return eRetVal;
+}
+
+static audio_ret_t get_param_filter(void *pvEffect, audio_effect_parameter_id_t eId, float *pfValue)
+{
+    AudioFilterLP_t *pxFilter = (AudioFilterLP_t *)pvEffect;
+    audio_ret_t eRetVal = AUDIO_OK;
+
+    if ( eId == AUDIO_EFFECT_PARAMETER_FILTER_FREQ )
+    {
+        *pfValue = pxFilter->fFrequency;
+    }
+    else if ( eId == AUDIO_EFFECT_PARAMETER_FILTER_Q )
+    {
+        *pfValue = pxFilter->fQ;
+    }
+    else
+    {
+        eRetVal = AUDIO_PARAM_ERROR;
+    }
+
+    return eRetVal;
+}
+
+static audio_ret_t init_delay(void *pvEffect, float fSampleRate)
+{
+    effect_delay_t *pxDelay = (effect_delay_t *)pvEffect;
+
+    /* Pool memory is reused, clear old content */
+    memset(pxDelay->fBuffer, 0, AUDIO_DELAY_BUFF_SIZE * sizeof(float));
+
+    return AUDIO_DELAY_init(&pxDelay->xCtrl, (uint32_t)fSampleRate, pxDelay->fBuffer, AUDIO_DELAY_BUFF_SIZE);
 }
 
-static float render_delay(float fInputData)
+AUDIO_RAMFUNC static float render_delay(void *pvEffect, float fInputData)
 {
-    return AUDIO_DELAY_process(&xDelayCtrl, fInputData);
+    return AUDIO_DELAY_process(&((effect_delay_t *)pvEffect)->xCtrl, fInputData);
+}
+
+static audio_ret_t set_param_delay(void *pvEffect, audio_effect_parameter_id_t eId, float fNewValue)
+{
+    effect_delay_t *pxDelay = (effect_delay_t *)pvEffect;
+    audio_ret_t eRetVal = AUDIO_PARAM_ERROR;
+
+    if ( eId == AUDIO_EFFECT_PARAMETER_DELAY_TIME )
+    {
+        eRetVal = AUDIO_DELAY_update_delay(&pxDelay->xCtrl, fNewValue);
+    }
+    else if ( eId == AUDIO_EFFECT_PARAMETER_DELAY_FB )
+    {
+        eRetVal = AUDIO_DELAY_update_feedback(&pxDelay->xCtrl, fNewValue);
+    }
+    else
+    {
+        // None
+    }
+
+    return eRetVal;
+}
+
+static audio_ret_t get_param_delay(void *pvEffect, audio_effect_parameter_id_t eId, float *pfValue)
+{
+    effect_delay_t *pxDelay = (effect_delay_t *)pvEffect;
+    audio_ret_t eRetVal = AUDIO_OK;
+
+    if ( eId == AUDIO_EFFECT_PARAMETER_DELAY_TIME )
+    {
+        *pfValue = pxDelay->xCtrl.fDelayTime;
+    }
+    else if ( eId == AUDIO_EFFECT_PARAMETER_DELAY_FB )
+    {
+        *pfValue = pxDelay->xCtrl.fFeedback;
+    }
+    else
+    {
+        eRetVal = AUDIO_PARAM_ERROR;
+    }
+
+    return eRetVal;
 }
 
-/* Private function definition -----------------------------------------------*/
 /* Public function definition ------------------------------------------------*/
 
-void AUDIO_EFFECT_init(float fSampleRate)
+void AUDIO_EFFECT_init(audio_effect_chain_t *pxChain, float fSampleRate)
 {
+    ERR_ASSERT( pxChain != NULL );
+
+    pxChain->fSampleRate = fSampleRate;
+    pxChain->xLockCB = NULL;
+
     /* Init effect list */
     for ( uint32_t i = 0U; i < AUDIO_EFFECT_SLOT_NUM; i++ )
     {
-        pxEffectList[i].bActive = false;
-        pxEffectList[i].eId = AUDIO_EFFECT_NONE;
-        pxEffectList[i].Render = render_none;
+        pxChain->pxSlot[i].bActive = false;
+        pxChain->pxSlot[i].pxInstance = NULL;
     }
 
-    /* Initiate delay module */
-    AUDIO_DELAY_init(&xDelayCtrl, fSampleRate, fDelayBuffer, AUDIO_DELAY_BUFF_SIZE);
+    /* All instances are released with the pool */
+    (void)AUDIO_POOL_init(&pxChain->xPool, pxChain->pu64Arena, sizeof(pxChain->pu64Arena));
+}
+
+void AUDIO_EFFECT_set_lock_cb(audio_effect_chain_t *pxChain, audio_effect_lock_cb_t xLockCB)
+{
+    ERR_ASSERT( pxChain != NULL );
 
-    /* Initiate filter module */
-    AUDIO_FILTER_LP_init(&xFilterLP);
-    AUDIO_FILTER_LP_set_samplerate(&xFilterLP, fSampleRate);
+    pxChain->xLockCB = xLockCB;
 }
 
-audio_ret_t AUDIO_EFFECT_set_slot(audio_effect_slot_t eSlot, audio_effect_id_t eId)
+audio_ret_t AUDIO_EFFECT_set_slot(audio_effect_chain_t *pxChain, audio_effect_slot_t eSlot, audio_effect_id_t eId)
 {
+    ERR_ASSERT( pxChain != NULL );
+
     audio_ret_t eRetVal = AUDIO_PARAM_ERROR;
 
     if ( (eSlot < AUDIO_EFFECT_SLOT_NUM) && (eId < AUDIO_EFFECT_NUM) )
     {
-        pxEffectList[eSlot].eId = eId;
+        effect_instance_t *pxOld = pxChain->pxSlot[eSlot].pxInstance;
 
-        if ( eId == AUDIO_EFFECT_NONE )
-        {
-            pxEffectList[eSlot].bActive = false;
-            pxEffectList[eSlot].Render = render_none;
-        }
-        else if ( eId == AUDIO_EFFECT_FILTER_LP )
-        {
-            pxEffectList[eSlot].Render = render_filter;
-        }
-        else if ( eId == AUDIO_EFFECT_DELAY )
-        {
-            pxEffectList[eSlot].Render = render_delay;
-        }
-        else
+        eRetVal = AUDIO_OK;
+
+        if ( (pxOld == NULL) || (pxOld->eId != eId) )
         {
-            // None
+            /* Detach slot before release, render only sees complete instances.
+               Pool is only used here, alloc and init run without lock */
+            effect_lock(pxChain, true);
+            pxChain->pxSlot[eSlot].pxInstance = NULL;
+            effect_lock(pxChain, false);
+
+            AUDIO_POOL_free(&pxChain->xPool, pxOld);
+
+            if ( eId == AUDIO_EFFECT_NONE )
+            {
+                pxChain->pxSlot[eSlot].bActive = false;
+            }
+            else
+            {
+                const effect_desc_t *pxDesc = &pxEffectDescList[eId];
+                effect_instance_t *pxNew = AUDIO_POOL_alloc(&pxChain->xPool, EFFECT_HDR_SIZE + pxDesc->u32InstanceSize);
+
+                if ( pxNew != NULL )
+                {
+                    pxNew->pxDesc = pxDesc;
+                    pxNew->pvData = (uint8_t *)pxNew + EFFECT_HDR_SIZE;
+                    pxNew->eId = eId;
+
+                    eRetVal = pxDesc->Init(pxNew->pvData, pxChain->fSampleRate);
+
+                    if ( eRetVal == AUDIO_OK )
+                    {
+                        effect_lock(pxChain, true);
+                        pxChain->pxSlot[eSlot].pxInstance = pxNew;
+                        effect_lock(pxChain, false);
+                    }
+                    else
+                    {
+                        AUDIO_POOL_free(&pxChain->xPool, pxNew);
+                    }
+                }
+                else
+                {
+                    /* No room left in pool, slot remains empty */
+                    pxChain->pxSlot[eSlot].bActive = false;
+                    eRetVal = AUDIO_ERR;
+                }
+            }
         }
-
-        eRetVal = AUDIO_OK;
     }
 
     return eRetVal;
 }
 
-audio_effect_id_t AUDIO_EFFECT_get_slot(audio_effect_slot_t eSlot)
+audio_effect_id_t AUDIO_EFFECT_get_slot(audio_effect_chain_t *pxChain, audio_effect_slot_t eSlot)
 {
+    ERR_ASSERT( pxChain != NULL );
+
     audio_effect_id_t eEffectId = AUDIO_EFFECT_NONE;
 
-    if ( eSlot < AUDIO_EFFECT_SLOT_NUM )
+    if ( (eSlot < AUDIO_EFFECT_SLOT_NUM) && (pxChain->pxSlot[eSlot].pxInstance != NULL) )
     {
-        eEffectId = pxEffectList[eSlot].eId;
+        eEffectId = pxChain->pxSlot[eSlot].pxInstance->eId;
     }
 
     return eEffectId;
 }
 
-bool AUDIO_EFFECT_get_slot_act(audio_effect_slot_t eSlot)
+bool AUDIO_EFFECT_get_slot_act(audio_effect_chain_t *pxChain, audio_effect_slot_t eSlot)
 {
+    ERR_ASSERT( pxChain != NULL );
+
     bool bSlotActive = false;
 
     if ( eSlot < AUDIO_EFFECT_SLOT_NUM )
     {
-        bSlotActive = pxEffectList[eSlot].bActive;
+        bSlotActive = pxChain->pxSlot[eSlot].bActive;
     }
 
     return bSlotActive;
 }
 
-audio_ret_t AUDIO_EFFECT_activate_slot(audio_effect_slot_t eSlot, bool bActive)
+audio_ret_t AUDIO_EFFECT_activate_slot(audio_effect_chain_t *pxChain, audio_effect_slot_t eSlot, bool bActive)
 {
+    ERR_ASSERT( pxChain != NULL );
+
     audio_ret_t eRetVal = AUDIO_PARAM_ERROR;
 
     if ( eSlot < AUDIO_EFFECT_SLOT_NUM )
     {
-        pxEffectList[eSlot].bActive = bActive;
+        pxChain->pxSlot[eSlot].bActive = bActive;
 
         eRetVal = AUDIO_OK;
     }
@@ -152,81 +379,81 @@ audio_ret_t AUDIO_EFFECT_activate_slot(audio_effect_slot_t eSlot, bool bActive)
     return eRetVal;
 }
 
-audio_ret_t AUDIO_EFFECT_parameter_update(audio_effect_parameter_id_t eId, float fNewValue)
+audio_ret_t AUDIO_EFFECT_parameter_update(audio_effect_chain_t *pxChain, audio_effect_slot_t eSlot, audio_effect_parameter_id_t eId, float fNewValue)
 {
+    ERR_ASSERT( pxChain != NULL );
+
     audio_ret_t eRetVal = AUDIO_PARAM_ERROR;
 
-    if ( eId < AUDIO_EFFECT_PARAMETER_NUM )
+    if ( (eSlot <= AUDIO_EFFECT_SLOT_NUM) && (eId < AUDIO_EFFECT_PARAMETER_NUM) )
     {
-        if ( eId == AUDIO_EFFECT_PARAMETER_FILTER_FREQ )
-        {
-            eRetVal = AUDIO_FILTER_LP_set_frequency(&xFilterLP, fNewValue);
-        }
-        else if ( eId == AUDIO_EFFECT_PARAMETER_FILTER_Q )
-        {
-            eRetVal = AUDIO_FILTER_LP_set_q(&xFilterLP, fNewValue);
-        }
-        else if ( eId == AUDIO_EFFECT_PARAMETER_DELAY_TIME )
-        {
-            eRetVal = AUDIO_DELAY_update_delay(&xDelayCtrl, fNewValue);
-        }
-        else if ( eId == AUDIO_EFFECT_PARAMETER_DELAY_FB )
+        for ( uint32_t i = 0U; i < AUDIO_EFFECT_SLOT_NUM; i++ )
         {
-            eRetVal = AUDIO_DELAY_update_feedback(&xDelayCtrl, fNewValue);
-        }
-        else
-        {
-            // None
+            effect_instance_t *pxInstance = pxChain->pxSlot[i].pxInstance;
+
+            if ( ((eSlot == AUDIO_EFFECT_SLOT_NUM) || (eSlot == i)) && (pxInstance != NULL) )
+            {
+                audio_ret_t eSlotRet = pxInstance->pxDesc->SetParam(pxInstance->pvData, eId, fNewValue);
+
+                /* Any slot accepting the value is enough for broadcast updates */
+                if ( (eSlotRet == AUDIO_OK) || (eSlot == i) )
+                {
+                    eRetVal = eSlotRet;
+                }
+            }
         }
     }
 
     return eRetVal;
 }
 
-float AUDIO_EFFECT_parameter_get(audio_effect_parameter_id_t eId)
+float AUDIO_EFFECT_parameter_get(audio_effect_chain_t *pxChain, audio_effect_slot_t eSlot, audio_effect_parameter_id_t eId)
 {
+    ERR_ASSERT( pxChain != NULL );
+
     float fValue = 0.0F;
 
-    if ( eId < AUDIO_EFFECT_PARAMETER_NUM )
+    if ( (eSlot <= AUDIO_EFFECT_SLOT_NUM) && (eId < AUDIO_EFFECT_PARAMETER_NUM) )
     {
-        if ( eId == AUDIO_EFFECT_PARAMETER_FILTER_FREQ )
-        {
-            fValue = xFilterLP.fFrequency;
-        }
-        else if ( eId == AUDIO_EFFECT_PARAMETER_FILTER_Q )
-        {
-            fValue = xFilterLP.fQ;
-        }
-        else if ( eId == AUDIO_EFFECT_PARAMETER_DELAY_TIME )
-        {
-            fValue = xDelayCtrl.fDelayTime;
-        }
-        else if ( eId == AUDIO_EFFECT_PARAMETER_DELAY_FB )
-        {
-            fValue = xDelayCtrl.fFeedback;
-        }
-        else
+        for ( uint32_t i = 0U; i < AUDIO_EFFECT_SLOT_NUM; i++ )
         {
-            // None
+            effect_instance_t *pxInstance = pxChain->pxSlot[i].pxInstance;
+
+            if ( ((eSlot == AUDIO_EFFECT_SLOT_NUM) || (eSlot == i)) && (pxInstance != NULL) )
+            {
+                if ( pxInstance->pxDesc->GetParam(pxInstance->pvData, eId, &fValue) == AUDIO_OK )
+                {
+                    break;
+                }
+            }
         }
     }
 
     return fValue;
 }
 
-float AUDIO_EFFECT_render(float fInputData)
+uint32_t AUDIO_EFFECT_get_free_mem(audio_effect_chain_t *pxChain)
+{
+    ERR_ASSERT( pxChain != NULL );
+
+    return AUDIO_POOL_get_free(&pxChain->xPool);
+}
+
+AUDIO_RAMFUNC float AUDIO_EFFECT_render(audio_effect_chain_t *pxChain, float fInputData)
 {
     float fRenderData = fInputData;
 
     for ( uint32_t i = 0U; i < AUDIO_EFFECT_SLOT_NUM; i++ )
     {
-        if ( pxEffectList[i].bActive )
+        effect_instance_t *pxInstance = pxChain->pxSlot[i].pxInstance;
+
+        if ( pxChain->pxSlot[i].bActive && (pxInstance != NULL) )
         {
-            fRenderData = pxEffectList[i].Render(fRenderData);
+            fRenderData = pxInstance->pxDesc->Render(pxInstance->pvData, fRenderData);
         }
     }
 
     return fRenderData;
 }
 
-/* EOF */
\ No newline at end of file
+/* EOF */
@@ -13,8 +13,6 @@
 #include "audio_engine.h"
 #include "audio_hal.h"
 #include "audio_tools.h"
-#include "audio_wavetable.h"
-#include "audio_env_adsr.h"
 
 #include "arm_math.h"
 
@@ -22,131 +20,291 @@
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
 
-/* Disable midi velocity */
-#define DISABLE_VELOCITY
-
 /* System sample rate in Hz */
-#define AUDIO_SAMPLE_RATE           ( 48000U )
+#define AUDIO_SAMPLE_RATE           ( AUDIO_ENGINE_SAMPLE_RATE )
 
 /* Max value for dac */
 #define AUDIO_FULL_AMPLITUDE        ( 32767.0F )
-#define AUDIO_FULL_AMPLITUDE_P      ( 32766 )
-#define AUDIO_FULL_AMPLITUDE_M      ( -32767 )
-#define AUDIO_AMPLITUDE             ( AUDIO_FULL_AMPLITUDE / (float)(AUDIO_VOICE_NUM * 3.0F) )
+#define AUDIO_FULL_AMPLITUDE_P      ( 32766.0F )
+#define AUDIO_FULL_AMPLITUDE_M      ( -32767.0F )
+
+/* Voice amplitude in full scale units, master stage handles overloads */
+#define AUDIO_AMPLITUDE             ( 2.0F / (float)AUDIO_VOICE_NUM )
 #define AUDIO_AMPLITUDE_NONE        ( 0.0F )
 
 /* Audio out sample buffer, 2 channels, 1 position for channel (16b) */
-#define AUDIO_BUFF_DATA_WIDE        ( sizeof(uint16_t) )
-#define AUDIO_BUFF_SIZE             ( 64U )
+#define AUDIO_BUFF_SIZE             ( AUDIO_ENGINE_BUFF_SIZE )
 #define AUDIO_HALF_BUFF_SIZE        ( AUDIO_BUFF_SIZE / 2U )
 
+/* Number of samples rendered each half transfer, same data on L and R */
+#define AUDIO_BLOCK_SIZE            ( AUDIO_ENGINE_BLOCK_SIZE )
+
 /* Audio buffer critical positions for DMA transfer */
 #define AUDIO_BUFF_INIT_INDEX       ( 0U )
 #define AUDIO_BUFF_HALF_INDEX       ( AUDIO_HALF_BUFF_SIZE )
 
-/* Number of elements of 32b in the buffer */
-#define AUDIO_TRANSFER_SIZE         ( sizeof(u16AudioBuffer) / AUDIO_BUFF_DATA_WIDE )
+/* Number of elements of 16b in the buffer */
+#define AUDIO_TRANSFER_SIZE         ( AUDIO_BUFF_SIZE )
 
 /* Max midi note */
 #define MAX_MIDI_NOTE               ( 0x7F )
 
+/* Render average weight, 1/16 */
+#define AUDIO_STATS_AVG_SHIFT       ( 4U )
+
+/* Pitch modulation defaults and limits */
+#define PITCH_BEND_RANGE_DEFAULT    ( 2.0F )
+#define PITCH_BEND_RANGE_MAX        ( 24.0F )
+#define VIBRATO_RATE_DEFAULT        ( 5.5F )
+#define VIBRATO_RATE_MAX            ( 20.0F )
+#define VIBRATO_DEPTH_DEFAULT       ( 0.5F )
+#define VIBRATO_DEPTH_MAX           ( 2.0F )
+
+/* Per voice expression defaults and limits, bend range follows MPE default */
+#define EXPR_BEND_RANGE_DEFAULT     ( 48.0F )
+#define EXPR_BEND_RANGE_MAX         ( 96.0F )
+#define EXPR_PRESSURE_DEPTH_DEFAULT ( 0.5F )
+#define EXPR_TIMBRE_DEPTH_DEFAULT   ( 1.0F )
+#define EXPR_TIMBRE_CENTER          ( 0.5F )
+
+/* Out of range applied value, forces update on next block */
+#define EXPR_FORCE_UPDATE           ( -2.0F )
+
+/* Pressure gain smoothing, one pole per block and snap distance */
+#define EXPR_GAIN_COEF              ( 0.25F )
+#define EXPR_GAIN_SNAP              ( 0.0001F )
+
 /* Amplitude mapping*/
 #define MAX_AMP_DB_MAP              ( 0.0F )
 #define MIN_AMP_DB_MAP              ( -40.0F )
 
-/* Private macro -------------------------------------------------------------*/
-/* Private variables ---------------------------------------------------------*/
-
-/* System voice list */
-AudioWaveTableVoice_t xVoiceList[AUDIO_VOICE_NUM];
-
-/* Voice envelopes */
-env_adsr_ctrl_t xAdsrEnvList[AUDIO_VOICE_NUM];
+/* Max midi velocity, min velocity of a note on */
+#define MAX_MIDI_VEL                ( 127.0F )
+#define MIN_MIDI_VEL                ( 1.0F )
 
-/* Audio buffer */
-uint16_t u16AudioBuffer[AUDIO_BUFF_SIZE] = { 0U };
+/* Exponent range of power velocity curve */
+#define VEL_EXPONENT_MIN            ( 0.1F )
+#define VEL_EXPONENT_MAX            ( 10.0F )
 
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 
 /**
  * @brief Callback to handle i2s events.
  * 
  * @param event sys_i2s event.
+ * @param pvArg engine instance given on HAL init.
  */
-static void audio_hal_cb(audio_hal_event_t event);
+static void audio_hal_cb(audio_hal_event_t event, void *pvArg);
 
 /**
  * @brief Prepare data in audio buffer.
  * 
+ * @param pxEngine engine instance.
  * @param pu16Buffer Output audio buffer.
  * @param u16StartIndex Start of the index where put new data.
  */
-static void audio_update_buffer(uint16_t *pu16Buffer, uint16_t u16StartIndex);
+static void audio_update_buffer(audio_engine_t *pxEngine, uint16_t *pu16Buffer, uint16_t u16StartIndex);
+
+/**
+ * @brief Render half buffer and update profiling counters.
+ * 
+ * @param pxEngine engine instance.
+ * @param u16StartIndex first position of buffer to update.
+ */
+static void audio_render_block(audio_engine_t *pxEngine, uint16_t u16StartIndex);
+
+/**
+ * @brief Advance realtime parameters one block and update DSP with the ones
+ *        that moved.
+ * 
+ * @param pxEngine engine instance.
+ */
+static void audio_param_apply(audio_engine_t *pxEngine);
+
+/**
+ * @brief Load realtime parameters from current DSP state, glides in progress
+ *        are dropped. Called after values are set by other paths.
+ * 
+ * @param pxEngine engine instance.
+ */
+static void audio_param_sync(audio_engine_t *pxEngine);
+
+/**
+ * @brief Compute pitch multiplier from bend and vibrato and hand it to all
+ *        voices if it changed. Called once per block.
+ * 
+ * @param pxEngine engine instance.
+ */
+static void audio_pitch_update(audio_engine_t *pxEngine);
+
+/**
+ * @brief Convert equal tempered pitch to frequency.
+ * 
+ * @param fPitch pitch in semitones, 69.0 is A4 at 440 Hz.
+ * @return float frequency in Hz.
+ */
+static float audio_note_freq(float fPitch);
+
+/**
+ * @brief Apply pressure and timbre of each voice, run once per block after
+ *        pitch stage.
+ * 
+ * @param pxEngine engine instance.
+ */
+static void audio_expr_update(audio_engine_t *pxEngine);
+
+/**
+ * @brief Gain of voice for given pressure.
+ * 
+ * @param pxEngine engine instance.
+ * @param fPressure pressure, 0.0 to 1.0.
+ * @return float gain, 1.0 at full pressure.
+ */
+static float audio_expr_gain(audio_engine_t *pxEngine, float fPressure);
+
+/**
+ * @brief Drop timbre offset of voice after its morph was set by other path,
+ *        offset is applied again from new position on next block.
+ * 
+ * @param pxEngine engine instance.
+ * @param u32Voice voice index.
+ */
+static void audio_expr_morph_reset(audio_engine_t *pxEngine, uint32_t u32Voice);
 
 /**
  * @brief Update frquency of voice.
  * 
+ * @param pxEngine engine instance.
  * @param eVoice voice id to update.
  * @param bState new state, true for enable outrput, folse for disable output.
  * @return audio_ret_t operation result.
  */
-static audio_ret_t audio_cmd_set_state(audio_voice_id_t eVoice, bool bState);
+static audio_ret_t audio_cmd_set_state(audio_engine_t *pxEngine, audio_voice_id_t eVoice, bool bState);
 
 /**
  * @brief Update voice frequency.
  * 
+ * @param pxEngine engine instance.
  * @param eVoice voice id to update.
  * @param fFreq new frequency to apply on voice.
  * @return audio_ret_t operation result.
  */
-audio_ret_t audio_cmd_set_freq(audio_voice_id_t eVoice, float fFreq);
+audio_ret_t audio_cmd_set_freq(audio_engine_t *pxEngine, audio_voice_id_t eVoice, float fFreq);
 
 /**
  * @brief Set voice frequency from midi note.
  * 
+ * @param pxEngine engine instance.
  * @param eVoice voice to update.
  * @param u8MidiNote midi note.
  * @param u8MidiVel midi velocity.
  * @param bState channel output state.
  * @return audio_ret_t operation result.
  */
-audio_ret_t audio_cmd_set_midi_note(audio_voice_id_t eVoice, uint8_t u8MidiNote, uint8_t u8MidiVel, bool bActive);
+audio_ret_t audio_cmd_set_midi_note(audio_engine_t *pxEngine, audio_voice_id_t eVoice, uint8_t u8MidiNote, uint8_t u8MidiVel, bool bActive);
 
 /**
  * @brief Change current voice waveform.
  * 
+ * @param pxEngine engine instance.
  * @param eVoice voice id to update.
  * @param eWaveId waveform id to apply.
  * @return audio_ret_t operation result.
  */
-audio_ret_t audio_cmd_set_waveform(audio_voice_id_t eVoice, audio_wave_id_t eWaveId);
+audio_ret_t audio_cmd_set_waveform(audio_engine_t *pxEngine, audio_voice_id_t eVoice, audio_wave_id_t eWaveId);
 
 /**
  * @brief Change current voice detune.
  * 
+ * @param pxEngine engine instance.
  * @param eVoice voice id to update.
  * @param fDetuneLvl amount of detune, range -1.0 to 1.0.
  * @return audio_ret_t operation result.
  */
-audio_ret_t audio_cmd_set_detune(audio_voice_id_t eVoice, float fDetuneLvl);
+audio_ret_t audio_cmd_set_detune(audio_engine_t *pxEngine, audio_voice_id_t eVoice, float fDetuneLvl);
+
+/**
+ * @brief Change wavetable morph position of voice.
+ * 
+ * @param pxEngine engine instance.
+ * @param eVoice voice id to update.
+ * @param fMorph position in wavetable bank, in frames.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t audio_cmd_set_morph(audio_engine_t *pxEngine, audio_voice_id_t eVoice, float fMorph);
+
+/**
+ * @brief Update envelope of voice, applied on next trigger or stage change.
+ * 
+ * @param pxEngine engine instance.
+ * @param eVoice voice id to update.
+ * @param pxAdsr new envelope times in seconds and levels in range 0.0 to 1.0.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t audio_cmd_set_adsr(audio_engine_t *pxEngine, audio_voice_id_t eVoice, const audio_cmd_set_adsr_t *pxAdsr);
+
+/**
+ * @brief Update master bus parameter.
+ * 
+ * @param pxEngine engine instance.
+ * @param eParamId parameter to update.
+ * @param fNewValue new value of parameter.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t audio_cmd_master_update(audio_engine_t *pxEngine, audio_master_parameter_id_t eParamId, float fNewValue);
+
+/**
+ * @brief Load frame of user wave in RAM bank.
+ * 
+ * @param eWaveId user wave id to load.
+ * @param pi16Data Q15 samples of full frame.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t audio_cmd_load_user_wave(audio_wave_id_t eWaveId, const int16_t *pi16Data);
+
+/**
+ * @brief Release group of voices in one critical section, all of them enter
+ *        release stage on the same sample.
+ * 
+ * @param pxEngine engine instance.
+ * @param u32VoiceMask bit n set to release voice n.
+ * @return audio_ret_t operation result.
+ */
+audio_ret_t audio_cmd_release_voices(audio_engine_t *pxEngine, uint32_t u32VoiceMask);
+
+/**
+ * @brief Effect chain lock, masks audio ISR.
+ * 
+ * @param bLock true to lock.
+ */
+static void audio_effect_lock_cb(bool bLock);
 
 /* Private function definition -----------------------------------------------*/
 
-static void audio_hal_cb(audio_hal_event_t event)
+static void audio_effect_lock_cb(bool bLock)
+{
+    AUDIO_HAL_isr_ctrl(!bLock);
+}
+
+static void audio_hal_cb(audio_hal_event_t event, void *pvArg)
 {
+    audio_engine_t *pxEngine = (audio_engine_t *)pvArg;
+
     switch ( event )
     {
         case AUDIO_HAL_EVENT_TX_DONE:
-            audio_update_buffer(u16AudioBuffer, AUDIO_BUFF_HALF_INDEX);
+            audio_render_block(pxEngine, AUDIO_BUFF_HALF_INDEX);
             break;
 
         case AUDIO_HAL_EVENT_HALF_TX_DONE:
-            audio_update_buffer(u16AudioBuffer, AUDIO_BUFF_INIT_INDEX);
+            audio_render_block(pxEngine, AUDIO_BUFF_INIT_INDEX);
             break;
 
         case AUDIO_HAL_EVENT_ERROR:
             /* Reset interface */
-            AUDIO_HAL_send_buffer(u16AudioBuffer, AUDIO_TRANSFER_SIZE);
+            AUDIO_HAL_send_buffer(pxEngine->u16AudioBuffer, AUDIO_TRANSFER_SIZE);
             break;
 
         default:
@@ -154,11 +312,256 @@ static void audio_hal_cb(audio_hal_event_t event)
     }
 }
 
-static void audio_update_buffer(uint16_t *pu16Buffer, uint16_t u16StartIndex)
+static void audio_render_block(audio_engine_t *pxEngine, uint16_t u16StartIndex)
+{
+    uint32_t u32Start = AUDIO_HAL_get_cycles();
+
+    audio_param_apply(pxEngine);
+    audio_pitch_update(pxEngine);
+    audio_expr_update(pxEngine);
+
+    audio_update_buffer(pxEngine, pxEngine->u16AudioBuffer, u16StartIndex);
+
+    uint32_t u32Cycles = AUDIO_HAL_get_cycles() - u32Start;
+
+    pxEngine->xRenderStats.u32LastCycles = u32Cycles;
+    pxEngine->xRenderStats.u32AvgCycles += (u32Cycles >> AUDIO_STATS_AVG_SHIFT) - (pxEngine->xRenderStats.u32AvgCycles >> AUDIO_STATS_AVG_SHIFT);
+    pxEngine->xRenderStats.u32BlockCount++;
+
+    if ( u32Cycles > pxEngine->xRenderStats.u32MaxCycles )
+    {
+        pxEngine->xRenderStats.u32MaxCycles = u32Cycles;
+    }
+
+    pxEngine->u32SampleClock += AUDIO_BLOCK_SIZE;
+
+    if ( pxEngine->pBlockCB != NULL )
+    {
+        pxEngine->pBlockCB(pxEngine->u32SampleClock, pxEngine->pvBlockArg);
+    }
+}
+
+static void audio_param_apply(audio_engine_t *pxEngine)
+{
+    uint32_t u32Mask = AUDIO_PARAM_process(&pxEngine->xParams);
+
+    for (uint32_t u32Param = 0U; (u32Mask != 0U) && (u32Param < (uint32_t)AUDIO_PARAM_NUM); u32Param++)
+    {
+        if ( (u32Mask & (1UL << u32Param)) == 0U )
+        {
+            continue;
+        }
+
+        u32Mask &= ~(1UL << u32Param);
+
+        audio_param_id_t eParam = (audio_param_id_t)u32Param;
+        float fValue = AUDIO_PARAM_get_value(&pxEngine->xParams, eParam);
+
+        switch ( eParam )
+        {
+            case AUDIO_PARAM_FILTER_FREQ:
+                (void)AUDIO_EFFECT_parameter_update(&pxEngine->xEffects, AUDIO_EFFECT_SLOT_NUM, AUDIO_EFFECT_PARAMETER_FILTER_FREQ, fValue);
+                break;
+
+            case AUDIO_PARAM_FILTER_Q:
+                (void)AUDIO_EFFECT_parameter_update(&pxEngine->xEffects, AUDIO_EFFECT_SLOT_NUM, AUDIO_EFFECT_PARAMETER_FILTER_Q, fValue);
+                break;
+
+            case AUDIO_PARAM_DELAY_TIME:
+                (void)AUDIO_EFFECT_parameter_update(&pxEngine->xEffects, AUDIO_EFFECT_SLOT_NUM, AUDIO_EFFECT_PARAMETER_DELAY_TIME, fValue);
+                break;
+
+            case AUDIO_PARAM_DELAY_FB:
+                (void)AUDIO_EFFECT_parameter_update(&pxEngine->xEffects, AUDIO_EFFECT_SLOT_NUM, AUDIO_EFFECT_PARAMETER_DELAY_FB, fValue);
+                break;
+
+            case AUDIO_PARAM_PITCH_BEND:
+            case AUDIO_PARAM_MOD_WHEEL:
+                /* Read by pitch stage every block */
+                break;
+
+            default:
+                /* Voice parameters */
+                for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
+                {
+                    AudioWaveTableVoice_t *pxVoice = &pxEngine->xVoiceList[u32Voice];
+                    env_adsr_ctrl_t *pxAdsr = &pxEngine->xAdsrEnvList[u32Voice];
+
+                    if ( eParam == AUDIO_PARAM_DETUNE )
+                    {
+                        (void)AUDIO_WAVE_update_detune(pxVoice, fValue);
+                    }
+                    else if ( eParam == AUDIO_PARAM_ATTACK )
+                    {
+                        ADSR_set_attack_time(pxAdsr, fValue);
+                    }
+                    else if ( eParam == AUDIO_PARAM_DECAY )
+                    {
+                        ADSR_set_decay_time(pxAdsr, fValue);
+                    }
+                    else if ( eParam == AUDIO_PARAM_SUSTAIN )
+                    {
+                        /* Envelope keeps sustain under attack level */
+                        ADSR_set_sustain_lvl(pxAdsr, fValue);
+                    }
+                    else if ( eParam == AUDIO_PARAM_RELEASE )
+                    {
+                        ADSR_set_release_time(pxAdsr, fValue);
+                    }
+                    else if ( eParam == AUDIO_PARAM_MORPH )
+                    {
+                        (void)AUDIO_WAVE_update_morph(pxVoice, fValue * (float)(pxVoice->pxBank->u32FrameNum - 1U));
+                        audio_expr_morph_reset(pxEngine, u32Voice);
+                    }
+                }
+                break;
+        }
+    }
+}
+
+static void audio_param_sync(audio_engine_t *pxEngine)
+{
+    audio_param_bank_t *pxParams = &pxEngine->xParams;
+    AudioWaveTableVoice_t *pxVoice = &pxEngine->xVoiceList[0];
+    env_adsr_ctrl_t *pxAdsr = &pxEngine->xAdsrEnvList[0];
+    float fMaxMorph = (float)(pxVoice->pxBank->u32FrameNum - 1U);
+
+    AUDIO_PARAM_reset(pxParams, AUDIO_PARAM_FILTER_FREQ, AUDIO_EFFECT_parameter_get(&pxEngine->xEffects, AUDIO_EFFECT_SLOT_NUM, AUDIO_EFFECT_PARAMETER_FILTER_FREQ));
+    AUDIO_PARAM_reset(pxParams, AUDIO_PARAM_FILTER_Q, AUDIO_EFFECT_parameter_get(&pxEngine->xEffects, AUDIO_EFFECT_SLOT_NUM, AUDIO_EFFECT_PARAMETER_FILTER_Q));
+    AUDIO_PARAM_reset(pxParams, AUDIO_PARAM_DELAY_TIME, AUDIO_EFFECT_parameter_get(&pxEngine->xEffects, AUDIO_EFFECT_SLOT_NUM, AUDIO_EFFECT_PARAMETER_DELAY_TIME));
+    AUDIO_PARAM_reset(pxParams, AUDIO_PARAM_DELAY_FB, AUDIO_EFFECT_parameter_get(&pxEngine->xEffects, AUDIO_EFFECT_SLOT_NUM, AUDIO_EFFECT_PARAMETER_DELAY_FB));
+    AUDIO_PARAM_reset(pxParams, AUDIO_PARAM_DETUNE, pxVoice->fDetune);
+    AUDIO_PARAM_reset(pxParams, AUDIO_PARAM_ATTACK, ADSR_get_attack_time(pxAdsr));
+    AUDIO_PARAM_reset(pxParams, AUDIO_PARAM_DECAY, ADSR_get_decay_time(pxAdsr));
+    AUDIO_PARAM_reset(pxParams, AUDIO_PARAM_SUSTAIN, ADSR_get_sustain_lvl(pxAdsr));
+    AUDIO_PARAM_reset(pxParams, AUDIO_PARAM_RELEASE, ADSR_get_release_time(pxAdsr));
+    AUDIO_PARAM_reset(pxParams, AUDIO_PARAM_MORPH, ( fMaxMorph > 0.0F ) ? ((pxVoice->fMorphTarget - pxEngine->xExpr.xVoice[0].fMorphOffset) / fMaxMorph) : 0.0F);
+}
+
+static void audio_pitch_update(audio_engine_t *pxEngine)
+{
+    audio_pitch_ctrl_t *pxPitch = &pxEngine->xPitch;
+    float fSemitones = AUDIO_PARAM_get_value(&pxEngine->xParams, AUDIO_PARAM_PITCH_BEND) * pxPitch->fBendRange;
+    float fMod = AUDIO_PARAM_get_value(&pxEngine->xParams, AUDIO_PARAM_MOD_WHEEL);
+
+    if ( fMod > 0.0F )
+    {
+        pxPitch->fVibratoPhase += pxPitch->fVibratoRate * ((float)AUDIO_BLOCK_SIZE / (float)AUDIO_SAMPLE_RATE);
+        pxPitch->fVibratoPhase -= (float)(uint32_t)pxPitch->fVibratoPhase;
+
+        fSemitones += fMod * pxPitch->fVibratoDepth * sinf(2.0F * PI * pxPitch->fVibratoPhase);
+    }
+    else
+    {
+        /* Vibrato always starts from center pitch */
+        pxPitch->fVibratoPhase = 0.0F;
+    }
+
+    float fPitchMod = ( fSemitones != 0.0F ) ? powf(2.0F, fSemitones / 12.0F) : 1.0F;
+    bool bShared = ( fPitchMod != pxPitch->fPitchMod );
+    float fExprRange = pxEngine->xExpr.fBendRange;
+
+    pxPitch->fPitchMod = fPitchMod;
+
+    /* Unbent voices reuse shared multiplier, bent ones pay one powf when something moved */
+    for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
+    {
+        audio_voice_expr_t *pxVoiceExpr = &pxEngine->xExpr.xVoice[u32Voice];
+        float fBend = pxVoiceExpr->fBend;
+
+        if ( bShared || (fBend != pxVoiceExpr->fBendApplied) )
+        {
+            float fVoiceMod = fPitchMod;
+
+            if ( fBend != 0.0F )
+            {
+                fVoiceMod = powf(2.0F, (fSemitones + (fBend * fExprRange)) / 12.0F);
+            }
+
+            pxVoiceExpr->fBendApplied = fBend;
+
+            if ( fVoiceMod != pxVoiceExpr->fPitchMod )
+            {
+                pxVoiceExpr->fPitchMod = fVoiceMod;
+                (void)AUDIO_WAVE_update_pitch_mod(&pxEngine->xVoiceList[u32Voice], fVoiceMod);
+            }
+        }
+    }
+}
+
+static void audio_expr_update(audio_engine_t *pxEngine)
+{
+    audio_expr_ctrl_t *pxExpr = &pxEngine->xExpr;
+
+    for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
+    {
+        AudioWaveTableVoice_t *pxVoice = &pxEngine->xVoiceList[u32Voice];
+        audio_voice_expr_t *pxVoiceExpr = &pxExpr->xVoice[u32Voice];
+        float fGain = audio_expr_gain(pxEngine, pxVoiceExpr->fPressure);
+        float fTimbre = pxVoiceExpr->fTimbre;
+
+        if ( fGain != pxVoiceExpr->fGain )
+        {
+            /* Pressure arrives in 7 bit steps, glide to avoid zipper noise */
+            if ( fabsf(fGain - pxVoiceExpr->fGain) > EXPR_GAIN_SNAP )
+            {
+                fGain = pxVoiceExpr->fGain + (EXPR_GAIN_COEF * (fGain - pxVoiceExpr->fGain));
+            }
+
+            pxVoiceExpr->fGain = fGain;
+            (void)AUDIO_WAVE_update_amp(pxVoice, pxVoiceExpr->fVelAmp * fGain);
+        }
+
+        if ( fTimbre != pxVoiceExpr->fTimbreApplied )
+        {
+            float fMaxMorph = (float)(pxVoice->pxBank->u32FrameNum - 1U);
+            float fBase = pxVoice->fMorphTarget - pxVoiceExpr->fMorphOffset;
+            float fMorph = fBase + ((fTimbre - EXPR_TIMBRE_CENTER) * pxExpr->fTimbreDepth * fMaxMorph);
+
+            if ( fMorph < 0.0F )
+            {
+                fMorph = 0.0F;
+            }
+            else if ( fMorph > fMaxMorph )
+            {
+                fMorph = fMaxMorph;
+            }
+
+            /* Keep offset really applied, so base is recovered after clamping */
+            pxVoiceExpr->fMorphOffset = fMorph - fBase;
+            pxVoiceExpr->fTimbreApplied = fTimbre;
+            (void)AUDIO_WAVE_update_morph(pxVoice, fMorph);
+        }
+    }
+}
+
+static float audio_expr_gain(audio_engine_t *pxEngine, float fPressure)
+{
+    return 1.0F - (pxEngine->xExpr.fPressureDepth * (1.0F - fPressure));
+}
+
+static void audio_expr_morph_reset(audio_engine_t *pxEngine, uint32_t u32Voice)
+{
+    audio_voice_expr_t *pxVoiceExpr = &pxEngine->xExpr.xVoice[u32Voice];
+
+    pxVoiceExpr->fMorphOffset = 0.0F;
+
+    if ( pxVoiceExpr->fTimbreApplied != EXPR_TIMBRE_CENTER )
+    {
+        pxVoiceExpr->fTimbreApplied = EXPR_FORCE_UPDATE;
+    }
+}
+
+static float audio_note_freq(float fPitch)
+{
+    return 440.0F * powf(2.0F, (fPitch - 69.0F) / 12.0F);
+}
+
+AUDIO_RAMFUNC static void audio_update_buffer(audio_engine_t *pxEngine, uint16_t *pu16Buffer, uint16_t u16StartIndex)
 {
     AUDIO_HAL_gpio_ctrl(true);
 
-    for (uint32_t i = 0; i < AUDIO_HALF_BUFF_SIZE; i += 2U)
+    for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; i++)
     {
         float fData = 0.0F;
 
@@ -166,33 +569,41 @@ static void audio_update_buffer(uint16_t *pu16Buffer, uint16_t u16StartIndex)
         for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
         {
             // Get envelope data
-            float fAdsrData = ADSR_process(&xAdsrEnvList[u32Voice]);
+            float fAdsrData = ADSR_process(&pxEngine->xAdsrEnvList[u32Voice]);
             // Get voice data 
-            float fVoiceData = AUDIO_WAVE_get_next_sample(&xVoiceList[u32Voice]);
+            float fVoiceData = AUDIO_WAVE_get_next_sample(&pxEngine->xVoiceList[u32Voice]);
             // Agregate all voice data
             fData += fAdsrData * fVoiceData;
 
             // Handle voice deactivation
-            if ( xVoiceList[u32Voice].bActive && !ADSR_is_active(&xAdsrEnvList[u32Voice]) )
+            if ( pxEngine->xVoiceList[u32Voice].bActive && !ADSR_is_active(&pxEngine->xAdsrEnvList[u32Voice]) )
             {
-                AUDIO_WAVE_set_active(&xVoiceList[u32Voice], false);
+                AUDIO_WAVE_set_active(&pxEngine->xVoiceList[u32Voice], false);
             }
         }
 
         // Add effect section
-        fData = AUDIO_EFFECT_render(fData);
+        pxEngine->fRenderBlock[i] = AUDIO_EFFECT_render(&pxEngine->xEffects, fData);
+    }
 
-        // Check DAC boundaries to prevent signal rollback
-        int16_t i16DacData = (int16_t)fData;
-        if ( i16DacData > AUDIO_FULL_AMPLITUDE_P )
+    // Master section, output bounded to full scale
+    AUDIO_MASTER_process(&pxEngine->xMaster, pxEngine->fRenderBlock, AUDIO_BLOCK_SIZE);
+
+    for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; i++)
+    {
+        // Check DAC boundaries before conversion to prevent signal rollback
+        float fDacData = pxEngine->fRenderBlock[i] * AUDIO_FULL_AMPLITUDE;
+        if ( fDacData > AUDIO_FULL_AMPLITUDE_P )
         {
-            i16DacData = AUDIO_FULL_AMPLITUDE_P;
+            fDacData = AUDIO_FULL_AMPLITUDE_P;
         }
-        else if ( i16DacData < AUDIO_FULL_AMPLITUDE_M )
+        else if ( fDacData < AUDIO_FULL_AMPLITUDE_M )
         {
-            i16DacData = AUDIO_FULL_AMPLITUDE_M;
+            fDacData = AUDIO_FULL_AMPLITUDE_M;
         }
 
+        int16_t i16DacData = (int16_t)fDacData;
+
         // Channel L
         pu16Buffer[u16StartIndex++] = i16DacData;
         // Channel R
@@ -202,7 +613,7 @@ static void audio_update_buffer(uint16_t *pu16Buffer, uint16_t u16StartIndex)
     AUDIO_HAL_gpio_ctrl(false);
 }
 
-audio_ret_t audio_cmd_set_state(audio_voice_id_t eVoice, bool bState)
+audio_ret_t audio_cmd_set_state(audio_engine_t *pxEngine, audio_voice_id_t eVoice, bool bState)
 {
     ERR_ASSERT(eVoice <= AUDIO_VOICE_NUM);
 
@@ -215,12 +626,12 @@ audio_ret_t audio_cmd_set_state(audio_voice_id_t eVoice, bool bState)
             /* Handle ADSR section */
             if ( bState )
             {
-                AUDIO_WAVE_set_active(&xVoiceList[u32Voice], bState);
-                ADSR_trigger(&xAdsrEnvList[u32Voice]);
+                AUDIO_WAVE_set_active(&pxEngine->xVoiceList[u32Voice], bState);
+                ADSR_trigger(&pxEngine->xAdsrEnvList[u32Voice]);
             }
             else
             {
-                ADSR_release(&xAdsrEnvList[u32Voice]);
+                ADSR_release(&pxEngine->xAdsrEnvList[u32Voice]);
             }
         }
     }
@@ -229,12 +640,12 @@ audio_ret_t audio_cmd_set_state(audio_voice_id_t eVoice, bool bState)
         /* Handle ADSR section */
         if ( bState )
         {
-            (void)AUDIO_WAVE_set_active(&xVoiceList[eVoice], bState);
-            ADSR_trigger(&xAdsrEnvList[eVoice]);
+            (void)AUDIO_WAVE_set_active(&pxEngine->xVoiceList[eVoice], bState);
+            ADSR_trigger(&pxEngine->xAdsrEnvList[eVoice]);
         }
         else
         {
-            ADSR_release(&xAdsrEnvList[eVoice]);
+            ADSR_release(&pxEngine->xAdsrEnvList[eVoice]);
         }
     }
 
@@ -243,7 +654,7 @@ audio_ret_t audio_cmd_set_state(audio_voice_id_t eVoice, bool bState)
     return AUDIO_OK;
 }
 
-audio_ret_t audio_cmd_set_freq(audio_voice_id_t eVoice, float fFreq)
+audio_ret_t audio_cmd_set_freq(audio_engine_t *pxEngine, audio_voice_id_t eVoice, float fFreq)
 {
     ERR_ASSERT(eVoice <= AUDIO_VOICE_NUM);
 
@@ -253,12 +664,12 @@ audio_ret_t audio_cmd_set_freq(audio_voice_id_t eVoice, float fFreq)
     {
         for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
         {
-            (void)AUDIO_WAVE_update_freq(&xVoiceList[u32Voice], fFreq);
+            (void)AUDIO_WAVE_update_freq(&pxEngine->xVoiceList[u32Voice], fFreq);
         }
     }
     else
     {
-        (void)AUDIO_WAVE_update_freq(&xVoiceList[eVoice], fFreq);
+        (void)AUDIO_WAVE_update_freq(&pxEngine->xVoiceList[eVoice], fFreq);
     }
 
     AUDIO_HAL_isr_ctrl(true);
@@ -266,19 +677,15 @@ audio_ret_t audio_cmd_set_freq(audio_voice_id_t eVoice, float fFreq)
     return AUDIO_OK;
 }
 
-audio_ret_t audio_cmd_set_midi_note(audio_voice_id_t eVoice, uint8_t u8MidiNote, uint8_t u8MidiVel, bool bActive)
+audio_ret_t audio_cmd_set_midi_note(audio_engine_t *pxEngine, audio_voice_id_t eVoice, uint8_t u8MidiNote, uint8_t u8MidiVel, bool bActive)
 {
     ERR_ASSERT(eVoice <= AUDIO_VOICE_NUM);
     ERR_ASSERT(u8MidiNote <= MAX_MIDI_NOTE);
     ERR_ASSERT(u8MidiVel <= MAX_MIDI_NOTE);
 
-    float fFreq = 440.0F * powf(2.0F, ((float)u8MidiNote - 69.0F) / 12.0F);
-#ifdef DISABLE_VELOCITY
-    float fAmp = 1.0F;
-#else
-    float fdB = AUDIO_TOOL_lin_map((int)u8MidiVel, 1.0F, 127.0F, MIN_AMP_DB_MAP, MAX_AMP_DB_MAP);
-    float fAmp = powf(10.0F, fdB / 20.0F);
-#endif
+    float fFreq = pxEngine->fNoteFreq[u8MidiNote];
+    float fAmp = pxEngine->xVelocity.fGain[u8MidiVel];
+    float fAttackScale = 1.0F - (pxEngine->xVelocity.fAttackSens * fAmp);
 
     AUDIO_HAL_isr_ctrl(false);
 
@@ -286,35 +693,45 @@ audio_ret_t audio_cmd_set_midi_note(audio_voice_id_t eVoice, uint8_t u8MidiNote,
     {
         for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
         {
-            (void)AUDIO_WAVE_update_freq(&xVoiceList[u32Voice], fFreq);
-            (void)AUDIO_WAVE_update_amp(&xVoiceList[u32Voice], fAmp);
+            (void)AUDIO_WAVE_update_freq(&pxEngine->xVoiceList[u32Voice], fFreq);
 
-            /* Handle ADSR section */
+            /* Handle ADSR section, release keeps level set by note on */
             if ( bActive )
             {
-                (void)AUDIO_WAVE_set_active(&xVoiceList[u32Voice], bActive);
-                ADSR_trigger(&xAdsrEnvList[u32Voice]);
+                audio_voice_expr_t *pxVoiceExpr = &pxEngine->xExpr.xVoice[u32Voice];
+
+                /* Pressure set before note on is used from first sample */
+                pxVoiceExpr->fVelAmp = fAmp;
+                pxVoiceExpr->fGain = audio_expr_gain(pxEngine, pxVoiceExpr->fPressure);
+                (void)AUDIO_WAVE_update_amp(&pxEngine->xVoiceList[u32Voice], fAmp * pxVoiceExpr->fGain);
+                (void)AUDIO_WAVE_set_active(&pxEngine->xVoiceList[u32Voice], bActive);
+                ADSR_trigger_scaled(&pxEngine->xAdsrEnvList[u32Voice], fAttackScale);
             }
             else
             {
-                ADSR_release(&xAdsrEnvList[u32Voice]);
+                ADSR_release(&pxEngine->xAdsrEnvList[u32Voice]);
             }
         }
     }
     else
     {
-        (void)AUDIO_WAVE_update_freq(&xVoiceList[eVoice], fFreq);
-        (void)AUDIO_WAVE_update_amp(&xVoiceList[eVoice], fAmp);
+        (void)AUDIO_WAVE_update_freq(&pxEngine->xVoiceList[eVoice], fFreq);
 
-        /* Handle ADSR section */
+        /* Handle ADSR section, release keeps level set by note on */
         if ( bActive )
         {
-            (void)AUDIO_WAVE_set_active(&xVoiceList[eVoice], bActive);
-            ADSR_trigger(&xAdsrEnvList[eVoice]);
+            audio_voice_expr_t *pxVoiceExpr = &pxEngine->xExpr.xVoice[eVoice];
+
+            /* Pressure set before note on is used from first sample */
+            pxVoiceExpr->fVelAmp = fAmp;
+            pxVoiceExpr->fGain = audio_expr_gain(pxEngine, pxVoiceExpr->fPressure);
+            (void)AUDIO_WAVE_update_amp(&pxEngine->xVoiceList[eVoice], fAmp * pxVoiceExpr->fGain);
+            (void)AUDIO_WAVE_set_active(&pxEngine->xVoiceList[eVoice], bActive);
+            ADSR_trigger_scaled(&pxEngine->xAdsrEnvList[eVoice], fAttackScale);
         }
         else
         {
-            ADSR_release(&xAdsrEnvList[eVoice]);
+            ADSR_release(&pxEngine->xAdsrEnvList[eVoice]);
         }
     }
 
@@ -323,7 +740,7 @@ audio_ret_t audio_cmd_set_midi_note(audio_voice_id_t eVoice, uint8_t u8MidiNote,
     return AUDIO_OK;
 }
 
-audio_ret_t audio_cmd_set_waveform(audio_voice_id_t eVoice, audio_wave_id_t eWaveId)
+audio_ret_t audio_cmd_set_waveform(audio_engine_t *pxEngine, audio_voice_id_t eVoice, audio_wave_id_t eWaveId)
 {
     ERR_ASSERT(eVoice <= AUDIO_VOICE_NUM);
     ERR_ASSERT(eWaveId < AUDIO_WAVE_NUM);
@@ -334,12 +751,14 @@ audio_ret_t audio_cmd_set_waveform(audio_voice_id_t eVoice, audio_wave_id_t eWav
     {
         for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
         {
-            (void)AUDIO_WAVE_change_wave(&xVoiceList[u32Voice], eWaveId);
+            (void)AUDIO_WAVE_change_wave(&pxEngine->xVoiceList[u32Voice], eWaveId);
+            audio_expr_morph_reset(pxEngine, u32Voice);
         }
     }
     else
     {
-        (void)AUDIO_WAVE_change_wave(&xVoiceList[eVoice], eWaveId);
+        (void)AUDIO_WAVE_change_wave(&pxEngine->xVoiceList[eVoice], eWaveId);
+        audio_expr_morph_reset(pxEngine, (uint32_t)eVoice);
     }
 
     AUDIO_HAL_isr_ctrl(true);
@@ -347,7 +766,7 @@ audio_ret_t audio_cmd_set_waveform(audio_voice_id_t eVoice, audio_wave_id_t eWav
     return AUDIO_OK;
 }
 
-audio_ret_t audio_cmd_set_detune(audio_voice_id_t eVoice, float fDetuneLvl)
+audio_ret_t audio_cmd_set_detune(audio_engine_t *pxEngine, audio_voice_id_t eVoice, float fDetuneLvl)
 {
     ERR_ASSERT(eVoice <= AUDIO_VOICE_NUM);
 
@@ -357,12 +776,12 @@ audio_ret_t audio_cmd_set_detune(audio_voice_id_t eVoice, float fDetuneLvl)
     {
         for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
         {
-            (void)AUDIO_WAVE_update_detune(&xVoiceList[u32Voice], fDetuneLvl);
+            (void)AUDIO_WAVE_update_detune(&pxEngine->xVoiceList[u32Voice], fDetuneLvl);
         }
     }
     else
     {
-        (void)AUDIO_WAVE_update_detune(&xVoiceList[eVoice], fDetuneLvl);
+        (void)AUDIO_WAVE_update_detune(&pxEngine->xVoiceList[eVoice], fDetuneLvl);
     }
 
     AUDIO_HAL_isr_ctrl(true);
@@ -370,29 +789,204 @@ audio_ret_t audio_cmd_set_detune(audio_voice_id_t eVoice, float fDetuneLvl)
     return AUDIO_OK;
 }
 
+audio_ret_t audio_cmd_set_morph(audio_engine_t *pxEngine, audio_voice_id_t eVoice, float fMorph)
+{
+    ERR_ASSERT(eVoice <= AUDIO_VOICE_NUM);
+
+    audio_ret_t eRetval = AUDIO_OK;
+
+    AUDIO_HAL_isr_ctrl(false);
+
+    if (eVoice == AUDIO_VOICE_NUM)
+    {
+        for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
+        {
+            if ( AUDIO_WAVE_update_morph(&pxEngine->xVoiceList[u32Voice], fMorph) != AUDIO_OK )
+            {
+                eRetval = AUDIO_PARAM_ERROR;
+            }
+            else
+            {
+                audio_expr_morph_reset(pxEngine, u32Voice);
+            }
+        }
+    }
+    else
+    {
+        eRetval = AUDIO_WAVE_update_morph(&pxEngine->xVoiceList[eVoice], fMorph);
+
+        if ( eRetval == AUDIO_OK )
+        {
+            audio_expr_morph_reset(pxEngine, (uint32_t)eVoice);
+        }
+    }
+
+    AUDIO_HAL_isr_ctrl(true);
+
+    return eRetval;
+}
+
+audio_ret_t audio_cmd_set_adsr(audio_engine_t *pxEngine, audio_voice_id_t eVoice, const audio_cmd_set_adsr_t *pxAdsr)
+{
+    ERR_ASSERT(eVoice <= AUDIO_VOICE_NUM);
+    ERR_ASSERT(pxAdsr != NULL);
+
+    audio_ret_t eRetval = AUDIO_PARAM_ERROR;
+
+    if ( (pxAdsr->fAttackTime >= 0.0F) && (pxAdsr->fDecayTime >= 0.0F) && (pxAdsr->fReleaseTime >= 0.0F) &&
+         (pxAdsr->fAttackLvl > 0.0F) && (pxAdsr->fAttackLvl <= 1.0F) &&
+         (pxAdsr->fSustainLvl >= 0.0F) && (pxAdsr->fSustainLvl <= pxAdsr->fAttackLvl) )
+    {
+        uint32_t u32First = ( eVoice == AUDIO_VOICE_NUM ) ? 0U : (uint32_t)eVoice;
+        uint32_t u32Last = ( eVoice == AUDIO_VOICE_NUM ) ? (uint32_t)AUDIO_VOICE_NUM : ((uint32_t)eVoice + 1U);
+
+        AUDIO_HAL_isr_ctrl(false);
+
+        for (uint32_t u32Voice = u32First; u32Voice < u32Last; u32Voice++)
+        {
+            ADSR_set_attack_time(&pxEngine->xAdsrEnvList[u32Voice], pxAdsr->fAttackTime);
+            ADSR_set_decay_time(&pxEngine->xAdsrEnvList[u32Voice], pxAdsr->fDecayTime);
+            ADSR_set_release_time(&pxEngine->xAdsrEnvList[u32Voice], pxAdsr->fReleaseTime);
+            /* Attack level first, sustain is bounded by it */
+            ADSR_set_attack_lvl(&pxEngine->xAdsrEnvList[u32Voice], pxAdsr->fAttackLvl);
+            ADSR_set_sustain_lvl(&pxEngine->xAdsrEnvList[u32Voice], pxAdsr->fSustainLvl);
+        }
+
+        AUDIO_HAL_isr_ctrl(true);
+
+        eRetval = AUDIO_OK;
+    }
+
+    return eRetval;
+}
+
+audio_ret_t audio_cmd_master_update(audio_engine_t *pxEngine, audio_master_parameter_id_t eParamId, float fNewValue)
+{
+    AUDIO_HAL_isr_ctrl(false);
+
+    audio_ret_t eRetval = AUDIO_MASTER_parameter_update(&pxEngine->xMaster, eParamId, fNewValue);
+
+    AUDIO_HAL_isr_ctrl(true);
+
+    return eRetval;
+}
+
+audio_ret_t audio_cmd_load_user_wave(audio_wave_id_t eWaveId, const int16_t *pi16Data)
+{
+    /* User bank is shared by all engines, voices playing it pick new data on next block */
+    AUDIO_HAL_isr_ctrl(false);
+
+    audio_ret_t eRetval = AUDIO_WAVE_load_user_frame(eWaveId, pi16Data, AUDIO_WAVE_get_frame_size());
+
+    AUDIO_HAL_isr_ctrl(true);
+
+    return eRetval;
+}
+
+audio_ret_t audio_cmd_release_voices(audio_engine_t *pxEngine, uint32_t u32VoiceMask)
+{
+    audio_ret_t eRetval = AUDIO_PARAM_ERROR;
+
+    if ( (u32VoiceMask >> AUDIO_VOICE_NUM) == 0U )
+    {
+        AUDIO_HAL_isr_ctrl(false);
+
+        for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
+        {
+            if ( (u32VoiceMask & (1UL << u32Voice)) != 0U )
+            {
+                ADSR_release(&pxEngine->xAdsrEnvList[u32Voice]);
+            }
+        }
+
+        AUDIO_HAL_isr_ctrl(true);
+
+        eRetval = AUDIO_OK;
+    }
+
+    return eRetval;
+}
+
 /* Public function prototypes ------------------------------------------------*/
 
-audio_ret_t AUDIO_init(void)
+audio_ret_t AUDIO_init(audio_engine_t *pxEngine)
 {
+    ERR_ASSERT(pxEngine != NULL);
+
     audio_ret_t eRetval = AUDIO_ERR;
 
     /* Init effect section */
-    AUDIO_EFFECT_init(AUDIO_SAMPLE_RATE);
-    AUDIO_EFFECT_set_slot(AUDIO_EFFECT_SLOT_0, AUDIO_EFFECT_FILTER_LP);
-    AUDIO_EFFECT_set_slot(AUDIO_EFFECT_SLOT_1, AUDIO_EFFECT_DELAY);
+    AUDIO_EFFECT_init(&pxEngine->xEffects, AUDIO_SAMPLE_RATE);
+    AUDIO_EFFECT_set_slot(&pxEngine->xEffects, AUDIO_EFFECT_SLOT_0, AUDIO_EFFECT_FILTER_LP);
+    AUDIO_EFFECT_set_slot(&pxEngine->xEffects, AUDIO_EFFECT_SLOT_1, AUDIO_EFFECT_DELAY);
+
+    /* Audio ISR may run from now on, later slot changes lock it out */
+    AUDIO_EFFECT_set_lock_cb(&pxEngine->xEffects, audio_effect_lock_cb);
+
+    /* Init master section */
+    AUDIO_MASTER_init(&pxEngine->xMaster, AUDIO_SAMPLE_RATE, AUDIO_BLOCK_SIZE);
+
+    /* Init render profiling */
+    pxEngine->xRenderStats.u32BudgetCycles = (uint32_t)(((uint64_t)AUDIO_HAL_get_core_clock() * AUDIO_BLOCK_SIZE) / AUDIO_SAMPLE_RATE);
+    AUDIO_reset_render_stats(pxEngine);
+
+    /* Sample clock, block callback registered once output is running */
+    pxEngine->u32SampleClock = 0U;
+    pxEngine->pBlockCB = NULL;
+    pxEngine->pvBlockArg = NULL;
 
     /* Set all voices with known values */
     for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
     {
-        AUDIO_WAVE_init_voice(&xVoiceList[u32Voice], AUDIO_SAMPLE_RATE, AUDIO_AMPLITUDE);
+        AUDIO_WAVE_init_voice(&pxEngine->xVoiceList[u32Voice], AUDIO_SAMPLE_RATE, AUDIO_AMPLITUDE);
+
+        ADSR_init(&pxEngine->xAdsrEnvList[u32Voice], AUDIO_SAMPLE_RATE);
+    }
+
+    /* Realtime parameters start from values set above */
+    AUDIO_PARAM_init(&pxEngine->xParams, (float)AUDIO_SAMPLE_RATE / (float)AUDIO_BLOCK_SIZE);
+    audio_param_sync(pxEngine);
+
+    /* Pitch wheel centered, no vibrato */
+    AUDIO_PARAM_reset(&pxEngine->xParams, AUDIO_PARAM_PITCH_BEND, 0.0F);
+    AUDIO_PARAM_reset(&pxEngine->xParams, AUDIO_PARAM_MOD_WHEEL, 0.0F);
+    pxEngine->xPitch.fBendRange = PITCH_BEND_RANGE_DEFAULT;
+    pxEngine->xPitch.fVibratoRate = VIBRATO_RATE_DEFAULT;
+    pxEngine->xPitch.fVibratoDepth = VIBRATO_DEPTH_DEFAULT;
+    pxEngine->xPitch.fVibratoPhase = 0.0F;
+    pxEngine->xPitch.fPitchMod = 1.0F;
+
+    /* Equal temperament until retuned */
+    AUDIO_reset_tuning(pxEngine);
 
-        ADSR_init(&xAdsrEnvList[u32Voice], AUDIO_SAMPLE_RATE);
+    /* Velocity mapped -40 dB to 0 dB, as engine always did */
+    pxEngine->xVelocity.fAttackSens = 0.0F;
+    (void)AUDIO_set_vel_curve(pxEngine, AUDIO_VEL_CURVE_DB, 1.0F);
+
+    /* All voices without expression */
+    pxEngine->xExpr.fBendRange = EXPR_BEND_RANGE_DEFAULT;
+    pxEngine->xExpr.fPressureDepth = EXPR_PRESSURE_DEPTH_DEFAULT;
+    pxEngine->xExpr.fTimbreDepth = EXPR_TIMBRE_DEPTH_DEFAULT;
+
+    for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
+    {
+        audio_voice_expr_t *pxVoiceExpr = &pxEngine->xExpr.xVoice[u32Voice];
+
+        pxVoiceExpr->fBend = 0.0F;
+        pxVoiceExpr->fPressure = 1.0F;
+        pxVoiceExpr->fTimbre = EXPR_TIMBRE_CENTER;
+        pxVoiceExpr->fBendApplied = 0.0F;
+        pxVoiceExpr->fPitchMod = 1.0F;
+        pxVoiceExpr->fVelAmp = 1.0F;
+        pxVoiceExpr->fGain = 1.0F;
+        pxVoiceExpr->fTimbreApplied = EXPR_TIMBRE_CENTER;
+        pxVoiceExpr->fMorphOffset = 0.0F;
     }
 
-    if ( AUDIO_HAL_init(audio_hal_cb) == AUDIO_OK )
+    if ( AUDIO_HAL_init(audio_hal_cb, pxEngine) == AUDIO_OK )
     {
         /* Start transfer */
-        if ( AUDIO_HAL_send_buffer(u16AudioBuffer, AUDIO_TRANSFER_SIZE) == AUDIO_OK )
+        if ( AUDIO_HAL_send_buffer(pxEngine->u16AudioBuffer, AUDIO_TRANSFER_SIZE) == AUDIO_OK )
         {
             eRetval = AUDIO_OK;
         }
@@ -401,12 +995,14 @@ audio_ret_t AUDIO_init(void)
     return eRetval;
 }
 
-audio_ret_t AUDIO_deinit(void)
+audio_ret_t AUDIO_deinit(audio_engine_t *pxEngine)
 {
+    ERR_ASSERT(pxEngine != NULL);
+
     /* Set all voices with known values */
     for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
     {
-        AUDIO_WAVE_init_voice(&xVoiceList[u32Voice], AUDIO_SAMPLE_RATE, AUDIO_AMPLITUDE_NONE);
+        AUDIO_WAVE_init_voice(&pxEngine->xVoiceList[u32Voice], AUDIO_SAMPLE_RATE, AUDIO_AMPLITUDE_NONE);
     }
 
     AUDIO_HAL_deinit();
@@ -414,8 +1010,302 @@ audio_ret_t AUDIO_deinit(void)
     return AUDIO_OK;
 }
 
-audio_ret_t AUDIO_handle_cmd(audio_cmd_t xAudioCmd)
+void AUDIO_get_render_stats(audio_engine_t *pxEngine, audio_render_stats_t *pxStats)
+{
+    ERR_ASSERT(pxEngine != NULL);
+    ERR_ASSERT(pxStats != NULL);
+
+    *pxStats = pxEngine->xRenderStats;
+}
+
+void AUDIO_reset_render_stats(audio_engine_t *pxEngine)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    pxEngine->xRenderStats.u32MaxCycles = 0U;
+    pxEngine->xRenderStats.u32AvgCycles = 0U;
+    pxEngine->xRenderStats.u32BlockCount = 0U;
+}
+
+uint32_t AUDIO_get_sample_clock(audio_engine_t *pxEngine)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    return pxEngine->u32SampleClock;
+}
+
+void AUDIO_set_block_cb(audio_engine_t *pxEngine, audio_block_cb_t pBlockCB, void *pvArg)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    AUDIO_HAL_isr_ctrl(false);
+    pxEngine->pBlockCB = pBlockCB;
+    pxEngine->pvBlockArg = pvArg;
+    AUDIO_HAL_isr_ctrl(true);
+}
+
+audio_ret_t AUDIO_set_param(audio_engine_t *pxEngine, audio_param_id_t eParam, float fNorm)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    return AUDIO_PARAM_set_target(&pxEngine->xParams, eParam, fNorm);
+}
+
+audio_ret_t AUDIO_set_bend_range(audio_engine_t *pxEngine, float fSemitones)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    audio_ret_t eRetval = AUDIO_PARAM_ERROR;
+
+    if ( (fSemitones >= 0.0F) && (fSemitones <= PITCH_BEND_RANGE_MAX) )
+    {
+        pxEngine->xPitch.fBendRange = fSemitones;
+        eRetval = AUDIO_OK;
+    }
+
+    return eRetval;
+}
+
+audio_ret_t AUDIO_set_vibrato(audio_engine_t *pxEngine, float fRate, float fDepth)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    audio_ret_t eRetval = AUDIO_PARAM_ERROR;
+
+    if ( (fRate >= 0.0F) && (fRate <= VIBRATO_RATE_MAX) && (fDepth >= 0.0F) && (fDepth <= VIBRATO_DEPTH_MAX) )
+    {
+        pxEngine->xPitch.fVibratoRate = fRate;
+        pxEngine->xPitch.fVibratoDepth = fDepth;
+        eRetval = AUDIO_OK;
+    }
+
+    return eRetval;
+}
+
+audio_ret_t AUDIO_set_note_tuning(audio_engine_t *pxEngine, uint8_t u8Note, float fPitch)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    audio_ret_t eRetval = AUDIO_PARAM_ERROR;
+
+    if ( (u8Note < AUDIO_ENGINE_NOTE_NUM) && (fPitch >= 0.0F) && (fPitch <= (float)AUDIO_ENGINE_NOTE_NUM) )
+    {
+        pxEngine->fNoteFreq[u8Note] = audio_note_freq(fPitch);
+        eRetval = AUDIO_OK;
+    }
+
+    return eRetval;
+}
+
+void AUDIO_reset_tuning(audio_engine_t *pxEngine)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    for (uint32_t u32Note = 0U; u32Note < AUDIO_ENGINE_NOTE_NUM; u32Note++)
+    {
+        pxEngine->fNoteFreq[u32Note] = audio_note_freq((float)u32Note);
+    }
+}
+
+float AUDIO_get_note_freq(audio_engine_t *pxEngine, uint8_t u8Note)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    return ( u8Note < AUDIO_ENGINE_NOTE_NUM ) ? pxEngine->fNoteFreq[u8Note] : 0.0F;
+}
+
+audio_ret_t AUDIO_set_vel_curve(audio_engine_t *pxEngine, audio_vel_curve_t eCurve, float fExponent)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    audio_ret_t eRetval = AUDIO_PARAM_ERROR;
+    float *pfGain = pxEngine->xVelocity.fGain;
+
+    if ( (eCurve == AUDIO_VEL_CURVE_POWER) && ((fExponent < VEL_EXPONENT_MIN) || (fExponent > VEL_EXPONENT_MAX)) )
+    {
+        /* Bad exponent, keep current curve */
+    }
+    else if ( eCurve < AUDIO_VEL_CURVE_NUM )
+    {
+        /* User table is kept as loaded, velocity 0 is silent on all other curves but off */
+        if ( eCurve != AUDIO_VEL_CURVE_USER )
+        {
+            for (uint32_t u32Vel = 0U; u32Vel < AUDIO_ENGINE_VEL_NUM; u32Vel++)
+            {
+                float fVel = (float)u32Vel;
+
+                if ( eCurve == AUDIO_VEL_CURVE_OFF )
+                {
+                    pfGain[u32Vel] = 1.0F;
+                }
+                else if ( u32Vel == 0U )
+                {
+                    pfGain[u32Vel] = 0.0F;
+                }
+                else if ( eCurve == AUDIO_VEL_CURVE_LINEAR )
+                {
+                    pfGain[u32Vel] = fVel / MAX_MIDI_VEL;
+                }
+                else if ( eCurve == AUDIO_VEL_CURVE_DB )
+                {
+                    float fdB = AUDIO_TOOL_lin_map(fVel, MIN_MIDI_VEL, MAX_MIDI_VEL, MIN_AMP_DB_MAP, MAX_AMP_DB_MAP);
+
+                    pfGain[u32Vel] = powf(10.0F, fdB / 20.0F);
+                }
+                else
+                {
+                    pfGain[u32Vel] = powf(fVel / MAX_MIDI_VEL, fExponent);
+                }
+            }
+        }
+
+        pxEngine->xVelocity.eCurve = eCurve;
+        eRetval = AUDIO_OK;
+    }
+
+    return eRetval;
+}
+
+audio_ret_t AUDIO_set_vel_table(audio_engine_t *pxEngine, const float *pfGain)
+{
+    ERR_ASSERT(pxEngine != NULL);
+    ERR_ASSERT(pfGain != NULL);
+
+    audio_ret_t eRetval = AUDIO_OK;
+
+    for (uint32_t u32Vel = 0U; u32Vel < AUDIO_ENGINE_VEL_NUM; u32Vel++)
+    {
+        if ( (pfGain[u32Vel] < AUDIO_WAVE_MIN_AMPLITUDE) || (pfGain[u32Vel] > AUDIO_WAVE_MAX_AMPLITUDE) )
+        {
+            eRetval = AUDIO_PARAM_ERROR;
+        }
+    }
+
+    if ( eRetval == AUDIO_OK )
+    {
+        for (uint32_t u32Vel = 0U; u32Vel < AUDIO_ENGINE_VEL_NUM; u32Vel++)
+        {
+            pxEngine->xVelocity.fGain[u32Vel] = pfGain[u32Vel];
+        }
+
+        pxEngine->xVelocity.eCurve = AUDIO_VEL_CURVE_USER;
+    }
+
+    return eRetval;
+}
+
+audio_ret_t AUDIO_set_vel_attack(audio_engine_t *pxEngine, float fSens)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    audio_ret_t eRetval = AUDIO_PARAM_ERROR;
+
+    if ( (fSens >= 0.0F) && (fSens <= 1.0F) )
+    {
+        pxEngine->xVelocity.fAttackSens = fSens;
+        eRetval = AUDIO_OK;
+    }
+
+    return eRetval;
+}
+
+audio_vel_curve_t AUDIO_get_vel_curve(audio_engine_t *pxEngine)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    return pxEngine->xVelocity.eCurve;
+}
+
+audio_ret_t AUDIO_set_voice_expr(audio_engine_t *pxEngine, audio_voice_id_t eVoice, audio_expr_id_t eExpr, float fValue)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    audio_ret_t eRetval = AUDIO_PARAM_ERROR;
+
+    if ( eVoice < AUDIO_VOICE_NUM )
+    {
+        audio_voice_expr_t *pxVoiceExpr = &pxEngine->xExpr.xVoice[eVoice];
+
+        if ( (eExpr == AUDIO_EXPR_BEND) && (fValue >= -1.0F) && (fValue <= 1.0F) )
+        {
+            pxVoiceExpr->fBend = fValue;
+            eRetval = AUDIO_OK;
+        }
+        else if ( (eExpr == AUDIO_EXPR_PRESSURE) && (fValue >= 0.0F) && (fValue <= 1.0F) )
+        {
+            pxVoiceExpr->fPressure = fValue;
+            eRetval = AUDIO_OK;
+        }
+        else if ( (eExpr == AUDIO_EXPR_TIMBRE) && (fValue >= 0.0F) && (fValue <= 1.0F) )
+        {
+            pxVoiceExpr->fTimbre = fValue;
+            eRetval = AUDIO_OK;
+        }
+    }
+
+    return eRetval;
+}
+
+void AUDIO_reset_voice_expr(audio_engine_t *pxEngine, audio_voice_id_t eVoice)
 {
+    ERR_ASSERT(pxEngine != NULL);
+    ERR_ASSERT(eVoice <= AUDIO_VOICE_NUM);
+
+    for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
+    {
+        if ( (eVoice == AUDIO_VOICE_NUM) || (u32Voice == (uint32_t)eVoice) )
+        {
+            pxEngine->xExpr.xVoice[u32Voice].fBend = 0.0F;
+            pxEngine->xExpr.xVoice[u32Voice].fPressure = 1.0F;
+            pxEngine->xExpr.xVoice[u32Voice].fTimbre = EXPR_TIMBRE_CENTER;
+        }
+    }
+}
+
+audio_ret_t AUDIO_set_expr_depth(audio_engine_t *pxEngine, float fBendRange, float fPressureDepth, float fTimbreDepth)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
+    audio_ret_t eRetval = AUDIO_PARAM_ERROR;
+
+    if ( (fBendRange >= 0.0F) && (fBendRange <= EXPR_BEND_RANGE_MAX) &&
+         (fPressureDepth >= 0.0F) && (fPressureDepth <= 1.0F) &&
+         (fTimbreDepth >= 0.0F) && (fTimbreDepth <= 1.0F) )
+    {
+        AUDIO_HAL_isr_ctrl(false);
+
+        pxEngine->xExpr.fBendRange = fBendRange;
+        pxEngine->xExpr.fPressureDepth = fPressureDepth;
+        pxEngine->xExpr.fTimbreDepth = fTimbreDepth;
+
+        /* Bent and moved voices pick new ranges on next block */
+        for (uint32_t u32Voice = 0; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++)
+        {
+            audio_voice_expr_t *pxVoiceExpr = &pxEngine->xExpr.xVoice[u32Voice];
+
+            if ( pxVoiceExpr->fBendApplied != 0.0F )
+            {
+                pxVoiceExpr->fBendApplied = EXPR_FORCE_UPDATE;
+            }
+
+            if ( pxVoiceExpr->fTimbreApplied != EXPR_TIMBRE_CENTER )
+            {
+                pxVoiceExpr->fTimbreApplied = EXPR_FORCE_UPDATE;
+            }
+        }
+
+        AUDIO_HAL_isr_ctrl(true);
+
+        eRetval = AUDIO_OK;
+    }
+
+    return eRetval;
+}
+
+audio_ret_t AUDIO_handle_cmd(audio_engine_t *pxEngine, audio_cmd_t xAudioCmd)
+{
+    ERR_ASSERT(pxEngine != NULL);
+
     audio_ret_t eRetval = AUDIO_ERR;
 
     switch ( xAudioCmd.eCmdId )
@@ -423,6 +1313,7 @@ audio_ret_t AUDIO_handle_cmd(audio_cmd_t xAudioCmd)
         case AUDIO_CMD_ACTIVATE_VOICE:
         {
             eRetval = audio_cmd_set_state(
+                                            pxEngine,
                                             xAudioCmd.xCmdPayload.xActVoice.eVoiceId,
                                             xAudioCmd.xCmdPayload.xActVoice.bState
                                         );
@@ -432,6 +1323,7 @@ audio_ret_t AUDIO_handle_cmd(audio_cmd_t xAudioCmd)
         case AUDIO_CMD_SET_FREQ:
         {
             eRetval = audio_cmd_set_freq(
+                                            pxEngine,
                                             xAudioCmd.xCmdPayload.xSetFreq.eVoiceId,
                                             xAudioCmd.xCmdPayload.xSetFreq.fFreq
                                         );
@@ -441,6 +1333,7 @@ audio_ret_t AUDIO_handle_cmd(audio_cmd_t xAudioCmd)
         case AUDIO_CMD_SET_MIDI_NOTE:
         {
             eRetval = audio_cmd_set_midi_note(
+                                                pxEngine,
                                                 xAudioCmd.xCmdPayload.xSetMidiNote.eVoiceId,
                                                 xAudioCmd.xCmdPayload.xSetMidiNote.u8Note,
                                                 xAudioCmd.xCmdPayload.xSetMidiNote.u8Velocity,
@@ -452,6 +1345,7 @@ audio_ret_t AUDIO_handle_cmd(audio_cmd_t xAudioCmd)
         case AUDIO_CMD_SET_WAVEFORM:
         {
             eRetval = audio_cmd_set_waveform(
+                                                pxEngine,
                                                 xAudioCmd.xCmdPayload.xSetWave.eVoiceId,
                                                 xAudioCmd.xCmdPayload.xSetWave.eWaveId
                                             );
@@ -461,29 +1355,51 @@ audio_ret_t AUDIO_handle_cmd(audio_cmd_t xAudioCmd)
         case AUDIO_CMD_SET_DETUNE:
         {
             eRetval = audio_cmd_set_detune(
+                                                pxEngine,
                                                 xAudioCmd.xCmdPayload.xSetDetune.eVoiceId,
                                                 xAudioCmd.xCmdPayload.xSetDetune.fDetuneLvl
                                             );
         }
         break;
 
+        case AUDIO_CMD_SET_MORPH:
+        {
+            eRetval = audio_cmd_set_morph(
+                                            pxEngine,
+                                            xAudioCmd.xCmdPayload.xSetMorph.eVoiceId,
+                                            xAudioCmd.xCmdPayload.xSetMorph.fMorph
+                                        );
+        }
+        break;
+
         case AUDIO_CMD_SET_ADSR:
         {
+            eRetval = audio_cmd_set_adsr(
+                                            pxEngine,
+                                            xAudioCmd.xCmdPayload.xSetAdsr.eVoiceId,
+                                            &xAudioCmd.xCmdPayload.xSetAdsr
+                                        );
         }
         break;
 
         case AUDIO_CMD_EFFECT_UPDATE:
         {
+            AUDIO_HAL_isr_ctrl(false);
             eRetval = AUDIO_EFFECT_parameter_update(
+                                                    &pxEngine->xEffects,
+                                                    xAudioCmd.xCmdPayload.xEffectUpdate.eSlot, 
                                                     xAudioCmd.xCmdPayload.xEffectUpdate.eParamId, 
                                                     xAudioCmd.xCmdPayload.xEffectUpdate.fNewValue
                                                     );
+            AUDIO_HAL_isr_ctrl(true);
         }
         break;
 
         case AUDIO_CMD_EFFECT_SET_SLOT:
         {
+            /* Audio ISR is only masked by chain lock, instance init is long */
             eRetval = AUDIO_EFFECT_set_slot(
+                                            &pxEngine->xEffects,
                                             xAudioCmd.xCmdPayload.xSetSlot.eSlot, 
                                             xAudioCmd.xCmdPayload.xSetSlot.eEffectId
                                             );
@@ -492,10 +1408,38 @@ audio_ret_t AUDIO_handle_cmd(audio_cmd_t xAudioCmd)
 
         case AUDIO_CMD_EFFECT_ACTIVATE:
         {
+            AUDIO_HAL_isr_ctrl(false);
             eRetval = AUDIO_EFFECT_activate_slot(
+                                                &pxEngine->xEffects,
                                                 xAudioCmd.xCmdPayload.xActivateSlot.eSlot, 
                                                 xAudioCmd.xCmdPayload.xActivateSlot.bActive
                                                 );
+            AUDIO_HAL_isr_ctrl(true);
+        }
+        break;
+
+        case AUDIO_CMD_MASTER_UPDATE:
+        {
+            eRetval = audio_cmd_master_update(
+                                                pxEngine,
+                                                xAudioCmd.xCmdPayload.xMasterUpdate.eParamId, 
+                                                xAudioCmd.xCmdPayload.xMasterUpdate.fNewValue
+                                                );
+        }
+        break;
+
+        case AUDIO_CMD_LOAD_USER_WAVE:
+        {
+            eRetval = audio_cmd_load_user_wave(
+                                                xAudioCmd.xCmdPayload.xLoadUserWave.eWaveId, 
+                                                xAudioCmd.xCmdPayload.xLoadUserWave.pi16Data
+                                                );
+        }
+        break;
+
+        case AUDIO_CMD_RELEASE_VOICES:
+        {
+            eRetval = audio_cmd_release_voices(pxEngine, xAudioCmd.xCmdPayload.xReleaseVoices.u32VoiceMask);
         }
         break;
 
@@ -505,6 +1449,17 @@ audio_ret_t AUDIO_handle_cmd(audio_cmd_t xAudioCmd)
         break;
     }
 
+    /* Direct updates win over parameter glides in progress */
+    if ( (eRetval == AUDIO_OK) &&
+         ((xAudioCmd.eCmdId == AUDIO_CMD_SET_WAVEFORM) || (xAudioCmd.eCmdId == AUDIO_CMD_SET_DETUNE) ||
+          (xAudioCmd.eCmdId == AUDIO_CMD_SET_MORPH) || (xAudioCmd.eCmdId == AUDIO_CMD_SET_ADSR) ||
+          (xAudioCmd.eCmdId == AUDIO_CMD_EFFECT_UPDATE) || (xAudioCmd.eCmdId == AUDIO_CMD_EFFECT_SET_SLOT)) )
+    {
+        AUDIO_HAL_isr_ctrl(false);
+        audio_param_sync(pxEngine);
+        AUDIO_HAL_isr_ctrl(true);
+    }
+
     return eRetval;
 }
 
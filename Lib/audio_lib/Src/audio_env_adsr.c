@@ -50,12 +50,19 @@ void ADSR_init(env_adsr_ctrl_t *pxAdsrCtrl, float fSampleRate)
 }
 
 void ADSR_trigger(env_adsr_ctrl_t *pxAdsrCtrl)
+{
+    ADSR_trigger_scaled(pxAdsrCtrl, 1.0F);
+}
+
+void ADSR_trigger_scaled(env_adsr_ctrl_t *pxAdsrCtrl, float fTimeScale)
 {
     ERR_ASSERT( pxAdsrCtrl != NULL );
+    ERR_ASSERT( fTimeScale >= 0.0F );
 
     pxAdsrCtrl->eState = ENV_ADSR_STATE_ATTACK;
 
-    RAMP_ramp_to(&pxAdsrCtrl->xRamp, pxAdsrCtrl->fAttackLvl, pxAdsrCtrl->fAttackTime);
+    /* Scale only applies to this attack, stored time is kept */
+    RAMP_ramp_to(&pxAdsrCtrl->xRamp, pxAdsrCtrl->fAttackLvl, pxAdsrCtrl->fAttackTime * fTimeScale);
 }
 
 void ADSR_release(env_adsr_ctrl_t *pxAdsrCtrl)
@@ -70,7 +77,7 @@ void ADSR_release(env_adsr_ctrl_t *pxAdsrCtrl)
     }
 }
 
-float ADSR_process(env_adsr_ctrl_t *pxAdsrCtrl)
+AUDIO_RAMFUNC float ADSR_process(env_adsr_ctrl_t *pxAdsrCtrl)
 {
     ERR_ASSERT( pxAdsrCtrl != NULL );
 
@@ -110,7 +117,7 @@ float ADSR_process(env_adsr_ctrl_t *pxAdsrCtrl)
     return fOutData;
 }
 
-bool ADSR_is_active(env_adsr_ctrl_t *pxAdsrCtrl)
+AUDIO_RAMFUNC bool ADSR_is_active(env_adsr_ctrl_t *pxAdsrCtrl)
 {
     ERR_ASSERT( pxAdsrCtrl != NULL );
 
@@ -57,7 +57,7 @@ void RAMP_ramp_to(env_ramp_ctrl_t *pxRampCtrl, float fValue, float fTime)
     pxRampCtrl->u32Cnt = (uint32_t)(pxRampCtrl->fSampleRate * fTime);
 }
 
-float RAMP_process(env_ramp_ctrl_t *pxRampCtrl)
+AUDIO_RAMFUNC float RAMP_process(env_ramp_ctrl_t *pxRampCtrl)
 {
     ERR_ASSERT( pxRampCtrl != NULL );
 
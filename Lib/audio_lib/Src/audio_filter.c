@@ -148,7 +148,7 @@ audio_ret_t AUDIO_FILTER_LP_set_q(AudioFilterLP_t *xFilter, float fNewQ)
     return eRetval;
 }
 
-float AUDIO_FILTER_LP_process(AudioFilterLP_t *xFilter, float fSampleIn)
+AUDIO_RAMFUNC float AUDIO_FILTER_LP_process(AudioFilterLP_t *xFilter, float fSampleIn)
 {
     ERR_ASSERT(xFilter != NULL);
 
@@ -13,6 +13,7 @@
 #include "audio_hal.h"
 
 #include "sys_i2s.h"
+#include "sys_mcu.h"
 #ifdef AUDIO_TRANSFER_TRACE
 #include "sys_gpio.h"
 #endif // AUDIO_TRANSFER_TRACE
@@ -31,6 +32,9 @@
 /* Event callbacl handler */
 audio_hal_event_cb pEventCallBack = NULL;
 
+/* Argument of event handler */
+void *pvEventCallBackArg = NULL;
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private function definition -----------------------------------------------*/
 
@@ -41,15 +45,15 @@ static void audio_i2s_cb(sys_i2s_event_t event)
         switch ( event )
         {
             case SYS_I2S_EVENT_TX_DONE:
-                pEventCallBack(AUDIO_HAL_EVENT_TX_DONE);
+                pEventCallBack(AUDIO_HAL_EVENT_TX_DONE, pvEventCallBackArg);
                 break;
 
             case SYS_I2S_EVENT_HALF_TX_DONE:
-                pEventCallBack(AUDIO_HAL_EVENT_HALF_TX_DONE);
+                pEventCallBack(AUDIO_HAL_EVENT_HALF_TX_DONE, pvEventCallBackArg);
                 break;
 
             case SYS_I2S_EVENT_ERROR:
-                pEventCallBack(AUDIO_HAL_EVENT_ERROR);
+                pEventCallBack(AUDIO_HAL_EVENT_ERROR, pvEventCallBackArg);
                 break;
 
             default:
@@ -60,13 +64,14 @@ static void audio_i2s_cb(sys_i2s_event_t event)
 
 /* Public function definition ------------------------------------------------*/
 
-audio_ret_t AUDIO_HAL_init(audio_hal_event_cb pEventCB)
+audio_ret_t AUDIO_HAL_init(audio_hal_event_cb pEventCB, void *pvArg)
 {
     ERR_ASSERT(pEventCB != NULL);
 
     audio_ret_t eRetVal = AUDIO_ERR;
 
     pEventCallBack = pEventCB;
+    pvEventCallBackArg = pvArg;
 
     if ( sys_i2s_init(AUDIO_I2S, audio_i2s_cb) == SYS_SUCCESS
 #ifdef AUDIO_TRANSFER_TRACE
@@ -85,6 +90,7 @@ void AUDIO_HAL_deinit(void)
     sys_i2s_deinit(AUDIO_I2S);
 
     pEventCallBack = NULL;
+    pvEventCallBackArg = NULL;
 }
 
 audio_ret_t AUDIO_HAL_send_buffer(uint16_t *pu16Data, uint16_t u16DataLen)
@@ -124,4 +130,14 @@ void AUDIO_HAL_gpio_ctrl(bool bSetState)
 #endif // AUDIO_TRANSFER_TRACE
 }
 
+uint32_t AUDIO_HAL_get_cycles(void)
+{
+    return sys_mcu_get_cycles();
+}
+
+uint32_t AUDIO_HAL_get_core_clock(void)
+{
+    return sys_mcu_get_core_clock();
+}
+
 /* EOF */
\ No newline at end of file
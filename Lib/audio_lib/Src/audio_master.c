@@ -0,0 +1,429 @@
+/**
+ * @file    audio_master.c
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Master bus stage, compressor, soft clipper and look-ahead limiter.
+ * @version 0.1
+ * @date    2021-11-13
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "audio_master.h"
+#include "audio_tools.h"
+
+#include <math.h>
+#include <string.h>
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+
+/* Soft clipper is linear below knee, tanh shaped from knee to full scale */
+#define CLIP_KNEE                   ( 0.8F )
+
+/* Input range covered by the clipper table, above it output is full scale */
+#define CLIP_TABLE_RANGE            ( 4.0F )
+#define CLIP_TABLE_SIZE             ( AUDIO_MASTER_CLIP_TABLE_SIZE )
+#define CLIP_TABLE_STEP             ( CLIP_TABLE_RANGE / (float)CLIP_TABLE_SIZE )
+
+// Default limiter values
+#define DEFAULT_LIMITER_ENABLE      ( true )
+#define DEFAULT_LIMITER_THRESHOLD   ( CLIP_KNEE )
+#define DEFAULT_LIMITER_RELEASE     ( 0.1F )
+
+// Default compressor values, ratio 1.0 leaves compressor bypassed
+#define DEFAULT_COMP_THRESHOLD      ( -12.0F )
+#define DEFAULT_COMP_RATIO          ( 1.0F )
+#define DEFAULT_COMP_ATTACK         ( 0.005F )
+#define DEFAULT_COMP_RELEASE        ( 0.1F )
+#define DEFAULT_COMP_MAKEUP         ( 0.0F )
+
+/* Floor for envelope level, avoid log of 0 */
+#define COMP_ENV_FLOOR              ( 0.000001F )
+
+/* Parameter boundaries */
+#define MIN_LIMITER_THRESHOLD       ( 0.1F )
+#define MAX_LIMITER_THRESHOLD       ( 1.0F )
+#define MIN_LIMITER_RELEASE         ( 0.001F )
+#define MAX_LIMITER_RELEASE         ( 2.0F )
+#define MIN_COMP_THRESHOLD          ( -60.0F )
+#define MAX_COMP_THRESHOLD          ( 0.0F )
+#define MIN_COMP_RATIO              ( 1.0F )
+#define MAX_COMP_RATIO              ( 20.0F )
+#define MIN_COMP_TIME               ( 0.0001F )
+#define MAX_COMP_TIME               ( 2.0F )
+#define MIN_COMP_MAKEUP             ( 0.0F )
+#define MAX_COMP_MAKEUP             ( 24.0F )
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief Fill soft clipper table.
+ * 
+ * @param pxMaster pointer to master structure.
+ */
+static void master_build_clip_table(AudioMaster_t *pxMaster);
+
+/**
+ * @brief Apply soft clipper to one sample.
+ * 
+ * @param pxMaster pointer to master structure.
+ * @param fSample input sample.
+ * @return float clipped sample, range -1.0 to 1.0.
+ */
+static inline float master_soft_clip(const AudioMaster_t *pxMaster, float fSample);
+
+/**
+ * @brief Compute per block release coefficient from release time.
+ * 
+ * @param pxMaster pointer to master structure.
+ */
+static void master_update_release(AudioMaster_t *pxMaster);
+
+/**
+ * @brief Compute one pole coefficient for envelope follower.
+ * 
+ * @param fTime time constant in seconds.
+ * @param fSampleRate sample rate in Hz.
+ * @return float coefficient.
+ */
+static float master_env_coef(float fTime, float fSampleRate);
+
+/**
+ * @brief Apply feed-forward compressor to a block. Envelope is followed per
+ *        sample, gain is computed once per block in log domain and ramped.
+ * 
+ * @param pxMaster pointer to master structure.
+ * @param pfData block of samples.
+ * @param u32Size number of samples.
+ */
+static void master_compress(AudioMaster_t *pxMaster, float *pfData, uint32_t u32Size);
+
+/* Private function definition -----------------------------------------------*/
+
+static void master_build_clip_table(AudioMaster_t *pxMaster)
+{
+    for ( uint32_t i = 0U; i <= CLIP_TABLE_SIZE; i++ )
+    {
+        float fIn = (float)i * CLIP_TABLE_STEP;
+
+        if ( fIn <= CLIP_KNEE )
+        {
+            pxMaster->pfClipTable[i] = fIn;
+        }
+        else
+        {
+            pxMaster->pfClipTable[i] = CLIP_KNEE + (1.0F - CLIP_KNEE) * tanhf((fIn - CLIP_KNEE) / (1.0F - CLIP_KNEE));
+        }
+    }
+}
+
+static inline float master_soft_clip(const AudioMaster_t *pxMaster, float fSample)
+{
+    float fAbs = fabsf(fSample);
+    float fOut = fAbs;
+
+    if ( fAbs >= CLIP_TABLE_RANGE )
+    {
+        fOut = 1.0F;
+    }
+    else if ( fAbs > CLIP_KNEE )
+    {
+        float fIndex = fAbs * (1.0F / CLIP_TABLE_STEP);
+        uint32_t u32Index = (uint32_t)fIndex;
+        float fFraction = fIndex - (float)u32Index;
+
+        fOut = pxMaster->pfClipTable[u32Index] + fFraction * (pxMaster->pfClipTable[u32Index + 1U] - pxMaster->pfClipTable[u32Index]);
+    }
+
+    return ( fSample < 0.0F ) ? -fOut : fOut;
+}
+
+static void master_update_release(AudioMaster_t *pxMaster)
+{
+    float fBlocksPerSecond = pxMaster->fSampleRate / (float)pxMaster->u32BlockSize;
+
+    pxMaster->fLimiterReleaseCoef = 1.0F - expf(-1.0F / (pxMaster->fLimiterRelease * fBlocksPerSecond));
+}
+
+static float master_env_coef(float fTime, float fSampleRate)
+{
+    return expf(-1.0F / (fTime * fSampleRate));
+}
+
+AUDIO_RAMFUNC static void master_compress(AudioMaster_t *pxMaster, float *pfData, uint32_t u32Size)
+{
+    float fEnv = pxMaster->fCompEnv;
+    float fEnvMax = 0.0F;
+
+    for ( uint32_t i = 0U; i < u32Size; i++ )
+    {
+        float fAbs = fabsf(pfData[i]);
+        float fCoef = ( fAbs > fEnv ) ? pxMaster->fCompAttackCoef : pxMaster->fCompReleaseCoef;
+
+        fEnv = fAbs + fCoef * (fEnv - fAbs);
+        fEnvMax = fmaxf(fEnvMax, fEnv);
+    }
+
+    pxMaster->fCompEnv = fEnv;
+
+    /* Gain computer, control rate */
+    float fOverDb = AUDIO_TOOL_lin_to_db(fmaxf(fEnvMax, COMP_ENV_FLOOR)) - pxMaster->fCompThreshold;
+    float fGainDb = pxMaster->fCompMakeup;
+
+    if ( fOverDb > 0.0F )
+    {
+        fGainDb -= fOverDb * pxMaster->fCompSlope;
+    }
+
+    float fTarget = AUDIO_TOOL_db_to_lin(fGainDb);
+    float fGain = pxMaster->fCompGain;
+    float fGainStep = (fTarget - fGain) / (float)u32Size;
+
+    for ( uint32_t i = 0U; i < u32Size; i++ )
+    {
+        fGain += fGainStep;
+        pfData[i] *= fGain;
+    }
+
+    pxMaster->fCompGain = fTarget;
+}
+
+/* Public function definition ------------------------------------------------*/
+
+audio_ret_t AUDIO_MASTER_init(AudioMaster_t *pxMaster, float fSampleRate, uint32_t u32BlockSize)
+{
+    ERR_ASSERT( pxMaster != NULL );
+
+    audio_ret_t eRetVal = AUDIO_PARAM_ERROR;
+
+    if ( (pxMaster != NULL) && (fSampleRate > 0.0F) && (u32BlockSize != 0U) && (u32BlockSize <= AUDIO_MASTER_MAX_BLOCK_SIZE) )
+    {
+        master_build_clip_table(pxMaster);
+
+        memset(pxMaster->pfLookAhead, 0, sizeof(pxMaster->pfLookAhead));
+
+        pxMaster->fSampleRate = fSampleRate;
+        pxMaster->u32BlockSize = u32BlockSize;
+        pxMaster->fLimiterGain = 1.0F;
+        pxMaster->fLimiterThreshold = DEFAULT_LIMITER_THRESHOLD;
+        pxMaster->fLimiterRelease = DEFAULT_LIMITER_RELEASE;
+        pxMaster->bLimiterEnable = DEFAULT_LIMITER_ENABLE;
+
+        pxMaster->fCompEnv = 0.0F;
+        pxMaster->fCompGain = 1.0F;
+        pxMaster->fCompThreshold = DEFAULT_COMP_THRESHOLD;
+        pxMaster->fCompRatio = DEFAULT_COMP_RATIO;
+        pxMaster->fCompSlope = 1.0F - (1.0F / DEFAULT_COMP_RATIO);
+        pxMaster->fCompAttack = DEFAULT_COMP_ATTACK;
+        pxMaster->fCompAttackCoef = master_env_coef(DEFAULT_COMP_ATTACK, fSampleRate);
+        pxMaster->fCompRelease = DEFAULT_COMP_RELEASE;
+        pxMaster->fCompReleaseCoef = master_env_coef(DEFAULT_COMP_RELEASE, fSampleRate);
+        pxMaster->fCompMakeup = DEFAULT_COMP_MAKEUP;
+
+        master_update_release(pxMaster);
+
+        eRetVal = AUDIO_OK;
+    }
+
+    return eRetVal;
+}
+
+audio_ret_t AUDIO_MASTER_parameter_update(AudioMaster_t *pxMaster, audio_master_parameter_id_t eId, float fNewValue)
+{
+    ERR_ASSERT( pxMaster != NULL );
+
+    audio_ret_t eRetVal = AUDIO_PARAM_ERROR;
+
+    if ( eId == AUDIO_MASTER_PARAMETER_LIMITER_ENABLE )
+    {
+        bool bEnable = ( fNewValue != 0.0F );
+
+        /* Flush look-ahead so enabling does not replay an old block */
+        if ( bEnable && !pxMaster->bLimiterEnable )
+        {
+            memset(pxMaster->pfLookAhead, 0, sizeof(pxMaster->pfLookAhead));
+            pxMaster->fLimiterGain = 1.0F;
+        }
+
+        pxMaster->bLimiterEnable = bEnable;
+        eRetVal = AUDIO_OK;
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_LIMITER_THRESHOLD )
+    {
+        if ( (fNewValue >= MIN_LIMITER_THRESHOLD) && (fNewValue <= MAX_LIMITER_THRESHOLD) )
+        {
+            pxMaster->fLimiterThreshold = fNewValue;
+            eRetVal = AUDIO_OK;
+        }
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_LIMITER_RELEASE )
+    {
+        if ( (fNewValue >= MIN_LIMITER_RELEASE) && (fNewValue <= MAX_LIMITER_RELEASE) )
+        {
+            pxMaster->fLimiterRelease = fNewValue;
+            master_update_release(pxMaster);
+            eRetVal = AUDIO_OK;
+        }
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_COMP_THRESHOLD )
+    {
+        if ( (fNewValue >= MIN_COMP_THRESHOLD) && (fNewValue <= MAX_COMP_THRESHOLD) )
+        {
+            pxMaster->fCompThreshold = fNewValue;
+            eRetVal = AUDIO_OK;
+        }
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_COMP_RATIO )
+    {
+        if ( (fNewValue >= MIN_COMP_RATIO) && (fNewValue <= MAX_COMP_RATIO) )
+        {
+            pxMaster->fCompRatio = fNewValue;
+            pxMaster->fCompSlope = 1.0F - (1.0F / fNewValue);
+            eRetVal = AUDIO_OK;
+        }
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_COMP_ATTACK )
+    {
+        if ( (fNewValue >= MIN_COMP_TIME) && (fNewValue <= MAX_COMP_TIME) )
+        {
+            pxMaster->fCompAttack = fNewValue;
+            pxMaster->fCompAttackCoef = master_env_coef(fNewValue, pxMaster->fSampleRate);
+            eRetVal = AUDIO_OK;
+        }
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_COMP_RELEASE )
+    {
+        if ( (fNewValue >= MIN_COMP_TIME) && (fNewValue <= MAX_COMP_TIME) )
+        {
+            pxMaster->fCompRelease = fNewValue;
+            pxMaster->fCompReleaseCoef = master_env_coef(fNewValue, pxMaster->fSampleRate);
+            eRetVal = AUDIO_OK;
+        }
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_COMP_MAKEUP )
+    {
+        if ( (fNewValue >= MIN_COMP_MAKEUP) && (fNewValue <= MAX_COMP_MAKEUP) )
+        {
+            pxMaster->fCompMakeup = fNewValue;
+            eRetVal = AUDIO_OK;
+        }
+    }
+    else
+    {
+        // None
+    }
+
+    return eRetVal;
+}
+
+float AUDIO_MASTER_parameter_get(AudioMaster_t *pxMaster, audio_master_parameter_id_t eId)
+{
+    ERR_ASSERT( pxMaster != NULL );
+
+    float fValue = 0.0F;
+
+    if ( eId == AUDIO_MASTER_PARAMETER_LIMITER_ENABLE )
+    {
+        fValue = pxMaster->bLimiterEnable ? 1.0F : 0.0F;
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_LIMITER_THRESHOLD )
+    {
+        fValue = pxMaster->fLimiterThreshold;
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_LIMITER_RELEASE )
+    {
+        fValue = pxMaster->fLimiterRelease;
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_COMP_THRESHOLD )
+    {
+        fValue = pxMaster->fCompThreshold;
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_COMP_RATIO )
+    {
+        fValue = pxMaster->fCompRatio;
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_COMP_ATTACK )
+    {
+        fValue = pxMaster->fCompAttack;
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_COMP_RELEASE )
+    {
+        fValue = pxMaster->fCompRelease;
+    }
+    else if ( eId == AUDIO_MASTER_PARAMETER_COMP_MAKEUP )
+    {
+        fValue = pxMaster->fCompMakeup;
+    }
+    else
+    {
+        // None
+    }
+
+    return fValue;
+}
+
+AUDIO_RAMFUNC void AUDIO_MASTER_process(AudioMaster_t *pxMaster, float *pfData, uint32_t u32Size)
+{
+    ERR_ASSERT( pxMaster != NULL );
+    ERR_ASSERT( pfData != NULL );
+    ERR_ASSERT( u32Size == pxMaster->u32BlockSize );
+
+    /* Compressor is bypassed with ratio 1:1 and no makeup, once gain is back to unity */
+    if ( (pxMaster->fCompRatio > MIN_COMP_RATIO) || (pxMaster->fCompMakeup > MIN_COMP_MAKEUP) || (pxMaster->fCompGain != 1.0F) )
+    {
+        master_compress(pxMaster, pfData, u32Size);
+    }
+
+    if ( pxMaster->bLimiterEnable )
+    {
+        /* Gain target covers peaks of delayed block and the incoming one, so
+         * the ramp never exceeds the gain needed by any output sample */
+        float fPeak = 0.0F;
+
+        for ( uint32_t i = 0U; i < u32Size; i++ )
+        {
+            fPeak = fmaxf(fPeak, fmaxf(fabsf(pfData[i]), fabsf(pxMaster->pfLookAhead[i])));
+        }
+
+        float fTarget = 1.0F;
+        if ( fPeak > pxMaster->fLimiterThreshold )
+        {
+            fTarget = pxMaster->fLimiterThreshold / fPeak;
+        }
+
+        /* Instant attack, smooth release */
+        if ( fTarget > pxMaster->fLimiterGain )
+        {
+            fTarget = pxMaster->fLimiterGain + (fTarget - pxMaster->fLimiterGain) * pxMaster->fLimiterReleaseCoef;
+        }
+
+        float fGain = pxMaster->fLimiterGain;
+        float fGainStep = (fTarget - fGain) / (float)u32Size;
+
+        for ( uint32_t i = 0U; i < u32Size; i++ )
+        {
+            float fIn = pfData[i];
+
+            fGain += fGainStep;
+            pfData[i] = master_soft_clip(pxMaster, pxMaster->pfLookAhead[i] * fGain);
+            pxMaster->pfLookAhead[i] = fIn;
+        }
+
+        pxMaster->fLimiterGain = fTarget;
+    }
+    else
+    {
+        for ( uint32_t i = 0U; i < u32Size; i++ )
+        {
+            pfData[i] = master_soft_clip(pxMaster, pfData[i]);
+        }
+    }
+}
+
+/* EOF */
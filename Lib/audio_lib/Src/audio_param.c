@@ -0,0 +1,213 @@
+/**
+ * @file    audio_param.c
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Realtime parameter bank with per block smoothing.
+ * @version 0.1
+ * @date    2021-12-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "audio_param.h"
+
+#include <math.h>
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+
+/* Parameter mapping from normalized range */
+typedef struct audio_param_def {
+    const char *pcName;             /**< Name shown on user interfaces */
+    float fMin;                     /**< Value at 0.0 */
+    float fMax;                     /**< Value at 1.0 */
+    float fTime;                    /**< Smoothing time constant in seconds */
+    bool bExp;                      /**< Exponential mapping, time and frequency values */
+} audio_param_def_t;
+
+/* Private define ------------------------------------------------------------*/
+
+/* Distance to target considered reached, normalized units */
+#define PARAM_SETTLE                ( 0.0001F )
+
+/* Min change reported while gliding, normalized units */
+#define PARAM_APPLY_STEP            ( 0.001F )
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+
+/* Morph is given as fraction of the bank, engine scales it to frames. Bend is
+   given as fraction of bend range, centered at 0.5 so it rests exactly on 0.0 */
+static const audio_param_def_t xParamDef[AUDIO_PARAM_NUM] = {
+    [AUDIO_PARAM_FILTER_FREQ] = { "cutoff",  20.0F,  20000.0F, 0.020F, true  },
+    [AUDIO_PARAM_FILTER_Q]    = { "q",       0.5F,   10.0F,    0.020F, true  },
+    [AUDIO_PARAM_DELAY_TIME]  = { "dtime",   0.001F, 0.19F,    0.100F, false },
+    [AUDIO_PARAM_DELAY_FB]    = { "dfb",     0.0F,   0.95F,    0.020F, false },
+    [AUDIO_PARAM_DETUNE]      = { "detune",  0.0F,   1.0F,     0.020F, false },
+    [AUDIO_PARAM_ATTACK]      = { "attack",  0.001F, 4.0F,     0.010F, true  },
+    [AUDIO_PARAM_DECAY]       = { "decay",   0.001F, 4.0F,     0.010F, true  },
+    [AUDIO_PARAM_SUSTAIN]     = { "sustain", 0.0F,   1.0F,     0.010F, false },
+    [AUDIO_PARAM_RELEASE]     = { "release", 0.001F, 4.0F,     0.010F, true  },
+    [AUDIO_PARAM_MORPH]       = { "morph",   0.0F,   1.0F,     0.010F, false },
+    [AUDIO_PARAM_PITCH_BEND]  = { "bend",    -1.0F,  1.0F,     0.005F, false },
+    [AUDIO_PARAM_MOD_WHEEL]   = { "mod",     0.0F,   1.0F,     0.020F, false },
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief Map normalized value to parameter units.
+ *
+ * @param eParam parameter id.
+ * @param fNorm value in range 0.0 to 1.0.
+ * @return float value in parameter units.
+ */
+static float param_from_norm(audio_param_id_t eParam, float fNorm);
+
+/**
+ * @brief Map parameter units to normalized value, bounded to 0.0 to 1.0.
+ *
+ * @param eParam parameter id.
+ * @param fValue value in parameter units.
+ * @return float normalized value.
+ */
+static float param_to_norm(audio_param_id_t eParam, float fValue);
+
+/* Private function definition -----------------------------------------------*/
+
+static float param_from_norm(audio_param_id_t eParam, float fNorm)
+{
+    const audio_param_def_t *pxDef = &xParamDef[eParam];
+    float fRetval;
+
+    if ( pxDef->bExp )
+    {
+        fRetval = pxDef->fMin * expf(fNorm * logf(pxDef->fMax / pxDef->fMin));
+    }
+    else
+    {
+        fRetval = pxDef->fMin + (fNorm * (pxDef->fMax - pxDef->fMin));
+    }
+
+    return fRetval;
+}
+
+static float param_to_norm(audio_param_id_t eParam, float fValue)
+{
+    const audio_param_def_t *pxDef = &xParamDef[eParam];
+    float fNorm = 0.0F;
+
+    if ( fValue >= pxDef->fMax )
+    {
+        fNorm = 1.0F;
+    }
+    else if ( fValue > pxDef->fMin )
+    {
+        if ( pxDef->bExp )
+        {
+            fNorm = logf(fValue / pxDef->fMin) / logf(pxDef->fMax / pxDef->fMin);
+        }
+        else
+        {
+            fNorm = (fValue - pxDef->fMin) / (pxDef->fMax - pxDef->fMin);
+        }
+    }
+
+    return fNorm;
+}
+
+/* Public function definition ------------------------------------------------*/
+
+void AUDIO_PARAM_init(audio_param_bank_t *pxBank, float fBlockRate)
+{
+    ERR_ASSERT(pxBank != NULL);
+    ERR_ASSERT(fBlockRate > 0.0F);
+
+    for (uint32_t u32Param = 0U; u32Param < (uint32_t)AUDIO_PARAM_NUM; u32Param++)
+    {
+        audio_param_smooth_t *pxParam = &pxBank->xParam[u32Param];
+
+        pxParam->fTarget = 0.0F;
+        pxParam->fValue = 0.0F;
+        pxParam->fApplied = 0.0F;
+        pxParam->fCoef = 1.0F - expf(-1.0F / (xParamDef[u32Param].fTime * fBlockRate));
+    }
+}
+
+void AUDIO_PARAM_reset(audio_param_bank_t *pxBank, audio_param_id_t eParam, float fValue)
+{
+    ERR_ASSERT(pxBank != NULL);
+    ERR_ASSERT(eParam < AUDIO_PARAM_NUM);
+
+    audio_param_smooth_t *pxParam = &pxBank->xParam[eParam];
+    float fNorm = param_to_norm(eParam, fValue);
+
+    pxParam->fTarget = fNorm;
+    pxParam->fValue = fNorm;
+    pxParam->fApplied = fNorm;
+}
+
+audio_ret_t AUDIO_PARAM_set_target(audio_param_bank_t *pxBank, audio_param_id_t eParam, float fNorm)
+{
+    ERR_ASSERT(pxBank != NULL);
+
+    audio_ret_t eRetval = AUDIO_PARAM_ERROR;
+
+    if ( (eParam < AUDIO_PARAM_NUM) && (fNorm >= 0.0F) && (fNorm <= 1.0F) )
+    {
+        pxBank->xParam[eParam].fTarget = fNorm;
+        eRetval = AUDIO_OK;
+    }
+
+    return eRetval;
+}
+
+AUDIO_RAMFUNC uint32_t AUDIO_PARAM_process(audio_param_bank_t *pxBank)
+{
+    ERR_ASSERT(pxBank != NULL);
+
+    uint32_t u32Mask = 0U;
+
+    for (uint32_t u32Param = 0U; u32Param < (uint32_t)AUDIO_PARAM_NUM; u32Param++)
+    {
+        audio_param_smooth_t *pxParam = &pxBank->xParam[u32Param];
+        float fTarget = pxParam->fTarget;
+        float fDiff = fTarget - pxParam->fValue;
+
+        if ( fabsf(fDiff) > PARAM_SETTLE )
+        {
+            pxParam->fValue += fDiff * pxParam->fCoef;
+        }
+        else
+        {
+            pxParam->fValue = fTarget;
+        }
+
+        /* Glide is reported in steps, last step always lands on target */
+        float fStep = fabsf(pxParam->fValue - pxParam->fApplied);
+
+        if ( (fStep > PARAM_APPLY_STEP) || ((fStep > 0.0F) && (pxParam->fValue == fTarget)) )
+        {
+            pxParam->fApplied = pxParam->fValue;
+            u32Mask |= (1UL << u32Param);
+        }
+    }
+
+    return u32Mask;
+}
+
+float AUDIO_PARAM_get_value(audio_param_bank_t *pxBank, audio_param_id_t eParam)
+{
+    ERR_ASSERT(pxBank != NULL);
+    ERR_ASSERT(eParam < AUDIO_PARAM_NUM);
+
+    return param_from_norm(eParam, pxBank->xParam[eParam].fApplied);
+}
+
+const char *AUDIO_PARAM_get_name(audio_param_id_t eParam)
+{
+    return ( eParam < AUDIO_PARAM_NUM ) ? xParamDef[eParam].pcName : "none";
+}
+
+/* EOF */
@@ -0,0 +1,193 @@
+/**
+ * @file    audio_pool.c
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Fixed arena allocator for audio module instances.
+ * @version 0.1
+ * @date    2021-11-06
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "audio_pool.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+
+/**
+ * @brief Header placed in front of every block of the arena.
+ * 
+ */
+typedef struct pool_block {
+    uint32_t u32Size;           /**< Block size in bytes, header included */
+    uint32_t u32Used;           /**< Block in use flag */
+} pool_block_t;
+
+/* Private define ------------------------------------------------------------*/
+
+/* Size of block header */
+#define POOL_HDR_SIZE               ( (uint32_t)sizeof(pool_block_t) )
+
+_Static_assert(sizeof(pool_block_t) == AUDIO_POOL_BLOCK_HDR_SIZE, "Pool block header size mismatch");
+
+/* Smallest block worth to split, header plus one aligned word */
+#define POOL_MIN_BLOCK_SIZE         ( POOL_HDR_SIZE + AUDIO_POOL_ALIGN )
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Round size up to pool alignment */
+#define POOL_ALIGN_UP(x)            ( ((x) + (AUDIO_POOL_ALIGN - 1U)) & ~(AUDIO_POOL_ALIGN - 1U) )
+
+/* Access block at arena offset */
+#define POOL_BLOCK_AT(pool, off)    ( (pool_block_t *)(void *)&(pool)->pu8Arena[(off)] )
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private function definition -----------------------------------------------*/
+/* Public function definition ------------------------------------------------*/
+
+audio_ret_t AUDIO_POOL_init(audio_pool_t *pxPool, void *pvArena, uint32_t u32ArenaSize)
+{
+    ERR_ASSERT( pxPool != NULL );
+    ERR_ASSERT( pvArena != NULL );
+
+    audio_ret_t eRetVal = AUDIO_PARAM_ERROR;
+
+    /* Arena is trimmed to alignment, must fit at least one minimal block */
+    u32ArenaSize &= ~(AUDIO_POOL_ALIGN - 1U);
+
+    if ( (pxPool != NULL) && (pvArena != NULL) && (u32ArenaSize >= POOL_MIN_BLOCK_SIZE) )
+    {
+        pxPool->pu8Arena = (uint8_t *)pvArena;
+        pxPool->u32ArenaSize = u32ArenaSize;
+        pxPool->u32FreeSize = u32ArenaSize - POOL_HDR_SIZE;
+
+        /* Whole arena as one free block */
+        pool_block_t *pxBlock = POOL_BLOCK_AT(pxPool, 0U);
+        pxBlock->u32Size = u32ArenaSize;
+        pxBlock->u32Used = 0U;
+
+        eRetVal = AUDIO_OK;
+    }
+
+    return eRetVal;
+}
+
+void *AUDIO_POOL_alloc(audio_pool_t *pxPool, uint32_t u32Size)
+{
+    ERR_ASSERT( pxPool != NULL );
+
+    void *pvBlock = NULL;
+
+    if ( (pxPool != NULL) && (u32Size != 0U) && (u32Size <= pxPool->u32FreeSize) )
+    {
+        uint32_t u32BlockSize = POOL_ALIGN_UP(u32Size) + POOL_HDR_SIZE;
+        uint32_t u32Offset = 0U;
+
+        while ( u32Offset < pxPool->u32ArenaSize )
+        {
+            pool_block_t *pxBlock = POOL_BLOCK_AT(pxPool, u32Offset);
+
+            if ( (pxBlock->u32Used == 0U) && (pxBlock->u32Size >= u32BlockSize) )
+            {
+                /* Split block if remaining space can hold another block */
+                uint32_t u32Remain = pxBlock->u32Size - u32BlockSize;
+
+                if ( u32Remain >= POOL_MIN_BLOCK_SIZE )
+                {
+                    pool_block_t *pxNext = POOL_BLOCK_AT(pxPool, u32Offset + u32BlockSize);
+                    pxNext->u32Size = u32Remain;
+                    pxNext->u32Used = 0U;
+                    pxBlock->u32Size = u32BlockSize;
+                    pxPool->u32FreeSize -= u32BlockSize;
+                }
+                else
+                {
+                    pxPool->u32FreeSize -= (pxBlock->u32Size - POOL_HDR_SIZE);
+                }
+
+                pxBlock->u32Used = 1U;
+                pvBlock = (void *)&pxPool->pu8Arena[u32Offset + POOL_HDR_SIZE];
+                break;
+            }
+
+            u32Offset += pxBlock->u32Size;
+        }
+    }
+
+    return pvBlock;
+}
+
+void AUDIO_POOL_free(audio_pool_t *pxPool, void *pvBlock)
+{
+    ERR_ASSERT( pxPool != NULL );
+
+    if ( (pxPool != NULL) && (pvBlock != NULL) )
+    {
+        uint8_t *pu8Block = (uint8_t *)pvBlock;
+
+        ERR_ASSERT( pu8Block >= &pxPool->pu8Arena[POOL_HDR_SIZE] );
+        ERR_ASSERT( pu8Block < &pxPool->pu8Arena[pxPool->u32ArenaSize] );
+
+        uint32_t u32Target = (uint32_t)(pu8Block - pxPool->pu8Arena) - POOL_HDR_SIZE;
+        uint32_t u32Offset = 0U;
+        uint32_t u32PrevFree = pxPool->u32ArenaSize;
+
+        /* Walk arena to validate block and locate previous free neighbour */
+        while ( u32Offset < u32Target )
+        {
+            pool_block_t *pxBlock = POOL_BLOCK_AT(pxPool, u32Offset);
+
+            u32PrevFree = ( pxBlock->u32Used == 0U ) ? u32Offset : pxPool->u32ArenaSize;
+            u32Offset += pxBlock->u32Size;
+        }
+
+        ERR_ASSERT( u32Offset == u32Target );
+
+        pool_block_t *pxBlock = POOL_BLOCK_AT(pxPool, u32Target);
+
+        if ( (u32Offset == u32Target) && (pxBlock->u32Used != 0U) )
+        {
+            pxBlock->u32Used = 0U;
+            pxPool->u32FreeSize += (pxBlock->u32Size - POOL_HDR_SIZE);
+
+            /* Merge with next block, its header becomes free space */
+            uint32_t u32Next = u32Target + pxBlock->u32Size;
+            if ( u32Next < pxPool->u32ArenaSize )
+            {
+                pool_block_t *pxNext = POOL_BLOCK_AT(pxPool, u32Next);
+
+                if ( pxNext->u32Used == 0U )
+                {
+                    pxBlock->u32Size += pxNext->u32Size;
+                    pxPool->u32FreeSize += POOL_HDR_SIZE;
+                }
+            }
+
+            /* Merge with previous block */
+            if ( u32PrevFree < pxPool->u32ArenaSize )
+            {
+                pool_block_t *pxPrev = POOL_BLOCK_AT(pxPool, u32PrevFree);
+                pxPrev->u32Size += pxBlock->u32Size;
+                pxPool->u32FreeSize += POOL_HDR_SIZE;
+            }
+        }
+    }
+}
+
+uint32_t AUDIO_POOL_get_free(audio_pool_t *pxPool)
+{
+    ERR_ASSERT( pxPool != NULL );
+
+    uint32_t u32Free = 0U;
+
+    if ( pxPool != NULL )
+    {
+        u32Free = pxPool->u32FreeSize;
+    }
+
+    return u32Free;
+}
+
+/* EOF */
@@ -14,7 +14,21 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
+
+/* Access to float bit pattern */
+typedef union tool_float_bits {
+    float f;
+    uint32_t u;
+} tool_float_bits_t;
+
 /* Private define ------------------------------------------------------------*/
+
+/* 20 * log10(2), dB per octave of amplitude */
+#define TOOL_DB_PER_LOG2            ( 6.0205999F )
+
+/* Range where exp2 result is a normal float */
+#define TOOL_EXP2_MAX               ( 126.0F )
+#define TOOL_EXP2_MIN               ( -126.0F )
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
@@ -26,4 +40,53 @@ float AUDIO_TOOL_lin_map(float x, float in_min, float in_max, float out_min, flo
     return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
 }
 
+AUDIO_RAMFUNC float AUDIO_TOOL_fast_log2(float x)
+{
+    ERR_ASSERT( x > 0.0F );
+
+    tool_float_bits_t xBits = { .f = x };
+
+    /* Exponent gives integer part, mantissa in range 1.0 to 2.0 is fitted with a quadratic */
+    float fExp = (float)((int32_t)((xBits.u >> 23U) & 0xFFU) - 127);
+    xBits.u = (xBits.u & 0x007FFFFFU) | 0x3F800000U;
+    float fMant = xBits.f;
+
+    return fExp + ((-0.34484843F * fMant + 2.02466578F) * fMant - 1.67487759F);
+}
+
+AUDIO_RAMFUNC float AUDIO_TOOL_fast_exp2(float x)
+{
+    if ( x > TOOL_EXP2_MAX )
+    {
+        x = TOOL_EXP2_MAX;
+    }
+    else if ( x < TOOL_EXP2_MIN )
+    {
+        x = TOOL_EXP2_MIN;
+    }
+
+    /* Integer part goes to exponent, fraction is fitted with a cubic */
+    int32_t i32Int = (int32_t)x;
+    if ( (float)i32Int > x )
+    {
+        i32Int--;
+    }
+    float fFrac = x - (float)i32Int;
+
+    tool_float_bits_t xBits;
+    xBits.u = (uint32_t)(i32Int + 127) << 23U;
+
+    return xBits.f * (1.0F + fFrac * (0.69606564F + fFrac * (0.22449434F + fFrac * 0.07944024F)));
+}
+
+AUDIO_RAMFUNC float AUDIO_TOOL_lin_to_db(float x)
+{
+    return TOOL_DB_PER_LOG2 * AUDIO_TOOL_fast_log2(x);
+}
+
+AUDIO_RAMFUNC float AUDIO_TOOL_db_to_lin(float x)
+{
+    return AUDIO_TOOL_fast_exp2(x * (1.0F / TOOL_DB_PER_LOG2));
+}
+
 /* EOF */
\ No newline at end of file
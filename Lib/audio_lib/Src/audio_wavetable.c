@@ -18,28 +18,126 @@
 
 #define WAVE_TABLE_SIZE         ( 256U )
 
+/* Scale of Q15 table samples to full scale units */
+#define WAVE_SAMPLE_SCALE       ( 1.0F / 32768.0F )
+
 #define WAVE_DEFAULT_FREQ       ( 440.0F )
 #define WAVE_DEFAULT_WAVE       ( AUDIO_WAVE_SAW )
 
+/* Morph glide length, 5ms at 48kHz */
+#define WAVE_MORPH_GLIDE_SAMPLES    ( 240U )
+
+/* Crossfade length, same as glide */
+#define WAVE_FADE_SAMPLES           ( WAVE_MORPH_GLIDE_SAMPLES )
+#define WAVE_FADE_STEP              ( 1.0F / (float)WAVE_FADE_SAMPLES )
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 
-const float saw_wave[WAVE_TABLE_SIZE] = {-0.992188F,-0.984375F,-0.976562F,-0.968750F,-0.960938F,-0.953125F,-0.945312F,-0.937500F,-0.929688F,-0.921875F,-0.914062F,-0.906250F,-0.898438F,-0.890625F,-0.882812F,-0.875000F,-0.867188F,-0.859375F,-0.851562F,-0.843750F,-0.835938F,-0.828125F,-0.820312F,-0.812500F,-0.804688F,-0.796875F,-0.789062F,-0.781250F,-0.773438F,-0.765625F,-0.757812F,-0.750000F,-0.742188F,-0.734375F,-0.726562F,-0.718750F,-0.710938F,-0.703125F,-0.695312F,-0.687500F,-0.679688F,-0.671875F,-0.664062F,-0.656250F,-0.648438F,-0.640625F,-0.632812F,-0.625000F,-0.617188F,-0.609375F,-0.601562F,-0.593750F,-0.585938F,-0.578125F,-0.570312F,-0.562500F,-0.554688F,-0.546875F,-0.539062F,-0.531250F,-0.523438F,-0.515625F,-0.507812F,-0.500000F,-0.492188F,-0.484375F,-0.476562F,-0.468750F,-0.460938F,-0.453125F,-0.445312F,-0.437500F,-0.429688F,-0.421875F,-0.414062F,-0.406250F,-0.398438F,-0.390625F,-0.382812F,-0.375000F,-0.367188F,-0.359375F,-0.351562F,-0.343750F,-0.335938F,-0.328125F,-0.320312F,-0.312500F,-0.304688F,-0.296875F,-0.289062F,-0.281250F,-0.273438F,-0.265625F,-0.257812F,-0.250000F,-0.242188F,-0.234375F,-0.226562F,-0.218750F,-0.210938F,-0.203125F,-0.195312F,-0.187500F,-0.179688F,-0.171875F,-0.164062F,-0.156250F,-0.148438F,-0.140625F,-0.132812F,-0.125000F,-0.117188F,-0.109375F,-0.101562F,-0.093750F,-0.085938F,-0.078125F,-0.070312F,-0.062500F,-0.054688F,-0.046875F,-0.039062F,-0.031250F,-0.023438F,-0.015625F,-0.007812F,0.000000F,0.007812F,0.015625F,0.023438F,0.031250F,0.039062F,0.046875F,0.054688F,0.062500F,0.070312F,0.078125F,0.085938F,0.093750F,0.101562F,0.109375F,0.117188F,0.125000F,0.132812F,0.140625F,0.148438F,0.156250F,0.164062F,0.171875F,0.179688F,0.187500F,0.195312F,0.203125F,0.210938F,0.218750F,0.226562F,0.234375F,0.242188F,0.250000F,0.257812F,0.265625F,0.273438F,0.281250F,0.289062F,0.296875F,0.304688F,0.312500F,0.320312F,0.328125F,0.335938F,0.343750F,0.351562F,0.359375F,0.367188F,0.375000F,0.382812F,0.390625F,0.398438F,0.406250F,0.414062F,0.421875F,0.429688F,0.437500F,0.445312F,0.453125F,0.460938F,0.468750F,0.476562F,0.484375F,0.492188F,0.500000F,0.507812F,0.515625F,0.523438F,0.531250F,0.539062F,0.546875F,0.554688F,0.562500F,0.570312F,0.578125F,0.585938F,0.593750F,0.601562F,0.609375F,0.617188F,0.625000F,0.632812F,0.640625F,0.648438F,0.656250F,0.664062F,0.671875F,0.679688F,0.687500F,0.695312F,0.703125F,0.710938F,0.718750F,0.726562F,0.734375F,0.742188F,0.750000F,0.757812F,0.765625F,0.773438F,0.781250F,0.789062F,0.796875F,0.804688F,0.812500F,0.820312F,0.828125F,0.835938F,0.843750F,0.851562F,0.859375F,0.867188F,0.875000F,0.882812F,0.890625F,0.898438F,0.906250F,0.914062F,0.921875F,0.929688F,0.937500F,0.945312F,0.953125F,0.960938F,0.968750F,0.976562F,0.984375F,0.992188F,1.000000F,};
-const float rsaw_wave[WAVE_TABLE_SIZE] = {0.992188F,0.984375F,0.976562F,0.968750F,0.960938F,0.953125F,0.945312F,0.937500F,0.929688F,0.921875F,0.914062F,0.906250F,0.898438F,0.890625F,0.882812F,0.875000F,0.867188F,0.859375F,0.851562F,0.843750F,0.835938F,0.828125F,0.820312F,0.812500F,0.804688F,0.796875F,0.789062F,0.781250F,0.773438F,0.765625F,0.757812F,0.750000F,0.742188F,0.734375F,0.726562F,0.718750F,0.710938F,0.703125F,0.695312F,0.687500F,0.679688F,0.671875F,0.664062F,0.656250F,0.648438F,0.640625F,0.632812F,0.625000F,0.617188F,0.609375F,0.601562F,0.593750F,0.585938F,0.578125F,0.570312F,0.562500F,0.554688F,0.546875F,0.539062F,0.531250F,0.523438F,0.515625F,0.507812F,0.500000F,0.492188F,0.484375F,0.476562F,0.468750F,0.460938F,0.453125F,0.445312F,0.437500F,0.429688F,0.421875F,0.414062F,0.406250F,0.398438F,0.390625F,0.382812F,0.375000F,0.367188F,0.359375F,0.351562F,0.343750F,0.335938F,0.328125F,0.320312F,0.312500F,0.304688F,0.296875F,0.289062F,0.281250F,0.273438F,0.265625F,0.257812F,0.250000F,0.242188F,0.234375F,0.226562F,0.218750F,0.210938F,0.203125F,0.195312F,0.187500F,0.179688F,0.171875F,0.164062F,0.156250F,0.148438F,0.140625F,0.132812F,0.125000F,0.117188F,0.109375F,0.101562F,0.093750F,0.085938F,0.078125F,0.070312F,0.062500F,0.054688F,0.046875F,0.039062F,0.031250F,0.023438F,0.015625F,0.007812F,0.000000F,-0.007812F,-0.015625F,-0.023438F,-0.031250F,-0.039062F,-0.046875F,-0.054688F,-0.062500F,-0.070312F,-0.078125F,-0.085938F,-0.093750F,-0.101562F,-0.109375F,-0.117188F,-0.125000F,-0.132812F,-0.140625F,-0.148438F,-0.156250F,-0.164062F,-0.171875F,-0.179688F,-0.187500F,-0.195312F,-0.203125F,-0.210938F,-0.218750F,-0.226562F,-0.234375F,-0.242188F,-0.250000F,-0.257812F,-0.265625F,-0.273438F,-0.281250F,-0.289062F,-0.296875F,-0.304688F,-0.312500F,-0.320312F,-0.328125F,-0.335938F,-0.343750F,-0.351562F,-0.359375F,-0.367188F,-0.375000F,-0.382812F,-0.390625F,-0.398438F,-0.406250F,-0.414062F,-0.421875F,-0.429688F,-0.437500F,-0.445312F,-0.453125F,-0.460938F,-0.468750F,-0.476562F,-0.484375F,-0.492188F,-0.500000F,-0.507812F,-0.515625F,-0.523438F,-0.531250F,-0.539062F,-0.546875F,-0.554688F,-0.562500F,-0.570312F,-0.578125F,-0.585938F,-0.593750F,-0.601562F,-0.609375F,-0.617188F,-0.625000F,-0.632812F,-0.640625F,-0.648438F,-0.656250F,-0.664062F,-0.671875F,-0.679688F,-0.687500F,-0.695312F,-0.703125F,-0.710938F,-0.718750F,-0.726562F,-0.734375F,-0.742188F,-0.750000F,-0.757812F,-0.765625F,-0.773438F,-0.781250F,-0.789062F,-0.796875F,-0.804688F,-0.812500F,-0.820312F,-0.828125F,-0.835938F,-0.843750F,-0.851562F,-0.859375F,-0.867188F,-0.875000F,-0.882812F,-0.890625F,-0.898438F,-0.906250F,-0.914062F,-0.921875F,-0.929688F,-0.937500F,-0.945312F,-0.953125F,-0.960938F,-0.968750F,-0.976562F,-0.984375F,-0.992188F,-1.000000F};
-const float square_wave[WAVE_TABLE_SIZE] = {1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F,-1.000000F};
-const float sin_wave[WAVE_TABLE_SIZE] = {0.000000F,0.024541F,0.049068F,0.073565F,0.098017F,0.122411F,0.146730F,0.170962F,0.195090F,0.219101F,0.242980F,0.266713F,0.290285F,0.313682F,0.336890F,0.359895F,0.382683F,0.405241F,0.427555F,0.449611F,0.471397F,0.492898F,0.514103F,0.534998F,0.555570F,0.575808F,0.595699F,0.615232F,0.634393F,0.653173F,0.671559F,0.689541F,0.707107F,0.724247F,0.740951F,0.757209F,0.773010F,0.788346F,0.803208F,0.817585F,0.831470F,0.844854F,0.857729F,0.870087F,0.881921F,0.893224F,0.903989F,0.914210F,0.923880F,0.932993F,0.941544F,0.949528F,0.956940F,0.963776F,0.970031F,0.975702F,0.980785F,0.985278F,0.989177F,0.992480F,0.995185F,0.997290F,0.998795F,0.999699F,1.000000F,0.999699F,0.998795F,0.997290F,0.995185F,0.992480F,0.989177F,0.985278F,0.980785F,0.975702F,0.970031F,0.963776F,0.956940F,0.949528F,0.941544F,0.932993F,0.923880F,0.914210F,0.903989F,0.893224F,0.881921F,0.870087F,0.857729F,0.844854F,0.831470F,0.817585F,0.803208F,0.788346F,0.773010F,0.757209F,0.740951F,0.724247F,0.707107F,0.689541F,0.671559F,0.653173F,0.634393F,0.615232F,0.595699F,0.575808F,0.555570F,0.534998F,0.514103F,0.492898F,0.471397F,0.449611F,0.427555F,0.405241F,0.382683F,0.359895F,0.336890F,0.313682F,0.290285F,0.266713F,0.242980F,0.219101F,0.195090F,0.170962F,0.146730F,0.122411F,0.098017F,0.073565F,0.049068F,0.024541F,0.000000F,-0.024541F,-0.049068F,-0.073565F,-0.098017F,-0.122411F,-0.146730F,-0.170962F,-0.195090F,-0.219101F,-0.242980F,-0.266713F,-0.290285F,-0.313682F,-0.336890F,-0.359895F,-0.382683F,-0.405241F,-0.427555F,-0.449611F,-0.471397F,-0.492898F,-0.514103F,-0.534998F,-0.555570F,-0.575808F,-0.595699F,-0.615232F,-0.634393F,-0.653173F,-0.671559F,-0.689541F,-0.707107F,-0.724247F,-0.740951F,-0.757209F,-0.773010F,-0.788346F,-0.803208F,-0.817585F,-0.831470F,-0.844854F,-0.857729F,-0.870087F,-0.881921F,-0.893224F,-0.903989F,-0.914210F,-0.923880F,-0.932993F,-0.941544F,-0.949528F,-0.956940F,-0.963776F,-0.970031F,-0.975702F,-0.980785F,-0.985278F,-0.989177F,-0.992480F,-0.995185F,-0.997290F,-0.998795F,-0.999699F,-1.000000F,-0.999699F,-0.998795F,-0.997290F,-0.995185F,-0.992480F,-0.989177F,-0.985278F,-0.980785F,-0.975702F,-0.970031F,-0.963776F,-0.956940F,-0.949528F,-0.941544F,-0.932993F,-0.923880F,-0.914210F,-0.903989F,-0.893224F,-0.881921F,-0.870087F,-0.857729F,-0.844854F,-0.831470F,-0.817585F,-0.803208F,-0.788346F,-0.773010F,-0.757209F,-0.740951F,-0.724247F,-0.707107F,-0.689541F,-0.671559F,-0.653173F,-0.634393F,-0.615232F,-0.595699F,-0.575808F,-0.555570F,-0.534998F,-0.514103F,-0.492898F,-0.471397F,-0.449611F,-0.427555F,-0.405241F,-0.382683F,-0.359895F,-0.336890F,-0.313682F,-0.290285F,-0.266713F,-0.242980F,-0.219101F,-0.195090F,-0.170962F,-0.146730F,-0.122411F,-0.098017F,-0.073565F,-0.049068F,-0.024541F};
-const float tri_wave[WAVE_TABLE_SIZE] = {-0.984375F,-0.968750F,-0.953125F,-0.937500F,-0.921875F,-0.906250F,-0.890625F,-0.875000F,-0.859375F,-0.843750F,-0.828125F,-0.812500F,-0.796875F,-0.781250F,-0.765625F,-0.750000F,-0.734375F,-0.718750F,-0.703125F,-0.687500F,-0.671875F,-0.656250F,-0.640625F,-0.625000F,-0.609375F,-0.593750F,-0.578125F,-0.562500F,-0.546875F,-0.531250F,-0.515625F,-0.500000F,-0.484375F,-0.468750F,-0.453125F,-0.437500F,-0.421875F,-0.406250F,-0.390625F,-0.375000F,-0.359375F,-0.343750F,-0.328125F,-0.312500F,-0.296875F,-0.281250F,-0.265625F,-0.250000F,-0.234375F,-0.218750F,-0.203125F,-0.187500F,-0.171875F,-0.156250F,-0.140625F,-0.125000F,-0.109375F,-0.093750F,-0.078125F,-0.062500F,-0.046875F,-0.031250F,-0.015625F,0.000000F,0.015625F,0.031250F,0.046875F,0.062500F,0.078125F,0.093750F,0.109375F,0.125000F,0.140625F,0.156250F,0.171875F,0.187500F,0.203125F,0.218750F,0.234375F,0.250000F,0.265625F,0.281250F,0.296875F,0.312500F,0.328125F,0.343750F,0.359375F,0.375000F,0.390625F,0.406250F,0.421875F,0.437500F,0.453125F,0.468750F,0.484375F,0.500000F,0.515625F,0.531250F,0.546875F,0.562500F,0.578125F,0.593750F,0.609375F,0.625000F,0.640625F,0.656250F,0.671875F,0.687500F,0.703125F,0.718750F,0.734375F,0.750000F,0.765625F,0.781250F,0.796875F,0.812500F,0.828125F,0.843750F,0.859375F,0.875000F,0.890625F,0.906250F,0.921875F,0.937500F,0.953125F,0.968750F,0.984375F,1.000000F,0.984375F,0.968750F,0.953125F,0.937500F,0.921875F,0.906250F,0.890625F,0.875000F,0.859375F,0.843750F,0.828125F,0.812500F,0.796875F,0.781250F,0.765625F,0.750000F,0.734375F,0.718750F,0.703125F,0.687500F,0.671875F,0.656250F,0.640625F,0.625000F,0.609375F,0.593750F,0.578125F,0.562500F,0.546875F,0.531250F,0.515625F,0.500000F,0.484375F,0.468750F,0.453125F,0.437500F,0.421875F,0.406250F,0.390625F,0.375000F,0.359375F,0.343750F,0.328125F,0.312500F,0.296875F,0.281250F,0.265625F,0.250000F,0.234375F,0.218750F,0.203125F,0.187500F,0.171875F,0.156250F,0.140625F,0.125000F,0.109375F,0.093750F,0.078125F,0.062500F,0.046875F,0.031250F,0.015625F,0.000000F,-0.015625F,-0.031250F,-0.046875F,-0.062500F,-0.078125F,-0.093750F,-0.109375F,-0.125000F,-0.140625F,-0.156250F,-0.171875F,-0.187500F,-0.203125F,-0.218750F,-0.234375F,-0.250000F,-0.265625F,-0.281250F,-0.296875F,-0.312500F,-0.328125F,-0.343750F,-0.359375F,-0.375000F,-0.390625F,-0.406250F,-0.421875F,-0.437500F,-0.453125F,-0.468750F,-0.484375F,-0.500000F,-0.515625F,-0.531250F,-0.546875F,-0.562500F,-0.578125F,-0.593750F,-0.609375F,-0.625000F,-0.640625F,-0.656250F,-0.671875F,-0.687500F,-0.703125F,-0.718750F,-0.734375F,-0.750000F,-0.765625F,-0.781250F,-0.796875F,-0.812500F,-0.828125F,-0.843750F,-0.859375F,-0.875000F,-0.890625F,-0.906250F,-0.921875F,-0.937500F,-0.953125F,-0.968750F,-0.984375F,-1.000000F};
-
-const float *wave_list[AUDIO_WAVE_NUM] = {
-    saw_wave,
-    rsaw_wave,
-    square_wave,
-    sin_wave,
-    tri_wave,
+/* Factory bank, one frame for each factory audio_wave_id_t, Q15 values. Stored in
+   flash and copied to SRAM at boot */
+AUDIO_FASTDATA const audio_wave_sample_t wave_factory_frames[AUDIO_WAVE_FACTORY_NUM][WAVE_TABLE_SIZE] = {
+    [AUDIO_WAVE_SAW] = {-32512,-32256,-32000,-31744,-31488,-31232,-30976,-30720,-30464,-30208,-29952,-29696,-29440,-29184,-28928,-28672,-28416,-28160,-27904,-27648,-27392,-27136,-26880,-26624,-26368,-26112,-25856,-25600,-25344,-25088,-24832,-24576,-24320,-24064,-23808,-23552,-23296,-23040,-22784,-22528,-22272,-22016,-21760,-21504,-21248,-20992,-20736,-20480,-20224,-19968,-19712,-19456,-19200,-18944,-18688,-18432,-18176,-17920,-17664,-17408,-17152,-16896,-16640,-16384,-16128,-15872,-15616,-15360,-15104,-14848,-14592,-14336,-14080,-13824,-13568,-13312,-13056,-12800,-12544,-12288,-12032,-11776,-11520,-11264,-11008,-10752,-10496,-10240,-9984,-9728,-9472,-9216,-8960,-8704,-8448,-8192,-7936,-7680,-7424,-7168,-6912,-6656,-6400,-6144,-5888,-5632,-5376,-5120,-4864,-4608,-4352,-4096,-3840,-3584,-3328,-3072,-2816,-2560,-2304,-2048,-1792,-1536,-1280,-1024,-768,-512,-256,0,256,512,768,1024,1280,1536,1792,2048,2304,2560,2816,3072,3328,3584,3840,4096,4352,4608,4864,5120,5376,5632,5888,6144,6400,6656,6912,7168,7424,7680,7936,8192,8448,8704,8960,9216,9472,9728,9984,10240,10496,10752,11008,11264,11520,11776,12032,12288,12544,12800,13056,13312,13568,13824,14080,14336,14592,14848,15104,15360,15616,15872,16128,16384,16640,16896,17152,17408,17664,17920,18176,18432,18688,18944,19200,19456,19712,19968,20224,20480,20736,20992,21248,21504,21760,22016,22272,22528,22784,23040,23296,23552,23808,24064,24320,24576,24832,25088,25344,25600,25856,26112,26368,26624,26880,27136,27392,27648,27904,28160,28416,28672,28928,29184,29440,29696,29952,30208,30464,30720,30976,31232,31488,31744,32000,32256,32512,32767},
+    [AUDIO_WAVE_RSAW] = {32512,32256,32000,31744,31488,31232,30976,30720,30464,30208,29952,29696,29440,29184,28928,28672,28416,28160,27904,27648,27392,27136,26880,26624,26368,26112,25856,25600,25344,25088,24832,24576,24320,24064,23808,23552,23296,23040,22784,22528,22272,22016,21760,21504,21248,20992,20736,20480,20224,19968,19712,19456,19200,18944,18688,18432,18176,17920,17664,17408,17152,16896,16640,16384,16128,15872,15616,15360,15104,14848,14592,14336,14080,13824,13568,13312,13056,12800,12544,12288,12032,11776,11520,11264,11008,10752,10496,10240,9984,9728,9472,9216,8960,8704,8448,8192,7936,7680,7424,7168,6912,6656,6400,6144,5888,5632,5376,5120,4864,4608,4352,4096,3840,3584,3328,3072,2816,2560,2304,2048,1792,1536,1280,1024,768,512,256,0,-256,-512,-768,-1024,-1280,-1536,-1792,-2048,-2304,-2560,-2816,-3072,-3328,-3584,-3840,-4096,-4352,-4608,-4864,-5120,-5376,-5632,-5888,-6144,-6400,-6656,-6912,-7168,-7424,-7680,-7936,-8192,-8448,-8704,-8960,-9216,-9472,-9728,-9984,-10240,-10496,-10752,-11008,-11264,-11520,-11776,-12032,-12288,-12544,-12800,-13056,-13312,-13568,-13824,-14080,-14336,-14592,-14848,-15104,-15360,-15616,-15872,-16128,-16384,-16640,-16896,-17152,-17408,-17664,-17920,-18176,-18432,-18688,-18944,-19200,-19456,-19712,-19968,-20224,-20480,-20736,-20992,-21248,-21504,-21760,-22016,-22272,-22528,-22784,-23040,-23296,-23552,-23808,-24064,-24320,-24576,-24832,-25088,-25344,-25600,-25856,-26112,-26368,-26624,-26880,-27136,-27392,-27648,-27904,-28160,-28416,-28672,-28928,-29184,-29440,-29696,-29952,-30208,-30464,-30720,-30976,-31232,-31488,-31744,-32000,-32256,-32512,-32768},
+    [AUDIO_WAVE_SQR] = {32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,32767,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768},
+    [AUDIO_WAVE_SIN] = {0,804,1608,2411,3212,4011,4808,5602,6393,7180,7962,8740,9512,10279,11039,11793,12540,13279,14010,14733,15447,16151,16846,17531,18205,18868,19520,20160,20788,21403,22006,22595,23170,23732,24279,24812,25330,25833,26320,26791,27246,27684,28106,28511,28899,29269,29622,29957,30274,30572,30853,31114,31357,31581,31786,31972,32138,32286,32413,32522,32610,32679,32729,32758,32767,32758,32729,32679,32610,32522,32413,32286,32138,31972,31786,31581,31357,31114,30853,30572,30274,29957,29622,29269,28899,28511,28106,27684,27246,26791,26320,25833,25330,24812,24279,23732,23170,22595,22006,21403,20788,20160,19520,18868,18205,17531,16846,16151,15447,14733,14010,13279,12540,11793,11039,10279,9512,8740,7962,7180,6393,5602,4808,4011,3212,2411,1608,804,0,-804,-1608,-2411,-3212,-4011,-4808,-5602,-6393,-7180,-7962,-8740,-9512,-10279,-11039,-11793,-12540,-13279,-14010,-14733,-15447,-16151,-16846,-17531,-18205,-18868,-19520,-20160,-20788,-21403,-22006,-22595,-23170,-23732,-24279,-24812,-25330,-25833,-26320,-26791,-27246,-27684,-28106,-28511,-28899,-29269,-29622,-29957,-30274,-30572,-30853,-31114,-31357,-31581,-31786,-31972,-32138,-32286,-32413,-32522,-32610,-32679,-32729,-32758,-32768,-32758,-32729,-32679,-32610,-32522,-32413,-32286,-32138,-31972,-31786,-31581,-31357,-31114,-30853,-30572,-30274,-29957,-29622,-29269,-28899,-28511,-28106,-27684,-27246,-26791,-26320,-25833,-25330,-24812,-24279,-23732,-23170,-22595,-22006,-21403,-20788,-20160,-19520,-18868,-18205,-17531,-16846,-16151,-15447,-14733,-14010,-13279,-12540,-11793,-11039,-10279,-9512,-8740,-7962,-7180,-6393,-5602,-4808,-4011,-3212,-2411,-1608,-804},
+    [AUDIO_WAVE_TRI] = {-32256,-31744,-31232,-30720,-30208,-29696,-29184,-28672,-28160,-27648,-27136,-26624,-26112,-25600,-25088,-24576,-24064,-23552,-23040,-22528,-22016,-21504,-20992,-20480,-19968,-19456,-18944,-18432,-17920,-17408,-16896,-16384,-15872,-15360,-14848,-14336,-13824,-13312,-12800,-12288,-11776,-11264,-10752,-10240,-9728,-9216,-8704,-8192,-7680,-7168,-6656,-6144,-5632,-5120,-4608,-4096,-3584,-3072,-2560,-2048,-1536,-1024,-512,0,512,1024,1536,2048,2560,3072,3584,4096,4608,5120,5632,6144,6656,7168,7680,8192,8704,9216,9728,10240,10752,11264,11776,12288,12800,13312,13824,14336,14848,15360,15872,16384,16896,17408,17920,18432,18944,19456,19968,20480,20992,21504,22016,22528,23040,23552,24064,24576,25088,25600,26112,26624,27136,27648,28160,28672,29184,29696,30208,30720,31232,31744,32256,32767,32256,31744,31232,30720,30208,29696,29184,28672,28160,27648,27136,26624,26112,25600,25088,24576,24064,23552,23040,22528,22016,21504,20992,20480,19968,19456,18944,18432,17920,17408,16896,16384,15872,15360,14848,14336,13824,13312,12800,12288,11776,11264,10752,10240,9728,9216,8704,8192,7680,7168,6656,6144,5632,5120,4608,4096,3584,3072,2560,2048,1536,1024,512,0,-512,-1024,-1536,-2048,-2560,-3072,-3584,-4096,-4608,-5120,-5632,-6144,-6656,-7168,-7680,-8192,-8704,-9216,-9728,-10240,-10752,-11264,-11776,-12288,-12800,-13312,-13824,-14336,-14848,-15360,-15872,-16384,-16896,-17408,-17920,-18432,-18944,-19456,-19968,-20480,-20992,-21504,-22016,-22528,-23040,-23552,-24064,-24576,-25088,-25600,-26112,-26624,-27136,-27648,-28160,-28672,-29184,-29696,-30208,-30720,-31232,-31744,-32256,-32768},
+};
+
+const AudioWaveBank_t wave_factory_bank = {
+    .pxFrames = &wave_factory_frames[0U][0U],
+    .u32FrameNum = AUDIO_WAVE_FACTORY_NUM,
+    .u32FrameSize = WAVE_TABLE_SIZE,
+};
+
+/* User bank in RAM, one frame for each user wave id */
+audio_wave_sample_t wave_user_frames[AUDIO_WAVE_USER_NUM][WAVE_TABLE_SIZE] = { { 0 } };
+
+const AudioWaveBank_t wave_user_bank = {
+    .pxFrames = &wave_user_frames[0U][0U],
+    .u32FrameNum = AUDIO_WAVE_USER_NUM,
+    .u32FrameSize = WAVE_TABLE_SIZE,
 };
 
 /* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief Compute phase increments of voice and sub-oscilator.
+ * 
+ * @param pVoice pointer to voice.
+ * @param fFreq voice frequency in Hz.
+ */
+static void wave_update_phase_inc(AudioWaveTableVoice_t *pVoice, float fFreq);
+
+/**
+ * @brief Interpolate sample between two frames, linear on index and morph fraction.
+ *        Samples are converted to float on load, result keeps Q15 range.
+ * 
+ * @param pxBank bank of frames.
+ * @param pxFrameA lower frame.
+ * @param pxFrameB upper frame.
+ * @param fIndex fractional index inside frame.
+ * @param fFrameFraction weight of upper frame.
+ * @return float interpolated sample.
+ */
+static inline float wave_interpolate(const AudioWaveBank_t *pxBank, const audio_wave_sample_t *pxFrameA, const audio_wave_sample_t *pxFrameB, float fIndex, float fFrameFraction);
+
+/**
+ * @brief Get adjacent frames around a morph position.
+ * 
+ * @param pxBank bank of frames.
+ * @param fMorph position in frames.
+ * @param ppxFrameA lower frame.
+ * @param ppxFrameB upper frame, same as lower on last frame.
+ * @return float weight of upper frame.
+ */
+static inline float wave_get_frames(const AudioWaveBank_t *pxBank, float fMorph, const audio_wave_sample_t **ppxFrameA, const audio_wave_sample_t **ppxFrameB);
+
 /* Private function definition -----------------------------------------------*/
+
+static void wave_update_phase_inc(AudioWaveTableVoice_t *pVoice, float fFreq)
+{
+    float fIncPerHz = (float)pVoice->pxBank->u32FrameSize / (float)pVoice->u32SampleRate;
+
+    pVoice->fFreq = fFreq;
+    pVoice->fPhaseInc = fFreq * fIncPerHz;
+    pVoice->fSubPhaseInc = (fFreq + fFreq * pVoice->fDetune) * fIncPerHz;
+    pVoice->fPhaseStep = pVoice->fPhaseInc * pVoice->fPitchMod;
+    pVoice->fSubPhaseStep = pVoice->fSubPhaseInc * pVoice->fPitchMod;
+}
+
+static inline float wave_interpolate(const AudioWaveBank_t *pxBank, const audio_wave_sample_t *pxFrameA, const audio_wave_sample_t *pxFrameB, float fIndex, float fFrameFraction)
+{
+    // Compute linear interpolation
+    uint32_t u32IndexBelow = (uint32_t)fIndex;
+    uint32_t u32IndexAbove = (u32IndexBelow + 1U) & (pxBank->u32FrameSize - 1U);
+
+    // Compute weigh for each sample
+    float fFractionAbove = fIndex - (float)u32IndexBelow;
+
+    // Load and convert taps, scale is applied later with voice gain
+    float fA0 = (float)pxFrameA[u32IndexBelow];
+    float fA1 = (float)pxFrameA[u32IndexAbove];
+    float fB0 = (float)pxFrameB[u32IndexBelow];
+    float fB1 = (float)pxFrameB[u32IndexAbove];
+
+    float fSampleA = fA0 + fFractionAbove * (fA1 - fA0);
+    float fSampleB = fB0 + fFractionAbove * (fB1 - fB0);
+
+    // Crossfade between frames
+    return fSampleA + fFrameFraction * (fSampleB - fSampleA);
+}
+
+static inline float wave_get_frames(const AudioWaveBank_t *pxBank, float fMorph, const audio_wave_sample_t **ppxFrameA, const audio_wave_sample_t **ppxFrameB)
+{
+    uint32_t u32Frame = (uint32_t)fMorph;
+
+    *ppxFrameA = &pxBank->pxFrames[u32Frame * pxBank->u32FrameSize];
+    *ppxFrameB = ( (u32Frame + 1U) < pxBank->u32FrameNum ) ? (*ppxFrameA + pxBank->u32FrameSize) : *ppxFrameA;
+
+    return fMorph - (float)u32Frame;
+}
+
 /* Public function prototypes -----------------------------------------------*/
 
 audio_ret_t AUDIO_WAVE_init_voice(AudioWaveTableVoice_t *pVoice, uint32_t u32SampleRate, float fMaxAmplitude )
@@ -49,14 +147,24 @@ audio_ret_t AUDIO_WAVE_init_voice(AudioWaveTableVoice_t *pVoice, uint32_t u32Sam
     pVoice->bActive = false;
     pVoice->fCurrentSample = 0.0F;
     pVoice->fSubCurrentSample = 0.0F;
-    pVoice->fFreq = WAVE_DEFAULT_FREQ;
     pVoice->fMaxAmplitude = fMaxAmplitude;
     pVoice->fAmplitude = AUDIO_WAVE_MAX_AMPLITUDE;
+    pVoice->fOutGain = AUDIO_WAVE_MAX_AMPLITUDE * WAVE_SAMPLE_SCALE;
     pVoice->fDetune = AUDIO_WAVE_NON_DETUNE;
+    pVoice->fPitchMod = 1.0F;
     pVoice->u32SampleRate = u32SampleRate;
-    pVoice->u32WaveTableSize = WAVE_TABLE_SIZE;
+    pVoice->pxBank = &wave_factory_bank;
     pVoice->eWaveId = WAVE_DEFAULT_WAVE;
-    pVoice->pu32WaveTable = wave_list[pVoice->eWaveId];
+    pVoice->fMorph = (float)WAVE_DEFAULT_WAVE;
+    pVoice->fMorphTarget = pVoice->fMorph;
+    pVoice->fMorphInc = 0.0F;
+    pVoice->u32MorphSteps = 0U;
+    pVoice->pxFadeFrameA = NULL;
+    pVoice->pxFadeFrameB = NULL;
+    pVoice->fFadeFraction = 0.0F;
+    pVoice->u32FadeSteps = 0U;
+
+    wave_update_phase_inc(pVoice, WAVE_DEFAULT_FREQ);
 
     return AUDIO_OK;
 }
@@ -66,17 +174,93 @@ audio_ret_t AUDIO_WAVE_change_wave(AudioWaveTableVoice_t *pVoice, audio_wave_id_
     ERR_ASSERT(pVoice != NULL);
     ERR_ASSERT(eWave < AUDIO_WAVE_NUM);
 
+    float fMorph = (float)eWave;
+    const AudioWaveBank_t *pxBank = &wave_factory_bank;
+
+    if ( eWave >= AUDIO_WAVE_FACTORY_NUM )
+    {
+        fMorph -= (float)AUDIO_WAVE_FACTORY_NUM;
+        pxBank = &wave_user_bank;
+    }
+
+    /* Frames in between are unrelated waves, sound at current position
+       fades out while selected frame plays. Morph glide is only for morph
+       control */
+    if ( pVoice->bActive )
+    {
+        pVoice->fFadeFraction = wave_get_frames(pVoice->pxBank, pVoice->fMorph, &pVoice->pxFadeFrameA, &pVoice->pxFadeFrameB);
+        pVoice->u32FadeSteps = WAVE_FADE_SAMPLES;
+    }
+
     pVoice->eWaveId = eWave;
-    pVoice->pu32WaveTable = wave_list[eWave];
+    pVoice->pxBank = pxBank;
+    pVoice->fMorph = fMorph;
+    pVoice->fMorphTarget = fMorph;
+    pVoice->u32MorphSteps = 0U;
 
     return AUDIO_OK;
 }
 
+audio_ret_t AUDIO_WAVE_load_user_frame(audio_wave_id_t eWave, const int16_t *pi16Data, uint32_t u32Size)
+{
+    ERR_ASSERT(pi16Data != NULL);
+
+    audio_ret_t eRetVal = AUDIO_PARAM_ERROR;
+
+    if ( (eWave >= AUDIO_WAVE_FACTORY_NUM) && (eWave < AUDIO_WAVE_NUM) && (u32Size == WAVE_TABLE_SIZE) && (pi16Data != NULL) )
+    {
+        audio_wave_sample_t *pxFrame = wave_user_frames[eWave - AUDIO_WAVE_FACTORY_NUM];
+
+        for ( uint32_t i = 0U; i < u32Size; i++ )
+        {
+            pxFrame[i] = (audio_wave_sample_t)pi16Data[i];
+        }
+
+        eRetVal = AUDIO_OK;
+    }
+
+    return eRetVal;
+}
+
+uint32_t AUDIO_WAVE_get_frame_size(void)
+{
+    return WAVE_TABLE_SIZE;
+}
+
+audio_ret_t AUDIO_WAVE_update_morph(AudioWaveTableVoice_t *pVoice, float fMorph)
+{
+    ERR_ASSERT(pVoice != NULL);
+
+    audio_ret_t eRetVal = AUDIO_PARAM_ERROR;
+    float fMaxMorph = (float)(pVoice->pxBank->u32FrameNum - 1U);
+
+    if ( (fMorph >= AUDIO_WAVE_MIN_MORPH) && (fMorph <= fMaxMorph) )
+    {
+        pVoice->fMorphTarget = fMorph;
+
+        if ( pVoice->bActive )
+        {
+            pVoice->fMorphInc = (fMorph - pVoice->fMorph) / (float)WAVE_MORPH_GLIDE_SAMPLES;
+            pVoice->u32MorphSteps = WAVE_MORPH_GLIDE_SAMPLES;
+        }
+        else
+        {
+            /* Silent voice, jump directly */
+            pVoice->fMorph = fMorph;
+            pVoice->u32MorphSteps = 0U;
+        }
+
+        eRetVal = AUDIO_OK;
+    }
+
+    return eRetVal;
+}
+
 audio_ret_t AUDIO_WAVE_update_freq(AudioWaveTableVoice_t *pVoice, float fFreq)
 {
     ERR_ASSERT(pVoice != NULL);
 
-    pVoice->fFreq = fFreq;
+    wave_update_phase_inc(pVoice, fFreq);
 
     return AUDIO_OK;
 }
@@ -88,6 +272,7 @@ audio_ret_t AUDIO_WAVE_update_amp(AudioWaveTableVoice_t *pVoice, float fAmp)
     ERR_ASSERT(fAmp <= AUDIO_WAVE_MAX_AMPLITUDE);
 
     pVoice->fAmplitude = fAmp * pVoice->fMaxAmplitude;
+    pVoice->fOutGain = pVoice->fAmplitude * WAVE_SAMPLE_SCALE;
 
     return AUDIO_OK;
 }
@@ -100,6 +285,20 @@ audio_ret_t AUDIO_WAVE_update_detune(AudioWaveTableVoice_t *pVoice, float fDetun
 
     pVoice->fDetune = fDetuneLvl;
 
+    wave_update_phase_inc(pVoice, pVoice->fFreq);
+
+    return AUDIO_OK;
+}
+
+AUDIO_RAMFUNC audio_ret_t AUDIO_WAVE_update_pitch_mod(AudioWaveTableVoice_t *pVoice, float fPitchMod)
+{
+    ERR_ASSERT(pVoice != NULL);
+    ERR_ASSERT(fPitchMod > 0.0F);
+
+    pVoice->fPitchMod = fPitchMod;
+    pVoice->fPhaseStep = pVoice->fPhaseInc * fPitchMod;
+    pVoice->fSubPhaseStep = pVoice->fSubPhaseInc * fPitchMod;
+
     return AUDIO_OK;
 }
 
@@ -112,12 +311,17 @@ audio_ret_t AUDIO_WAVE_set_active(AudioWaveTableVoice_t *pVoice, bool bState)
     if ( !bState )
     {
         pVoice->fCurrentSample = 0.0F;
+
+        /* Pending glide and fade are not audible anymore */
+        pVoice->fMorph = pVoice->fMorphTarget;
+        pVoice->u32MorphSteps = 0U;
+        pVoice->u32FadeSteps = 0U;
     }
 
     return AUDIO_OK;
 }
 
-float AUDIO_WAVE_get_next_sample(AudioWaveTableVoice_t *pVoice)
+AUDIO_RAMFUNC float AUDIO_WAVE_get_next_sample(AudioWaveTableVoice_t *pVoice)
 {
     ERR_ASSERT(pVoice != NULL);
 
@@ -125,47 +329,68 @@ float AUDIO_WAVE_get_next_sample(AudioWaveTableVoice_t *pVoice)
 
     if ( pVoice->bActive )
     {
-        // Compute main voice
-        // Compute linear interpolation
-        uint32_t u32IndexBelow = (uint32_t)pVoice->fCurrentSample;
-        uint32_t u32IndexAbove = (u32IndexBelow + 1U) % pVoice->u32WaveTableSize;
+        const AudioWaveBank_t *pxBank = pVoice->pxBank;
+        float fTableSize = (float)pxBank->u32FrameSize;
+
+        // Advance morph glide
+        if ( pVoice->u32MorphSteps != 0U )
+        {
+            pVoice->u32MorphSteps--;
+            pVoice->fMorph = ( pVoice->u32MorphSteps == 0U ) ? pVoice->fMorphTarget : (pVoice->fMorph + pVoice->fMorphInc);
+        }
+
+        // Select adjacent frames around morph position
+        const audio_wave_sample_t *pxFrameA;
+        const audio_wave_sample_t *pxFrameB;
+        float fFrameFraction = wave_get_frames(pxBank, pVoice->fMorph, &pxFrameA, &pxFrameB);
 
-        // Compute weigh for each sample
-        float fFractionAbove = pVoice->fCurrentSample - (float)u32IndexBelow;
-        float fFractionBelow = 1.0F - fFractionAbove;
+        // Weight of faded frames, all banks share frame size
+        float fFade = 0.0F;
 
-        fOutData = pVoice->fAmplitude * ( fFractionAbove * pVoice->pu32WaveTable[u32IndexAbove] + fFractionBelow * pVoice->pu32WaveTable[u32IndexBelow] );
+        if ( pVoice->u32FadeSteps != 0U )
+        {
+            fFade = (float)pVoice->u32FadeSteps * WAVE_FADE_STEP;
+            pVoice->u32FadeSteps--;
+        }
+
+        // Compute main voice
+        fOutData = wave_interpolate(pxBank, pxFrameA, pxFrameB, pVoice->fCurrentSample, fFrameFraction);
+
+        if ( fFade != 0.0F )
+        {
+            fOutData += fFade * (wave_interpolate(pxBank, pVoice->pxFadeFrameA, pVoice->pxFadeFrameB, pVoice->fCurrentSample, pVoice->fFadeFraction) - fOutData);
+        }
 
         // Compute next sample index from wavetable
-        pVoice->fCurrentSample += (pVoice->u32WaveTableSize * pVoice->fFreq) / pVoice->u32SampleRate;
-        while (pVoice->fCurrentSample >= (float)pVoice->u32WaveTableSize)
+        pVoice->fCurrentSample += pVoice->fPhaseStep;
+        while (pVoice->fCurrentSample >= fTableSize)
         {
-            pVoice->fCurrentSample -= (float)pVoice->u32WaveTableSize;
+            pVoice->fCurrentSample -= fTableSize;
         }
 
         // Compute sub-oscilator
         if ( pVoice->fDetune != AUDIO_WAVE_NON_DETUNE )
         {
-            // Re-compute linear interpolation
-            u32IndexBelow = (uint32_t)pVoice->fSubCurrentSample;
-            u32IndexAbove = (u32IndexBelow + 1U) % pVoice->u32WaveTableSize;
-
-            fFractionAbove = pVoice->fSubCurrentSample - (float)u32IndexBelow;
-            fFractionBelow = 1.0F - fFractionAbove;
+            float fSubData = wave_interpolate(pxBank, pxFrameA, pxFrameB, pVoice->fSubCurrentSample, fFrameFraction);
 
-            fOutData += pVoice->fAmplitude * ( fFractionAbove * pVoice->pu32WaveTable[u32IndexAbove] + fFractionBelow * pVoice->pu32WaveTable[u32IndexBelow] );
+            if ( fFade != 0.0F )
+            {
+                fSubData += fFade * (wave_interpolate(pxBank, pVoice->pxFadeFrameA, pVoice->pxFadeFrameB, pVoice->fSubCurrentSample, pVoice->fFadeFraction) - fSubData);
+            }
 
-            float fSubOscFreq = pVoice->fFreq + pVoice->fFreq * pVoice->fDetune;
+            fOutData += fSubData;
 
-            pVoice->fSubCurrentSample += (pVoice->u32WaveTableSize * fSubOscFreq) / pVoice->u32SampleRate;
-            while (pVoice->fSubCurrentSample >= (float)pVoice->u32WaveTableSize)
+            pVoice->fSubCurrentSample += pVoice->fSubPhaseStep;
+            while (pVoice->fSubCurrentSample >= fTableSize)
             {
-                pVoice->fSubCurrentSample -= (float)pVoice->u32WaveTableSize;
+                pVoice->fSubCurrentSample -= fTableSize;
             }
         }
+
+        fOutData *= pVoice->fOutGain;
     }
 
     return fOutData;
 }
 
-/* EOF */
\ No newline at end of file
+/* EOF */
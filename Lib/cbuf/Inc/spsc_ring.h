@@ -0,0 +1,168 @@
+/**
+ * @file    spsc_ring.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Lock free single producer, single consumer byte ring.
+ * @version 0.1
+ * @date    2021-12-11
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Producer and consumer may run in different contexts (ISR and task, or DMA
+ * plus ISR and task) without locks: each index is written by one side only.
+ * Indexes are free running counters, buffer size must be a power of two so
+ * wrap is a mask and a full ring is told apart from an empty one.
+ */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SPSC_RING_H
+#define __SPSC_RING_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported types ------------------------------------------------------------*/
+
+/** Ring handler */
+typedef struct spsc_ring {
+    uint8_t *pu8Buff;               /**< Storage, power of two size. */
+    uint32_t u32Mask;               /**< Size - 1. */
+    volatile uint32_t u32Head;      /**< Bytes written, owned by producer. */
+    volatile uint32_t u32Tail;      /**< Bytes read, owned by consumer. */
+} spsc_ring_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported defines ----------------------------------------------------------*/
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Init empty ring on given storage.
+ *
+ * @param pxRing ring handler.
+ * @param pu8Buff storage.
+ * @param u32Size storage size, power of two.
+ * @return true on success, false if size is not a power of two.
+ */
+bool spsc_ring_init(spsc_ring_t *pxRing, uint8_t *pu8Buff, uint32_t u32Size);
+
+/**
+ * @brief Drop all data. Only safe while producer and consumer are idle.
+ *
+ * @param pxRing ring handler.
+ */
+void spsc_ring_reset(spsc_ring_t *pxRing);
+
+/**
+ * @brief Get ring size.
+ *
+ * @param pxRing ring handler.
+ * @return uint32_t ring size in bytes.
+ */
+uint32_t spsc_ring_capacity(const spsc_ring_t *pxRing);
+
+/**
+ * @brief Get number of bytes pending to read, consumer side. Value above
+ *        capacity means producer committed more than free space (overrun).
+ *
+ * @param pxRing ring handler.
+ * @return uint32_t pending bytes.
+ */
+uint32_t spsc_ring_count(const spsc_ring_t *pxRing);
+
+/**
+ * @brief Get free space, producer side.
+ *
+ * @param pxRing ring handler.
+ * @return uint32_t free bytes.
+ */
+uint32_t spsc_ring_free(const spsc_ring_t *pxRing);
+
+/**
+ * @brief Write one byte, producer side.
+ *
+ * @param pxRing ring handler.
+ * @param u8Data byte to write.
+ * @return true on success, false if ring is full.
+ */
+bool spsc_ring_put(spsc_ring_t *pxRing, uint8_t u8Data);
+
+/**
+ * @brief Read one byte, consumer side.
+ *
+ * @param pxRing ring handler.
+ * @param pu8Data output byte.
+ * @return true on success, false if ring is empty.
+ */
+bool spsc_ring_get(spsc_ring_t *pxRing, uint8_t *pu8Data);
+
+/**
+ * @brief Write block of data, producer side. Copy is split at most in two
+ *        segments and published at once.
+ *
+ * @param pxRing ring handler.
+ * @param pu8Data data to write.
+ * @param u32Len number of bytes.
+ * @return uint32_t bytes written, less than u32Len if ring gets full.
+ */
+uint32_t spsc_ring_put_bulk(spsc_ring_t *pxRing, const uint8_t *pu8Data, uint32_t u32Len);
+
+/**
+ * @brief Read block of data, consumer side.
+ *
+ * @param pxRing ring handler.
+ * @param pu8Data output buffer.
+ * @param u32Len max number of bytes.
+ * @return uint32_t bytes read.
+ */
+uint32_t spsc_ring_get_bulk(spsc_ring_t *pxRing, uint8_t *pu8Data, uint32_t u32Len);
+
+/**
+ * @brief Get contiguous span of pending data, consumer side. Data is used in
+ *        place and released with spsc_ring_commit_read.
+ *
+ * @param pxRing ring handler.
+ * @param ppu8Data output pointer to first pending byte.
+ * @return uint32_t contiguous bytes, call again after commit to get data
+ *         after wrap.
+ */
+uint32_t spsc_ring_peek_read(const spsc_ring_t *pxRing, uint8_t **ppu8Data);
+
+/**
+ * @brief Release data read in place, consumer side.
+ *
+ * @param pxRing ring handler.
+ * @param u32Len number of bytes.
+ */
+void spsc_ring_commit_read(spsc_ring_t *pxRing, uint32_t u32Len);
+
+/**
+ * @brief Get contiguous span of free space, producer side. Data is written
+ *        in place (or by DMA) and published with spsc_ring_commit_write.
+ *
+ * @param pxRing ring handler.
+ * @param ppu8Data output pointer to first free byte.
+ * @return uint32_t contiguous free bytes.
+ */
+uint32_t spsc_ring_peek_write(const spsc_ring_t *pxRing, uint8_t **ppu8Data);
+
+/**
+ * @brief Publish data written in place, producer side.
+ *
+ * @param pxRing ring handler.
+ * @param u32Len number of bytes.
+ */
+void spsc_ring_commit_write(spsc_ring_t *pxRing, uint32_t u32Len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SPSC_RING_H */
+
+/* EOF */
@@ -0,0 +1,195 @@
+/**
+ * @file    spsc_ring.c
+ * @author  Sebastián Del Moral Gallardo
+ * @brief   Lock free single producer, single consumer byte ring.
+ * @version 0.1
+ * @date    2021-12-11
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "spsc_ring.h"
+#include "user_assert.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+
+/* Index owned by other side, data behind it is visible once index is read */
+#define SPSC_LOAD_ACQUIRE(x)        __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+
+/* Own index, data written before is visible to other side */
+#define SPSC_STORE_RELEASE(x, v)    __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private function definition -----------------------------------------------*/
+/* Public function definition ------------------------------------------------*/
+
+bool spsc_ring_init(spsc_ring_t *pxRing, uint8_t *pu8Buff, uint32_t u32Size)
+{
+    ERR_ASSERT( pxRing != NULL );
+    ERR_ASSERT( pu8Buff != NULL );
+
+    bool bRetval = false;
+
+    if ( (u32Size != 0U) && ((u32Size & (u32Size - 1U)) == 0U) )
+    {
+        pxRing->pu8Buff = pu8Buff;
+        pxRing->u32Mask = u32Size - 1U;
+        spsc_ring_reset(pxRing);
+        bRetval = true;
+    }
+
+    return bRetval;
+}
+
+void spsc_ring_reset(spsc_ring_t *pxRing)
+{
+    ERR_ASSERT( pxRing != NULL );
+
+    pxRing->u32Head = 0U;
+    pxRing->u32Tail = 0U;
+}
+
+uint32_t spsc_ring_capacity(const spsc_ring_t *pxRing)
+{
+    ERR_ASSERT( pxRing != NULL );
+
+    return pxRing->u32Mask + 1U;
+}
+
+uint32_t spsc_ring_count(const spsc_ring_t *pxRing)
+{
+    ERR_ASSERT( pxRing != NULL );
+
+    return SPSC_LOAD_ACQUIRE(pxRing->u32Head) - pxRing->u32Tail;
+}
+
+uint32_t spsc_ring_free(const spsc_ring_t *pxRing)
+{
+    ERR_ASSERT( pxRing != NULL );
+
+    uint32_t u32Used = pxRing->u32Head - SPSC_LOAD_ACQUIRE(pxRing->u32Tail);
+
+    return ( u32Used < (pxRing->u32Mask + 1U) ) ? ((pxRing->u32Mask + 1U) - u32Used) : 0U;
+}
+
+bool spsc_ring_put(spsc_ring_t *pxRing, uint8_t u8Data)
+{
+    bool bRetval = ( spsc_ring_free(pxRing) != 0U );
+
+    if ( bRetval )
+    {
+        pxRing->pu8Buff[pxRing->u32Head & pxRing->u32Mask] = u8Data;
+        SPSC_STORE_RELEASE(pxRing->u32Head, pxRing->u32Head + 1U);
+    }
+
+    return bRetval;
+}
+
+bool spsc_ring_get(spsc_ring_t *pxRing, uint8_t *pu8Data)
+{
+    ERR_ASSERT( pu8Data != NULL );
+
+    bool bRetval = ( spsc_ring_count(pxRing) != 0U );
+
+    if ( bRetval )
+    {
+        *pu8Data = pxRing->pu8Buff[pxRing->u32Tail & pxRing->u32Mask];
+        SPSC_STORE_RELEASE(pxRing->u32Tail, pxRing->u32Tail + 1U);
+    }
+
+    return bRetval;
+}
+
+uint32_t spsc_ring_put_bulk(spsc_ring_t *pxRing, const uint8_t *pu8Data, uint32_t u32Len)
+{
+    ERR_ASSERT( pu8Data != NULL );
+
+    uint32_t u32Free = spsc_ring_free(pxRing);
+    uint32_t u32Num = ( u32Len < u32Free ) ? u32Len : u32Free;
+    uint32_t u32Pos = pxRing->u32Head & pxRing->u32Mask;
+    uint32_t u32First = (pxRing->u32Mask + 1U) - u32Pos;
+
+    if ( u32First > u32Num )
+    {
+        u32First = u32Num;
+    }
+
+    (void)memcpy(&pxRing->pu8Buff[u32Pos], pu8Data, u32First);
+    (void)memcpy(pxRing->pu8Buff, &pu8Data[u32First], u32Num - u32First);
+
+    SPSC_STORE_RELEASE(pxRing->u32Head, pxRing->u32Head + u32Num);
+
+    return u32Num;
+}
+
+uint32_t spsc_ring_get_bulk(spsc_ring_t *pxRing, uint8_t *pu8Data, uint32_t u32Len)
+{
+    ERR_ASSERT( pu8Data != NULL );
+
+    uint32_t u32Count = spsc_ring_count(pxRing);
+    uint32_t u32Num = ( u32Len < u32Count ) ? u32Len : u32Count;
+    uint32_t u32Pos = pxRing->u32Tail & pxRing->u32Mask;
+    uint32_t u32First = (pxRing->u32Mask + 1U) - u32Pos;
+
+    if ( u32First > u32Num )
+    {
+        u32First = u32Num;
+    }
+
+    (void)memcpy(pu8Data, &pxRing->pu8Buff[u32Pos], u32First);
+    (void)memcpy(&pu8Data[u32First], pxRing->pu8Buff, u32Num - u32First);
+
+    SPSC_STORE_RELEASE(pxRing->u32Tail, pxRing->u32Tail + u32Num);
+
+    return u32Num;
+}
+
+uint32_t spsc_ring_peek_read(const spsc_ring_t *pxRing, uint8_t **ppu8Data)
+{
+    ERR_ASSERT( ppu8Data != NULL );
+
+    uint32_t u32Count = spsc_ring_count(pxRing);
+    uint32_t u32Pos = pxRing->u32Tail & pxRing->u32Mask;
+    uint32_t u32Linear = (pxRing->u32Mask + 1U) - u32Pos;
+
+    *ppu8Data = &pxRing->pu8Buff[u32Pos];
+
+    return ( u32Count < u32Linear ) ? u32Count : u32Linear;
+}
+
+void spsc_ring_commit_read(spsc_ring_t *pxRing, uint32_t u32Len)
+{
+    ERR_ASSERT( pxRing != NULL );
+
+    SPSC_STORE_RELEASE(pxRing->u32Tail, pxRing->u32Tail + u32Len);
+}
+
+uint32_t spsc_ring_peek_write(const spsc_ring_t *pxRing, uint8_t **ppu8Data)
+{
+    ERR_ASSERT( ppu8Data != NULL );
+
+    uint32_t u32Free = spsc_ring_free(pxRing);
+    uint32_t u32Pos = pxRing->u32Head & pxRing->u32Mask;
+    uint32_t u32Linear = (pxRing->u32Mask + 1U) - u32Pos;
+
+    *ppu8Data = &pxRing->pu8Buff[u32Pos];
+
+    return ( u32Free < u32Linear ) ? u32Free : u32Linear;
+}
+
+void spsc_ring_commit_write(spsc_ring_t *pxRing, uint32_t u32Len)
+{
+    ERR_ASSERT( pxRing != NULL );
+
+    SPSC_STORE_RELEASE(pxRing->u32Head, pxRing->u32Head + u32Len);
+}
+
+/* EOF */
@@ -108,6 +108,28 @@ typedef enum midiStatus {
 #define MIDI_CC_ATT                 0x49U
 #define MIDI_CC_NOTE_OFF            0x7BU
 
+/* Pedals, on at values from MIDI_CC_PEDAL_ON */
+#define MIDI_CC_SUSTAIN             0x40U
+#define MIDI_CC_SOSTENUTO           0x42U
+#define MIDI_CC_PEDAL_ON            0x40U
+
+/* Parameter number selection and data entry */
+#define MIDI_CC_DATA_MSB            0x06U
+#define MIDI_CC_DATA_LSB            0x26U
+#define MIDI_CC_NRPN_LSB            0x62U
+#define MIDI_CC_NRPN_MSB            0x63U
+#define MIDI_CC_RPN_LSB             0x64U
+#define MIDI_CC_RPN_MSB             0x65U
+
+/* Registered parameter numbers */
+#define MIDI_RPN_BEND_RANGE         0x00U
+#define MIDI_RPN_MPE_CONFIG         0x06U   /**< MPE configuration message, data MSB is member channel count */
+#define MIDI_RPN_NULL               0x7FU
+
+/* Pitch bend 14 bit value */
+#define MIDI_PITCH_BEND_CENTER      0x2000U
+#define MIDI_PITCH_BEND_SPAN        0x4000U
+
 #define MIDI_CC_USER_0_INI          0x14U
 #define MIDI_CC_USER_0_END          0x1FU
 
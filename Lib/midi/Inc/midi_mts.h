@@ -0,0 +1,84 @@
+/**
+ * @file    midi_mts.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Decoder of MIDI Tuning Standard universal sys ex messages.
+ * @version 0.1
+ * @date    2021-12-13
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Every supported message is reduced to a list of (note, pitch) pairs, pitch
+ * given in equal tempered semitones where 69.0 is A4 at 440 Hz. Synth keeps a
+ * single tuning table, tuning program and bank numbers are not used.
+ */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_MTS_H
+#define __MIDI_MTS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "midi_common.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/** Called once for each retuned note */
+typedef void (*midi_mts_note_cb_t)(uint8_t u8Note, float fPitch, void *pvArg);
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported defines ----------------------------------------------------------*/
+
+/* Universal sys ex ids */
+#define MTS_UNIVERSAL_NON_RT        0x7EU
+#define MTS_UNIVERSAL_RT            0x7FU
+
+/* Device id accepted by every unit */
+#define MTS_DEV_ID_ALL              0x7FU
+
+/* Sub id of tuning messages */
+#define MTS_SUB_ID                  0x08U
+
+/* Supported tuning messages, second sub id */
+#define MTS_BULK_DUMP               0x01U   /**< [prog][name x16][xx yy zz x128][checksum] */
+#define MTS_NOTE_CHANGE             0x02U   /**< [prog][num][kk xx yy zz x num] */
+#define MTS_NOTE_CHANGE_BANK        0x07U   /**< [bank][prog][num][kk xx yy zz x num] */
+#define MTS_SCALE_OCTAVE_1          0x08U   /**< [ff gg hh][ss x12], 1 cent steps */
+#define MTS_SCALE_OCTAVE_2          0x09U   /**< [ff gg hh][ss tt x12], 14 bit */
+
+/* Notes covered by a tuning table */
+#define MTS_NOTE_NUM                128U
+
+/* Size of bulk dump without F0 and F7 */
+#define MTS_BULK_DUMP_SIZE          406U
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Decode one tuning message delivered by midi lib, without F0 and F7
+ *        bytes. Notes whose frequency word is 7F 7F 7F are left untouched.
+ *
+ * @param pu8Data sys ex data.
+ * @param u32Len number of bytes.
+ * @param u8DevId device id of this unit.
+ * @param u8Channel midi channel of this unit, used by scale/octave messages.
+ * @param pNoteCB callback run for each retuned note.
+ * @param pvArg argument given to callback.
+ * @return midiStatus_t midiOk on decoded message, midiBadParam if message is
+ *         not a supported tuning message for this unit, midiError on
+ *         malformed message or bad checksum.
+ */
+midiStatus_t MTS_parse(const uint8_t *pu8Data, uint32_t u32Len, uint8_t u8DevId, uint8_t u8Channel,
+                       midi_mts_note_cb_t pNoteCB, void *pvArg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_MTS_H */
+
+/* EOF */
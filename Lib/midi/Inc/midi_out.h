@@ -0,0 +1,134 @@
+/**
+ * @file    midi_out.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Midi output queue with merge, running status and batched transfers.
+ * @version 0.1
+ * @date    2021-12-13
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * All sources of one context (thru, sequencer) queue whole messages in a byte
+ * ring, so messages never interleave. Transport gets all contiguous pending
+ * bytes in a single transfer and queue is drained on transfer end, a send
+ * never waits for the line. Producer and transport calls must run in the
+ * same context, transfer end is signalled to it by the driver.
+ */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_OUT_H
+#define __MIDI_OUT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "midi_common.h"
+#include "spsc_ring.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/** Start async transfer of data, true if transport took it. Data stays valid until MIDI_OUT_tx_done. */
+typedef bool (*midi_out_send_t)(const uint8_t *pu8Data, uint32_t u32Len);
+
+/** Output counters */
+typedef struct midi_out_stats {
+    uint32_t u32Dropped;        /**< Messages dropped on full queue. */
+    uint32_t u32Saved;          /**< Status bytes saved by running status. */
+    uint32_t u32Batches;        /**< Transfers started. */
+    uint32_t u32Pending;        /**< Bytes queued or in flight. */
+} midi_out_stats_t;
+
+/** Output handler */
+typedef struct midi_out {
+    spsc_ring_t xRing;          /**< Pending bytes, power of two size. */
+    midi_out_send_t pSend;      /**< Transport. */
+    uint32_t u32InFlight;       /**< Bytes handed to transport, released on transfer end. */
+    uint8_t u8RunningStatus;    /**< Last channel status sent, 0 if none. */
+    bool bRunningStatus;        /**< Running status compression enabled. */
+    midi_out_stats_t xStats;    /**< Counters, u32Pending only set on read. */
+} midi_out_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported defines ----------------------------------------------------------*/
+
+/* Longest channel or system common message */
+#define MIDI_OUT_MSG_MAX            3U
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Init output with empty queue, running status enabled.
+ *
+ * @param pxOut output handler.
+ * @param pu8Buff queue storage.
+ * @param u32Size storage size, power of two.
+ * @param pSend transport.
+ * @return midiStatus_t operation result.
+ */
+midiStatus_t MIDI_OUT_init(midi_out_t *pxOut, uint8_t *pu8Buff, uint32_t u32Size, midi_out_send_t pSend);
+
+/**
+ * @brief Enable or disable running status. Next channel message is always
+ *        sent with its status byte.
+ *
+ * @param pxOut output handler.
+ * @param bEnable compression state.
+ */
+void MIDI_OUT_set_running_status(midi_out_t *pxOut, bool bEnable);
+
+/**
+ * @brief Queue one channel, system common or real time message. Message is
+ *        queued whole or dropped.
+ *
+ * @param pxOut output handler.
+ * @param pu8Msg message starting with status byte.
+ * @param u32Len message size, must match status.
+ * @return midiStatus_t midiOk if queued, midiBadParam on malformed message,
+ *         midiSysExcBuffFull if queue has no room.
+ */
+midiStatus_t MIDI_OUT_send_msg(midi_out_t *pxOut, const uint8_t *pu8Msg, uint32_t u32Len);
+
+/**
+ * @brief Queue sys ex message, start and end bytes are added.
+ *
+ * @param pxOut output handler.
+ * @param pu8Data sys ex data, without start and end bytes.
+ * @param u32Len number of data bytes.
+ * @return midiStatus_t midiOk if queued, midiSysExcBuffFull if queue has no
+ *         room.
+ */
+midiStatus_t MIDI_OUT_send_sysex(midi_out_t *pxOut, const uint8_t *pu8Data, uint32_t u32Len);
+
+/**
+ * @brief Start transfer of pending bytes if transport is idle. Called once
+ *        after a group of sends, so they share one transfer.
+ *
+ * @param pxOut output handler.
+ */
+void MIDI_OUT_flush(midi_out_t *pxOut);
+
+/**
+ * @brief Release bytes of finished transfer and start next one.
+ *
+ * @param pxOut output handler.
+ */
+void MIDI_OUT_tx_done(midi_out_t *pxOut);
+
+/**
+ * @brief Get output counters, may be called from other contexts.
+ *
+ * @param pxOut output handler.
+ * @param pxStats output counters.
+ */
+void MIDI_OUT_get_stats(const midi_out_t *pxOut, midi_out_stats_t *pxStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_OUT_H */
+
+/* EOF */
@@ -0,0 +1,136 @@
+/**
+ * @file    midi_seq.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Standard MIDI File player driven by an external sample clock.
+ * @version 0.1
+ * @date    2021-12-04
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_SEQ_H
+#define __MIDI_SEQ_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "midi_common.h"
+#include "midi_smf.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/** Sequencer states */
+typedef enum midi_seq_state {
+    SEQ_STATE_IDLE = 0x00,          /**< No file loaded or stopped. */
+    SEQ_STATE_PLAY,                 /**< Events dispatched on clock updates. */
+    SEQ_STATE_END,                  /**< Last event dispatched, no loop. */
+} midi_seq_state_t;
+
+/** CB to handle events when due, channel, sys ex and meta events */
+typedef void (*midi_seq_event_cb_t)(const midi_smf_event_t *pxEvent, void *pvArg);
+
+/** Sequencer handler */
+typedef struct midi_seq {
+    midi_smf_t xSmf;                /**< File reader. */
+    midi_smf_event_t xNext;         /**< Next event read, waiting to be due. */
+    midi_seq_state_t eState;        /**< Play state. */
+    bool bLoaded;                   /**< Valid file opened. */
+    bool bNextValid;                /**< xNext holds an event. */
+    bool bLoop;                     /**< Restart file after last event. */
+    uint32_t u32SampleRate;         /**< Rate of sample clock. */
+    uint32_t u32StartClock;         /**< Sample clock at file time zero. */
+    uint32_t u32NextSample;         /**< Sample offset of xNext. */
+    uint32_t u32LoopCount;          /**< Number of file restarts. */
+    midi_seq_event_cb_t pEventCB;   /**< Event handler. */
+    void *pvEventArg;               /**< Argument of event handler. */
+} midi_seq_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported defines ----------------------------------------------------------*/
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Initiate sequencer handler.
+ *
+ * @param pxSeq sequencer handler.
+ * @param u32SampleRate rate of clock given to SEQ_update.
+ * @param pEventCB handler of due events.
+ * @param pvArg argument given to handler.
+ * @return midiStatus_t operation result.
+ */
+midiStatus_t SEQ_init(midi_seq_t *pxSeq, uint32_t u32SampleRate, midi_seq_event_cb_t pEventCB, void *pvArg);
+
+/**
+ * @brief Load file held in memory, sequencer is stopped. Buffer must stay
+ *        valid while loaded.
+ *
+ * @param pxSeq sequencer handler.
+ * @param pu8Data file content.
+ * @param u32Len file length.
+ * @return midiStatus_t midiOk on valid file, midiError on malformed header.
+ */
+midiStatus_t SEQ_load(midi_seq_t *pxSeq, const uint8_t *pu8Data, uint32_t u32Len);
+
+/**
+ * @brief Drop loaded file, sequencer is stopped.
+ *
+ * @param pxSeq sequencer handler.
+ */
+void SEQ_unload(midi_seq_t *pxSeq);
+
+/**
+ * @brief Play loaded file from first event, file time zero is current clock.
+ *
+ * @param pxSeq sequencer handler.
+ * @param u32Clock current sample clock.
+ * @return midiStatus_t midiOk on success, midiError if no file is loaded.
+ */
+midiStatus_t SEQ_start(midi_seq_t *pxSeq, uint32_t u32Clock);
+
+/**
+ * @brief Stop playback, pending event is dropped. Notes still active must be
+ *        released by caller.
+ *
+ * @param pxSeq sequencer handler.
+ */
+void SEQ_stop(midi_seq_t *pxSeq);
+
+/**
+ * @brief Restart file once last event is dispatched.
+ *
+ * @param pxSeq sequencer handler.
+ * @param bLoop loop enable.
+ */
+void SEQ_set_loop(midi_seq_t *pxSeq, bool bLoop);
+
+/**
+ * @brief Dispatch every event due at given clock. Clock wraps around, file
+ *        position is tracked as offset from start clock.
+ *
+ * @param pxSeq sequencer handler.
+ * @param u32Clock current sample clock.
+ * @return midiStatus_t midiOk on success, midiError on malformed track.
+ */
+midiStatus_t SEQ_update(midi_seq_t *pxSeq, uint32_t u32Clock);
+
+/**
+ * @brief Get sequencer state.
+ *
+ * @param pxSeq sequencer handler.
+ * @return midi_seq_state_t current state.
+ */
+midi_seq_state_t SEQ_get_state(const midi_seq_t *pxSeq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_SEQ_H */
+
+/* EOF */
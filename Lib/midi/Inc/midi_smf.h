@@ -0,0 +1,120 @@
+/**
+ * @file    midi_smf.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Standard MIDI File reader, tracks are merged in time order.
+ * @version 0.1
+ * @date    2021-11-28
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_SMF_H
+#define __MIDI_SMF_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "midi_common.h"
+
+/* Exported defines ----------------------------------------------------------*/
+
+/* Max number of tracks handled, extra tracks are ignored */
+#define SMF_MAX_TRACKS              16U
+
+/* Tempo used until first tempo meta event, 120 bpm */
+#define SMF_DEFAULT_TEMPO_US        500000U
+
+/* Meta event types */
+#define SMF_META_END_OF_TRACK       0x2FU
+#define SMF_META_TEMPO              0x51U
+
+/* Exported types ------------------------------------------------------------*/
+
+/** Type of event delivered by reader */
+typedef enum midi_smf_evt_type {
+    SMF_EVT_MIDI = 0x00,            /**< Channel message, bytes in pu8Msg. */
+    SMF_EVT_SYSEX,                  /**< Sys ex data after F0 or F7 byte. */
+    SMF_EVT_META,                   /**< Meta event, type in u8MetaType. */
+    SMF_EVT_END,                    /**< All tracks finished. */
+} midi_smf_evt_type_t;
+
+/** Event delivered by reader, data points inside file buffer */
+typedef struct midi_smf_event {
+    midi_smf_evt_type_t eType;      /**< Event type. */
+    uint32_t u32Tick;               /**< Absolute time in ticks. */
+    uint64_t u64TimeUs;             /**< Absolute time in microseconds. */
+    uint8_t u8Track;                /**< Source track. */
+    uint8_t pu8Msg[3];              /**< Channel message, status included. */
+    uint8_t u8MsgLen;               /**< Channel message length. */
+    uint8_t u8MetaType;             /**< Meta event type. */
+    const uint8_t *pu8Data;         /**< Sys ex or meta data. */
+    uint32_t u32DataLen;            /**< Sys ex or meta data length. */
+} midi_smf_event_t;
+
+/** Track reader state */
+typedef struct midi_smf_track {
+    const uint8_t *pu8Start;        /**< First event of track. */
+    const uint8_t *pu8Pos;          /**< Next event to read. */
+    const uint8_t *pu8End;          /**< End of track chunk. */
+    uint32_t u32NextTick;           /**< Absolute tick of next event. */
+    uint8_t u8RunningStatus;        /**< Running status of track. */
+    bool bEnded;                    /**< No more events in track. */
+} midi_smf_track_t;
+
+/** File reader handler */
+typedef struct midi_smf {
+    midi_smf_track_t pxTrack[SMF_MAX_TRACKS];
+    uint16_t u16Format;             /**< File format, 0, 1 or 2. */
+    uint16_t u16TrackNum;           /**< Tracks handled. */
+    uint16_t u16Division;           /**< Raw division field of header. */
+    uint32_t u32TempoUs;            /**< Current tempo, us per quarter note. */
+    uint32_t u32TempoTick;          /**< Tick of last tempo change. */
+    uint64_t u64TempoTimeUs;        /**< Time of last tempo change. */
+    uint32_t u32LastTick;           /**< Tick of last event read. */
+    uint64_t u64LastTimeUs;         /**< Time of last event read. */
+} midi_smf_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Open file held in memory. Buffer must stay valid while reading.
+ *
+ * @param pxSmf reader handler.
+ * @param pu8Data file content.
+ * @param u32Len file length.
+ * @return midiStatus_t midiOk on valid header, midiError on malformed file.
+ */
+midiStatus_t SMF_open(midi_smf_t *pxSmf, const uint8_t *pu8Data, uint32_t u32Len);
+
+/**
+ * @brief Restart reading from first event of every track.
+ *
+ * @param pxSmf reader handler.
+ * @return midiStatus_t midiOk on success, midiError on malformed track.
+ */
+midiStatus_t SMF_rewind(midi_smf_t *pxSmf);
+
+/**
+ * @brief Get next event of file, tracks merged in time order. Tempo changes
+ *        are applied while reading, event time is already in microseconds.
+ *
+ * @param pxSmf reader handler.
+ * @param pxEvent output event, SMF_EVT_END once all tracks are finished.
+ * @return midiStatus_t midiOk on success, midiError on malformed track.
+ */
+midiStatus_t SMF_next_event(midi_smf_t *pxSmf, midi_smf_event_t *pxEvent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_SMF_H */
+
+/* EOF */
@@ -0,0 +1,127 @@
+/**
+ * @file    midi_sysex.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Framing, 7 bit packing and checksum of synth system exclusive messages.
+ * @version 0.1
+ * @date    2021-11-20
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_SYSEX_H
+#define __MIDI_SYSEX_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "midi_common.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/** Parsed synth sys ex message, payload points inside the source buffer */
+typedef struct midi_sysex_msg {
+    uint8_t u8DevId;                /**< Target device id. */
+    uint8_t u8Cmd;                  /**< Synth command. */
+    const uint8_t *pu8Payload;      /**< Command payload, 7 bit data. */
+    uint32_t u32PayloadLen;         /**< Payload length in bytes. */
+} midi_sysex_msg_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+
+/* Packed size of a block of raw bytes, one extra MSB byte each 7 bytes */
+#define SYSEX_PACKED_SIZE(len)      ( (len) + (((len) + 6U) / 7U) )
+
+/* Exported defines ----------------------------------------------------------*/
+
+/* Non commercial manufacturer id */
+#define SYSEX_MANUFACTURER_ID       0x7DU
+
+/* Device id accepted by every unit */
+#define SYSEX_DEV_ID_ALL            0x7FU
+
+/* Bytes around payload: manufacturer, device, command and checksum */
+#define SYSEX_HEADER_SIZE           3U
+#define SYSEX_FRAME_OVERHEAD        ( SYSEX_HEADER_SIZE + 1U )
+
+/* Wave upload commands */
+#define SYSEX_CMD_WAVE_BEGIN        0x10U   /**< [slot] */
+#define SYSEX_CMD_WAVE_DATA         0x11U   /**< [slot][chunk][packed samples] */
+#define SYSEX_CMD_WAVE_END          0x12U   /**< [slot] */
+
+/* Samples of each wave data chunk, int16 little endian before packing */
+#define SYSEX_WAVE_CHUNK_SAMPLES    32U
+#define SYSEX_WAVE_CHUNK_BYTES      ( SYSEX_WAVE_CHUNK_SAMPLES * 2U )
+
+/* Sequencer commands, file upload to RAM and playback control */
+#define SYSEX_CMD_SEQ_BEGIN         0x20U   /**< no payload */
+#define SYSEX_CMD_SEQ_DATA          0x21U   /**< [offset lsb][offset msb][packed file bytes] */
+#define SYSEX_CMD_SEQ_END           0x22U   /**< no payload */
+#define SYSEX_CMD_SEQ_PLAY          0x23U   /**< [source][loop] */
+#define SYSEX_CMD_SEQ_STOP          0x24U   /**< no payload */
+
+/* Max file bytes of each sequencer data chunk before packing, offset in 14 bits */
+#define SYSEX_SEQ_CHUNK_BYTES       64U
+#define SYSEX_SEQ_OFFSET_MAX        0x3FFFU
+
+/* Sequencer play sources */
+#define SYSEX_SEQ_SRC_FLASH         0x00U
+#define SYSEX_SEQ_SRC_USER          0x01U
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Pack 8 bit data in 7 bit bytes. Each group of 7 bytes is preceded by
+ *        a byte holding the MSB of the group, first byte in bit 0.
+ *
+ * @param pu8In raw data.
+ * @param u32Len number of raw bytes.
+ * @param pu8Out output buffer, at least SYSEX_PACKED_SIZE(u32Len) bytes.
+ * @return uint32_t number of bytes written.
+ */
+uint32_t SYSEX_pack(const uint8_t *pu8In, uint32_t u32Len, uint8_t *pu8Out);
+
+/**
+ * @brief Unpack 7 bit data generated with SYSEX_pack.
+ *
+ * @param pu8In packed data.
+ * @param u32Len number of packed bytes.
+ * @param pu8Out output buffer.
+ * @param u32OutSize size of output buffer.
+ * @return uint32_t number of bytes written, 0 on malformed input or no room.
+ */
+uint32_t SYSEX_unpack(const uint8_t *pu8In, uint32_t u32Len, uint8_t *pu8Out, uint32_t u32OutSize);
+
+/**
+ * @brief Compute checksum of data, sum of data plus checksum is 0 modulo 128.
+ *
+ * @param pu8Data data to check.
+ * @param u32Len number of bytes.
+ * @return uint8_t 7 bit checksum.
+ */
+uint8_t SYSEX_checksum(const uint8_t *pu8Data, uint32_t u32Len);
+
+/**
+ * @brief Parse sys ex data delivered by midi lib, without F0 and F7 bytes.
+ *
+ * @param pu8Data sys ex data.
+ * @param u32Len number of bytes.
+ * @param u8DevId device id of this unit.
+ * @param pxMsg output message.
+ * @return midiStatus_t midiOk on valid message, midiBadParam if message is
+ *         not addressed to this unit, midiError on bad checksum.
+ */
+midiStatus_t SYSEX_parse(const uint8_t *pu8Data, uint32_t u32Len, uint8_t u8DevId, midi_sysex_msg_t *pxMsg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_SYSEX_H */
+
+/* EOF */
@@ -23,6 +23,22 @@ extern "C"
 
 /* Exported types ------------------------------------------------------------*/
 
+/** Max voices of one handler, one bit each in free mask */
+#define MIDI_VOICE_MAX              ( 32U )
+
+/** Number of midi notes */
+#define MIDI_VOICE_NOTE_NUM         ( 128U )
+
+/** Note map entry without voice */
+#define MIDI_VOICE_NONE             ( 0xFFU )
+
+/** Number of midi channels */
+#define MIDI_VOICE_CH_NUM           ( 16U )
+
+/** MPE zone master channels */
+#define MIDI_VOICE_MPE_LOWER        ( 0x00U )
+#define MIDI_VOICE_MPE_UPPER        ( 0x0FU )
+
 /** Voice states */
 typedef enum midi_voice_state {
     VOICE_STATE_NONE    = 0U,   /**< No change in voice. */
@@ -35,14 +51,42 @@ typedef enum midi_voice_state {
 /** CB to handle voice actions */
 typedef void (*midi_voice_action_cb_t)(uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity, midi_voice_state_t eAction);
 
+/** CB to release group of voices at once, bit n set for voice n */
+typedef void (*midi_voice_release_cb_t)(uint32_t u32VoiceMask);
+
+/** Per note expression of MPE member channels */
+typedef enum midi_voice_expr {
+    VOICE_EXPR_RESET    = 0U,   /**< Voice back to neutral expression, value unused. */
+    VOICE_EXPR_BEND,            /**< 14 bit pitch bend, MIDI_PITCH_BEND_CENTER at rest. */
+    VOICE_EXPR_PRESSURE,        /**< 7 bit channel pressure. */
+    VOICE_EXPR_TIMBRE,          /**< 7 bit CC 74. */
+    VOICE_EXPR_NUM,             /**< Num expressions. */
+} midi_voice_expr_t;
+
+/** CB to route expression to one voice, raw midi value */
+typedef void (*midi_voice_expr_cb_t)(uint8_t u8Voice, midi_voice_expr_t eExpr, uint16_t u16Value);
+
 /** Voice control data */
 typedef struct midi_voice {
     uint8_t u8Ch;
     uint8_t u8Note;
     uint8_t u8Velocity;
     midi_voice_state_t eState;
+    uint8_t u8MidiCh;           /**< MPE member channel of note, MIDI_VOICE_NONE if none. */
 } midi_voice_t;
 
+/** MPE zone, each member channel carries notes with their own expression */
+typedef struct midi_voice_mpe {
+    uint8_t u8MasterCh;                         /**< Master channel, lower or upper zone. */
+    uint8_t u8FirstCh;                          /**< Lowest member channel. */
+    uint8_t u8MemberNum;                        /**< Member channels, 0 when zone is disabled. */
+    uint16_t pu16Bend[MIDI_VOICE_CH_NUM];       /**< Last pitch bend of each channel. */
+    uint8_t pu8Pressure[MIDI_VOICE_CH_NUM];     /**< Last channel pressure of each channel. */
+    uint8_t pu8Timbre[MIDI_VOICE_CH_NUM];       /**< Last CC 74 of each channel. */
+    uint32_t pu32ChMask[MIDI_VOICE_CH_NUM];     /**< Voices with key down on each channel, same bit order as free mask. */
+    uint32_t u32ExprMask;                       /**< Voices left with per note expression. */
+} midi_voice_mpe_t;
+
 /** Voice control data */
 typedef struct midi_voice_handler {
     midi_voice_t *pxVoiceList;
@@ -50,6 +94,15 @@ typedef struct midi_voice_handler {
     uint8_t u8VoiceNum;
     uint8_t u8MidiCh;
     midi_voice_action_cb_t xVoiceActionCB;
+    uint32_t u32FreeMask;                       /**< Bit 31 - n set when voice n is free. */
+    uint8_t pu8NoteMap[MIDI_VOICE_NOTE_NUM];    /**< Voice playing each note, MIDI_VOICE_NONE if none. */
+    midi_voice_release_cb_t xReleaseCB;         /**< Optional bulk release, pedal lift. */
+    bool bSustain;                              /**< Sustain pedal down. */
+    bool bSostenuto;                            /**< Sostenuto pedal down. */
+    uint32_t u32HeldMask;                       /**< Voices with note off deferred by a pedal, same bit order as free mask. */
+    uint32_t u32SostenutoMask;                  /**< Voices latched when sostenuto went down. */
+    midi_voice_expr_cb_t xExprCB;               /**< Optional per note expression output. */
+    midi_voice_mpe_t xMpe;                      /**< MPE zone state. */
 } midi_voice_handler_t;
 
 /* Exported constants --------------------------------------------------------*/
@@ -62,7 +115,7 @@ typedef struct midi_voice_handler {
  * 
  * @param pxVoiceHandler pointer to voice handler control structure to initiate.
  * @param pxVoiceList pointer to the list of voices to use with handler.
- * @param u8VoiceNum number of voices in list.
+ * @param u8VoiceNum number of voices in list, up to MIDI_VOICE_MAX.
  * @param u8MidiCh Assigned midi channel.
  * @param xActionCB Callback to handle actions derived of voice processing.
  * @return midiStatus_t Operation result.
@@ -114,6 +167,72 @@ midiStatus_t VOICE_update_mode(midi_voice_handler_t *pxVoiceHandler, midiMode_t
  */
 midiStatus_t VOICE_update_ch(midi_voice_handler_t *pxVoiceHandler, uint8_t u8NewCh);
 
+/**
+ * @brief Register callback used to release voices held by pedals in one
+ *        call. Without it, each voice gets a VOICE_STATE_OFF action.
+ * 
+ * @param pxVoiceHandler pointer to voice handler.
+ * @param xReleaseCB bulk release callback, NULL to remove it.
+ * @return midiStatus_t operation result.
+ */
+midiStatus_t VOICE_set_release_cb(midi_voice_handler_t *pxVoiceHandler, midi_voice_release_cb_t xReleaseCB);
+
+/**
+ * @brief Update sustain pedal (CC 64). While down, note offs are deferred
+ *        and voices keep sounding, on lift all of them are released at once.
+ * 
+ * @param pxVoiceHandler pointer to voice handler.
+ * @param bDown pedal state.
+ * @return midiStatus_t operation result.
+ */
+midiStatus_t VOICE_set_sustain(midi_voice_handler_t *pxVoiceHandler, bool bDown);
+
+/**
+ * @brief Update sostenuto pedal (CC 66). Only notes playing when pedal goes
+ *        down are held, notes played later follow their keys.
+ * 
+ * @param pxVoiceHandler pointer to voice handler.
+ * @param bDown pedal state.
+ * @return midiStatus_t operation result.
+ */
+midiStatus_t VOICE_set_sostenuto(midi_voice_handler_t *pxVoiceHandler, bool bDown);
+
+/**
+ * @brief Register callback used to route per note expression to voices.
+ * 
+ * @param pxVoiceHandler pointer to voice handler.
+ * @param xExprCB expression callback, NULL to remove it.
+ * @return midiStatus_t operation result.
+ */
+midiStatus_t VOICE_set_expr_cb(midi_voice_handler_t *pxVoiceHandler, midi_voice_expr_cb_t xExprCB);
+
+/**
+ * @brief Configure MPE zone. Notes on member channels get a poly voice each,
+ *        whatever the midi mode, and follow expression of their channel.
+ *        One zone is handled, voices of previous zone are turned off.
+ * 
+ * @param pxVoiceHandler pointer to voice handler.
+ * @param u8MasterCh MIDI_VOICE_MPE_LOWER (members from channel 1 up) or
+ *        MIDI_VOICE_MPE_UPPER (members from channel 14 down).
+ * @param u8MemberNum member channels, 0 to 15, 0 disables zone.
+ * @return midiStatus_t operation result.
+ */
+midiStatus_t VOICE_set_mpe_zone(midi_voice_handler_t *pxVoiceHandler, uint8_t u8MasterCh, uint8_t u8MemberNum);
+
+/**
+ * @brief Update per note expression with channel message. Pitch bend,
+ *        channel pressure and CC 74 of member channels are routed to voices
+ *        of that channel and kept for next notes.
+ * 
+ * @param pxVoiceHandler pointer to voice handler.
+ * @param u8Cmd midi status.
+ * @param u8Data0 first data byte.
+ * @param u8Data1 second data byte, unused by channel pressure.
+ * @return midiStatus_t midiOk if message was per note expression,
+ *         midiBadParam if it must be handled as channel wide message.
+ */
+midiStatus_t VOICE_update_expression(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Cmd, uint8_t u8Data0, uint8_t u8Data1);
+
 #ifdef __cplusplus
 }
 #endif
@@ -164,11 +164,18 @@ static midiStatus_t state_handler_wait_byte_sys_ex(midi_handler_t *midi_handler,
                                                     midi_handler->ctrl_var.sys_ex_buff, 
                                                     midi_handler->ctrl_var.i_data_sys_ex);
                     }
-                    // midi_handler->ctrl_var.i_data_sys_ex = 0U
                 }
+
+                /* End of sys_ex is not a new status, also clears running status */
+                midi_handler->ctrl_var.i_data_sys_ex = 0U;
+                midi_handler->ctrl_var.tmp_running_status = 0U;
+                midi_handler->ctrl_var.fsm_state = (uint32_t)wait_byte_init;
+            }
+            else
+            {
+                midi_handler->ctrl_var.fsm_state = dispatch_status;
+                retval = midiHandleNewState;
             }
-            midi_handler->ctrl_var.fsm_state = dispatch_status;
-            retval = midiHandleNewState;
         }
     }
     else
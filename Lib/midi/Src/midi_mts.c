@@ -0,0 +1,242 @@
+/**
+ * @file    midi_mts.c
+ * @author  Sebastián Del Moral Gallardo
+ * @brief   Decoder of MIDI Tuning Standard universal sys ex messages.
+ * @version 0.1
+ * @date    2021-12-13
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "midi_mts.h"
+#include "user_assert.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+
+/* Bytes before message body: universal id, device, sub id 1 and sub id 2 */
+#define MTS_HEADER_SIZE             4U
+
+/* Frequency word, semitone plus 14 bit fraction */
+#define MTS_FREQ_WORD_SIZE          3U
+#define MTS_FREQ_NO_CHANGE          0x7FU
+#define MTS_FRACTION_SPAN           16384.0F
+
+/* Note change entry, note number plus frequency word */
+#define MTS_NOTE_ENTRY_SIZE         ( 1U + MTS_FREQ_WORD_SIZE )
+
+/* Bulk dump layout */
+#define MTS_BULK_NAME_SIZE          16U
+#define MTS_BULK_DATA_INDEX         ( MTS_HEADER_SIZE + 1U + MTS_BULK_NAME_SIZE )
+
+/* Scale/octave layout, channel mask in 3 bytes then one entry per pitch class */
+#define MTS_SCALE_MASK_SIZE         3U
+#define MTS_SCALE_DATA_INDEX        ( MTS_HEADER_SIZE + MTS_SCALE_MASK_SIZE )
+#define MTS_SCALE_CLASS_NUM         12U
+#define MTS_SCALE_1_CENTER          64.0F
+#define MTS_SCALE_2_CENTER          8192.0F
+#define MTS_SCALE_2_CENTS           ( 100.0F / 8192.0F )
+
+/* Channels held in each byte of the scale/octave channel mask */
+#define MTS_MASK_CH_PER_BYTE        7U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief Decode frequency word.
+ *
+ * @param pu8Word 3 bytes frequency word.
+ * @param pfPitch output pitch in semitones.
+ * @return true if note must be retuned, false on no change word.
+ */
+static bool mts_decode_freq(const uint8_t *pu8Word, float *pfPitch);
+
+/**
+ * @brief Decode list of single note changes.
+ *
+ * @param pu8Data first byte of list, after entry count.
+ * @param u32Num number of entries.
+ * @param pNoteCB note callback.
+ * @param pvArg callback argument.
+ */
+static void mts_note_change(const uint8_t *pu8Data, uint32_t u32Num, midi_mts_note_cb_t pNoteCB, void *pvArg);
+
+/**
+ * @brief Check if channel is set in scale/octave channel mask.
+ *
+ * @param pu8Mask 3 bytes channel mask, ff gg hh.
+ * @param u8Channel midi channel, 0 to 15.
+ * @return true if channel is addressed.
+ */
+static bool mts_channel_in_mask(const uint8_t *pu8Mask, uint8_t u8Channel);
+
+/* Private function definition -----------------------------------------------*/
+
+static bool mts_decode_freq(const uint8_t *pu8Word, float *pfPitch)
+{
+    bool bRetval = false;
+
+    if ( (pu8Word[0U] != MTS_FREQ_NO_CHANGE) || (pu8Word[1U] != MTS_FREQ_NO_CHANGE) || (pu8Word[2U] != MTS_FREQ_NO_CHANGE) )
+    {
+        uint32_t u32Fraction = ((uint32_t)pu8Word[1U] << 7U) | (uint32_t)pu8Word[2U];
+
+        *pfPitch = (float)pu8Word[0U] + ((float)u32Fraction / MTS_FRACTION_SPAN);
+        bRetval = true;
+    }
+
+    return bRetval;
+}
+
+static void mts_note_change(const uint8_t *pu8Data, uint32_t u32Num, midi_mts_note_cb_t pNoteCB, void *pvArg)
+{
+    for ( uint32_t i = 0U; i < u32Num; i++ )
+    {
+        const uint8_t *pu8Entry = &pu8Data[i * MTS_NOTE_ENTRY_SIZE];
+        float fPitch = 0.0F;
+
+        if ( (pu8Entry[0U] < MTS_NOTE_NUM) && mts_decode_freq(&pu8Entry[1U], &fPitch) )
+        {
+            pNoteCB(pu8Entry[0U], fPitch, pvArg);
+        }
+    }
+}
+
+static bool mts_channel_in_mask(const uint8_t *pu8Mask, uint8_t u8Channel)
+{
+    /* Last byte holds channels 0 to 6, first byte channels 14 and 15 */
+    uint32_t u32Byte = (MTS_SCALE_MASK_SIZE - 1U) - ((uint32_t)u8Channel / MTS_MASK_CH_PER_BYTE);
+    uint32_t u32Bit = (uint32_t)u8Channel % MTS_MASK_CH_PER_BYTE;
+
+    return ( (pu8Mask[u32Byte] & (1U << u32Bit)) != 0U );
+}
+
+/* Public function definition ------------------------------------------------*/
+
+midiStatus_t MTS_parse(const uint8_t *pu8Data, uint32_t u32Len, uint8_t u8DevId, uint8_t u8Channel,
+                       midi_mts_note_cb_t pNoteCB, void *pvArg)
+{
+    ERR_ASSERT( pu8Data != NULL );
+    ERR_ASSERT( pNoteCB != NULL );
+    ERR_ASSERT( u8Channel <= MIDI_CHANNEL_MAX_VALUE );
+
+    midiStatus_t eRetval = midiBadParam;
+
+    if ( (u32Len > MTS_HEADER_SIZE) &&
+         ((pu8Data[0U] == MTS_UNIVERSAL_NON_RT) || (pu8Data[0U] == MTS_UNIVERSAL_RT)) &&
+         ((pu8Data[1U] == u8DevId) || (pu8Data[1U] == MTS_DEV_ID_ALL)) &&
+         (pu8Data[2U] == MTS_SUB_ID) )
+    {
+        const uint8_t *pu8Body = &pu8Data[MTS_HEADER_SIZE];
+        uint32_t u32BodyLen = u32Len - MTS_HEADER_SIZE;
+
+        eRetval = midiError;
+
+        switch ( pu8Data[3U] )
+        {
+            case MTS_BULK_DUMP:
+            {
+                if ( u32Len == MTS_BULK_DUMP_SIZE )
+                {
+                    /* Checksum is XOR of all bytes before it */
+                    uint8_t u8Checksum = 0U;
+
+                    for ( uint32_t i = 0U; i < (u32Len - 1U); i++ )
+                    {
+                        u8Checksum ^= pu8Data[i];
+                    }
+
+                    if ( (u8Checksum & 0x7FU) == pu8Data[u32Len - 1U] )
+                    {
+                        for ( uint32_t u32Note = 0U; u32Note < MTS_NOTE_NUM; u32Note++ )
+                        {
+                            float fPitch = 0.0F;
+
+                            if ( mts_decode_freq(&pu8Data[MTS_BULK_DATA_INDEX + (u32Note * MTS_FREQ_WORD_SIZE)], &fPitch) )
+                            {
+                                pNoteCB((uint8_t)u32Note, fPitch, pvArg);
+                            }
+                        }
+
+                        eRetval = midiOk;
+                    }
+                }
+                break;
+            }
+
+            case MTS_NOTE_CHANGE:
+            {
+                if ( (u32BodyLen >= 2U) && (u32BodyLen == (2U + ((uint32_t)pu8Body[1U] * MTS_NOTE_ENTRY_SIZE))) )
+                {
+                    mts_note_change(&pu8Body[2U], pu8Body[1U], pNoteCB, pvArg);
+                    eRetval = midiOk;
+                }
+                break;
+            }
+
+            case MTS_NOTE_CHANGE_BANK:
+            {
+                if ( (u32BodyLen >= 3U) && (u32BodyLen == (3U + ((uint32_t)pu8Body[2U] * MTS_NOTE_ENTRY_SIZE))) )
+                {
+                    mts_note_change(&pu8Body[3U], pu8Body[2U], pNoteCB, pvArg);
+                    eRetval = midiOk;
+                }
+                break;
+            }
+
+            case MTS_SCALE_OCTAVE_1:
+            case MTS_SCALE_OCTAVE_2:
+            {
+                uint32_t u32EntrySize = ( pu8Data[3U] == MTS_SCALE_OCTAVE_1 ) ? 1U : 2U;
+
+                if ( u32Len != (MTS_SCALE_DATA_INDEX + (MTS_SCALE_CLASS_NUM * u32EntrySize)) )
+                {
+                    /* Malformed, keep error */
+                }
+                else if ( !mts_channel_in_mask(pu8Body, u8Channel) )
+                {
+                    eRetval = midiBadParam;
+                }
+                else
+                {
+                    const uint8_t *pu8Class = &pu8Data[MTS_SCALE_DATA_INDEX];
+                    float fCents[MTS_SCALE_CLASS_NUM];
+
+                    for ( uint32_t i = 0U; i < MTS_SCALE_CLASS_NUM; i++ )
+                    {
+                        if ( u32EntrySize == 1U )
+                        {
+                            fCents[i] = (float)pu8Class[i] - MTS_SCALE_1_CENTER;
+                        }
+                        else
+                        {
+                            uint32_t u32Value = ((uint32_t)pu8Class[2U * i] << 7U) | (uint32_t)pu8Class[(2U * i) + 1U];
+
+                            fCents[i] = ((float)u32Value - MTS_SCALE_2_CENTER) * MTS_SCALE_2_CENTS;
+                        }
+                    }
+
+                    for ( uint32_t u32Note = 0U; u32Note < MTS_NOTE_NUM; u32Note++ )
+                    {
+                        pNoteCB((uint8_t)u32Note, (float)u32Note + (fCents[u32Note % MTS_SCALE_CLASS_NUM] / 100.0F), pvArg);
+                    }
+
+                    eRetval = midiOk;
+                }
+                break;
+            }
+
+            default:
+                eRetval = midiBadParam;
+                break;
+        }
+    }
+
+    return eRetval;
+}
+
+/* EOF */
@@ -0,0 +1,263 @@
+/**
+ * @file    midi_out.c
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Midi output queue with merge, running status and batched transfers.
+ * @version 0.1
+ * @date    2021-12-13
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "midi_out.h"
+#include "user_assert.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+
+/* No running status held */
+#define OUT_STATUS_NONE             0x00U
+
+/* Status and data byte check */
+#define OUT_STATUS_FLAG             0x80U
+#define OUT_SYS_COMMON_MASK         0xF0U
+
+/* Tune request, only system common without data */
+#define OUT_TUNE_REQUEST            0xF6U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief Get expected size of message starting with given status byte.
+ *
+ * @param u8Status status byte.
+ * @return uint32_t message size, 0 if status can not be sent as single message.
+ */
+static uint32_t out_msg_size(uint8_t u8Status);
+
+/**
+ * @brief Queue bytes only if all of them fit.
+ *
+ * @param pxOut output handler.
+ * @param pu8Data bytes to queue.
+ * @param u32Len number of bytes.
+ * @return true if queued.
+ */
+static bool out_put(midi_out_t *pxOut, const uint8_t *pu8Data, uint32_t u32Len);
+
+/* Private function definition -----------------------------------------------*/
+
+static uint32_t out_msg_size(uint8_t u8Status)
+{
+    uint32_t u32Retval = 0U;
+
+    if ( u8Status >= MIDI_RT_MASK )
+    {
+        u32Retval = 1U;
+    }
+    else if ( u8Status < OUT_SYS_COMMON_MASK )
+    {
+        uint8_t u8Cmd = MIDI_CMD_GET_STATUS(u8Status);
+
+        u32Retval = ( (u8Cmd == MIDI_STATUS_PROG_CHANGE) || (u8Cmd == MIDI_STATUS_CH_PRESS) ) ? 2U : 3U;
+    }
+    else if ( (u8Status == MIDI_STATUS_TIME_CODE) || (u8Status == MIDI_STATUS_SONG_SELECT) )
+    {
+        u32Retval = 2U;
+    }
+    else if ( u8Status == MIDI_STATUS_SONG_POS )
+    {
+        u32Retval = 3U;
+    }
+    else if ( u8Status == OUT_TUNE_REQUEST )
+    {
+        u32Retval = 1U;
+    }
+    else
+    {
+        /* Sys ex framing and undefined status, not a single message */
+    }
+
+    return u32Retval;
+}
+
+static bool out_put(midi_out_t *pxOut, const uint8_t *pu8Data, uint32_t u32Len)
+{
+    bool bRetval = false;
+
+    if ( spsc_ring_free(&pxOut->xRing) >= u32Len )
+    {
+        (void)spsc_ring_put_bulk(&pxOut->xRing, pu8Data, u32Len);
+        bRetval = true;
+    }
+
+    return bRetval;
+}
+
+/* Public function definition ------------------------------------------------*/
+
+midiStatus_t MIDI_OUT_init(midi_out_t *pxOut, uint8_t *pu8Buff, uint32_t u32Size, midi_out_send_t pSend)
+{
+    ERR_ASSERT( pxOut != NULL );
+    ERR_ASSERT( pu8Buff != NULL );
+    ERR_ASSERT( pSend != NULL );
+
+    midiStatus_t eRetval = midiBadParam;
+
+    if ( spsc_ring_init(&pxOut->xRing, pu8Buff, u32Size) )
+    {
+        pxOut->pSend = pSend;
+        pxOut->u32InFlight = 0U;
+        pxOut->u8RunningStatus = OUT_STATUS_NONE;
+        pxOut->bRunningStatus = true;
+        pxOut->xStats.u32Dropped = 0U;
+        pxOut->xStats.u32Saved = 0U;
+        pxOut->xStats.u32Batches = 0U;
+        pxOut->xStats.u32Pending = 0U;
+        eRetval = midiOk;
+    }
+
+    return eRetval;
+}
+
+void MIDI_OUT_set_running_status(midi_out_t *pxOut, bool bEnable)
+{
+    ERR_ASSERT( pxOut != NULL );
+
+    pxOut->bRunningStatus = bEnable;
+    pxOut->u8RunningStatus = OUT_STATUS_NONE;
+}
+
+midiStatus_t MIDI_OUT_send_msg(midi_out_t *pxOut, const uint8_t *pu8Msg, uint32_t u32Len)
+{
+    ERR_ASSERT( pxOut != NULL );
+    ERR_ASSERT( pu8Msg != NULL );
+
+    midiStatus_t eRetval = midiBadParam;
+
+    if ( (u32Len > 0U) && (u32Len <= MIDI_OUT_MSG_MAX) && (out_msg_size(pu8Msg[0U]) == u32Len) )
+    {
+        bool bValid = true;
+
+        for ( uint32_t i = 1U; i < u32Len; i++ )
+        {
+            bValid = bValid && ( (pu8Msg[i] & OUT_STATUS_FLAG) == 0U );
+        }
+
+        if ( bValid )
+        {
+            uint8_t u8Status = pu8Msg[0U];
+            bool bSkipStatus = ( pxOut->bRunningStatus && (u8Status == pxOut->u8RunningStatus) );
+            const uint8_t *pu8Data = ( bSkipStatus ) ? &pu8Msg[1U] : pu8Msg;
+            uint32_t u32DataLen = ( bSkipStatus ) ? (u32Len - 1U) : u32Len;
+
+            if ( out_put(pxOut, pu8Data, u32DataLen) )
+            {
+                if ( bSkipStatus )
+                {
+                    pxOut->xStats.u32Saved++;
+                }
+                else if ( u8Status < OUT_SYS_COMMON_MASK )
+                {
+                    pxOut->u8RunningStatus = ( pxOut->bRunningStatus ) ? u8Status : OUT_STATUS_NONE;
+                }
+                else if ( u8Status < MIDI_RT_MASK )
+                {
+                    /* System common cancels running status on receivers */
+                    pxOut->u8RunningStatus = OUT_STATUS_NONE;
+                }
+                else
+                {
+                    /* Real time does not touch running status */
+                }
+
+                eRetval = midiOk;
+            }
+            else
+            {
+                pxOut->xStats.u32Dropped++;
+                eRetval = midiSysExcBuffFull;
+            }
+        }
+    }
+
+    return eRetval;
+}
+
+midiStatus_t MIDI_OUT_send_sysex(midi_out_t *pxOut, const uint8_t *pu8Data, uint32_t u32Len)
+{
+    ERR_ASSERT( pxOut != NULL );
+    ERR_ASSERT( (pu8Data != NULL) || (u32Len == 0U) );
+
+    midiStatus_t eRetval = midiSysExcBuffFull;
+    uint8_t u8Start = MIDI_STATUS_SYS_EX_START;
+    uint8_t u8End = MIDI_STATUS_SYS_EX_END;
+
+    /* Framing is checked with data, message goes whole or not at all */
+    if ( spsc_ring_free(&pxOut->xRing) >= (u32Len + 2U) )
+    {
+        (void)out_put(pxOut, &u8Start, 1U);
+
+        /* Empty message is only framing */
+        if ( u32Len != 0U )
+        {
+            (void)out_put(pxOut, pu8Data, u32Len);
+        }
+
+        (void)out_put(pxOut, &u8End, 1U);
+        pxOut->u8RunningStatus = OUT_STATUS_NONE;
+        eRetval = midiOk;
+    }
+    else
+    {
+        pxOut->xStats.u32Dropped++;
+    }
+
+    return eRetval;
+}
+
+void MIDI_OUT_flush(midi_out_t *pxOut)
+{
+    ERR_ASSERT( pxOut != NULL );
+
+    if ( pxOut->u32InFlight == 0U )
+    {
+        uint8_t *pu8Data = NULL;
+        uint32_t u32Len = spsc_ring_peek_read(&pxOut->xRing, &pu8Data);
+
+        if ( (u32Len != 0U) && pxOut->pSend(pu8Data, u32Len) )
+        {
+            pxOut->u32InFlight = u32Len;
+            pxOut->xStats.u32Batches++;
+        }
+    }
+}
+
+void MIDI_OUT_tx_done(midi_out_t *pxOut)
+{
+    ERR_ASSERT( pxOut != NULL );
+
+    if ( pxOut->u32InFlight != 0U )
+    {
+        spsc_ring_commit_read(&pxOut->xRing, pxOut->u32InFlight);
+        pxOut->u32InFlight = 0U;
+    }
+
+    MIDI_OUT_flush(pxOut);
+}
+
+void MIDI_OUT_get_stats(const midi_out_t *pxOut, midi_out_stats_t *pxStats)
+{
+    ERR_ASSERT( pxOut != NULL );
+    ERR_ASSERT( pxStats != NULL );
+
+    /* Handler is not written, safe from other contexts */
+    *pxStats = pxOut->xStats;
+    pxStats->u32Pending = spsc_ring_count(&pxOut->xRing);
+}
+
+/* EOF */
@@ -0,0 +1,182 @@
+/**
+ * @file    midi_seq.c
+ * @author  Sebastián Del Moral Gallardo
+ * @brief   Standard MIDI File player driven by an external sample clock.
+ * @version 0.1
+ * @date    2021-12-04
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "midi_seq.h"
+#include "user_assert.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+
+/* Microseconds in one second */
+#define SEQ_US_PER_SEC              1000000U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief Read next file event and compute its sample offset.
+ *
+ * @param pxSeq sequencer handler.
+ * @return midiStatus_t midiOk on success, midiError on malformed track.
+ */
+static midiStatus_t seq_read_next(midi_seq_t *pxSeq);
+
+/* Private function definition -----------------------------------------------*/
+
+static midiStatus_t seq_read_next(midi_seq_t *pxSeq)
+{
+    midiStatus_t eRetval = SMF_next_event(&pxSeq->xSmf, &pxSeq->xNext);
+
+    /* Malformed track is closed by reader, event is not valid */
+    pxSeq->bNextValid = ( eRetval == midiOk );
+
+    if ( pxSeq->bNextValid )
+    {
+        uint64_t u64Sample = ((pxSeq->xNext.u64TimeUs * pxSeq->u32SampleRate) + (SEQ_US_PER_SEC / 2U)) / SEQ_US_PER_SEC;
+
+        pxSeq->u32NextSample = ( u64Sample > UINT32_MAX ) ? UINT32_MAX : (uint32_t)u64Sample;
+    }
+
+    return eRetval;
+}
+
+/* Public function definition ------------------------------------------------*/
+
+midiStatus_t SEQ_init(midi_seq_t *pxSeq, uint32_t u32SampleRate, midi_seq_event_cb_t pEventCB, void *pvArg)
+{
+    ERR_ASSERT( pxSeq != NULL );
+
+    midiStatus_t eRetval = midiBadParam;
+
+    if ( (u32SampleRate != 0U) && (pEventCB != NULL) )
+    {
+        pxSeq->eState = SEQ_STATE_IDLE;
+        pxSeq->bLoaded = false;
+        pxSeq->bNextValid = false;
+        pxSeq->bLoop = false;
+        pxSeq->u32SampleRate = u32SampleRate;
+        pxSeq->u32StartClock = 0U;
+        pxSeq->u32NextSample = 0U;
+        pxSeq->u32LoopCount = 0U;
+        pxSeq->pEventCB = pEventCB;
+        pxSeq->pvEventArg = pvArg;
+        eRetval = midiOk;
+    }
+
+    return eRetval;
+}
+
+midiStatus_t SEQ_load(midi_seq_t *pxSeq, const uint8_t *pu8Data, uint32_t u32Len)
+{
+    ERR_ASSERT( pxSeq != NULL );
+    ERR_ASSERT( pu8Data != NULL );
+
+    SEQ_stop(pxSeq);
+
+    midiStatus_t eRetval = SMF_open(&pxSeq->xSmf, pu8Data, u32Len);
+
+    pxSeq->bLoaded = ( eRetval == midiOk );
+
+    return eRetval;
+}
+
+void SEQ_unload(midi_seq_t *pxSeq)
+{
+    ERR_ASSERT( pxSeq != NULL );
+
+    SEQ_stop(pxSeq);
+    pxSeq->bLoaded = false;
+}
+
+midiStatus_t SEQ_start(midi_seq_t *pxSeq, uint32_t u32Clock)
+{
+    ERR_ASSERT( pxSeq != NULL );
+
+    midiStatus_t eRetval = midiError;
+
+    if ( pxSeq->bLoaded && (SMF_rewind(&pxSeq->xSmf) == midiOk) )
+    {
+        pxSeq->u32StartClock = u32Clock;
+        pxSeq->u32LoopCount = 0U;
+        pxSeq->eState = SEQ_STATE_PLAY;
+        eRetval = seq_read_next(pxSeq);
+    }
+
+    return eRetval;
+}
+
+void SEQ_stop(midi_seq_t *pxSeq)
+{
+    ERR_ASSERT( pxSeq != NULL );
+
+    pxSeq->eState = SEQ_STATE_IDLE;
+    pxSeq->bNextValid = false;
+}
+
+void SEQ_set_loop(midi_seq_t *pxSeq, bool bLoop)
+{
+    ERR_ASSERT( pxSeq != NULL );
+
+    pxSeq->bLoop = bLoop;
+}
+
+midiStatus_t SEQ_update(midi_seq_t *pxSeq, uint32_t u32Clock)
+{
+    ERR_ASSERT( pxSeq != NULL );
+
+    midiStatus_t eRetval = midiOk;
+
+    while ( pxSeq->eState == SEQ_STATE_PLAY )
+    {
+        uint32_t u32Elapsed = u32Clock - pxSeq->u32StartClock;
+
+        if ( !pxSeq->bNextValid )
+        {
+            /* Skip event lost on malformed track */
+            eRetval = ( seq_read_next(pxSeq) == midiOk ) ? eRetval : midiError;
+        }
+        else if ( pxSeq->u32NextSample > u32Elapsed )
+        {
+            break;
+        }
+        else if ( pxSeq->xNext.eType != SMF_EVT_END )
+        {
+            pxSeq->pEventCB(&pxSeq->xNext, pxSeq->pvEventArg);
+            eRetval = ( seq_read_next(pxSeq) == midiOk ) ? eRetval : midiError;
+        }
+        else if ( pxSeq->bLoop && (pxSeq->u32NextSample != 0U) && (SMF_rewind(&pxSeq->xSmf) == midiOk) )
+        {
+            /* Next pass starts where last one ended, keeps loop length exact */
+            pxSeq->u32StartClock += pxSeq->u32NextSample;
+            pxSeq->u32LoopCount++;
+            eRetval = ( seq_read_next(pxSeq) == midiOk ) ? eRetval : midiError;
+        }
+        else
+        {
+            pxSeq->eState = SEQ_STATE_END;
+            pxSeq->bNextValid = false;
+        }
+    }
+
+    return eRetval;
+}
+
+midi_seq_state_t SEQ_get_state(const midi_seq_t *pxSeq)
+{
+    ERR_ASSERT( pxSeq != NULL );
+
+    return pxSeq->eState;
+}
+
+/* EOF */
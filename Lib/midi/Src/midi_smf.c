@@ -0,0 +1,389 @@
+/**
+ * @file    midi_smf.c
+ * @author  Sebastián Del Moral Gallardo
+ * @brief   Standard MIDI File reader, tracks are merged in time order.
+ * @version 0.1
+ * @date    2021-11-28
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "midi_smf.h"
+#include "user_assert.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+
+/* Chunk header: 4 bytes id, 4 bytes length */
+#define SMF_CHUNK_HEADER_SIZE       8U
+#define SMF_HEADER_DATA_SIZE        6U
+
+/* Variable length quantities use at most 4 bytes */
+#define SMF_VLQ_MAX_BYTES           4U
+
+/* Status bytes with special meaning in files */
+#define SMF_STATUS_META             0xFFU
+#define SMF_STATUS_SYSEX            0xF0U
+#define SMF_STATUS_ESCAPE           0xF7U
+
+/* Division with SMPTE time code */
+#define SMF_DIVISION_SMPTE          0x8000U
+
+/* Private macro -------------------------------------------------------------*/
+
+#define SMF_IS_CHUNK(p, a, b, c, d) ( ((p)[0] == (a)) && ((p)[1] == (b)) && ((p)[2] == (c)) && ((p)[3] == (d)) )
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief Read big endian value.
+ *
+ * @param pu8Data data to read.
+ * @param u32Bytes number of bytes, up to 4.
+ * @return uint32_t value.
+ */
+static uint32_t smf_read_be(const uint8_t *pu8Data, uint32_t u32Bytes);
+
+/**
+ * @brief Read variable length quantity.
+ *
+ * @param ppu8Pos read position, updated.
+ * @param pu8End end of data.
+ * @param pu32Value output value.
+ * @return true on success, false on truncated or too long value.
+ */
+static bool smf_read_vlq(const uint8_t **ppu8Pos, const uint8_t *pu8End, uint32_t *pu32Value);
+
+/**
+ * @brief Read delta time of next track event.
+ *
+ * @param pxTrack track to update.
+ * @return true on success, false on malformed track.
+ */
+static bool smf_track_delta(midi_smf_track_t *pxTrack);
+
+/**
+ * @brief Convert absolute tick in time using current tempo segment.
+ *
+ * @param pxSmf reader handler.
+ * @param u32Tick tick to convert, not before last tempo change.
+ * @return uint64_t time in microseconds.
+ */
+static uint64_t smf_tick_to_us(midi_smf_t *pxSmf, uint32_t u32Tick);
+
+/* Private function definition -----------------------------------------------*/
+
+static uint32_t smf_read_be(const uint8_t *pu8Data, uint32_t u32Bytes)
+{
+    uint32_t u32Value = 0U;
+
+    for ( uint32_t i = 0U; i < u32Bytes; i++ )
+    {
+        u32Value = (u32Value << 8U) | pu8Data[i];
+    }
+
+    return u32Value;
+}
+
+static bool smf_read_vlq(const uint8_t **ppu8Pos, const uint8_t *pu8End, uint32_t *pu32Value)
+{
+    const uint8_t *pu8Pos = *ppu8Pos;
+    uint32_t u32Value = 0U;
+    bool bDone = false;
+
+    for ( uint32_t i = 0U; (i < SMF_VLQ_MAX_BYTES) && !bDone && (pu8Pos < pu8End); i++ )
+    {
+        u32Value = (u32Value << 7U) | (*pu8Pos & 0x7FU);
+        bDone = ( (*pu8Pos & 0x80U) == 0U );
+        pu8Pos++;
+    }
+
+    *ppu8Pos = pu8Pos;
+    *pu32Value = u32Value;
+
+    return bDone;
+}
+
+static bool smf_track_delta(midi_smf_track_t *pxTrack)
+{
+    bool bRetval = true;
+
+    if ( pxTrack->pu8Pos >= pxTrack->pu8End )
+    {
+        /* Missing end of track meta event, accepted */
+        pxTrack->bEnded = true;
+    }
+    else
+    {
+        uint32_t u32Delta = 0U;
+
+        bRetval = smf_read_vlq(&pxTrack->pu8Pos, pxTrack->pu8End, &u32Delta);
+        pxTrack->u32NextTick += u32Delta;
+
+        if ( bRetval && (pxTrack->pu8Pos >= pxTrack->pu8End) )
+        {
+            /* Delta time without event at chunk end, nothing left to read */
+            pxTrack->bEnded = true;
+        }
+    }
+
+    return bRetval;
+}
+
+static uint64_t smf_tick_to_us(midi_smf_t *pxSmf, uint32_t u32Tick)
+{
+    uint64_t u64TimeUs = 0U;
+
+    if ( (pxSmf->u16Division & SMF_DIVISION_SMPTE) != 0U )
+    {
+        /* Frames per second stored as negative value, 29 means 29.97 */
+        uint32_t u32Fps = (uint32_t)(-(int8_t)(pxSmf->u16Division >> 8U));
+        uint32_t u32TicksPerFrame = pxSmf->u16Division & 0xFFU;
+        uint64_t u64Num = (uint64_t)u32Tick * 1000000U * 100U;
+        uint64_t u64Den = (uint64_t)((u32Fps == 29U) ? 2997U : (u32Fps * 100U)) * u32TicksPerFrame;
+
+        u64TimeUs = u64Num / u64Den;
+    }
+    else
+    {
+        uint64_t u64Ticks = (uint64_t)(u32Tick - pxSmf->u32TempoTick);
+
+        u64TimeUs = pxSmf->u64TempoTimeUs + ((u64Ticks * pxSmf->u32TempoUs) / pxSmf->u16Division);
+    }
+
+    return u64TimeUs;
+}
+
+/* Public function definition ------------------------------------------------*/
+
+midiStatus_t SMF_open(midi_smf_t *pxSmf, const uint8_t *pu8Data, uint32_t u32Len)
+{
+    ERR_ASSERT( pxSmf != NULL );
+    ERR_ASSERT( pu8Data != NULL );
+
+    midiStatus_t eRetval = midiError;
+
+    pxSmf->u16TrackNum = 0U;
+
+    if ( (u32Len >= (SMF_CHUNK_HEADER_SIZE + SMF_HEADER_DATA_SIZE)) &&
+         SMF_IS_CHUNK(pu8Data, 'M', 'T', 'h', 'd') &&
+         (smf_read_be(&pu8Data[4U], 4U) >= SMF_HEADER_DATA_SIZE) )
+    {
+        uint32_t u32HeaderLen = smf_read_be(&pu8Data[4U], 4U);
+        uint32_t u32Declared = smf_read_be(&pu8Data[10U], 2U);
+        uint32_t u32Pos = SMF_CHUNK_HEADER_SIZE + u32HeaderLen;
+
+        pxSmf->u16Format = (uint16_t)smf_read_be(&pu8Data[8U], 2U);
+        pxSmf->u16Division = (uint16_t)smf_read_be(&pu8Data[12U], 2U);
+
+        /* Walk chunks, unknown chunk types are skipped */
+        while ( (pxSmf->u16TrackNum < u32Declared) &&
+                (pxSmf->u16TrackNum < SMF_MAX_TRACKS) &&
+                ((u32Pos + SMF_CHUNK_HEADER_SIZE) <= u32Len) )
+        {
+            uint32_t u32ChunkLen = smf_read_be(&pu8Data[u32Pos + 4U], 4U);
+            uint32_t u32ChunkData = u32Pos + SMF_CHUNK_HEADER_SIZE;
+
+            /* Truncated last chunk is read up to end of file */
+            if ( u32ChunkLen > (u32Len - u32ChunkData) )
+            {
+                u32ChunkLen = u32Len - u32ChunkData;
+            }
+
+            if ( SMF_IS_CHUNK(&pu8Data[u32Pos], 'M', 'T', 'r', 'k') )
+            {
+                midi_smf_track_t *pxTrack = &pxSmf->pxTrack[pxSmf->u16TrackNum++];
+
+                pxTrack->pu8Start = &pu8Data[u32ChunkData];
+                pxTrack->pu8End = &pu8Data[u32ChunkData + u32ChunkLen];
+            }
+
+            u32Pos = u32ChunkData + u32ChunkLen;
+        }
+
+        if ( (pxSmf->u16TrackNum != 0U) && (pxSmf->u16Division != 0U) && ((pxSmf->u16Division & 0xFFU) != 0U) )
+        {
+            eRetval = SMF_rewind(pxSmf);
+        }
+    }
+
+    return eRetval;
+}
+
+midiStatus_t SMF_rewind(midi_smf_t *pxSmf)
+{
+    ERR_ASSERT( pxSmf != NULL );
+
+    midiStatus_t eRetval = midiOk;
+
+    pxSmf->u32TempoUs = SMF_DEFAULT_TEMPO_US;
+    pxSmf->u32TempoTick = 0U;
+    pxSmf->u64TempoTimeUs = 0U;
+    pxSmf->u32LastTick = 0U;
+    pxSmf->u64LastTimeUs = 0U;
+
+    for ( uint32_t i = 0U; i < pxSmf->u16TrackNum; i++ )
+    {
+        midi_smf_track_t *pxTrack = &pxSmf->pxTrack[i];
+
+        pxTrack->pu8Pos = pxTrack->pu8Start;
+        pxTrack->u32NextTick = 0U;
+        pxTrack->u8RunningStatus = 0U;
+        pxTrack->bEnded = false;
+
+        if ( !smf_track_delta(pxTrack) )
+        {
+            eRetval = midiError;
+        }
+    }
+
+    return eRetval;
+}
+
+midiStatus_t SMF_next_event(midi_smf_t *pxSmf, midi_smf_event_t *pxEvent)
+{
+    ERR_ASSERT( pxSmf != NULL );
+    ERR_ASSERT( pxEvent != NULL );
+
+    midiStatus_t eRetval = midiOk;
+    midi_smf_track_t *pxTrack = NULL;
+
+    /* Earliest pending event, lower track wins on same tick */
+    for ( uint32_t i = 0U; i < pxSmf->u16TrackNum; i++ )
+    {
+        midi_smf_track_t *pxCandidate = &pxSmf->pxTrack[i];
+
+        if ( !pxCandidate->bEnded && ((pxTrack == NULL) || (pxCandidate->u32NextTick < pxTrack->u32NextTick)) )
+        {
+            pxTrack = pxCandidate;
+            pxEvent->u8Track = (uint8_t)i;
+        }
+    }
+
+    if ( pxTrack == NULL )
+    {
+        pxEvent->eType = SMF_EVT_END;
+        pxEvent->u32Tick = pxSmf->u32LastTick;
+        pxEvent->u64TimeUs = pxSmf->u64LastTimeUs;
+    }
+    else
+    {
+        const uint8_t *pu8End = pxTrack->pu8End;
+        uint8_t u8Status = *pxTrack->pu8Pos;
+        uint32_t u32Len = 0U;
+
+        pxEvent->u32Tick = pxTrack->u32NextTick;
+        pxEvent->u64TimeUs = smf_tick_to_us(pxSmf, pxTrack->u32NextTick);
+        pxEvent->u8MsgLen = 0U;
+        pxEvent->u8MetaType = 0U;
+        pxEvent->pu8Data = NULL;
+        pxEvent->u32DataLen = 0U;
+
+        pxSmf->u32LastTick = pxEvent->u32Tick;
+        pxSmf->u64LastTimeUs = pxEvent->u64TimeUs;
+
+        if ( u8Status == SMF_STATUS_META )
+        {
+            pxTrack->u8RunningStatus = 0U;
+            pxTrack->pu8Pos++;
+
+            if ( pxTrack->pu8Pos < pu8End )
+            {
+                pxEvent->eType = SMF_EVT_META;
+                pxEvent->u8MetaType = *pxTrack->pu8Pos++;
+
+                if ( !smf_read_vlq(&pxTrack->pu8Pos, pu8End, &u32Len) || (u32Len > (uint32_t)(pu8End - pxTrack->pu8Pos)) )
+                {
+                    eRetval = midiError;
+                }
+            }
+            else
+            {
+                eRetval = midiError;
+            }
+        }
+        else if ( (u8Status == SMF_STATUS_SYSEX) || (u8Status == SMF_STATUS_ESCAPE) )
+        {
+            pxTrack->u8RunningStatus = 0U;
+            pxTrack->pu8Pos++;
+            pxEvent->eType = SMF_EVT_SYSEX;
+
+            if ( !smf_read_vlq(&pxTrack->pu8Pos, pu8End, &u32Len) || (u32Len > (uint32_t)(pu8End - pxTrack->pu8Pos)) )
+            {
+                eRetval = midiError;
+            }
+        }
+        else
+        {
+            /* Channel message, data byte first means running status */
+            if ( (u8Status & 0x80U) != 0U )
+            {
+                pxTrack->u8RunningStatus = u8Status;
+                pxTrack->pu8Pos++;
+            }
+
+            u8Status = pxTrack->u8RunningStatus;
+
+            uint8_t u8Cmd = MIDI_CMD_GET_STATUS(u8Status);
+            uint8_t u8DataNum = ( (u8Cmd == MIDI_STATUS_PROG_CHANGE) || (u8Cmd == MIDI_STATUS_CH_PRESS) ) ? 1U : 2U;
+
+            if ( (u8Status < MIDI_STATUS_NOTE_OFF) || (u8Status >= SMF_STATUS_SYSEX) ||
+                 (pxTrack->pu8Pos >= pu8End) || ((uint32_t)(pu8End - pxTrack->pu8Pos) < u8DataNum) )
+            {
+                eRetval = midiError;
+            }
+            else
+            {
+                pxEvent->eType = SMF_EVT_MIDI;
+                pxEvent->pu8Msg[0U] = u8Status;
+                pxEvent->u8MsgLen = 1U;
+
+                for ( uint32_t i = 0U; i < u8DataNum; i++ )
+                {
+                    pxEvent->pu8Msg[pxEvent->u8MsgLen++] = *pxTrack->pu8Pos++ & 0x7FU;
+                }
+            }
+        }
+
+        if ( eRetval == midiOk )
+        {
+            pxEvent->pu8Data = pxTrack->pu8Pos;
+            pxEvent->u32DataLen = u32Len;
+            pxTrack->pu8Pos += u32Len;
+
+            if ( pxEvent->eType == SMF_EVT_META )
+            {
+                if ( pxEvent->u8MetaType == SMF_META_END_OF_TRACK )
+                {
+                    pxTrack->bEnded = true;
+                }
+                else if ( (pxEvent->u8MetaType == SMF_META_TEMPO) && (u32Len == 3U) )
+                {
+                    /* New tempo segment starts at this event */
+                    pxSmf->u64TempoTimeUs = pxEvent->u64TimeUs;
+                    pxSmf->u32TempoTick = pxEvent->u32Tick;
+                    pxSmf->u32TempoUs = smf_read_be(pxEvent->pu8Data, 3U);
+                }
+            }
+
+            if ( !pxTrack->bEnded && !smf_track_delta(pxTrack) )
+            {
+                eRetval = midiError;
+            }
+        }
+
+        if ( eRetval != midiOk )
+        {
+            /* Stop reading broken track, rest of file still playable */
+            pxTrack->bEnded = true;
+        }
+    }
+
+    return eRetval;
+}
+
+/* EOF */
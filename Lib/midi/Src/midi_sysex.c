@@ -0,0 +1,132 @@
+/**
+ * @file    midi_sysex.c
+ * @author  Sebastián Del Moral Gallardo
+ * @brief   Framing, 7 bit packing and checksum of synth system exclusive messages.
+ * @version 0.1
+ * @date    2021-11-20
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "midi_sysex.h"
+#include "user_assert.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+
+/* Raw bytes covered by each MSB byte */
+#define SYSEX_GROUP_SIZE            7U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private function definition -----------------------------------------------*/
+/* Public function definition ------------------------------------------------*/
+
+uint32_t SYSEX_pack(const uint8_t *pu8In, uint32_t u32Len, uint8_t *pu8Out)
+{
+    ERR_ASSERT( pu8In != NULL );
+    ERR_ASSERT( pu8Out != NULL );
+
+    uint32_t u32OutLen = 0U;
+
+    for ( uint32_t i = 0U; i < u32Len; i += SYSEX_GROUP_SIZE )
+    {
+        uint32_t u32MsbIndex = u32OutLen++;
+        uint8_t u8Msb = 0U;
+
+        for ( uint32_t j = 0U; (j < SYSEX_GROUP_SIZE) && ((i + j) < u32Len); j++ )
+        {
+            u8Msb |= (uint8_t)((pu8In[i + j] >> 7U) << j);
+            pu8Out[u32OutLen++] = pu8In[i + j] & 0x7FU;
+        }
+
+        pu8Out[u32MsbIndex] = u8Msb;
+    }
+
+    return u32OutLen;
+}
+
+uint32_t SYSEX_unpack(const uint8_t *pu8In, uint32_t u32Len, uint8_t *pu8Out, uint32_t u32OutSize)
+{
+    ERR_ASSERT( pu8In != NULL );
+    ERR_ASSERT( pu8Out != NULL );
+
+    uint32_t u32OutLen = 0U;
+    uint32_t i = 0U;
+    bool bValid = true;
+
+    while ( bValid && (i < u32Len) )
+    {
+        uint8_t u8Msb = pu8In[i++];
+
+        /* Every group holds the MSB byte plus at least one data byte */
+        bValid = ( (u8Msb & 0x80U) == 0U ) && ( i < u32Len );
+
+        for ( uint32_t j = 0U; bValid && (j < SYSEX_GROUP_SIZE) && (i < u32Len); j++ )
+        {
+            bValid = ( (pu8In[i] & 0x80U) == 0U ) && ( u32OutLen < u32OutSize );
+
+            if ( bValid )
+            {
+                pu8Out[u32OutLen++] = pu8In[i++] | (uint8_t)(((u8Msb >> j) & 0x01U) << 7U);
+            }
+        }
+    }
+
+    return bValid ? u32OutLen : 0U;
+}
+
+uint8_t SYSEX_checksum(const uint8_t *pu8Data, uint32_t u32Len)
+{
+    ERR_ASSERT( pu8Data != NULL );
+
+    uint32_t u32Sum = 0U;
+
+    for ( uint32_t i = 0U; i < u32Len; i++ )
+    {
+        u32Sum += pu8Data[i];
+    }
+
+    return (uint8_t)((128U - (u32Sum & 0x7FU)) & 0x7FU);
+}
+
+midiStatus_t SYSEX_parse(const uint8_t *pu8Data, uint32_t u32Len, uint8_t u8DevId, midi_sysex_msg_t *pxMsg)
+{
+    ERR_ASSERT( pu8Data != NULL );
+    ERR_ASSERT( pxMsg != NULL );
+
+    midiStatus_t eRetval = midiBadParam;
+
+    if ( (u32Len >= SYSEX_FRAME_OVERHEAD) && (pu8Data[0U] == SYSEX_MANUFACTURER_ID) )
+    {
+        uint8_t u8MsgDev = pu8Data[1U];
+
+        if ( (u8MsgDev == u8DevId) || (u8MsgDev == SYSEX_DEV_ID_ALL) )
+        {
+            /* Checksum covers command and payload */
+            const uint8_t *pu8Body = &pu8Data[SYSEX_HEADER_SIZE - 1U];
+            uint32_t u32BodyLen = u32Len - SYSEX_HEADER_SIZE;
+
+            if ( SYSEX_checksum(pu8Body, u32BodyLen) == pu8Data[u32Len - 1U] )
+            {
+                pxMsg->u8DevId = u8MsgDev;
+                pxMsg->u8Cmd = pu8Body[0U];
+                pxMsg->pu8Payload = &pu8Body[1U];
+                pxMsg->u32PayloadLen = u32BodyLen - 1U;
+                eRetval = midiOk;
+            }
+            else
+            {
+                eRetval = midiError;
+            }
+        }
+    }
+
+    return eRetval;
+}
+
+/* EOF */
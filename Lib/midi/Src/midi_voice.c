@@ -16,13 +16,38 @@
 /* Private includes ----------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+
+/* Expression of member channel before any message, as MPE spec */
+#define VOICE_MPE_PRESSURE_INIT     ( 0U )
+#define VOICE_MPE_TIMBRE_INIT       ( 64U )
+
 /* Private macro -------------------------------------------------------------*/
+
+/* Free mask bit of voice n, voice 0 on MSB */
+#define VOICE_MASK(n)               ( 0x80000000UL >> (n) )
+
+/* Free mask with first n voices set */
+#define VOICE_MASK_ALL(n)           ( ((n) >= 32U) ? 0xFFFFFFFFUL : ~(0xFFFFFFFFUL >> (n)) )
+
+/* Index of first set bit from MSB, single instruction on Cortex-M4 */
+#define VOICE_CLZ(x)                ( (uint32_t)__builtin_clz(x) )
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 
 static void clear_voice_list(midi_voice_handler_t *pxVoiceHandler);
 static bool get_first_free_voice(midi_voice_handler_t *pxVoiceHandler, uint8_t *pu8VoiceCh);
-static bool search_voice_with_state(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Note, midi_voice_state_t eState, uint8_t *pu8VoiceCh);
+static bool get_first_held_voice(midi_voice_handler_t *pxVoiceHandler, uint8_t *pu8VoiceCh);
+static bool search_active_note(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Note, uint8_t *pu8VoiceCh);
+static void set_voice_on(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity, uint8_t u8MpeCh);
+static void set_voice_off(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity);
+static void clear_voice(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Voice);
+static void release_voice(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity);
+static void release_held_voices(midi_voice_handler_t *pxVoiceHandler, uint32_t u32Mask);
+
+static bool mpe_is_member(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Ch);
+static void mpe_reset_channels(midi_voice_handler_t *pxVoiceHandler);
+static void mpe_leave_channel(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Voice);
+static bool search_mpe_note(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Ch, uint8_t u8Note, uint8_t *pu8VoiceCh);
 
 static void handle_note_on_mono(midi_voice_handler_t *pxVoiceHandler, uint8_t u8NewNote, uint8_t u8NewVelocity, uint8_t u8Voice);
 static void handle_note_on_poly(midi_voice_handler_t *pxVoiceHandler, uint8_t u8NewNote, uint8_t u8NewVelocity);
@@ -30,6 +55,9 @@ static void handle_note_on_poly(midi_voice_handler_t *pxVoiceHandler, uint8_t u8
 static void handle_note_off_mono(midi_voice_handler_t *pxVoiceHandler, uint8_t u8NewNote, uint8_t u8NewVelocity, uint8_t u8Voice);
 static void handle_note_off_poly(midi_voice_handler_t *pxVoiceHandler, uint8_t u8NewNote, uint8_t u8NewVelocity);
 
+static void handle_note_on_mpe(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Ch, uint8_t u8NewNote, uint8_t u8NewVelocity);
+static void handle_note_off_mpe(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Ch, uint8_t u8NewNote, uint8_t u8NewVelocity);
+
 /* Private function definition -----------------------------------------------*/
 
 static void clear_voice_list(midi_voice_handler_t *pxVoiceHandler)
@@ -42,7 +70,25 @@ static void clear_voice_list(midi_voice_handler_t *pxVoiceHandler)
         pxVoiceHandler->pxVoiceList[i].u8Note = 0xFFU;
         pxVoiceHandler->pxVoiceList[i].u8Velocity = 0xFFU;
         pxVoiceHandler->pxVoiceList[i].eState = VOICE_STATE_OFF;
+        pxVoiceHandler->pxVoiceList[i].u8MidiCh = MIDI_VOICE_NONE;
+    }
+
+    for ( uint32_t i = 0U; i < MIDI_VOICE_CH_NUM; i++ )
+    {
+        pxVoiceHandler->xMpe.pu32ChMask[i] = 0U;
     }
+
+    for ( uint32_t i = 0U; i < MIDI_VOICE_NOTE_NUM; i++ )
+    {
+        pxVoiceHandler->pu8NoteMap[i] = MIDI_VOICE_NONE;
+    }
+
+    /* Voice 0 on MSB, CLZ gives lowest free voice */
+    pxVoiceHandler->u32FreeMask = VOICE_MASK_ALL(pxVoiceHandler->u8VoiceNum);
+
+    /* Pedals keep their state, nothing is held anymore */
+    pxVoiceHandler->u32HeldMask = 0U;
+    pxVoiceHandler->u32SostenutoMask = 0U;
 }
 
 static bool get_first_free_voice(midi_voice_handler_t *pxVoiceHandler, uint8_t *pu8VoiceCh)
@@ -50,36 +96,230 @@ static bool get_first_free_voice(midi_voice_handler_t *pxVoiceHandler, uint8_t *
     ERR_ASSERT( pxVoiceHandler != NULL );
     ERR_ASSERT( pu8VoiceCh != NULL );
 
-    bool bFreeVoice = false;
+    bool bFreeVoice = ( pxVoiceHandler->u32FreeMask != 0U );
 
-    for ( uint8_t i = 0U; i < pxVoiceHandler->u8VoiceNum; i++ )
+    if ( bFreeVoice )
     {
-        if ( pxVoiceHandler->pxVoiceList[i].eState == VOICE_STATE_OFF )
-        {
-            *pu8VoiceCh = pxVoiceHandler->pxVoiceList[i].u8Ch;
-            bFreeVoice = true;
-            break;
-        }
+        *pu8VoiceCh = pxVoiceHandler->pxVoiceList[VOICE_CLZ(pxVoiceHandler->u32FreeMask)].u8Ch;
     }
 
     return bFreeVoice;
 }
 
-static bool search_voice_with_state(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Note, midi_voice_state_t eState, uint8_t *pu8VoiceCh)
+static bool get_first_held_voice(midi_voice_handler_t *pxVoiceHandler, uint8_t *pu8VoiceCh)
+{
+    ERR_ASSERT( pxVoiceHandler != NULL );
+    ERR_ASSERT( pu8VoiceCh != NULL );
+
+    bool bHeldVoice = ( pxVoiceHandler->u32HeldMask != 0U );
+
+    if ( bHeldVoice )
+    {
+        *pu8VoiceCh = pxVoiceHandler->pxVoiceList[VOICE_CLZ(pxVoiceHandler->u32HeldMask)].u8Ch;
+    }
+
+    return bHeldVoice;
+}
+
+static bool search_active_note(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Note, uint8_t *pu8VoiceCh)
 {
     ERR_ASSERT( pxVoiceHandler != NULL );
-    ERR_ASSERT( eState < VOICE_STATE_NUM );
     ERR_ASSERT( pu8VoiceCh != NULL );
 
+    uint8_t u8Voice = ( u8Note < MIDI_VOICE_NOTE_NUM ) ? pxVoiceHandler->pu8NoteMap[u8Note] : MIDI_VOICE_NONE;
+    bool bFound = ( u8Voice != MIDI_VOICE_NONE );
+
+    if ( bFound )
+    {
+        *pu8VoiceCh = pxVoiceHandler->pxVoiceList[u8Voice].u8Ch;
+    }
+
+    return bFound;
+}
+
+static void set_voice_on(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity, uint8_t u8MpeCh)
+{
+    midi_voice_t *pxVoice = &pxVoiceHandler->pxVoiceList[u8Voice];
+
+    /* Note replaced on mono voice leaves the map */
+    if ( (pxVoice->eState == VOICE_STATE_ON) && (pxVoice->u8Note < MIDI_VOICE_NOTE_NUM) &&
+         (pxVoiceHandler->pu8NoteMap[pxVoice->u8Note] == u8Voice) )
+    {
+        pxVoiceHandler->pu8NoteMap[pxVoice->u8Note] = MIDI_VOICE_NONE;
+    }
+
+    pxVoice->eState = VOICE_STATE_ON;
+    pxVoice->u8Note = u8Note;
+    pxVoice->u8Velocity = u8Velocity;
+
+    /* Same note may sound on several member channels, those are found by channel */
+    if ( (u8Note < MIDI_VOICE_NOTE_NUM) && (u8MpeCh == MIDI_VOICE_NONE) )
+    {
+        pxVoiceHandler->pu8NoteMap[u8Note] = u8Voice;
+    }
+
+    /* New note follows its key, even on a voice held before */
+    pxVoiceHandler->u32FreeMask &= ~VOICE_MASK(u8Voice);
+    pxVoiceHandler->u32HeldMask &= ~VOICE_MASK(u8Voice);
+    pxVoiceHandler->u32SostenutoMask &= ~VOICE_MASK(u8Voice);
+
+    /* Expression of new note reaches voice before note on */
+    mpe_leave_channel(pxVoiceHandler, u8Voice);
+
+    if ( u8MpeCh != MIDI_VOICE_NONE )
+    {
+        midi_voice_mpe_t *pxMpe = &pxVoiceHandler->xMpe;
+
+        pxMpe->pu32ChMask[u8MpeCh] |= VOICE_MASK(u8Voice);
+        pxVoice->u8MidiCh = u8MpeCh;
+
+        if ( pxVoiceHandler->xExprCB != NULL )
+        {
+            pxVoiceHandler->xExprCB(u8Voice, VOICE_EXPR_BEND, pxMpe->pu16Bend[u8MpeCh]);
+            pxVoiceHandler->xExprCB(u8Voice, VOICE_EXPR_PRESSURE, pxMpe->pu8Pressure[u8MpeCh]);
+            pxVoiceHandler->xExprCB(u8Voice, VOICE_EXPR_TIMBRE, pxMpe->pu8Timbre[u8MpeCh]);
+            pxMpe->u32ExprMask |= VOICE_MASK(u8Voice);
+        }
+    }
+    else if ( (pxVoiceHandler->xMpe.u32ExprMask & VOICE_MASK(u8Voice)) != 0U )
+    {
+        /* Voice used by a member channel before, drop its expression */
+        pxVoiceHandler->xMpe.u32ExprMask &= ~VOICE_MASK(u8Voice);
+
+        if ( pxVoiceHandler->xExprCB != NULL )
+        {
+            pxVoiceHandler->xExprCB(u8Voice, VOICE_EXPR_RESET, 0U);
+        }
+    }
+
+    // Call callback to trigger action.
+    if ( pxVoiceHandler->xVoiceActionCB != NULL )
+    {
+        pxVoiceHandler->xVoiceActionCB(u8Voice, u8Note, u8Velocity, VOICE_STATE_ON);
+    }
+}
+
+static void set_voice_off(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity)
+{
+    clear_voice(pxVoiceHandler, u8Voice);
+
+    // Call callback to trigger action.
+    if ( pxVoiceHandler->xVoiceActionCB != NULL )
+    {
+        pxVoiceHandler->xVoiceActionCB(u8Voice, u8Note, u8Velocity, VOICE_STATE_OFF);
+    }
+}
+
+static void clear_voice(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Voice)
+{
+    midi_voice_t *pxVoice = &pxVoiceHandler->pxVoiceList[u8Voice];
+
+    if ( (pxVoice->u8Note < MIDI_VOICE_NOTE_NUM) && (pxVoiceHandler->pu8NoteMap[pxVoice->u8Note] == u8Voice) )
+    {
+        pxVoiceHandler->pu8NoteMap[pxVoice->u8Note] = MIDI_VOICE_NONE;
+    }
+
+    pxVoice->eState = VOICE_STATE_OFF;
+    pxVoice->u8Note = 0U;
+    pxVoice->u8Velocity = 0U;
+
+    mpe_leave_channel(pxVoiceHandler, u8Voice);
+
+    pxVoiceHandler->u32FreeMask |= VOICE_MASK(u8Voice);
+    pxVoiceHandler->u32HeldMask &= ~VOICE_MASK(u8Voice);
+    pxVoiceHandler->u32SostenutoMask &= ~VOICE_MASK(u8Voice);
+}
+
+static void release_voice(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity)
+{
+    /* Key is up, next messages of its channel belong to next note */
+    mpe_leave_channel(pxVoiceHandler, u8Voice);
+
+    if ( pxVoiceHandler->bSustain || ((pxVoiceHandler->u32SostenutoMask & VOICE_MASK(u8Voice)) != 0U) )
+    {
+        /* Key up under pedal, voice keeps sounding until pedal lift */
+        pxVoiceHandler->u32HeldMask |= VOICE_MASK(u8Voice);
+    }
+    else
+    {
+        set_voice_off(pxVoiceHandler, u8Voice, u8Note, u8Velocity);
+    }
+}
+
+static void release_held_voices(midi_voice_handler_t *pxVoiceHandler, uint32_t u32Mask)
+{
+    uint32_t u32Release = 0U;
+
+    while ( u32Mask != 0U )
+    {
+        uint8_t u8Voice = (uint8_t)VOICE_CLZ(u32Mask);
+
+        u32Mask &= ~VOICE_MASK(u8Voice);
+
+        if ( pxVoiceHandler->xReleaseCB != NULL )
+        {
+            /* Voice index as seen by action callback, LSB first */
+            clear_voice(pxVoiceHandler, u8Voice);
+            u32Release |= (1UL << u8Voice);
+        }
+        else
+        {
+            set_voice_off(pxVoiceHandler, u8Voice, pxVoiceHandler->pxVoiceList[u8Voice].u8Note, 0U);
+        }
+    }
+
+    if ( u32Release != 0U )
+    {
+        pxVoiceHandler->xReleaseCB(u32Release);
+    }
+}
+
+static bool mpe_is_member(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Ch)
+{
+    midi_voice_mpe_t *pxMpe = &pxVoiceHandler->xMpe;
+
+    return ( (pxMpe->u8MemberNum != 0U) && (u8Ch >= pxMpe->u8FirstCh) && (u8Ch < (pxMpe->u8FirstCh + pxMpe->u8MemberNum)) );
+}
+
+static void mpe_reset_channels(midi_voice_handler_t *pxVoiceHandler)
+{
+    midi_voice_mpe_t *pxMpe = &pxVoiceHandler->xMpe;
+
+    for ( uint32_t i = 0U; i < MIDI_VOICE_CH_NUM; i++ )
+    {
+        pxMpe->pu16Bend[i] = MIDI_PITCH_BEND_CENTER;
+        pxMpe->pu8Pressure[i] = VOICE_MPE_PRESSURE_INIT;
+        pxMpe->pu8Timbre[i] = VOICE_MPE_TIMBRE_INIT;
+    }
+}
+
+static void mpe_leave_channel(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Voice)
+{
+    midi_voice_t *pxVoice = &pxVoiceHandler->pxVoiceList[u8Voice];
+
+    if ( pxVoice->u8MidiCh < MIDI_VOICE_CH_NUM )
+    {
+        pxVoiceHandler->xMpe.pu32ChMask[pxVoice->u8MidiCh] &= ~VOICE_MASK(u8Voice);
+        pxVoice->u8MidiCh = MIDI_VOICE_NONE;
+    }
+}
+
+static bool search_mpe_note(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Ch, uint8_t u8Note, uint8_t *pu8VoiceCh)
+{
+    uint32_t u32Mask = pxVoiceHandler->xMpe.pu32ChMask[u8Ch];
     bool bFound = false;
 
-    for ( uint8_t i = 0U; i < pxVoiceHandler->u8VoiceNum; i++ )
+    /* Usually a single voice per member channel */
+    while ( (u32Mask != 0U) && !bFound )
     {
-        if ( (pxVoiceHandler->pxVoiceList[i].u8Note == u8Note) && (pxVoiceHandler->pxVoiceList[i].eState == eState) )
+        uint8_t u8Voice = (uint8_t)VOICE_CLZ(u32Mask);
+
+        u32Mask &= ~VOICE_MASK(u8Voice);
+
+        if ( pxVoiceHandler->pxVoiceList[u8Voice].u8Note == u8Note )
         {
-            *pu8VoiceCh = pxVoiceHandler->pxVoiceList[i].u8Ch;
+            *pu8VoiceCh = pxVoiceHandler->pxVoiceList[u8Voice].u8Ch;
             bFound = true;
-            break;
         }
     }
 
@@ -94,17 +334,10 @@ static void handle_note_on_mono(midi_voice_handler_t *pxVoiceHandler, uint8_t u8
     {
         /* Check if current voice is IDLE or new note is over the current active note (old school monofonic) */
         if ( (pxVoiceHandler->pxVoiceList[u8Voice].eState == VOICE_STATE_OFF) ||
+             ((pxVoiceHandler->u32HeldMask & VOICE_MASK(u8Voice)) != 0U) ||
             ((pxVoiceHandler->pxVoiceList[u8Voice].eState == VOICE_STATE_ON) && (pxVoiceHandler->pxVoiceList[u8Voice].u8Note < u8NewNote)) )
         {
-            pxVoiceHandler->pxVoiceList[u8Voice].eState = VOICE_STATE_ON;
-            pxVoiceHandler->pxVoiceList[u8Voice].u8Note = u8NewNote;
-            pxVoiceHandler->pxVoiceList[u8Voice].u8Velocity = u8NewVelocity;
-
-            // Call callback to trigger action.
-            if ( pxVoiceHandler->xVoiceActionCB != NULL )
-            {
-                pxVoiceHandler->xVoiceActionCB(u8Voice, u8NewNote, u8NewVelocity, VOICE_STATE_ON);
-            }
+            set_voice_on(pxVoiceHandler, u8Voice, u8NewNote, u8NewVelocity, MIDI_VOICE_NONE);
         }
     }
 }
@@ -113,25 +346,21 @@ static void handle_note_on_poly(midi_voice_handler_t *pxVoiceHandler, uint8_t u8
 {
     uint8_t u8VoiceId = 0U;
     
-    // Check if note already active
-    if ( !search_voice_with_state(pxVoiceHandler, u8NewNote, VOICE_STATE_ON, &u8VoiceId) )
+    // Check if note already active, then search for a free slot
+    if ( search_active_note(pxVoiceHandler, u8NewNote, &u8VoiceId) )
     {
-        // Search for a free slot
-        if ( get_first_free_voice(pxVoiceHandler, &u8VoiceId) )
+        // Note held by pedal struck again, retrigger same voice
+        if ( (u8VoiceId < pxVoiceHandler->u8VoiceNum) && ((pxVoiceHandler->u32HeldMask & VOICE_MASK(u8VoiceId)) != 0U) )
         {
-            // Free voice slot found, assign new note to free slot
-            if ( u8VoiceId < pxVoiceHandler->u8VoiceNum )
-            {
-                pxVoiceHandler->pxVoiceList[u8VoiceId].eState = VOICE_STATE_ON;
-                pxVoiceHandler->pxVoiceList[u8VoiceId].u8Note = u8NewNote;
-                pxVoiceHandler->pxVoiceList[u8VoiceId].u8Velocity = u8NewVelocity;
-
-                // Call callback to trigger action.
-                if ( pxVoiceHandler->xVoiceActionCB != NULL )
-                {
-                    pxVoiceHandler->xVoiceActionCB(u8VoiceId, u8NewNote, u8NewVelocity, VOICE_STATE_ON);
-                }
-            }
+            set_voice_on(pxVoiceHandler, u8VoiceId, u8NewNote, u8NewVelocity, MIDI_VOICE_NONE);
+        }
+    }
+    else if ( get_first_free_voice(pxVoiceHandler, &u8VoiceId) || get_first_held_voice(pxVoiceHandler, &u8VoiceId) )
+    {
+        // Free voice slot found, else reuse voice only sounding by pedal
+        if ( u8VoiceId < pxVoiceHandler->u8VoiceNum )
+        {
+            set_voice_on(pxVoiceHandler, u8VoiceId, u8NewNote, u8NewVelocity, MIDI_VOICE_NONE);
         }
     }
 }
@@ -143,15 +372,7 @@ static void handle_note_off_mono(midi_voice_handler_t *pxVoiceHandler, uint8_t u
         /* Check if current voice is IDLE or new note is over the current active note (old school monofonic) */
         if ( (pxVoiceHandler->pxVoiceList[u8Voice].eState == VOICE_STATE_ON) && (pxVoiceHandler->pxVoiceList[u8Voice].u8Note == u8NewNote) )
         {
-            pxVoiceHandler->pxVoiceList[u8Voice].eState = VOICE_STATE_OFF;
-            pxVoiceHandler->pxVoiceList[u8Voice].u8Note = 0U;
-            pxVoiceHandler->pxVoiceList[u8Voice].u8Velocity = 0U;
-
-            // Call callback to trigger action.
-            if ( pxVoiceHandler->xVoiceActionCB != NULL )
-            {
-                pxVoiceHandler->xVoiceActionCB(u8Voice, u8NewNote, u8NewVelocity, VOICE_STATE_OFF);
-            }
+            release_voice(pxVoiceHandler, u8Voice, u8NewNote, u8NewVelocity);
         }
     }
 }
@@ -161,20 +382,42 @@ static void handle_note_off_poly(midi_voice_handler_t *pxVoiceHandler, uint8_t u
     uint8_t u8VoiceId = 0U;
 
     // Check if note already active
-    if ( search_voice_with_state(pxVoiceHandler, u8NewNote, VOICE_STATE_ON, &u8VoiceId) )
+    if ( search_active_note(pxVoiceHandler, u8NewNote, &u8VoiceId) )
     {
         if ( u8VoiceId < pxVoiceHandler->u8VoiceNum )
         {
-            // Free voice slot
-            pxVoiceHandler->pxVoiceList[u8VoiceId].eState = VOICE_STATE_OFF;
-            pxVoiceHandler->pxVoiceList[u8VoiceId].u8Note = 0U;
-            pxVoiceHandler->pxVoiceList[u8VoiceId].u8Velocity = 0U;
+            // Free voice slot, deferred while a pedal holds it
+            release_voice(pxVoiceHandler, u8VoiceId, u8NewNote, u8NewVelocity);
+        }
+    }
+}
 
-            // Call callback to trigger action.
-            if ( pxVoiceHandler->xVoiceActionCB != NULL )
-            {
-                pxVoiceHandler->xVoiceActionCB(u8VoiceId, u8NewNote, u8NewVelocity, VOICE_STATE_OFF);
-            }
+static void handle_note_on_mpe(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Ch, uint8_t u8NewNote, uint8_t u8NewVelocity)
+{
+    uint8_t u8VoiceId = 0U;
+
+    // Key struck again on its channel retriggers voice, else one voice per note as poly
+    if ( search_mpe_note(pxVoiceHandler, u8Ch, u8NewNote, &u8VoiceId) ||
+         get_first_free_voice(pxVoiceHandler, &u8VoiceId) ||
+         get_first_held_voice(pxVoiceHandler, &u8VoiceId) )
+    {
+        if ( u8VoiceId < pxVoiceHandler->u8VoiceNum )
+        {
+            set_voice_on(pxVoiceHandler, u8VoiceId, u8NewNote, u8NewVelocity, u8Ch);
+        }
+    }
+}
+
+static void handle_note_off_mpe(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Ch, uint8_t u8NewNote, uint8_t u8NewVelocity)
+{
+    uint8_t u8VoiceId = 0U;
+
+    if ( search_mpe_note(pxVoiceHandler, u8Ch, u8NewNote, &u8VoiceId) )
+    {
+        if ( u8VoiceId < pxVoiceHandler->u8VoiceNum )
+        {
+            // Free voice slot, deferred while a pedal holds it
+            release_voice(pxVoiceHandler, u8VoiceId, u8NewNote, u8NewVelocity);
         }
     }
 }
@@ -187,6 +430,7 @@ midiStatus_t VOICE_init(midi_voice_handler_t *pxVoiceHandler, midi_voice_t *pxVo
     ERR_ASSERT( pxVoiceList != NULL );
     ERR_ASSERT( xActionCB != NULL );
     ERR_ASSERT( u8VoiceNum != 0U );
+    ERR_ASSERT( u8VoiceNum <= MIDI_VOICE_MAX );
     ERR_ASSERT( u8MidiCh <= MIDI_CHANNEL_MAX_VALUE );
 
     midiStatus_t xRetval = midiBadParam;
@@ -194,6 +438,7 @@ midiStatus_t VOICE_init(midi_voice_handler_t *pxVoiceHandler, midi_voice_t *pxVo
     if ( (pxVoiceHandler != NULL) && 
         (pxVoiceList != NULL) && 
         (u8VoiceNum != 0U) && 
+        (u8VoiceNum <= MIDI_VOICE_MAX) && 
         (xActionCB != 0U) &&
         (u8MidiCh <= MIDI_CHANNEL_MAX_VALUE) )
     {
@@ -202,6 +447,17 @@ midiStatus_t VOICE_init(midi_voice_handler_t *pxVoiceHandler, midi_voice_t *pxVo
         pxVoiceHandler->u8VoiceNum = u8VoiceNum;
         pxVoiceHandler->xVoiceActionCB = xActionCB;
         pxVoiceHandler->u8MidiCh = u8MidiCh;
+        pxVoiceHandler->xReleaseCB = NULL;
+        pxVoiceHandler->bSustain = false;
+        pxVoiceHandler->bSostenuto = false;
+        pxVoiceHandler->xExprCB = NULL;
+
+        /* MPE disabled until configured */
+        pxVoiceHandler->xMpe.u8MasterCh = MIDI_VOICE_MPE_LOWER;
+        pxVoiceHandler->xMpe.u8FirstCh = MIDI_VOICE_MPE_LOWER + 1U;
+        pxVoiceHandler->xMpe.u8MemberNum = 0U;
+        pxVoiceHandler->xMpe.u32ExprMask = 0U;
+        mpe_reset_channels(pxVoiceHandler);
 
         clear_voice_list(pxVoiceHandler);
 
@@ -222,7 +478,13 @@ midiStatus_t VOICE_deinit(midi_voice_handler_t *pxVoiceHandler)
         pxVoiceHandler->eMode = MidiModeNum;
         pxVoiceHandler->pxVoiceList = NULL;
         pxVoiceHandler->u8VoiceNum = 0U;
+        pxVoiceHandler->u32FreeMask = 0U;
+        pxVoiceHandler->u32HeldMask = 0U;
+        pxVoiceHandler->u32SostenutoMask = 0U;
         pxVoiceHandler->xVoiceActionCB = NULL;
+        pxVoiceHandler->xReleaseCB = NULL;
+        pxVoiceHandler->xExprCB = NULL;
+        pxVoiceHandler->xMpe.u8MemberNum = 0U;
 
         xRetval = midiOk;
     }
@@ -257,10 +519,27 @@ midiStatus_t VOICE_update_note(midi_voice_handler_t *pxVoiceHandler, uint8_t u8C
         uint8_t u8Status = MIDI_CMD_GET_STATUS(u8Cmd);
         uint8_t u8Ch = MIDI_CMD_GET_CH(u8Cmd);
 
+        /*
+         * Handle MPE member channels (poly, one voice per note with own expression)
+         */
+        if ( mpe_is_member(pxVoiceHandler, u8Ch) )
+        {
+            if ( (u8Status == MIDI_STATUS_NOTE_ON) && (u8Velocity != 0U) )
+            {
+                handle_note_on_mpe(pxVoiceHandler, u8Ch, u8Note, u8Velocity);
+                xRetval = midiOk;
+            }
+            else if ( (u8Status == MIDI_STATUS_NOTE_OFF) || 
+                    ((u8Status == MIDI_STATUS_NOTE_ON) && (u8Velocity == 0U)) )
+            {
+                handle_note_off_mpe(pxVoiceHandler, u8Ch, u8Note, u8Velocity);
+                xRetval = midiOk;
+            }
+        }
         /*
          * Handle mode1 (poly, all channels) and mode2 (mono, all channels)
          */
-        if ( (pxVoiceHandler->eMode == MidiMode1) || (pxVoiceHandler->eMode == MidiMode2) )
+        else if ( (pxVoiceHandler->eMode == MidiMode1) || (pxVoiceHandler->eMode == MidiMode2) )
         {
             if ( (u8Status == MIDI_STATUS_NOTE_ON) && (u8Velocity != 0U) )
             {
@@ -370,4 +649,180 @@ midiStatus_t VOICE_update_ch(midi_voice_handler_t *pxVoiceHandler, uint8_t u8New
     return xRetval;
 }
 
+midiStatus_t VOICE_set_release_cb(midi_voice_handler_t *pxVoiceHandler, midi_voice_release_cb_t xReleaseCB)
+{
+    ERR_ASSERT( pxVoiceHandler != NULL );
+
+    midiStatus_t xRetval = midiBadParam;
+
+    if ( pxVoiceHandler != NULL )
+    {
+        pxVoiceHandler->xReleaseCB = xReleaseCB;
+
+        xRetval = midiOk;
+    }
+
+    return xRetval;
+}
+
+midiStatus_t VOICE_set_sustain(midi_voice_handler_t *pxVoiceHandler, bool bDown)
+{
+    ERR_ASSERT( pxVoiceHandler != NULL );
+
+    midiStatus_t xRetval = midiBadParam;
+
+    if ( (pxVoiceHandler != NULL) && (pxVoiceHandler->u8VoiceNum != 0U) )
+    {
+        pxVoiceHandler->bSustain = bDown;
+
+        /* Voices latched by sostenuto wait for that pedal */
+        if ( !bDown )
+        {
+            release_held_voices(pxVoiceHandler, pxVoiceHandler->u32HeldMask & ~pxVoiceHandler->u32SostenutoMask);
+        }
+
+        xRetval = midiOk;
+    }
+
+    return xRetval;
+}
+
+midiStatus_t VOICE_set_sostenuto(midi_voice_handler_t *pxVoiceHandler, bool bDown)
+{
+    ERR_ASSERT( pxVoiceHandler != NULL );
+
+    midiStatus_t xRetval = midiBadParam;
+
+    if ( (pxVoiceHandler != NULL) && (pxVoiceHandler->u8VoiceNum != 0U) )
+    {
+        if ( bDown && !pxVoiceHandler->bSostenuto )
+        {
+            /* Latch voices with key down, voices already held stay with sustain */
+            pxVoiceHandler->u32SostenutoMask = ~pxVoiceHandler->u32FreeMask & ~pxVoiceHandler->u32HeldMask &
+                                               VOICE_MASK_ALL(pxVoiceHandler->u8VoiceNum);
+        }
+        else if ( !bDown && pxVoiceHandler->bSostenuto )
+        {
+            uint32_t u32Latched = pxVoiceHandler->u32SostenutoMask;
+
+            pxVoiceHandler->u32SostenutoMask = 0U;
+
+            if ( !pxVoiceHandler->bSustain )
+            {
+                release_held_voices(pxVoiceHandler, pxVoiceHandler->u32HeldMask & u32Latched);
+            }
+        }
+
+        pxVoiceHandler->bSostenuto = bDown;
+
+        xRetval = midiOk;
+    }
+
+    return xRetval;
+}
+
+midiStatus_t VOICE_set_expr_cb(midi_voice_handler_t *pxVoiceHandler, midi_voice_expr_cb_t xExprCB)
+{
+    ERR_ASSERT( pxVoiceHandler != NULL );
+
+    midiStatus_t xRetval = midiBadParam;
+
+    if ( pxVoiceHandler != NULL )
+    {
+        pxVoiceHandler->xExprCB = xExprCB;
+
+        xRetval = midiOk;
+    }
+
+    return xRetval;
+}
+
+midiStatus_t VOICE_set_mpe_zone(midi_voice_handler_t *pxVoiceHandler, uint8_t u8MasterCh, uint8_t u8MemberNum)
+{
+    ERR_ASSERT( pxVoiceHandler != NULL );
+
+    midiStatus_t xRetval = midiBadParam;
+
+    if ( (pxVoiceHandler != NULL) && (pxVoiceHandler->u8VoiceNum != 0U) &&
+         ((u8MasterCh == MIDI_VOICE_MPE_LOWER) || (u8MasterCh == MIDI_VOICE_MPE_UPPER)) &&
+         (u8MemberNum < MIDI_VOICE_CH_NUM) )
+    {
+        midi_voice_mpe_t *pxMpe = &pxVoiceHandler->xMpe;
+
+        /* Notes of old zone would lose their channel, turn them off */
+        for ( uint32_t i = 0U; i < MIDI_VOICE_CH_NUM; i++ )
+        {
+            while ( pxMpe->pu32ChMask[i] != 0U )
+            {
+                uint8_t u8Voice = (uint8_t)VOICE_CLZ(pxMpe->pu32ChMask[i]);
+
+                set_voice_off(pxVoiceHandler, u8Voice, pxVoiceHandler->pxVoiceList[u8Voice].u8Note, 0U);
+            }
+        }
+
+        /* Lower zone grows up from channel 1, upper zone down from channel 14 */
+        pxMpe->u8MasterCh = u8MasterCh;
+        pxMpe->u8MemberNum = u8MemberNum;
+        pxMpe->u8FirstCh = ( u8MasterCh == MIDI_VOICE_MPE_LOWER ) ? (u8MasterCh + 1U) : (u8MasterCh - u8MemberNum);
+
+        mpe_reset_channels(pxVoiceHandler);
+
+        xRetval = midiOk;
+    }
+
+    return xRetval;
+}
+
+midiStatus_t VOICE_update_expression(midi_voice_handler_t *pxVoiceHandler, uint8_t u8Cmd, uint8_t u8Data0, uint8_t u8Data1)
+{
+    ERR_ASSERT( pxVoiceHandler != NULL );
+
+    midiStatus_t xRetval = midiBadParam;
+    uint8_t u8Status = MIDI_CMD_GET_STATUS(u8Cmd);
+    uint8_t u8Ch = MIDI_CMD_GET_CH(u8Cmd);
+
+    if ( (pxVoiceHandler != NULL) && mpe_is_member(pxVoiceHandler, u8Ch) )
+    {
+        midi_voice_mpe_t *pxMpe = &pxVoiceHandler->xMpe;
+        midi_voice_expr_t eExpr = VOICE_EXPR_NUM;
+        uint16_t u16Value = 0U;
+
+        if ( u8Status == MIDI_STATUS_PITCH_BEND )
+        {
+            u16Value = (uint16_t)(((uint16_t)u8Data1 << 7U) | (uint16_t)u8Data0);
+            pxMpe->pu16Bend[u8Ch] = u16Value;
+            eExpr = VOICE_EXPR_BEND;
+        }
+        else if ( u8Status == MIDI_STATUS_CH_PRESS )
+        {
+            u16Value = u8Data0;
+            pxMpe->pu8Pressure[u8Ch] = u8Data0;
+            eExpr = VOICE_EXPR_PRESSURE;
+        }
+        else if ( (u8Status == MIDI_STATUS_CC) && (u8Data0 == MIDI_CC_BRI) )
+        {
+            u16Value = u8Data1;
+            pxMpe->pu8Timbre[u8Ch] = u8Data1;
+            eExpr = VOICE_EXPR_TIMBRE;
+        }
+
+        if ( eExpr != VOICE_EXPR_NUM )
+        {
+            uint32_t u32Mask = pxMpe->pu32ChMask[u8Ch];
+
+            while ( (u32Mask != 0U) && (pxVoiceHandler->xExprCB != NULL) )
+            {
+                uint8_t u8Voice = (uint8_t)VOICE_CLZ(u32Mask);
+
+                u32Mask &= ~VOICE_MASK(u8Voice);
+                pxVoiceHandler->xExprCB(u8Voice, eExpr, u16Value);
+            }
+
+            xRetval = midiOk;
+        }
+    }
+
+    return xRetval;
+}
+
 /* EOF */
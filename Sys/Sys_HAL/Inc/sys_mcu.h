@@ -41,6 +41,20 @@ sys_state_t sys_mcu_init(void);
  */
 uint32_t sys_mcu_get_systick(void);
 
+/**
+ * @brief Get CPU cycle counter, wraps around every 2^32 cycles.
+ * 
+ * @return uint32_t current cycle count.
+ */
+uint32_t sys_mcu_get_cycles(void);
+
+/**
+ * @brief Get CPU core clock.
+ * 
+ * @return uint32_t core clock in Hz.
+ */
+uint32_t sys_mcu_get_core_clock(void);
+
 /**
  * @brief Reset MCU.
  * 
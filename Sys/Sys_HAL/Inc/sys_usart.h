@@ -36,6 +36,7 @@ typedef enum {
     SYS_USART_EVENT_RX_BUFF_FULL    = 2U,
     SYS_USART_EVENT_RX_DONE         = 3U,
     SYS_USART_EVENT_ERROR           = 4U,
+    SYS_USART_EVENT_RX_DATA         = 5U,
     SYS_USART_EVENT_NUM
 } sys_usart_event_t;
 
@@ -73,22 +74,44 @@ sys_state_t sys_usart_deinit(sys_usart_id_t eId);
 sys_state_t sys_usart_send(sys_usart_id_t eId, uint8_t *pu8Data, uint16_t u16LenData);
 
 /**
- * @brief Inititate data read from selected interface.
+ * @brief Start endless reception on a circular DMA buffer. Reception never
+ *        stops, it is restarted by driver after line errors. Data is read in
+ *        place with sys_usart_rx_peek, SYS_USART_EVENT_RX_DATA is raised on
+ *        line idle and on each half of the buffer.
  * 
  * @param eId: Interface to use.
- * @param pu8Data: Pointer where store read data.
- * @param u16MaxLen: Read size, when reached this value, the operation will stop.
+ * @param pu8Buff: Circular buffer, must stay valid while receiving.
+ * @param u16Size: Buffer size, power of two.
  * @return sys_state_t: operation result.
  */
-sys_state_t sys_usart_read(sys_usart_id_t eId, uint8_t *pu8Data, uint16_t u16MaxLen);
+sys_state_t sys_usart_read_circular(sys_usart_id_t eId, uint8_t *pu8Buff, uint16_t u16Size);
 
 /**
- * @brief Get current number of bytes read in one interface.
+ * @brief Get next block of unread data of circular reception, without copy.
+ *        Call again after sys_usart_rx_consume to get data after buffer wrap.
  * 
  * @param eId: Interface to use.
- * @return uint16_t: Number of bytes read.
+ * @param ppu8Data: Output pointer to first unread byte.
+ * @return uint16_t: Number of contiguous bytes available, 0 if none.
  */
-uint16_t sys_usart_get_read_count(sys_usart_id_t eId);
+uint16_t sys_usart_rx_peek(sys_usart_id_t eId, uint8_t **ppu8Data);
+
+/**
+ * @brief Release data returned by sys_usart_rx_peek.
+ * 
+ * @param eId: Interface to use.
+ * @param u16Len: Number of bytes processed.
+ */
+void sys_usart_rx_consume(sys_usart_id_t eId, uint16_t u16Len);
+
+/**
+ * @brief Get number of overruns of circular reception, both peripheral
+ *        overruns and unread data overwritten by DMA.
+ * 
+ * @param eId: Interface to use.
+ * @return uint32_t: Overrun count since reception start.
+ */
+uint32_t sys_usart_get_overrun(sys_usart_id_t eId);
 
 #ifdef __cplusplus
 }
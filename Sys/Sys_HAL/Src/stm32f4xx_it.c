@@ -36,6 +36,7 @@ extern UART_HandleTypeDef huart3;
 extern DMA_HandleTypeDef hdma_adc1;
 extern DMA_HandleTypeDef hdma_dac1;
 extern DMA_HandleTypeDef hdma_dac2;
+extern DMA_HandleTypeDef hdma_usart2_rx;
 extern DMA_HandleTypeDef hdma_usart3_rx;
 extern DMA_HandleTypeDef hdma_usart3_tx;
 extern DMA_HandleTypeDef hdma_spi2_tx;
@@ -145,7 +146,15 @@ void DMA1_Stream3_IRQHandler(void)
   */
 void DMA1_Stream5_IRQHandler(void)
 {
-    HAL_DMA_IRQHandler(&hdma_dac1);
+    /* Stream shared by USART2 RX and DAC1, only one of them initialised */
+    if ( hdma_usart2_rx.State != HAL_DMA_STATE_RESET )
+    {
+        HAL_DMA_IRQHandler(&hdma_usart2_rx);
+    }
+    else
+    {
+        HAL_DMA_IRQHandler(&hdma_dac1);
+    }
 }
 
 /**
@@ -185,19 +194,8 @@ void SPI2_IRQHandler(void)
   */
 void USART2_IRQHandler(void)
 {
+    /* Line idle is handled by HAL on reception to idle mode */
     HAL_UART_IRQHandler(&huart2);
-
-    /* Check IDLE state */
-    if ( __HAL_UART_GET_FLAG(&huart2, UART_FLAG_IDLE) )
-    {
-        __HAL_UART_CLEAR_IDLEFLAG(&huart2);
-
-        /* Handle IDLE evetn as Rx event */
-        HAL_UART_RxCpltCallback(&huart2);
-
-        /* Clear reception and pass event to driver */
-        HAL_UART_Abort_IT(&huart2);
-    }
 }
 
 /**
@@ -205,16 +203,8 @@ void USART2_IRQHandler(void)
   */
 void USART3_IRQHandler(void)
 {
+    /* Line idle is handled by HAL on reception to idle mode */
     HAL_UART_IRQHandler(&huart3);
-
-    /* Check IDLE state */
-    if ( __HAL_UART_GET_FLAG(&huart3, UART_FLAG_IDLE) )
-    {
-        __HAL_UART_CLEAR_IDLEFLAG(&huart3);
-
-        /* Abort current reception and pass control to driver callback */
-        HAL_UART_Abort_IT(&huart3);
-    }
 }
 
 /* EOF */
@@ -89,6 +89,11 @@ sys_state_t sys_mcu_init(void)
     /* Initiate error log interface */
     sys_error_init();
 
+    /* Enable DWT cycle counter for profiling */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     return SYS_SUCCESS;
 }
 
@@ -97,6 +102,16 @@ uint32_t sys_mcu_get_systick(void)
     return HAL_GetTick();
 }
 
+uint32_t sys_mcu_get_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+uint32_t sys_mcu_get_core_clock(void)
+{
+    return HAL_RCC_GetHCLKFreq();
+}
+
 void sys_mcu_reset(void)
 {
     NVIC_SystemReset();
@@ -12,14 +12,28 @@
 /* Private includes ----------------------------------------------------------*/
 #include "sys_usart.h"
 #include "stm32f4xx_hal.h"
+#include "spsc_ring.h"
 
 /* Private typedef -----------------------------------------------------------*/
 
+/* Circular reception state, ring written by DMA and published by ISR */
+typedef struct usart_rx_circ
+{
+    spsc_ring_t             xRing;
+    uint16_t                u16LastPos;
+    volatile uint32_t       u32GapStart;
+    volatile uint32_t       u32GapEnd;
+    volatile uint32_t       u32HwOverrun;
+    uint32_t                u32BuffOverrun;
+    bool                    bActive;
+} usart_rx_circ_t;
+
 /* Hanlder definition for each interface */
 typedef struct usart_handler
 {
     UART_HandleTypeDef      *handler;
     usart_event_cb          event_cb;
+    usart_rx_circ_t         rx_circ;
 } usart_handler_t;
 
 /* Private define ------------------------------------------------------------*/
@@ -27,6 +41,7 @@ typedef struct usart_handler
 /* Private variables ---------------------------------------------------------*/
 UART_HandleTypeDef huart2;
 UART_HandleTypeDef huart3;
+DMA_HandleTypeDef hdma_usart2_rx;
 DMA_HandleTypeDef hdma_usart3_rx;
 DMA_HandleTypeDef hdma_usart3_tx;
 
@@ -49,6 +64,89 @@ usart_handler_t* usart_handler_list[SYS_USART_NUM] = {
 
 /* Private function prototypes -----------------------------------------------*/
 
+static usart_handler_t *usart_get_handler(UART_HandleTypeDef *huart);
+static HAL_StatusTypeDef usart_circ_start(usart_handler_t *pHandler);
+static HAL_StatusTypeDef usart_circ_restart(usart_handler_t *pHandler);
+
+/**
+ * @brief Get driver handler of HAL instance.
+ * 
+ * @param huart HAL instance.
+ * @return usart_handler_t* driver handler, NULL if not handled.
+ */
+static usart_handler_t *usart_get_handler(UART_HandleTypeDef *huart)
+{
+    usart_handler_t * pHandler = NULL;
+
+    if ( huart->Instance == USART2 )
+    {
+        pHandler = usart_handler_list[SYS_USART_0]; 
+    }
+    else if ( huart->Instance == USART3 )
+    {
+        pHandler = usart_handler_list[SYS_USART_1];
+    }
+
+    return pHandler;
+}
+
+/**
+ * @brief Start circular reception on buffer start.
+ * 
+ * @param pHandler driver handler.
+ * @return HAL_StatusTypeDef HAL operation result.
+ */
+static HAL_StatusTypeDef usart_circ_start(usart_handler_t *pHandler)
+{
+    usart_rx_circ_t *pxCirc = &pHandler->rx_circ;
+
+    pxCirc->u16LastPos = 0U;
+
+    return HAL_UARTEx_ReceiveToIdle_DMA(pHandler->handler, pxCirc->xRing.pu8Buff, (uint16_t)spsc_ring_capacity(&pxCirc->xRing));
+}
+
+/**
+ * @brief Restart circular reception after DMA was aborted. Bytes received
+ *        since last event are published, gap up to buffer end is recorded
+ *        so reader skips it.
+ * 
+ * @param pHandler driver handler.
+ * @return HAL_StatusTypeDef HAL operation result.
+ */
+static HAL_StatusTypeDef usart_circ_restart(usart_handler_t *pHandler)
+{
+    usart_rx_circ_t *pxCirc = &pHandler->rx_circ;
+    uint32_t u32Mask = pxCirc->xRing.u32Mask;
+
+    /* Stream is stopped, NDTR holds what DMA did not write yet */
+    uint16_t u16Pos = (uint16_t)((pHandler->handler->RxXferSize - pHandler->handler->hdmarx->Instance->NDTR) & u32Mask);
+
+    spsc_ring_commit_write(&pxCirc->xRing, (uint32_t)(u16Pos - pxCirc->u16LastPos) & u32Mask);
+
+    /* DMA starts again on buffer start, bytes up to end are never written */
+    uint32_t u32GapLen = (spsc_ring_capacity(&pxCirc->xRing) - u16Pos) & u32Mask;
+
+    if ( u32GapLen != 0U )
+    {
+        uint32_t u32Head = pxCirc->xRing.u32Head;
+
+        if ( (int32_t)(pxCirc->u32GapEnd - pxCirc->xRing.u32Tail) > 0 )
+        {
+            /* Previous gap not reached yet, merged, valid data between them is lost */
+            pxCirc->u32BuffOverrun++;
+        }
+        else
+        {
+            pxCirc->u32GapStart = u32Head;
+        }
+
+        pxCirc->u32GapEnd = u32Head + u32GapLen;
+        spsc_ring_commit_write(&pxCirc->xRing, u32GapLen);
+    }
+
+    return usart_circ_start(pHandler);
+}
+
 void MX_USART2_UART_Init(void)
 {
     huart2.Instance = USART2;
@@ -106,9 +204,31 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
         GPIO_InitStruct.Alternate = GPIO_AF7_USART2;
         HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
-        __HAL_UART_ENABLE_IT(&huart2, UART_IT_IDLE);
+        /* USART2 DMA Init, stream shared with DAC1, both can not be used */
+        __HAL_RCC_DMA1_CLK_ENABLE();
 
+        /* USART2_RX Init */
+        hdma_usart2_rx.Instance = DMA1_Stream5;
+        hdma_usart2_rx.Init.Channel = DMA_CHANNEL_4;
+        hdma_usart2_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+        hdma_usart2_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+        hdma_usart2_rx.Init.MemInc = DMA_MINC_ENABLE;
+        hdma_usart2_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+        hdma_usart2_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+        hdma_usart2_rx.Init.Mode = DMA_CIRCULAR;
+        hdma_usart2_rx.Init.Priority = DMA_PRIORITY_LOW;
+        hdma_usart2_rx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+        if (HAL_DMA_Init(&hdma_usart2_rx) != HAL_OK)
+        {
+            sys_error_handler();
+        }
+
+        __HAL_LINKDMA(uartHandle,hdmarx,hdma_usart2_rx);
+
+        HAL_NVIC_SetPriority(DMA1_Stream5_IRQn, 10, 0);
         HAL_NVIC_SetPriority(USART2_IRQn, 10, 0);
+
+        HAL_NVIC_EnableIRQ(DMA1_Stream5_IRQn);
         HAL_NVIC_EnableIRQ(USART2_IRQn);
     }
     else if(uartHandle->Instance==USART3)
@@ -146,7 +266,7 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
         hdma_usart3_rx.Init.MemInc = DMA_MINC_ENABLE;
         hdma_usart3_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
         hdma_usart3_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
-        hdma_usart3_rx.Init.Mode = DMA_NORMAL;
+        hdma_usart3_rx.Init.Mode = DMA_CIRCULAR;
         hdma_usart3_rx.Init.Priority = DMA_PRIORITY_LOW;
         hdma_usart3_rx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
         if (HAL_DMA_Init(&hdma_usart3_rx) != HAL_OK)
@@ -174,8 +294,6 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
 
         __HAL_LINKDMA(uartHandle,hdmatx,hdma_usart3_tx);
 
-        __HAL_UART_ENABLE_IT(&huart3, UART_IT_IDLE);
-
         HAL_NVIC_SetPriority(DMA1_Stream1_IRQn, 10, 0);
         HAL_NVIC_SetPriority(DMA1_Stream3_IRQn, 10, 0);
         HAL_NVIC_SetPriority(USART3_IRQn, 10, 0);
@@ -199,6 +317,10 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* uartHandle)
         */
         HAL_GPIO_DeInit(GPIOA, GPIO_PIN_2|GPIO_PIN_3);
 
+        /* USART2 DMA DeInit */
+        HAL_DMA_DeInit(uartHandle->hdmarx);
+
+        HAL_NVIC_DisableIRQ(DMA1_Stream5_IRQn);
         HAL_NVIC_DisableIRQ(USART2_IRQn);
     }
     else if(uartHandle->Instance==USART3)
@@ -268,6 +390,31 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
     }
 }
 
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    usart_handler_t * pHandler = usart_get_handler(huart);
+
+    if ( pHandler != NULL )
+    {
+        usart_rx_circ_t *pxCirc = &pHandler->rx_circ;
+
+        if ( pxCirc->bActive )
+        {
+            /* Half, full and idle events keep distance between two events under buffer size */
+            uint32_t u32Mask = pxCirc->xRing.u32Mask;
+            uint16_t u16Pos = (uint16_t)(Size & u32Mask);
+
+            spsc_ring_commit_write(&pxCirc->xRing, (uint32_t)(u16Pos - pxCirc->u16LastPos) & u32Mask);
+            pxCirc->u16LastPos = u16Pos;
+        }
+
+        if ( pHandler->event_cb != NULL )
+        {
+            pHandler->event_cb(SYS_USART_EVENT_RX_DATA);
+        }
+    }
+}
+
 void HAL_UART_AbortCpltCallback(UART_HandleTypeDef *huart)
 {
     usart_handler_t * pHandler = NULL;
@@ -292,19 +439,23 @@ void HAL_UART_AbortCpltCallback(UART_HandleTypeDef *huart)
 
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 {
-    usart_handler_t * pHandler = NULL;
-
-    if ( huart->Instance == USART2 )
-    {
-        pHandler = usart_handler_list[SYS_USART_0]; 
-    }
-    else if ( huart->Instance == USART3 )
-    {
-        pHandler = usart_handler_list[SYS_USART_1];
-    }
+    usart_handler_t * pHandler = usart_get_handler(huart);
 
     if ( pHandler != NULL )
     {
+        usart_rx_circ_t *pxCirc = &pHandler->rx_circ;
+
+        if ( (huart->ErrorCode & HAL_UART_ERROR_ORE) != 0U )
+        {
+            pxCirc->u32HwOverrun++;
+        }
+
+        /* DMA reception is aborted by HAL on error, circular mode never stops */
+        if ( pxCirc->bActive && (huart->RxState == HAL_UART_STATE_READY) )
+        {
+            (void)usart_circ_restart(pHandler);
+        }
+
         if ( pHandler->event_cb != NULL )
         {
             pHandler->event_cb(SYS_USART_EVENT_ERROR);
@@ -375,27 +526,34 @@ sys_state_t sys_usart_send(sys_usart_id_t eId, uint8_t *pu8Data, uint16_t u16Len
     return eRetval;
 }
 
-sys_state_t sys_usart_read(sys_usart_id_t eId, uint8_t *pu8Data, uint16_t u16MaxLen)
+sys_state_t sys_usart_read_circular(sys_usart_id_t eId, uint8_t *pu8Buff, uint16_t u16Size)
 {
     ERR_ASSERT(eId < SYS_USART_NUM);
+    ERR_ASSERT(pu8Buff != NULL);
 
-    sys_state_t eRetval = SYS_SUCCESS;
+    sys_state_t eRetval = SYS_ERROR;
+    usart_handler_t *pHandler = usart_handler_list[eId];
+    usart_rx_circ_t *pxCirc = &pHandler->rx_circ;
 
-    if ( eId == SYS_USART_0)
+    if ( (pHandler->handler->hdmarx != NULL) && (pHandler->handler->hdmarx->Init.Mode == DMA_CIRCULAR) && !pxCirc->bActive &&
+         (u16Size >= 2U) && spsc_ring_init(&pxCirc->xRing, pu8Buff, u16Size) )
     {
-        HAL_StatusTypeDef eHalResult = HAL_UART_Receive_IT(usart_handler_list[eId]->handler, pu8Data, u16MaxLen);
+        pxCirc->u16LastPos = 0U;
+        pxCirc->u32GapStart = 0U;
+        pxCirc->u32GapEnd = 0U;
+        pxCirc->u32HwOverrun = 0U;
+        pxCirc->u32BuffOverrun = 0U;
+        pxCirc->bActive = true;
 
-        if ( eHalResult != HAL_OK )
+        HAL_StatusTypeDef eHalResult = usart_circ_start(pHandler);
+
+        if ( eHalResult == HAL_OK )
         {
-            eRetval = (eHalResult == HAL_BUSY) ? SYS_BUSY : SYS_ERROR;
+            eRetval = SYS_SUCCESS;
         }
-    }
-    else if ( eId == SYS_USART_1)
-    {
-        HAL_StatusTypeDef eHalResult = HAL_UART_Receive_DMA(usart_handler_list[eId]->handler, pu8Data, u16MaxLen);
-
-        if ( eHalResult != HAL_OK )
+        else
         {
+            pxCirc->bActive = false;
             eRetval = (eHalResult == HAL_BUSY) ? SYS_BUSY : SYS_ERROR;
         }
     }
@@ -403,22 +561,84 @@ sys_state_t sys_usart_read(sys_usart_id_t eId, uint8_t *pu8Data, uint16_t u16Max
     return eRetval;
 }
 
-uint16_t sys_usart_get_read_count(sys_usart_id_t eId)
+uint16_t sys_usart_rx_peek(sys_usart_id_t eId, uint8_t **ppu8Data)
 {
     ERR_ASSERT(eId < SYS_USART_NUM);
+    ERR_ASSERT(ppu8Data != NULL);
 
-    uint16_t u16RedData = 0U;
+    usart_rx_circ_t *pxCirc = &usart_handler_list[eId]->rx_circ;
+    uint16_t u16Len = 0U;
 
-    if ( eId == SYS_USART_0)
+    if ( pxCirc->bActive )
     {
-        u16RedData = usart_handler_list[eId]->handler->RxXferSize - usart_handler_list[eId]->handler->RxXferCount;
-    }
-    else if ( eId == SYS_USART_1)
-    {
-        u16RedData = usart_handler_list[eId]->handler->RxXferSize - usart_handler_list[eId]->handler->hdmarx->Instance->NDTR;
+        /* Gap left by a restart is skipped once reader gets to it, a new
+           gap always moves its start so a read torn by the ISR is retried.
+           Gaps made after head is sampled start at or after it */
+        uint32_t u32Head = pxCirc->xRing.u32Head;
+        uint32_t u32GapStart;
+        uint32_t u32GapEnd;
+
+        do
+        {
+            u32GapStart = pxCirc->u32GapStart;
+            u32GapEnd = pxCirc->u32GapEnd;
+        } while ( u32GapStart != pxCirc->u32GapStart );
+
+        uint32_t u32Tail = pxCirc->xRing.u32Tail;
+
+        if ( (u32Tail - u32GapStart) < (u32GapEnd - u32GapStart) )
+        {
+            spsc_ring_commit_read(&pxCirc->xRing, u32GapEnd - u32Tail);
+        }
+
+        /* DMA went around the buffer, pending data is not valid */
+        uint32_t u32Count = spsc_ring_count(&pxCirc->xRing);
+
+        if ( u32Count > spsc_ring_capacity(&pxCirc->xRing) )
+        {
+            pxCirc->u32BuffOverrun++;
+            spsc_ring_commit_read(&pxCirc->xRing, u32Count);
+        }
+
+        uint32_t u32Len = spsc_ring_peek_read(&pxCirc->xRing, ppu8Data);
+
+        /* Block stops at sampled head or where a gap ahead starts */
+        u32Tail = pxCirc->xRing.u32Tail;
+
+        if ( (int32_t)(u32Head - u32Tail) <= 0 )
+        {
+            u32Len = 0U;
+        }
+        else if ( u32Len > (u32Head - u32Tail) )
+        {
+            u32Len = u32Head - u32Tail;
+        }
+
+        if ( ((int32_t)(u32GapStart - u32Tail) > 0) && (u32Len > (u32GapStart - u32Tail)) )
+        {
+            u32Len = u32GapStart - u32Tail;
+        }
+
+        u16Len = (uint16_t)u32Len;
     }
 
-    return u16RedData;
+    return u16Len;
+}
+
+void sys_usart_rx_consume(sys_usart_id_t eId, uint16_t u16Len)
+{
+    ERR_ASSERT(eId < SYS_USART_NUM);
+
+    spsc_ring_commit_read(&usart_handler_list[eId]->rx_circ.xRing, u16Len);
+}
+
+uint32_t sys_usart_get_overrun(sys_usart_id_t eId)
+{
+    ERR_ASSERT(eId < SYS_USART_NUM);
+
+    usart_rx_circ_t *pxCirc = &usart_handler_list[eId]->rx_circ;
+
+    return pxCirc->u32HwOverrun + pxCirc->u32BuffOverrun;
 }
 
 /* EOF */
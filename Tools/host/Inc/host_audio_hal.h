@@ -0,0 +1,73 @@
+/**
+ * @file    host_audio_hal.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Host audio HAL, render events are triggered by the host tool.
+ * @version 0.1
+ * @date    2021-11-27
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HOST_AUDIO_HAL_H__
+#define __HOST_AUDIO_HAL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "audio_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+
+/* Host time base, cycles reported by HAL are nanoseconds */
+#define HOST_HAL_CORE_CLOCK         ( 1000000000U )
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions prototypes ---------------------------------------------*/
+
+/*
+ * HAL state is kept per thread, every thread can start and render its own
+ * engine instance.
+ */
+
+/**
+ * @brief Deliver event to engine as the I2S DMA would do.
+ *
+ * @param eEvent event to deliver.
+ */
+void HOST_HAL_trigger(audio_hal_event_t eEvent);
+
+/**
+ * @brief Get buffer handed by engine in last send call.
+ *
+ * @param pu16Size output, number of elements of buffer.
+ * @return uint16_t* engine output buffer, NULL if not started.
+ */
+uint16_t *HOST_HAL_get_buffer(uint16_t *pu16Size);
+
+/**
+ * @brief Render one half of engine buffer and copy it as mono samples.
+ *
+ * @param pi16Out output buffer, half buffer size / 2 samples.
+ * @param bSecondHalf false to render first half, true for second half.
+ * @return uint32_t number of samples written.
+ */
+uint32_t HOST_HAL_render_half(int16_t *pi16Out, bool bSecondHalf);
+
+/**
+ * @brief Monotonic host time.
+ *
+ * @return uint64_t time in nanoseconds.
+ */
+uint64_t HOST_HAL_get_time_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /*__HOST_AUDIO_HAL_H__ */
+
+/* EOF */
@@ -0,0 +1,73 @@
+/**
+ * @file    host_wav.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Minimal 16 bit PCM WAV file writer for host tools.
+ * @version 0.1
+ * @date    2021-11-28
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HOST_WAV_H__
+#define __HOST_WAV_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Open WAV file */
+typedef struct host_wav {
+    FILE *pxFile;                   /**< Output file */
+    uint32_t u32SampleRate;         /**< Sample rate in Hz */
+    uint16_t u16Channels;           /**< Interleaved channels */
+    uint32_t u32Frames;             /**< Frames written */
+} host_wav_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Create WAV file, header is completed on close.
+ *
+ * @param pxWav wav handler.
+ * @param pcPath output path.
+ * @param u32SampleRate sample rate in Hz.
+ * @param u16Channels number of interleaved channels.
+ * @return true on success.
+ */
+bool HOST_WAV_open(host_wav_t *pxWav, const char *pcPath, uint32_t u32SampleRate, uint16_t u16Channels);
+
+/**
+ * @brief Append interleaved frames.
+ *
+ * @param pxWav wav handler.
+ * @param pi16Data samples, u32Frames * channels elements.
+ * @param u32Frames number of frames.
+ * @return true on success.
+ */
+bool HOST_WAV_write(host_wav_t *pxWav, const int16_t *pi16Data, uint32_t u32Frames);
+
+/**
+ * @brief Complete header and close file.
+ *
+ * @param pxWav wav handler.
+ * @return true on success.
+ */
+bool HOST_WAV_close(host_wav_t *pxWav);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /*__HOST_WAV_H__ */
+
+/* EOF */
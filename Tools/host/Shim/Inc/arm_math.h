@@ -0,0 +1,34 @@
+/**
+ * @file    arm_math.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Host replacement of the CMSIS-DSP subset used by audio_lib.
+ * @version 0.1
+ * @date    2021-11-27
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _ARM_MATH_H
+#define _ARM_MATH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Same value as CMSIS-DSP */
+#define PI                  ( 3.14159265358979f )
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ARM_MATH_H */
+
+/* EOF */
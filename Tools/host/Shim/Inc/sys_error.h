@@ -0,0 +1,29 @@
+/**
+ * @file    sys_error.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Host replacement of system error handler header.
+ * @version 0.1
+ * @date    2021-11-27
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SYS_ERROR_H
+#define __SYS_ERROR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "user_assert.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SYS_ERROR_H */
+
+/* EOF */
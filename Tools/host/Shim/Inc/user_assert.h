@@ -0,0 +1,44 @@
+/**
+ * @file    user_assert.h
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Host replacement of firmware assert, always evaluated as on target.
+ * @version 0.1
+ * @date    2021-11-27
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef __USER_ASSERT_H
+#define __USER_ASSERT_H
+
+#ifdef  __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+/** Execute assert, not removed by NDEBUG */
+#define ERR_ASSERT(exp)     \
+do {                        \
+    if (!(exp)) {           \
+        (void)fprintf(stderr, "%s:%d: assert failed: %s\n", __FILE__, __LINE__, #exp); \
+        abort();            \
+    }                       \
+} while (0)
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif /* __USER_ASSERT_H */
+
+/* EOF */
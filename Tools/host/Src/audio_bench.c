@@ -0,0 +1,1046 @@
+/**
+ * @file    audio_bench.c
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Host performance regression suite of audio_lib.
+ * @version 0.1
+ * @date    2021-11-27
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Microbenchmarks report best time of several runs as JSON. Parameter
+ * update benchmarks count one call as one sample. Golden scenarios render
+ * the engine through the same DMA callback path as firmware and compare
+ * output against reference CSV files within a tolerance in LSB.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "host_audio_hal.h"
+
+#include "audio_engine.h"
+#include "audio_wavetable.h"
+#include "audio_env_adsr.h"
+#include "audio_env_ramp.h"
+#include "audio_filter.h"
+#include "audio_delay.h"
+#include "audio_effect.h"
+#include "audio_master.h"
+#include "audio_tools.h"
+#include "audio_pool.h"
+
+#include "midi_voice.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+
+/* Benchmark body, returns elapsed nanoseconds of measured section */
+typedef uint64_t (*bench_fn_t)(uint32_t u32Samples);
+
+/* Benchmark definition */
+typedef struct bench_def {
+    const char *pcName;
+    bench_fn_t pFn;
+} bench_def_t;
+
+/* Golden scenario, configures engine before render */
+typedef struct golden_def {
+    const char *pcName;
+    void (*pSetup)(void);
+} golden_def_t;
+
+/* Tool options */
+typedef struct bench_opt {
+    const char *pcJsonPath;
+    const char *pcGoldenDir;
+    const char *pcFilter;
+    uint32_t u32Samples;
+    uint32_t u32Runs;
+    uint32_t u32Tolerance;
+    bool bUpdateGolden;
+    bool bSkipGolden;
+} bench_opt_t;
+
+/* Private define ------------------------------------------------------------*/
+
+/* Engine sample rate */
+#define BENCH_SAMPLE_RATE           ( 48000U )
+
+/* Engine block, same as firmware half transfer */
+#define BENCH_BLOCK_SIZE            ( 16U )
+
+/* Default options */
+#define BENCH_DEF_SAMPLES           ( BENCH_SAMPLE_RATE )
+#define BENCH_DEF_RUNS              ( 7U )
+#define BENCH_DEF_TOLERANCE         ( 2U )
+
+/* Delay line used in delay benchmark */
+#define BENCH_DELAY_SIZE            ( 4096U )
+
+/* Golden render length and note off position */
+#define GOLDEN_SAMPLES              ( 9600U )
+#define GOLDEN_NOTE_OFF             ( 4800U )
+
+#ifndef HOST_GOLDEN_DIR
+#define HOST_GOLDEN_DIR             "Golden"
+#endif
+
+/* Private macro -------------------------------------------------------------*/
+
+#define ARRAY_SIZE(_a)              ( sizeof(_a) / sizeof((_a)[0]) )
+
+/* Private variables ---------------------------------------------------------*/
+
+/* Engine instance for chain, end to end and golden runs */
+audio_engine_t xBenchEngine;
+
+/* Keeps results alive so loops are not optimised out */
+volatile float fBenchSink = 0.0F;
+
+/* Delay line for delay benchmark */
+float pfBenchDelayBuff[BENCH_DELAY_SIZE];
+
+/* Arena for pool benchmark */
+uint64_t pu64BenchArena[256];
+
+/* Voice allocator benchmark, voices reported active by callback */
+midi_voice_handler_t xBenchVoiceHandler;
+midi_voice_t xBenchVoiceList[MIDI_VOICE_MAX];
+uint32_t u32BenchVoiceActive = 0U;
+uint32_t u32BenchVoiceErr = 0U;
+
+/* Golden render output */
+int16_t pi16GoldenOut[GOLDEN_SAMPLES];
+int16_t pi16GoldenRef[GOLDEN_SAMPLES];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint64_t bench_osc(audio_wave_id_t eWave, float fDetune, float fMorph, uint32_t u32Samples);
+static uint64_t bench_osc_saw(uint32_t u32Samples);
+static uint64_t bench_osc_rsaw(uint32_t u32Samples);
+static uint64_t bench_osc_sqr(uint32_t u32Samples);
+static uint64_t bench_osc_sin(uint32_t u32Samples);
+static uint64_t bench_osc_tri(uint32_t u32Samples);
+static uint64_t bench_osc_detune(uint32_t u32Samples);
+static uint64_t bench_osc_morph(uint32_t u32Samples);
+static uint64_t bench_osc_update_freq(uint32_t u32Samples);
+static uint64_t bench_adsr(uint32_t u32Samples);
+static uint64_t bench_ramp(uint32_t u32Samples);
+static uint64_t bench_filter(uint32_t u32Samples);
+static uint64_t bench_filter_set_freq(uint32_t u32Samples);
+static uint64_t bench_delay(uint32_t u32Samples);
+static uint64_t bench_effect_chain(uint32_t u32Samples);
+static uint64_t bench_master(uint32_t u32Samples);
+static uint64_t bench_tool_log2(uint32_t u32Samples);
+static uint64_t bench_tool_exp2(uint32_t u32Samples);
+static uint64_t bench_tool_lin_to_db(uint32_t u32Samples);
+static uint64_t bench_tool_db_to_lin(uint32_t u32Samples);
+static uint64_t bench_tool_lin_map(uint32_t u32Samples);
+static uint64_t bench_pool(uint32_t u32Samples);
+static uint64_t bench_engine(uint32_t u32Voices, uint32_t u32Samples);
+static uint64_t bench_engine_1v(uint32_t u32Samples);
+static uint64_t bench_engine_4v(uint32_t u32Samples);
+static uint64_t bench_engine_8v(uint32_t u32Samples);
+static uint64_t bench_voice_chord(uint32_t u32Voices, uint32_t u32Samples);
+static uint64_t bench_voice_chord8(uint32_t u32Samples);
+static uint64_t bench_voice_chord32(uint32_t u32Samples);
+static void bench_voice_cb(uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity, midi_voice_state_t eAction);
+
+static void engine_cmd_note(uint32_t u32Voice, uint8_t u8Note, bool bActive);
+static void engine_cmd_wave(uint32_t u32Voice, audio_wave_id_t eWave);
+static void golden_setup_chord(void);
+static void golden_setup_waves(void);
+static void golden_setup_fx(void);
+static void golden_render(const golden_def_t *pxGolden, int16_t *pi16Out);
+static bool golden_load(const char *pcPath, int16_t *pi16Data, uint32_t u32Size);
+static bool golden_store(const char *pcPath, const int16_t *pi16Data, uint32_t u32Size);
+
+static bool bench_parse_args(int argc, char **argv, bench_opt_t *pxOpt);
+static void bench_usage(const char *pcProg);
+
+/* Private variables ---------------------------------------------------------*/
+
+/* Benchmark list */
+static const bench_def_t xBenchList[] = {
+    { "osc.saw",                bench_osc_saw },
+    { "osc.rsaw",               bench_osc_rsaw },
+    { "osc.sqr",                bench_osc_sqr },
+    { "osc.sin",                bench_osc_sin },
+    { "osc.tri",                bench_osc_tri },
+    { "osc.detune",             bench_osc_detune },
+    { "osc.morph",              bench_osc_morph },
+    { "osc.update_freq",        bench_osc_update_freq },
+    { "adsr.process",           bench_adsr },
+    { "ramp.process",           bench_ramp },
+    { "filter_lp.process",      bench_filter },
+    { "filter_lp.set_freq",     bench_filter_set_freq },
+    { "delay.process",          bench_delay },
+    { "effect.render",          bench_effect_chain },
+    { "master.process",         bench_master },
+    { "tool.fast_log2",         bench_tool_log2 },
+    { "tool.fast_exp2",         bench_tool_exp2 },
+    { "tool.lin_to_db",         bench_tool_lin_to_db },
+    { "tool.db_to_lin",         bench_tool_db_to_lin },
+    { "tool.lin_map",           bench_tool_lin_map },
+    { "pool.alloc_free",        bench_pool },
+    { "engine.1v",              bench_engine_1v },
+    { "engine.4v",              bench_engine_4v },
+    { "engine.8v",              bench_engine_8v },
+    { "voice.chord8",           bench_voice_chord8 },
+    { "voice.chord32",          bench_voice_chord32 },
+};
+
+/* Golden scenario list */
+static const golden_def_t xGoldenList[] = {
+    { "engine_chord",           golden_setup_chord },
+    { "engine_waves",           golden_setup_waves },
+    { "engine_fx",              golden_setup_fx },
+};
+
+/* Private function definition -----------------------------------------------*/
+
+static uint64_t bench_osc(audio_wave_id_t eWave, float fDetune, float fMorph, uint32_t u32Samples)
+{
+    AudioWaveTableVoice_t xVoice;
+    float fAcc = 0.0F;
+
+    AUDIO_WAVE_init_voice(&xVoice, BENCH_SAMPLE_RATE, 1.0F);
+    AUDIO_WAVE_change_wave(&xVoice, eWave);
+    AUDIO_WAVE_update_morph(&xVoice, fMorph);
+    AUDIO_WAVE_update_freq(&xVoice, 440.0F);
+    AUDIO_WAVE_update_detune(&xVoice, fDetune);
+    AUDIO_WAVE_set_active(&xVoice, true);
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        fAcc += AUDIO_WAVE_get_next_sample(&xVoice);
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = fAcc;
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_osc_saw(uint32_t u32Samples)
+{
+    return bench_osc(AUDIO_WAVE_SAW, AUDIO_WAVE_NON_DETUNE, (float)AUDIO_WAVE_SAW, u32Samples);
+}
+
+static uint64_t bench_osc_rsaw(uint32_t u32Samples)
+{
+    return bench_osc(AUDIO_WAVE_RSAW, AUDIO_WAVE_NON_DETUNE, (float)AUDIO_WAVE_RSAW, u32Samples);
+}
+
+static uint64_t bench_osc_sqr(uint32_t u32Samples)
+{
+    return bench_osc(AUDIO_WAVE_SQR, AUDIO_WAVE_NON_DETUNE, (float)AUDIO_WAVE_SQR, u32Samples);
+}
+
+static uint64_t bench_osc_sin(uint32_t u32Samples)
+{
+    return bench_osc(AUDIO_WAVE_SIN, AUDIO_WAVE_NON_DETUNE, (float)AUDIO_WAVE_SIN, u32Samples);
+}
+
+static uint64_t bench_osc_tri(uint32_t u32Samples)
+{
+    return bench_osc(AUDIO_WAVE_TRI, AUDIO_WAVE_NON_DETUNE, (float)AUDIO_WAVE_TRI, u32Samples);
+}
+
+static uint64_t bench_osc_detune(uint32_t u32Samples)
+{
+    return bench_osc(AUDIO_WAVE_SAW, 0.01F, (float)AUDIO_WAVE_SAW, u32Samples);
+}
+
+static uint64_t bench_osc_morph(uint32_t u32Samples)
+{
+    return bench_osc(AUDIO_WAVE_SAW, AUDIO_WAVE_NON_DETUNE, 1.5F, u32Samples);
+}
+
+static uint64_t bench_osc_update_freq(uint32_t u32Samples)
+{
+    AudioWaveTableVoice_t xVoice;
+
+    AUDIO_WAVE_init_voice(&xVoice, BENCH_SAMPLE_RATE, 1.0F);
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        AUDIO_WAVE_update_freq(&xVoice, 100.0F + (float)(i & 0x3FFU));
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = AUDIO_WAVE_get_next_sample(&xVoice);
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_adsr(uint32_t u32Samples)
+{
+    env_adsr_ctrl_t xAdsr;
+    float fAcc = 0.0F;
+
+    ADSR_init(&xAdsr, (float)BENCH_SAMPLE_RATE);
+    ADSR_trigger(&xAdsr);
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        fAcc += ADSR_process(&xAdsr);
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = fAcc;
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_ramp(uint32_t u32Samples)
+{
+    env_ramp_ctrl_t xRamp;
+    float fAcc = 0.0F;
+
+    RAMP_init(&xRamp, (float)BENCH_SAMPLE_RATE);
+    RAMP_set_value(&xRamp, 0.0F);
+    RAMP_ramp_to(&xRamp, 1.0F, (float)u32Samples / (float)BENCH_SAMPLE_RATE);
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        fAcc += RAMP_process(&xRamp);
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = fAcc;
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_filter(uint32_t u32Samples)
+{
+    AudioFilterLP_t xFilter;
+    float fAcc = 0.0F;
+    float fIn = 1.0F;
+
+    AUDIO_FILTER_LP_init(&xFilter);
+    AUDIO_FILTER_LP_set_samplerate(&xFilter, (float)BENCH_SAMPLE_RATE);
+    AUDIO_FILTER_LP_set_frequency(&xFilter, 1000.0F);
+    AUDIO_FILTER_LP_set_q(&xFilter, 0.707F);
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        fAcc += AUDIO_FILTER_LP_process(&xFilter, fIn);
+        fIn = -fIn;
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = fAcc;
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_filter_set_freq(uint32_t u32Samples)
+{
+    AudioFilterLP_t xFilter;
+
+    AUDIO_FILTER_LP_init(&xFilter);
+    AUDIO_FILTER_LP_set_samplerate(&xFilter, (float)BENCH_SAMPLE_RATE);
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        AUDIO_FILTER_LP_set_frequency(&xFilter, 100.0F + (float)(i & 0x1FFFU));
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = AUDIO_FILTER_LP_process(&xFilter, 1.0F);
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_delay(uint32_t u32Samples)
+{
+    AudioDelayCtrl_t xDelay;
+    float fAcc = 0.0F;
+    float fIn = 1.0F;
+
+    AUDIO_DELAY_init(&xDelay, BENCH_SAMPLE_RATE, pfBenchDelayBuff, BENCH_DELAY_SIZE);
+    AUDIO_DELAY_update_delay(&xDelay, 0.05F);
+    AUDIO_DELAY_update_feedback(&xDelay, 0.5F);
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        fAcc += AUDIO_DELAY_process(&xDelay, fIn);
+        fIn = -fIn;
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = fAcc;
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_effect_chain(uint32_t u32Samples)
+{
+    float fAcc = 0.0F;
+    float fIn = 0.5F;
+
+    /* Default engine chain: filter on slot 0, delay on slot 1 */
+    (void)AUDIO_init(&xBenchEngine);
+    (void)AUDIO_EFFECT_activate_slot(&xBenchEngine.xEffects, AUDIO_EFFECT_SLOT_0, true);
+    (void)AUDIO_EFFECT_activate_slot(&xBenchEngine.xEffects, AUDIO_EFFECT_SLOT_1, true);
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        fAcc += AUDIO_EFFECT_render(&xBenchEngine.xEffects, fIn);
+        fIn = -fIn;
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = fAcc;
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_master(uint32_t u32Samples)
+{
+    static AudioMaster_t xMasterBench;
+    float pfBlock[BENCH_BLOCK_SIZE];
+    uint64_t u64Elapsed = 0U;
+
+    AUDIO_MASTER_init(&xMasterBench, (float)BENCH_SAMPLE_RATE, BENCH_BLOCK_SIZE);
+    AUDIO_MASTER_parameter_update(&xMasterBench, AUDIO_MASTER_PARAMETER_COMP_RATIO, 4.0F);
+
+    for ( uint32_t u32Done = 0U; u32Done < u32Samples; u32Done += BENCH_BLOCK_SIZE )
+    {
+        /* Hot signal so compressor and limiter are working */
+        for ( uint32_t i = 0U; i < BENCH_BLOCK_SIZE; i++ )
+        {
+            pfBlock[i] = ( (i & 1U) != 0U ) ? 1.5F : -1.5F;
+        }
+
+        uint64_t u64Start = HOST_HAL_get_time_ns();
+
+        AUDIO_MASTER_process(&xMasterBench, pfBlock, BENCH_BLOCK_SIZE);
+
+        u64Elapsed += HOST_HAL_get_time_ns() - u64Start;
+    }
+
+    fBenchSink = pfBlock[0U];
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_tool_log2(uint32_t u32Samples)
+{
+    float fAcc = 0.0F;
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        fAcc += AUDIO_TOOL_fast_log2(1.0F + (float)(i & 0xFFFU));
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = fAcc;
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_tool_exp2(uint32_t u32Samples)
+{
+    float fAcc = 0.0F;
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        fAcc += AUDIO_TOOL_fast_exp2((float)(i & 0xFFU) * -0.0625F);
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = fAcc;
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_tool_lin_to_db(uint32_t u32Samples)
+{
+    float fAcc = 0.0F;
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        fAcc += AUDIO_TOOL_lin_to_db(0.001F + ((float)(i & 0x3FFU) * 0.001F));
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = fAcc;
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_tool_db_to_lin(uint32_t u32Samples)
+{
+    float fAcc = 0.0F;
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        fAcc += AUDIO_TOOL_db_to_lin((float)(i & 0x3FU) * -1.0F);
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = fAcc;
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_tool_lin_map(uint32_t u32Samples)
+{
+    float fAcc = 0.0F;
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        fAcc += AUDIO_TOOL_lin_map((float)(i & 0x7FU), 0.0F, 127.0F, 20.0F, 20000.0F);
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = fAcc;
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_pool(uint32_t u32Samples)
+{
+    audio_pool_t xPool;
+
+    (void)AUDIO_POOL_init(&xPool, pu64BenchArena, sizeof(pu64BenchArena));
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Samples; i++ )
+    {
+        void *pvBlock = AUDIO_POOL_alloc(&xPool, 64U + (i & 0xFFU));
+        AUDIO_POOL_free(&xPool, pvBlock);
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    fBenchSink = (float)AUDIO_POOL_get_free(&xPool);
+
+    return u64Elapsed;
+}
+
+static uint64_t bench_engine(uint32_t u32Voices, uint32_t u32Samples)
+{
+    (void)AUDIO_init(&xBenchEngine);
+
+    engine_cmd_wave(AUDIO_VOICE_NUM, AUDIO_WAVE_SAW);
+
+    for ( uint32_t u32Voice = 0U; u32Voice < u32Voices; u32Voice++ )
+    {
+        engine_cmd_note(u32Voice, (uint8_t)(48U + (u32Voice * 4U)), true);
+    }
+
+    /* Same path as DMA interrupt, includes render profiling */
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t u32Block = 0U; (u32Block * BENCH_BLOCK_SIZE) < u32Samples; u32Block++ )
+    {
+        HOST_HAL_trigger(( (u32Block & 1U) != 0U ) ? AUDIO_HAL_EVENT_TX_DONE : AUDIO_HAL_EVENT_HALF_TX_DONE);
+    }
+
+    return HOST_HAL_get_time_ns() - u64Start;
+}
+
+static uint64_t bench_engine_1v(uint32_t u32Samples)
+{
+    return bench_engine(1U, u32Samples);
+}
+
+static uint64_t bench_engine_4v(uint32_t u32Samples)
+{
+    return bench_engine(4U, u32Samples);
+}
+
+static uint64_t bench_engine_8v(uint32_t u32Samples)
+{
+    return bench_engine(8U, u32Samples);
+}
+
+static void bench_voice_cb(uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity, midi_voice_state_t eAction)
+{
+    uint32_t u32Bit = 1UL << u8Voice;
+    bool bActive = ( (u32BenchVoiceActive & u32Bit) != 0U );
+
+    (void)u8Note;
+    (void)u8Velocity;
+
+    /* Allocator must never hand out a busy voice or free an idle one */
+    if ( (eAction == VOICE_STATE_ON) == bActive )
+    {
+        u32BenchVoiceErr++;
+    }
+
+    u32BenchVoiceActive ^= u32Bit;
+}
+
+static uint64_t bench_voice_chord(uint32_t u32Voices, uint32_t u32Samples)
+{
+    uint32_t u32Chord = 0U;
+    uint32_t u32Events = 0U;
+
+    (void)VOICE_init(&xBenchVoiceHandler, xBenchVoiceList, (uint8_t)u32Voices, 0U, bench_voice_cb);
+    u32BenchVoiceActive = 0U;
+    u32BenchVoiceErr = 0U;
+
+    /* Chords one note larger than voice count, released in reverse order. One event is one sample */
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    while ( u32Events < u32Samples )
+    {
+        uint8_t u8Base = (uint8_t)((u32Chord * 5U) % (MIDI_VOICE_NOTE_NUM - MIDI_VOICE_MAX - 1U));
+
+        for ( uint32_t n = 0U; n <= u32Voices; n++ )
+        {
+            (void)VOICE_update_note(&xBenchVoiceHandler, MIDI_STATUS_NOTE_ON, (uint8_t)(u8Base + n), 100U);
+        }
+
+        if ( u32BenchVoiceActive != (uint32_t)((1ULL << u32Voices) - 1U) )
+        {
+            u32BenchVoiceErr++;
+        }
+
+        for ( uint32_t n = u32Voices + 1U; n > 0U; n-- )
+        {
+            (void)VOICE_update_note(&xBenchVoiceHandler, MIDI_STATUS_NOTE_OFF, (uint8_t)(u8Base + n - 1U), 0U);
+        }
+
+        u32Events += 2U * (u32Voices + 1U);
+        u32Chord++;
+    }
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    if ( (u32BenchVoiceErr != 0U) || (u32BenchVoiceActive != 0U) )
+    {
+        fprintf(stderr, "voice allocator error, %lu faults, active mask 0x%08lx\n",
+                (unsigned long)u32BenchVoiceErr, (unsigned long)u32BenchVoiceActive);
+        exit(EXIT_FAILURE);
+    }
+
+    /* Time is normalised by caller to requested samples */
+    return (u64Elapsed * u32Samples) / u32Events;
+}
+
+static uint64_t bench_voice_chord8(uint32_t u32Samples)
+{
+    return bench_voice_chord(8U, u32Samples);
+}
+
+static uint64_t bench_voice_chord32(uint32_t u32Samples)
+{
+    return bench_voice_chord(MIDI_VOICE_MAX, u32Samples);
+}
+
+static void engine_cmd_note(uint32_t u32Voice, uint8_t u8Note, bool bActive)
+{
+    audio_cmd_t xAudioCmd = { 0U };
+
+    xAudioCmd.eCmdId = AUDIO_CMD_SET_MIDI_NOTE;
+    xAudioCmd.xCmdPayload.xSetMidiNote.eVoiceId = (audio_voice_id_t)u32Voice;
+    xAudioCmd.xCmdPayload.xSetMidiNote.u8Note = u8Note;
+    xAudioCmd.xCmdPayload.xSetMidiNote.u8Velocity = 100U;
+    xAudioCmd.xCmdPayload.xSetMidiNote.bActive = bActive;
+    (void)AUDIO_handle_cmd(&xBenchEngine, xAudioCmd);
+}
+
+static void engine_cmd_wave(uint32_t u32Voice, audio_wave_id_t eWave)
+{
+    audio_cmd_t xAudioCmd = { 0U };
+
+    xAudioCmd.eCmdId = AUDIO_CMD_SET_WAVEFORM;
+    xAudioCmd.xCmdPayload.xSetWave.eVoiceId = (audio_voice_id_t)u32Voice;
+    xAudioCmd.xCmdPayload.xSetWave.eWaveId = eWave;
+    (void)AUDIO_handle_cmd(&xBenchEngine, xAudioCmd);
+}
+
+static void golden_setup_chord(void)
+{
+    static const uint8_t pu8Chord[] = { 48U, 55U, 60U, 64U };
+
+    engine_cmd_wave(AUDIO_VOICE_NUM, AUDIO_WAVE_SAW);
+
+    for ( uint32_t i = 0U; i < ARRAY_SIZE(pu8Chord); i++ )
+    {
+        engine_cmd_note(i, pu8Chord[i], true);
+    }
+}
+
+static void golden_setup_waves(void)
+{
+    audio_cmd_t xAudioCmd = { 0U };
+
+    for ( uint32_t u32Voice = 0U; u32Voice < (uint32_t)AUDIO_VOICE_NUM; u32Voice++ )
+    {
+        engine_cmd_wave(u32Voice, (audio_wave_id_t)(u32Voice % (uint32_t)AUDIO_WAVE_FACTORY_NUM));
+
+        xAudioCmd.eCmdId = AUDIO_CMD_SET_DETUNE;
+        xAudioCmd.xCmdPayload.xSetDetune.eVoiceId = (audio_voice_id_t)u32Voice;
+        xAudioCmd.xCmdPayload.xSetDetune.fDetuneLvl = ((float)u32Voice - 4.0F) * 0.005F;
+        (void)AUDIO_handle_cmd(&xBenchEngine, xAudioCmd);
+
+        xAudioCmd.eCmdId = AUDIO_CMD_SET_MORPH;
+        xAudioCmd.xCmdPayload.xSetMorph.eVoiceId = (audio_voice_id_t)u32Voice;
+        xAudioCmd.xCmdPayload.xSetMorph.fMorph = (float)u32Voice * 0.45F;
+        (void)AUDIO_handle_cmd(&xBenchEngine, xAudioCmd);
+
+        engine_cmd_note(u32Voice, (uint8_t)(36U + (u32Voice * 7U)), true);
+    }
+}
+
+static void golden_setup_fx(void)
+{
+    audio_cmd_t xAudioCmd = { 0U };
+
+    golden_setup_waves();
+
+    xAudioCmd.eCmdId = AUDIO_CMD_EFFECT_UPDATE;
+    xAudioCmd.xCmdPayload.xEffectUpdate.eSlot = AUDIO_EFFECT_SLOT_0;
+    xAudioCmd.xCmdPayload.xEffectUpdate.eParamId = AUDIO_EFFECT_PARAMETER_FILTER_FREQ;
+    xAudioCmd.xCmdPayload.xEffectUpdate.fNewValue = 1200.0F;
+    (void)AUDIO_handle_cmd(&xBenchEngine, xAudioCmd);
+
+    xAudioCmd.xCmdPayload.xEffectUpdate.eSlot = AUDIO_EFFECT_SLOT_1;
+    xAudioCmd.xCmdPayload.xEffectUpdate.eParamId = AUDIO_EFFECT_PARAMETER_DELAY_TIME;
+    xAudioCmd.xCmdPayload.xEffectUpdate.fNewValue = 0.03F;
+    (void)AUDIO_handle_cmd(&xBenchEngine, xAudioCmd);
+
+    xAudioCmd.xCmdPayload.xEffectUpdate.eParamId = AUDIO_EFFECT_PARAMETER_DELAY_FB;
+    xAudioCmd.xCmdPayload.xEffectUpdate.fNewValue = 0.6F;
+    (void)AUDIO_handle_cmd(&xBenchEngine, xAudioCmd);
+
+    for ( uint32_t u32Slot = 0U; u32Slot < 2U; u32Slot++ )
+    {
+        xAudioCmd.eCmdId = AUDIO_CMD_EFFECT_ACTIVATE;
+        xAudioCmd.xCmdPayload.xActivateSlot.eSlot = (audio_effect_slot_t)u32Slot;
+        xAudioCmd.xCmdPayload.xActivateSlot.bActive = true;
+        (void)AUDIO_handle_cmd(&xBenchEngine, xAudioCmd);
+    }
+
+    xAudioCmd.eCmdId = AUDIO_CMD_MASTER_UPDATE;
+    xAudioCmd.xCmdPayload.xMasterUpdate.eParamId = AUDIO_MASTER_PARAMETER_COMP_RATIO;
+    xAudioCmd.xCmdPayload.xMasterUpdate.fNewValue = 4.0F;
+    (void)AUDIO_handle_cmd(&xBenchEngine, xAudioCmd);
+
+    xAudioCmd.xCmdPayload.xMasterUpdate.eParamId = AUDIO_MASTER_PARAMETER_COMP_THRESHOLD;
+    xAudioCmd.xCmdPayload.xMasterUpdate.fNewValue = -18.0F;
+    (void)AUDIO_handle_cmd(&xBenchEngine, xAudioCmd);
+}
+
+static void golden_render(const golden_def_t *pxGolden, int16_t *pi16Out)
+{
+    uint32_t u32Done = 0U;
+    bool bSecondHalf = false;
+
+    (void)AUDIO_init(&xBenchEngine);
+    pxGolden->pSetup();
+
+    while ( u32Done < GOLDEN_SAMPLES )
+    {
+        if ( u32Done == GOLDEN_NOTE_OFF )
+        {
+            engine_cmd_note(AUDIO_VOICE_NUM, 0U, false);
+        }
+
+        u32Done += HOST_HAL_render_half(&pi16Out[u32Done], bSecondHalf);
+        bSecondHalf = !bSecondHalf;
+    }
+}
+
+static bool golden_load(const char *pcPath, int16_t *pi16Data, uint32_t u32Size)
+{
+    bool bRetval = false;
+    FILE *pxFile = fopen(pcPath, "r");
+
+    if ( pxFile != NULL )
+    {
+        char pcLine[32];
+        uint32_t u32Count = 0U;
+
+        /* Skip header */
+        (void)fgets(pcLine, sizeof(pcLine), pxFile);
+
+        while ( (u32Count < u32Size) && (fgets(pcLine, sizeof(pcLine), pxFile) != NULL) )
+        {
+            pi16Data[u32Count++] = (int16_t)strtol(pcLine, NULL, 10);
+        }
+
+        bRetval = (u32Count == u32Size);
+
+        (void)fclose(pxFile);
+    }
+
+    return bRetval;
+}
+
+static bool golden_store(const char *pcPath, const int16_t *pi16Data, uint32_t u32Size)
+{
+    bool bRetval = false;
+    FILE *pxFile = fopen(pcPath, "w");
+
+    if ( pxFile != NULL )
+    {
+        (void)fprintf(pxFile, "sample\n");
+
+        for ( uint32_t i = 0U; i < u32Size; i++ )
+        {
+            (void)fprintf(pxFile, "%d\n", pi16Data[i]);
+        }
+
+        bRetval = (fclose(pxFile) == 0);
+    }
+
+    return bRetval;
+}
+
+static void bench_usage(const char *pcProg)
+{
+    (void)fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  -o <file>          write JSON report to file, default stdout\n"
+        "  -n <samples>       samples per benchmark run, default %u\n"
+        "  -r <runs>          runs per benchmark, best is reported, default %u\n"
+        "  -f <prefix>        only run benchmarks starting with prefix\n"
+        "  -g <dir>           golden directory, default %s\n"
+        "  -t <lsb>           golden tolerance in LSB, default %u\n"
+        "  --update-golden    store current render as golden reference\n"
+        "  --no-golden        skip golden checks\n",
+        pcProg, BENCH_DEF_SAMPLES, BENCH_DEF_RUNS, HOST_GOLDEN_DIR, BENCH_DEF_TOLERANCE);
+}
+
+static bool bench_parse_args(int argc, char **argv, bench_opt_t *pxOpt)
+{
+    bool bRetval = true;
+
+    pxOpt->pcJsonPath = NULL;
+    pxOpt->pcGoldenDir = HOST_GOLDEN_DIR;
+    pxOpt->pcFilter = "";
+    pxOpt->u32Samples = BENCH_DEF_SAMPLES;
+    pxOpt->u32Runs = BENCH_DEF_RUNS;
+    pxOpt->u32Tolerance = BENCH_DEF_TOLERANCE;
+    pxOpt->bUpdateGolden = false;
+    pxOpt->bSkipGolden = false;
+
+    for ( int i = 1; (i < argc) && bRetval; i++ )
+    {
+        bool bHasValue = ((i + 1) < argc);
+
+        if ( strcmp(argv[i], "--update-golden") == 0 )
+        {
+            pxOpt->bUpdateGolden = true;
+        }
+        else if ( strcmp(argv[i], "--no-golden") == 0 )
+        {
+            pxOpt->bSkipGolden = true;
+        }
+        else if ( (strcmp(argv[i], "-o") == 0) && bHasValue )
+        {
+            pxOpt->pcJsonPath = argv[++i];
+        }
+        else if ( (strcmp(argv[i], "-n") == 0) && bHasValue )
+        {
+            pxOpt->u32Samples = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (strcmp(argv[i], "-r") == 0) && bHasValue )
+        {
+            pxOpt->u32Runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (strcmp(argv[i], "-f") == 0) && bHasValue )
+        {
+            pxOpt->pcFilter = argv[++i];
+        }
+        else if ( (strcmp(argv[i], "-g") == 0) && bHasValue )
+        {
+            pxOpt->pcGoldenDir = argv[++i];
+        }
+        else if ( (strcmp(argv[i], "-t") == 0) && bHasValue )
+        {
+            pxOpt->u32Tolerance = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            bRetval = false;
+        }
+    }
+
+    if ( (pxOpt->u32Samples == 0U) || (pxOpt->u32Runs == 0U) )
+    {
+        bRetval = false;
+    }
+
+    return bRetval;
+}
+
+/* Public function definition ------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    bench_opt_t xOpt;
+    bool bGoldenPass = true;
+
+    if ( !bench_parse_args(argc, argv, &xOpt) )
+    {
+        bench_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE *pxJson = stdout;
+
+    if ( xOpt.pcJsonPath != NULL )
+    {
+        pxJson = fopen(xOpt.pcJsonPath, "w");
+
+        if ( pxJson == NULL )
+        {
+            (void)fprintf(stderr, "Cannot open %s\n", xOpt.pcJsonPath);
+            return EXIT_FAILURE;
+        }
+    }
+
+    (void)fprintf(pxJson, "{\n  \"sample_rate\": %u,\n  \"samples\": %u,\n  \"runs\": %u,\n  \"benchmarks\": [",
+                  BENCH_SAMPLE_RATE, xOpt.u32Samples, xOpt.u32Runs);
+
+    const char *pcSep = "\n";
+
+    for ( uint32_t u32Bench = 0U; u32Bench < ARRAY_SIZE(xBenchList); u32Bench++ )
+    {
+        const bench_def_t *pxBench = &xBenchList[u32Bench];
+
+        if ( strncmp(pxBench->pcName, xOpt.pcFilter, strlen(xOpt.pcFilter)) == 0 )
+        {
+            /* Best run filters scheduler noise */
+            uint64_t u64Best = UINT64_MAX;
+
+            for ( uint32_t u32Run = 0U; u32Run < xOpt.u32Runs; u32Run++ )
+            {
+                uint64_t u64Elapsed = pxBench->pFn(xOpt.u32Samples);
+
+                if ( u64Elapsed < u64Best )
+                {
+                    u64Best = u64Elapsed;
+                }
+            }
+
+            double dNsPerSample = (double)u64Best / (double)xOpt.u32Samples;
+            double dSamplesPerSec = (dNsPerSample > 0.0) ? (1.0e9 / dNsPerSample) : 0.0;
+
+            (void)fprintf(pxJson, "%s    { \"name\": \"%s\", \"ns_per_sample\": %.3f, \"samples_per_s\": %.0f, \"realtime_x\": %.1f }",
+                          pcSep, pxBench->pcName, dNsPerSample, dSamplesPerSec, dSamplesPerSec / (double)BENCH_SAMPLE_RATE);
+            pcSep = ",\n";
+        }
+    }
+
+    (void)fprintf(pxJson, "\n  ],\n  \"golden\": [");
+
+    pcSep = "\n";
+
+    for ( uint32_t u32Golden = 0U; (u32Golden < ARRAY_SIZE(xGoldenList)) && !xOpt.bSkipGolden; u32Golden++ )
+    {
+        const golden_def_t *pxGolden = &xGoldenList[u32Golden];
+        char pcPath[512];
+
+        (void)snprintf(pcPath, sizeof(pcPath), "%s/%s.csv", xOpt.pcGoldenDir, pxGolden->pcName);
+
+        golden_render(pxGolden, pi16GoldenOut);
+
+        if ( xOpt.bUpdateGolden )
+        {
+            if ( !golden_store(pcPath, pi16GoldenOut, GOLDEN_SAMPLES) )
+            {
+                (void)fprintf(stderr, "Cannot write %s\n", pcPath);
+                bGoldenPass = false;
+            }
+        }
+        else if ( !golden_load(pcPath, pi16GoldenRef, GOLDEN_SAMPLES) )
+        {
+            (void)fprintf(stderr, "Missing golden %s, run with --update-golden\n", pcPath);
+            bGoldenPass = false;
+        }
+        else
+        {
+            uint32_t u32MaxDiff = 0U;
+            double dSqSum = 0.0;
+
+            for ( uint32_t i = 0U; i < GOLDEN_SAMPLES; i++ )
+            {
+                int32_t i32Diff = (int32_t)pi16GoldenOut[i] - (int32_t)pi16GoldenRef[i];
+                uint32_t u32Diff = (uint32_t)abs(i32Diff);
+
+                if ( u32Diff > u32MaxDiff )
+                {
+                    u32MaxDiff = u32Diff;
+                }
+                dSqSum += (double)i32Diff * (double)i32Diff;
+            }
+
+            bool bPass = (u32MaxDiff <= xOpt.u32Tolerance);
+            bGoldenPass = bGoldenPass && bPass;
+
+            (void)fprintf(pxJson, "%s    { \"name\": \"%s\", \"max_diff\": %u, \"rms_diff\": %.3f, \"tolerance\": %u, \"pass\": %s }",
+                          pcSep, pxGolden->pcName, u32MaxDiff, sqrt(dSqSum / (double)GOLDEN_SAMPLES),
+                          xOpt.u32Tolerance, bPass ? "true" : "false");
+            pcSep = ",\n";
+
+            if ( !bPass )
+            {
+                (void)fprintf(stderr, "Golden %s failed: max diff %u LSB\n", pxGolden->pcName, u32MaxDiff);
+            }
+        }
+    }
+
+    (void)fprintf(pxJson, "\n  ]\n}\n");
+
+    if ( pxJson != stdout )
+    {
+        (void)fclose(pxJson);
+    }
+
+    return bGoldenPass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* EOF */
@@ -0,0 +1,877 @@
+/**
+ * @file    batch_render.c
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Parallel batch render of patch x note x velocity matrix.
+ * @version 0.1
+ * @date    2021-11-28
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Each render starts from a freshly initialised engine, so renders are
+ * independent and can run in any order. Every worker thread owns an engine
+ * instance and pulls jobs from a shared counter. Results are written to a
+ * summary CSV in matrix order once all workers are done.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#include <unistd.h>
+#include <pthread.h>
+
+#include "host_audio_hal.h"
+#include "host_wav.h"
+
+#include "audio_engine.h"
+#include "audio_wavetable.h"
+#include "audio_env_adsr.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+
+/* Patch, list of engine commands applied after init */
+typedef struct batch_patch {
+    char pcName[32];
+    audio_cmd_t pxCmd[24];
+    uint32_t u32CmdNum;
+} batch_patch_t;
+
+/* Render matrix */
+typedef struct batch_matrix {
+    batch_patch_t *pxPatch;
+    uint32_t u32PatchNum;
+    uint8_t pu8Note[128];
+    uint32_t u32NoteNum;
+    uint8_t pu8Vel[128];
+    uint32_t u32VelNum;
+    float fHold;
+    float fTail;
+} batch_matrix_t;
+
+/* Spectral summary of one render */
+typedef struct batch_result {
+    float fPeakDb;                  /**< Peak of whole render, dBFS */
+    float fRmsDb;                   /**< RMS of held section, dBFS */
+    float fCentroidHz;              /**< Spectral centroid */
+    float fRolloffHz;               /**< Frequency below 85% of energy */
+    float fPeakHz;                  /**< Strongest spectral peak */
+    float pfBandDb[9];              /**< Octave band energy relative to total, dB */
+    bool bDone;                     /**< Job rendered and stored */
+} batch_result_t;
+
+/* Patch key mapped on effect or master parameter */
+typedef struct batch_key {
+    const char *pcName;
+    audio_effect_slot_t eSlot;
+    uint32_t u32Param;
+} batch_key_t;
+
+/* State shared by all workers */
+typedef struct batch_shared {
+    const batch_matrix_t *pxMatrix;
+    const char *pcOutDir;
+    batch_result_t *pxResult;
+    uint32_t u32JobNum;
+    uint32_t u32NextJob;
+    bool bFailed;
+} batch_shared_t;
+
+/* Worker private data */
+typedef struct batch_worker {
+    audio_engine_t xEngine;         /**< Engine used for all jobs of worker */
+    int16_t *pi16Buff;              /**< Render buffer, hold plus tail */
+    double *pdRe;                   /**< FFT work buffers */
+    double *pdIm;
+} batch_worker_t;
+
+/* Private define ------------------------------------------------------------*/
+
+/* Engine sample rate */
+#define BATCH_SAMPLE_RATE           ( 48000U )
+
+/* Samples rendered each half transfer */
+#define BATCH_BLOCK_SIZE            ( 16U )
+
+/* Analysis window, placed on loudest frame of held section */
+#define BATCH_FFT_SIZE              ( 8192U )
+#define BATCH_FFT_HOP               ( 1024U )
+
+/* Octave bands, centre frequencies from 63 Hz */
+#define BATCH_BAND_NUM              ( 9U )
+#define BATCH_BAND_FIRST_HZ         ( 62.5 )
+
+/* Energy fraction used for rolloff */
+#define BATCH_ROLLOFF               ( 0.85 )
+
+/* Floor for log of silent signals */
+#define BATCH_DB_FLOOR              ( -120.0F )
+
+/* Defaults */
+#define BATCH_DEF_HOLD              ( 1.0F )
+#define BATCH_DEF_TAIL              ( 0.5F )
+#define BATCH_DEF_VELOCITY          ( 100U )
+#define BATCH_DEF_NOTE              ( 60U )
+
+/* Private macro -------------------------------------------------------------*/
+
+#define ARRAY_SIZE(_a)              ( sizeof(_a) / sizeof((_a)[0]) )
+
+/* Private variables ---------------------------------------------------------*/
+
+/* Effect keys, engine default chain has filter on slot 0 and delay on slot 1 */
+static const batch_key_t pxEffectKey[] = {
+    { "filter",     AUDIO_EFFECT_SLOT_0, AUDIO_EFFECT_PARAMETER_FILTER_FREQ },
+    { "q",          AUDIO_EFFECT_SLOT_0, AUDIO_EFFECT_PARAMETER_FILTER_Q },
+    { "delay",      AUDIO_EFFECT_SLOT_1, AUDIO_EFFECT_PARAMETER_DELAY_TIME },
+    { "feedback",   AUDIO_EFFECT_SLOT_1, AUDIO_EFFECT_PARAMETER_DELAY_FB },
+};
+
+/* Master keys */
+static const batch_key_t pxMasterKey[] = {
+    { "limiter",        AUDIO_EFFECT_SLOT_NUM, AUDIO_MASTER_PARAMETER_LIMITER_ENABLE },
+    { "comp_threshold", AUDIO_EFFECT_SLOT_NUM, AUDIO_MASTER_PARAMETER_COMP_THRESHOLD },
+    { "comp_ratio",     AUDIO_EFFECT_SLOT_NUM, AUDIO_MASTER_PARAMETER_COMP_RATIO },
+    { "comp_makeup",    AUDIO_EFFECT_SLOT_NUM, AUDIO_MASTER_PARAMETER_COMP_MAKEUP },
+};
+/* Private function prototypes -----------------------------------------------*/
+
+static float batch_db(double dValue);
+static void batch_fft(double *pdRe, double *pdIm, uint32_t u32Size);
+static void batch_analyse(batch_worker_t *pxWorker, uint32_t u32Size, uint32_t u32HoldSamples, batch_result_t *pxResult);
+static void batch_render_job(batch_shared_t *pxShared, batch_worker_t *pxWorker, uint32_t u32Job);
+static void *batch_worker(void *pvArg);
+static const batch_key_t *batch_find_key(const batch_key_t *pxKeys, uint32_t u32Num, const char *pcKey);
+static bool batch_patch_add(batch_patch_t *pxPatch, const char *pcKey, float fValue, audio_cmd_set_adsr_t *pxAdsr, bool *pbAdsr);
+static bool batch_parse_matrix(const char *pcPath, batch_matrix_t *pxMatrix);
+static bool batch_write_summary(const batch_shared_t *pxShared);
+
+/* Private function definition -----------------------------------------------*/
+
+static float batch_db(double dValue)
+{
+    float fDb = BATCH_DB_FLOOR;
+
+    if ( dValue > 0.0 )
+    {
+        fDb = (float)(10.0 * log10(dValue));
+        fDb = ( fDb < BATCH_DB_FLOOR ) ? BATCH_DB_FLOOR : fDb;
+    }
+
+    return fDb;
+}
+
+/**
+ * @brief In place radix 2 complex FFT.
+ *
+ * @param pdRe real part.
+ * @param pdIm imaginary part.
+ * @param u32Size number of points, power of two.
+ */
+static void batch_fft(double *pdRe, double *pdIm, uint32_t u32Size)
+{
+    /* Bit reversal permutation */
+    for ( uint32_t i = 1U, j = 0U; i < u32Size; i++ )
+    {
+        uint32_t u32Bit = u32Size >> 1U;
+
+        for ( ; (j & u32Bit) != 0U; u32Bit >>= 1U )
+        {
+            j ^= u32Bit;
+        }
+        j ^= u32Bit;
+
+        if ( i < j )
+        {
+            double dTmp = pdRe[i]; pdRe[i] = pdRe[j]; pdRe[j] = dTmp;
+            dTmp = pdIm[i]; pdIm[i] = pdIm[j]; pdIm[j] = dTmp;
+        }
+    }
+
+    for ( uint32_t u32Len = 2U; u32Len <= u32Size; u32Len <<= 1U )
+    {
+        double dAngle = -2.0 * M_PI / (double)u32Len;
+
+        for ( uint32_t i = 0U; i < u32Size; i += u32Len )
+        {
+            for ( uint32_t k = 0U; k < (u32Len / 2U); k++ )
+            {
+                double dWr = cos(dAngle * (double)k);
+                double dWi = sin(dAngle * (double)k);
+                uint32_t a = i + k;
+                uint32_t b = a + (u32Len / 2U);
+                double dRe = (pdRe[b] * dWr) - (pdIm[b] * dWi);
+                double dIm = (pdRe[b] * dWi) + (pdIm[b] * dWr);
+
+                pdRe[b] = pdRe[a] - dRe;
+                pdIm[b] = pdIm[a] - dIm;
+                pdRe[a] += dRe;
+                pdIm[a] += dIm;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Compute level and spectral summary of a render.
+ *
+ * @param pxWorker worker holding rendered samples.
+ * @param u32Size number of samples.
+ * @param u32HoldSamples samples while note is held.
+ * @param pxResult output summary.
+ */
+static void batch_analyse(batch_worker_t *pxWorker, uint32_t u32Size, uint32_t u32HoldSamples, batch_result_t *pxResult)
+{
+    const int16_t *pi16Data = pxWorker->pi16Buff;
+    double *pdRe = pxWorker->pdRe;
+    double *pdIm = pxWorker->pdIm;
+    double pdPower[BATCH_FFT_SIZE / 2U];
+    double dPeak = 0.0;
+    double dSqSum = 0.0;
+
+    for ( uint32_t i = 0U; i < u32Size; i++ )
+    {
+        double dSample = (double)pi16Data[i] / 32768.0;
+
+        dPeak = fmax(dPeak, fabs(dSample));
+
+        if ( i < u32HoldSamples )
+        {
+            dSqSum += dSample * dSample;
+        }
+    }
+
+    pxResult->fPeakDb = batch_db(dPeak * dPeak);
+    pxResult->fRmsDb = batch_db((u32HoldSamples != 0U) ? (dSqSum / (double)u32HoldSamples) : 0.0);
+
+    /* Hann window on loudest frame of held section, zero padded if hold is short */
+    uint32_t u32Start = 0U;
+    double dBestEnergy = -1.0;
+
+    for ( uint32_t u32Pos = 0U; (u32Pos + BATCH_FFT_SIZE) <= u32HoldSamples; u32Pos += BATCH_FFT_HOP )
+    {
+        double dEnergy = 0.0;
+
+        for ( uint32_t i = u32Pos; i < (u32Pos + BATCH_FFT_SIZE); i++ )
+        {
+            dEnergy += (double)pi16Data[i] * (double)pi16Data[i];
+        }
+
+        if ( dEnergy > dBestEnergy )
+        {
+            dBestEnergy = dEnergy;
+            u32Start = u32Pos;
+        }
+    }
+
+    for ( uint32_t i = 0U; i < BATCH_FFT_SIZE; i++ )
+    {
+        uint32_t u32Index = u32Start + i;
+        double dWin = 0.5 - (0.5 * cos((2.0 * M_PI * (double)i) / (double)(BATCH_FFT_SIZE - 1U)));
+
+        pdRe[i] = ( u32Index < u32Size ) ? (((double)pi16Data[u32Index] / 32768.0) * dWin) : 0.0;
+        pdIm[i] = 0.0;
+    }
+
+    batch_fft(pdRe, pdIm, BATCH_FFT_SIZE);
+
+    double dBinHz = (double)BATCH_SAMPLE_RATE / (double)BATCH_FFT_SIZE;
+    double dTotal = 0.0;
+    double dWeighted = 0.0;
+    uint32_t u32PeakBin = 1U;
+
+    /* DC bin excluded */
+    pdPower[0U] = 0.0;
+
+    for ( uint32_t k = 1U; k < (BATCH_FFT_SIZE / 2U); k++ )
+    {
+        pdPower[k] = (pdRe[k] * pdRe[k]) + (pdIm[k] * pdIm[k]);
+        dTotal += pdPower[k];
+        dWeighted += pdPower[k] * (double)k * dBinHz;
+
+        if ( pdPower[k] > pdPower[u32PeakBin] )
+        {
+            u32PeakBin = k;
+        }
+    }
+
+    pxResult->fCentroidHz = (dTotal > 0.0) ? (float)(dWeighted / dTotal) : 0.0F;
+    pxResult->fPeakHz = (dTotal > 0.0) ? (float)((double)u32PeakBin * dBinHz) : 0.0F;
+    pxResult->fRolloffHz = 0.0F;
+
+    double dAcc = 0.0;
+
+    for ( uint32_t k = 1U; (k < (BATCH_FFT_SIZE / 2U)) && (dTotal > 0.0); k++ )
+    {
+        dAcc += pdPower[k];
+
+        if ( dAcc >= (dTotal * BATCH_ROLLOFF) )
+        {
+            pxResult->fRolloffHz = (float)((double)k * dBinHz);
+            break;
+        }
+    }
+
+    /* Octave bands, edges at centre / sqrt(2) and centre * sqrt(2) */
+    for ( uint32_t u32Band = 0U; u32Band < BATCH_BAND_NUM; u32Band++ )
+    {
+        double dCentre = BATCH_BAND_FIRST_HZ * (double)(1U << u32Band);
+        double dEnergy = 0.0;
+
+        for ( uint32_t k = 1U; k < (BATCH_FFT_SIZE / 2U); k++ )
+        {
+            double dHz = (double)k * dBinHz;
+
+            if ( (dHz >= (dCentre / M_SQRT2)) && (dHz < (dCentre * M_SQRT2)) )
+            {
+                dEnergy += pdPower[k];
+            }
+        }
+
+        pxResult->pfBandDb[u32Band] = batch_db((dTotal > 0.0) ? (dEnergy / dTotal) : 0.0);
+    }
+}
+
+/**
+ * @brief Render one matrix entry from a fresh engine and store WAV.
+ *
+ * @param pxShared state shared by workers.
+ * @param pxWorker worker running the job.
+ * @param u32Job job index, patch major order.
+ */
+static void batch_render_job(batch_shared_t *pxShared, batch_worker_t *pxWorker, uint32_t u32Job)
+{
+    const batch_matrix_t *pxMatrix = pxShared->pxMatrix;
+    const batch_patch_t *pxPatch = &pxMatrix->pxPatch[u32Job / (pxMatrix->u32NoteNum * pxMatrix->u32VelNum)];
+    uint8_t u8Note = pxMatrix->pu8Note[(u32Job / pxMatrix->u32VelNum) % pxMatrix->u32NoteNum];
+    uint8_t u8Vel = pxMatrix->pu8Vel[u32Job % pxMatrix->u32VelNum];
+    uint32_t u32Hold = ((uint32_t)(pxMatrix->fHold * (float)BATCH_SAMPLE_RATE) / BATCH_BLOCK_SIZE) * BATCH_BLOCK_SIZE;
+    uint32_t u32Total = u32Hold + (((uint32_t)(pxMatrix->fTail * (float)BATCH_SAMPLE_RATE) / BATCH_BLOCK_SIZE) * BATCH_BLOCK_SIZE);
+    audio_engine_t *pxEngine = &pxWorker->xEngine;
+    audio_cmd_t xAudioCmd = { 0U };
+    bool bSecondHalf = false;
+    uint32_t u32Done = 0U;
+
+    ERR_ASSERT(AUDIO_init(pxEngine) == AUDIO_OK);
+
+    for ( uint32_t i = 0U; i < pxPatch->u32CmdNum; i++ )
+    {
+        (void)AUDIO_handle_cmd(pxEngine, pxPatch->pxCmd[i]);
+    }
+
+    xAudioCmd.eCmdId = AUDIO_CMD_SET_MIDI_NOTE;
+    xAudioCmd.xCmdPayload.xSetMidiNote.eVoiceId = AUDIO_VOICE_0;
+    xAudioCmd.xCmdPayload.xSetMidiNote.u8Note = u8Note;
+    xAudioCmd.xCmdPayload.xSetMidiNote.u8Velocity = u8Vel;
+    xAudioCmd.xCmdPayload.xSetMidiNote.bActive = true;
+    (void)AUDIO_handle_cmd(pxEngine, xAudioCmd);
+
+    while ( u32Done < u32Total )
+    {
+        if ( u32Done == u32Hold )
+        {
+            xAudioCmd.eCmdId = AUDIO_CMD_ACTIVATE_VOICE;
+            xAudioCmd.xCmdPayload.xActVoice.eVoiceId = AUDIO_VOICE_0;
+            xAudioCmd.xCmdPayload.xActVoice.bState = false;
+            (void)AUDIO_handle_cmd(pxEngine, xAudioCmd);
+        }
+
+        /* Engine was started from this thread, HAL renders it */
+        u32Done += HOST_HAL_render_half(&pxWorker->pi16Buff[u32Done], bSecondHalf);
+        bSecondHalf = !bSecondHalf;
+    }
+
+    (void)AUDIO_deinit(pxEngine);
+
+    char pcPath[512];
+    host_wav_t xWav;
+
+    (void)snprintf(pcPath, sizeof(pcPath), "%s/%s_n%u_v%u.wav", pxShared->pcOutDir, pxPatch->pcName, u8Note, u8Vel);
+
+    if ( !HOST_WAV_open(&xWav, pcPath, BATCH_SAMPLE_RATE, 1U) ||
+         !HOST_WAV_write(&xWav, pxWorker->pi16Buff, u32Total) ||
+         !HOST_WAV_close(&xWav) )
+    {
+        (void)fprintf(stderr, "Cannot write %s\n", pcPath);
+        __atomic_store_n(&pxShared->bFailed, true, __ATOMIC_RELAXED);
+    }
+
+    batch_analyse(pxWorker, u32Total, u32Hold, &pxShared->pxResult[u32Job]);
+    pxShared->pxResult[u32Job].bDone = true;
+}
+
+/**
+ * @brief Worker thread, pull jobs from shared counter until matrix is exhausted.
+ *
+ * @param pvArg state shared by workers.
+ * @return void* unused.
+ */
+static void *batch_worker(void *pvArg)
+{
+    batch_shared_t *pxShared = (batch_shared_t *)pvArg;
+    const batch_matrix_t *pxMatrix = pxShared->pxMatrix;
+    uint32_t u32BuffSize = (uint32_t)((pxMatrix->fHold + pxMatrix->fTail) * (float)BATCH_SAMPLE_RATE) + BATCH_BLOCK_SIZE;
+    batch_worker_t *pxWorker = malloc(sizeof(batch_worker_t));
+
+    ERR_ASSERT(pxWorker != NULL);
+
+    pxWorker->pi16Buff = malloc(u32BuffSize * sizeof(int16_t));
+    pxWorker->pdRe = malloc(BATCH_FFT_SIZE * sizeof(double));
+    pxWorker->pdIm = malloc(BATCH_FFT_SIZE * sizeof(double));
+
+    ERR_ASSERT((pxWorker->pi16Buff != NULL) && (pxWorker->pdRe != NULL) && (pxWorker->pdIm != NULL));
+
+    for ( ;; )
+    {
+        uint32_t u32Job = __atomic_fetch_add(&pxShared->u32NextJob, 1U, __ATOMIC_RELAXED);
+
+        if ( u32Job >= pxShared->u32JobNum )
+        {
+            break;
+        }
+
+        batch_render_job(pxShared, pxWorker, u32Job);
+    }
+
+    free(pxWorker->pdIm);
+    free(pxWorker->pdRe);
+    free(pxWorker->pi16Buff);
+    free(pxWorker);
+
+    return NULL;
+}
+
+static const batch_key_t *batch_find_key(const batch_key_t *pxKeys, uint32_t u32Num, const char *pcKey)
+{
+    const batch_key_t *pxRetval = NULL;
+
+    for ( uint32_t i = 0U; (i < u32Num) && (pxRetval == NULL); i++ )
+    {
+        if ( strcmp(pxKeys[i].pcName, pcKey) == 0 )
+        {
+            pxRetval = &pxKeys[i];
+        }
+    }
+
+    return pxRetval;
+}
+
+/**
+ * @brief Translate patch key in engine commands.
+ *
+ * @param pxPatch patch to update.
+ * @param pcKey parameter name.
+ * @param fValue parameter value.
+ * @param pxAdsr envelope being built, sent as one command at the end.
+ * @param pbAdsr set when an envelope key is found.
+ * @return true if key is known.
+ */
+static bool batch_patch_add(batch_patch_t *pxPatch, const char *pcKey, float fValue, audio_cmd_set_adsr_t *pxAdsr, bool *pbAdsr)
+{
+    audio_cmd_t xCmd = { 0U };
+    bool bRetval = true;
+    bool bAddCmd = true;
+
+    if ( strcmp(pcKey, "wave") == 0 )
+    {
+        xCmd.eCmdId = AUDIO_CMD_SET_WAVEFORM;
+        xCmd.xCmdPayload.xSetWave.eVoiceId = AUDIO_VOICE_NUM;
+        xCmd.xCmdPayload.xSetWave.eWaveId = (audio_wave_id_t)fValue;
+        bRetval = (fValue >= 0.0F) && (fValue < (float)AUDIO_WAVE_FACTORY_NUM);
+    }
+    else if ( strcmp(pcKey, "morph") == 0 )
+    {
+        xCmd.eCmdId = AUDIO_CMD_SET_MORPH;
+        xCmd.xCmdPayload.xSetMorph.eVoiceId = AUDIO_VOICE_NUM;
+        xCmd.xCmdPayload.xSetMorph.fMorph = fValue;
+    }
+    else if ( strcmp(pcKey, "detune") == 0 )
+    {
+        xCmd.eCmdId = AUDIO_CMD_SET_DETUNE;
+        xCmd.xCmdPayload.xSetDetune.eVoiceId = AUDIO_VOICE_NUM;
+        xCmd.xCmdPayload.xSetDetune.fDetuneLvl = fValue;
+    }
+    else if ( batch_find_key(pxEffectKey, ARRAY_SIZE(pxEffectKey), pcKey) != NULL )
+    {
+        const batch_key_t *pxKey = batch_find_key(pxEffectKey, ARRAY_SIZE(pxEffectKey), pcKey);
+        audio_cmd_t xActCmd = { 0U };
+
+        xCmd.eCmdId = AUDIO_CMD_EFFECT_UPDATE;
+        xCmd.xCmdPayload.xEffectUpdate.eSlot = pxKey->eSlot;
+        xCmd.xCmdPayload.xEffectUpdate.eParamId = (audio_effect_parameter_id_t)pxKey->u32Param;
+        xCmd.xCmdPayload.xEffectUpdate.fNewValue = fValue;
+
+        /* Slot is enabled as soon as one of its parameters is set */
+        xActCmd.eCmdId = AUDIO_CMD_EFFECT_ACTIVATE;
+        xActCmd.xCmdPayload.xActivateSlot.eSlot = pxKey->eSlot;
+        xActCmd.xCmdPayload.xActivateSlot.bActive = true;
+        bRetval = (pxPatch->u32CmdNum < ARRAY_SIZE(pxPatch->pxCmd));
+
+        if ( bRetval )
+        {
+            pxPatch->pxCmd[pxPatch->u32CmdNum++] = xActCmd;
+        }
+    }
+    else if ( batch_find_key(pxMasterKey, ARRAY_SIZE(pxMasterKey), pcKey) != NULL )
+    {
+        xCmd.eCmdId = AUDIO_CMD_MASTER_UPDATE;
+        xCmd.xCmdPayload.xMasterUpdate.eParamId = (audio_master_parameter_id_t)batch_find_key(pxMasterKey, ARRAY_SIZE(pxMasterKey), pcKey)->u32Param;
+        xCmd.xCmdPayload.xMasterUpdate.fNewValue = fValue;
+    }
+    else
+    {
+        bAddCmd = false;
+        *pbAdsr = true;
+
+        if ( strcmp(pcKey, "attack") == 0 )
+        {
+            pxAdsr->fAttackTime = fValue;
+        }
+        else if ( strcmp(pcKey, "decay") == 0 )
+        {
+            pxAdsr->fDecayTime = fValue;
+        }
+        else if ( strcmp(pcKey, "release") == 0 )
+        {
+            pxAdsr->fReleaseTime = fValue;
+        }
+        else if ( strcmp(pcKey, "attack_lvl") == 0 )
+        {
+            pxAdsr->fAttackLvl = fValue;
+        }
+        else if ( strcmp(pcKey, "sustain") == 0 )
+        {
+            pxAdsr->fSustainLvl = fValue;
+        }
+        else
+        {
+            bRetval = false;
+        }
+    }
+
+    if ( bRetval && bAddCmd )
+    {
+        bRetval = (pxPatch->u32CmdNum < ARRAY_SIZE(pxPatch->pxCmd));
+
+        if ( bRetval )
+        {
+            pxPatch->pxCmd[pxPatch->u32CmdNum++] = xCmd;
+        }
+    }
+
+    return bRetval;
+}
+
+/**
+ * @brief Parse matrix description file.
+ *
+ * @param pcPath file path.
+ * @param pxMatrix output matrix.
+ * @return true on success.
+ */
+static bool batch_parse_matrix(const char *pcPath, batch_matrix_t *pxMatrix)
+{
+    FILE *pxFile = fopen(pcPath, "r");
+    char pcLine[1024];
+    uint32_t u32Line = 0U;
+    bool bRetval = (pxFile != NULL);
+
+    pxMatrix->pxPatch = NULL;
+    pxMatrix->u32PatchNum = 0U;
+    pxMatrix->u32NoteNum = 0U;
+    pxMatrix->u32VelNum = 0U;
+    pxMatrix->fHold = BATCH_DEF_HOLD;
+    pxMatrix->fTail = BATCH_DEF_TAIL;
+
+    while ( bRetval && (fgets(pcLine, sizeof(pcLine), pxFile) != NULL) )
+    {
+        char *pcSave = NULL;
+        char *pcTok = strtok_r(pcLine, " \t\r\n", &pcSave);
+
+        u32Line++;
+
+        if ( (pcTok == NULL) || (pcTok[0] == '#') )
+        {
+            continue;
+        }
+
+        if ( (strcmp(pcTok, "notes") == 0) || (strcmp(pcTok, "velocities") == 0) )
+        {
+            bool bNotes = (pcTok[0] == 'n');
+            uint8_t *pu8List = bNotes ? pxMatrix->pu8Note : pxMatrix->pu8Vel;
+            uint32_t *pu32Num = bNotes ? &pxMatrix->u32NoteNum : &pxMatrix->u32VelNum;
+
+            while ( bRetval && ((pcTok = strtok_r(NULL, " \t\r\n", &pcSave)) != NULL) )
+            {
+                long lValue = strtol(pcTok, NULL, 0);
+
+                bRetval = (lValue >= (bNotes ? 0L : 1L)) && (lValue <= 127L) && (*pu32Num < 128U);
+
+                if ( bRetval )
+                {
+                    pu8List[(*pu32Num)++] = (uint8_t)lValue;
+                }
+            }
+        }
+        else if ( (strcmp(pcTok, "hold") == 0) || (strcmp(pcTok, "tail") == 0) )
+        {
+            float *pfValue = (pcTok[0] == 'h') ? &pxMatrix->fHold : &pxMatrix->fTail;
+
+            pcTok = strtok_r(NULL, " \t\r\n", &pcSave);
+            bRetval = (pcTok != NULL);
+
+            if ( bRetval )
+            {
+                *pfValue = strtof(pcTok, NULL);
+                bRetval = (*pfValue >= 0.0F) && (*pfValue <= 60.0F);
+            }
+        }
+        else if ( strcmp(pcTok, "patch") == 0 )
+        {
+            batch_patch_t *pxPatch = realloc(pxMatrix->pxPatch, (pxMatrix->u32PatchNum + 1U) * sizeof(batch_patch_t));
+            env_adsr_ctrl_t xDefEnv;
+            audio_cmd_set_adsr_t xAdsr;
+            bool bAdsr = false;
+
+            bRetval = (pxPatch != NULL);
+
+            if ( bRetval )
+            {
+                pxMatrix->pxPatch = pxPatch;
+                pxPatch = &pxPatch[pxMatrix->u32PatchNum++];
+                memset(pxPatch, 0, sizeof(batch_patch_t));
+
+                pcTok = strtok_r(NULL, " \t\r\n", &pcSave);
+                bRetval = (pcTok != NULL) && (strlen(pcTok) < sizeof(pxPatch->pcName)) && (strchr(pcTok, '=') == NULL);
+            }
+
+            if ( bRetval )
+            {
+                (void)strcpy(pxPatch->pcName, pcTok);
+
+                /* Envelope keys not given keep engine defaults */
+                ADSR_init(&xDefEnv, (float)BATCH_SAMPLE_RATE);
+                xAdsr.eVoiceId = AUDIO_VOICE_NUM;
+                xAdsr.fAttackTime = ADSR_get_attack_time(&xDefEnv);
+                xAdsr.fDecayTime = ADSR_get_decay_time(&xDefEnv);
+                xAdsr.fReleaseTime = ADSR_get_release_time(&xDefEnv);
+                xAdsr.fAttackLvl = ADSR_get_attack_lvl(&xDefEnv);
+                xAdsr.fSustainLvl = ADSR_get_sustain_lvl(&xDefEnv);
+            }
+
+            while ( bRetval && ((pcTok = strtok_r(NULL, " \t\r\n", &pcSave)) != NULL) )
+            {
+                char *pcValue = strchr(pcTok, '=');
+
+                bRetval = (pcValue != NULL);
+
+                if ( bRetval )
+                {
+                    *pcValue++ = '\0';
+                    bRetval = batch_patch_add(pxPatch, pcTok, strtof(pcValue, NULL), &xAdsr, &bAdsr);
+                }
+            }
+
+            if ( bRetval && bAdsr )
+            {
+                bRetval = (pxPatch->u32CmdNum < ARRAY_SIZE(pxPatch->pxCmd));
+
+                if ( bRetval )
+                {
+                    pxPatch->pxCmd[pxPatch->u32CmdNum].eCmdId = AUDIO_CMD_SET_ADSR;
+                    pxPatch->pxCmd[pxPatch->u32CmdNum].xCmdPayload.xSetAdsr = xAdsr;
+                    pxPatch->u32CmdNum++;
+                }
+            }
+        }
+        else
+        {
+            bRetval = false;
+        }
+
+        if ( !bRetval )
+        {
+            (void)fprintf(stderr, "%s:%u: invalid line\n", pcPath, u32Line);
+        }
+    }
+
+    if ( pxFile != NULL )
+    {
+        (void)fclose(pxFile);
+    }
+
+    /* Missing lists default to one entry */
+    if ( pxMatrix->u32NoteNum == 0U )
+    {
+        pxMatrix->pu8Note[pxMatrix->u32NoteNum++] = BATCH_DEF_NOTE;
+    }
+
+    if ( pxMatrix->u32VelNum == 0U )
+    {
+        pxMatrix->pu8Vel[pxMatrix->u32VelNum++] = BATCH_DEF_VELOCITY;
+    }
+
+    return bRetval && (pxMatrix->u32PatchNum != 0U);
+}
+
+/**
+ * @brief Write one summary row per render in matrix order.
+ *
+ * @param pxShared matrix and results.
+ * @return true if all renders are present and file was written.
+ */
+static bool batch_write_summary(const batch_shared_t *pxShared)
+{
+    const batch_matrix_t *pxMatrix = pxShared->pxMatrix;
+    char pcPath[512];
+    bool bRetval = true;
+
+    (void)snprintf(pcPath, sizeof(pcPath), "%s/summary.csv", pxShared->pcOutDir);
+
+    FILE *pxFile = fopen(pcPath, "w");
+
+    if ( pxFile == NULL )
+    {
+        (void)fprintf(stderr, "Cannot write %s\n", pcPath);
+        return false;
+    }
+
+    (void)fprintf(pxFile, "patch,note,velocity,peak_dbfs,rms_dbfs,centroid_hz,rolloff_hz,peak_hz");
+
+    for ( uint32_t u32Band = 0U; u32Band < BATCH_BAND_NUM; u32Band++ )
+    {
+        (void)fprintf(pxFile, ",band_%g_db", BATCH_BAND_FIRST_HZ * (double)(1U << u32Band));
+    }
+
+    (void)fprintf(pxFile, "\n");
+
+    for ( uint32_t u32Job = 0U; u32Job < pxShared->u32JobNum; u32Job++ )
+    {
+        const batch_result_t *pxResult = &pxShared->pxResult[u32Job];
+
+        if ( !pxResult->bDone )
+        {
+            bRetval = false;
+            continue;
+        }
+
+        (void)fprintf(pxFile, "%s,%u,%u,%.2f,%.2f,%.1f,%.1f,%.1f",
+                      pxMatrix->pxPatch[u32Job / (pxMatrix->u32NoteNum * pxMatrix->u32VelNum)].pcName,
+                      pxMatrix->pu8Note[(u32Job / pxMatrix->u32VelNum) % pxMatrix->u32NoteNum],
+                      pxMatrix->pu8Vel[u32Job % pxMatrix->u32VelNum],
+                      (double)pxResult->fPeakDb, (double)pxResult->fRmsDb,
+                      (double)pxResult->fCentroidHz, (double)pxResult->fRolloffHz, (double)pxResult->fPeakHz);
+
+        for ( uint32_t u32Band = 0U; u32Band < BATCH_BAND_NUM; u32Band++ )
+        {
+            (void)fprintf(pxFile, ",%.2f", (double)pxResult->pfBandDb[u32Band]);
+        }
+
+        (void)fprintf(pxFile, "\n");
+    }
+
+    bRetval = (fclose(pxFile) == 0) && bRetval;
+
+    return bRetval;
+}
+
+/* Public function definition ------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    batch_matrix_t xMatrix;
+    long lWorkers = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *pcMatrixPath = NULL;
+    const char *pcOutDir = NULL;
+    bool bArgs = true;
+
+    for ( int i = 1; (i < argc) && bArgs; i++ )
+    {
+        if ( (strcmp(argv[i], "-j") == 0) && ((i + 1) < argc) )
+        {
+            lWorkers = strtol(argv[++i], NULL, 0);
+        }
+        else if ( pcMatrixPath == NULL )
+        {
+            pcMatrixPath = argv[i];
+        }
+        else if ( pcOutDir == NULL )
+        {
+            pcOutDir = argv[i];
+        }
+        else
+        {
+            bArgs = false;
+        }
+    }
+
+    if ( !bArgs || (pcMatrixPath == NULL) || (pcOutDir == NULL) || (lWorkers < 1L) )
+    {
+        (void)fprintf(stderr,
+            "Usage: %s [-j workers] <matrix.txt> <out_dir>\n"
+            "  -j <n>   parallel workers, default number of cores\n",
+            argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if ( !batch_parse_matrix(pcMatrixPath, &xMatrix) )
+    {
+        free(xMatrix.pxPatch);
+        return EXIT_FAILURE;
+    }
+
+    batch_shared_t xShared = { 0U };
+
+    xShared.pxMatrix = &xMatrix;
+    xShared.pcOutDir = pcOutDir;
+    xShared.u32JobNum = xMatrix.u32PatchNum * xMatrix.u32NoteNum * xMatrix.u32VelNum;
+    xShared.pxResult = calloc(xShared.u32JobNum, sizeof(batch_result_t));
+
+    lWorkers = ( lWorkers > (long)xShared.u32JobNum ) ? (long)xShared.u32JobNum : lWorkers;
+
+    pthread_t *pxThread = calloc((size_t)lWorkers, sizeof(pthread_t));
+    long lStarted = 0L;
+
+    if ( (xShared.pxResult == NULL) || (pxThread == NULL) )
+    {
+        (void)fprintf(stderr, "Cannot allocate %u results\n", xShared.u32JobNum);
+        free(pxThread);
+        free(xShared.pxResult);
+        free(xMatrix.pxPatch);
+        return EXIT_FAILURE;
+    }
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( ; lStarted < lWorkers; lStarted++ )
+    {
+        if ( pthread_create(&pxThread[lStarted], NULL, batch_worker, &xShared) != 0 )
+        {
+            (void)fprintf(stderr, "Cannot start worker %ld\n", lStarted);
+            break;
+        }
+    }
+
+    for ( long lWorker = 0L; lWorker < lStarted; lWorker++ )
+    {
+        (void)pthread_join(pxThread[lWorker], NULL);
+    }
+
+    double dElapsed = (double)(HOST_HAL_get_time_ns() - u64Start) * 1.0e-9;
+
+    /* Jobs left by missing workers show up as absent results */
+    bool bOk = batch_write_summary(&xShared) && !xShared.bFailed && (lStarted != 0L);
+
+    (void)fprintf(stderr, "%u renders with %ld workers in %.2f s\n", xShared.u32JobNum, lStarted, dElapsed);
+
+    free(pxThread);
+    free(xShared.pxResult);
+    free(xMatrix.pxPatch);
+
+    return bOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* EOF */
@@ -0,0 +1,136 @@
+/**
+ * @file    host_audio_hal.c
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Host audio HAL, render events are triggered by the host tool.
+ * @version 0.1
+ * @date    2021-11-27
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_audio_hal.h"
+
+#include <time.h>
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+
+/* HAL state, one interface for each host thread */
+
+/* Engine event handler */
+_Thread_local audio_hal_event_cb pHostEventCallBack = NULL;
+_Thread_local void *pvHostEventCallBackArg = NULL;
+
+/* Buffer handed by engine */
+_Thread_local uint16_t *pu16HostBuffer = NULL;
+_Thread_local uint16_t u16HostBufferSize = 0U;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private function definition -----------------------------------------------*/
+/* Public function definition ------------------------------------------------*/
+
+audio_ret_t AUDIO_HAL_init(audio_hal_event_cb pEventCB, void *pvArg)
+{
+    ERR_ASSERT(pEventCB != NULL);
+
+    pHostEventCallBack = pEventCB;
+    pvHostEventCallBackArg = pvArg;
+
+    return AUDIO_OK;
+}
+
+void AUDIO_HAL_deinit(void)
+{
+    pHostEventCallBack = NULL;
+    pvHostEventCallBackArg = NULL;
+    pu16HostBuffer = NULL;
+    u16HostBufferSize = 0U;
+}
+
+audio_ret_t AUDIO_HAL_send_buffer(uint16_t *pu16Data, uint16_t u16DataLen)
+{
+    ERR_ASSERT(pu16Data != NULL);
+    ERR_ASSERT(u16DataLen != 0U);
+
+    pu16HostBuffer = pu16Data;
+    u16HostBufferSize = u16DataLen;
+
+    return AUDIO_OK;
+}
+
+void AUDIO_HAL_isr_ctrl(bool bIsrEnable)
+{
+    (void)bIsrEnable;
+}
+
+void AUDIO_HAL_gpio_ctrl(bool bSetState)
+{
+    (void)bSetState;
+}
+
+uint32_t AUDIO_HAL_get_cycles(void)
+{
+    return (uint32_t)HOST_HAL_get_time_ns();
+}
+
+uint32_t AUDIO_HAL_get_core_clock(void)
+{
+    return HOST_HAL_CORE_CLOCK;
+}
+
+void HOST_HAL_trigger(audio_hal_event_t eEvent)
+{
+    if ( pHostEventCallBack != NULL )
+    {
+        pHostEventCallBack(eEvent, pvHostEventCallBackArg);
+    }
+}
+
+uint16_t *HOST_HAL_get_buffer(uint16_t *pu16Size)
+{
+    if ( pu16Size != NULL )
+    {
+        *pu16Size = u16HostBufferSize;
+    }
+
+    return pu16HostBuffer;
+}
+
+uint32_t HOST_HAL_render_half(int16_t *pi16Out, bool bSecondHalf)
+{
+    ERR_ASSERT(pi16Out != NULL);
+
+    uint32_t u32Samples = 0U;
+
+    if ( pu16HostBuffer != NULL )
+    {
+        uint32_t u32Half = (uint32_t)u16HostBufferSize / 2U;
+        uint32_t u32Start = bSecondHalf ? u32Half : 0U;
+
+        HOST_HAL_trigger(bSecondHalf ? AUDIO_HAL_EVENT_TX_DONE : AUDIO_HAL_EVENT_HALF_TX_DONE);
+
+        /* Same data on L and R, keep left channel */
+        for ( uint32_t i = u32Start; i < (u32Start + u32Half); i += 2U )
+        {
+            pi16Out[u32Samples++] = (int16_t)pu16HostBuffer[i];
+        }
+    }
+
+    return u32Samples;
+}
+
+uint64_t HOST_HAL_get_time_ns(void)
+{
+    struct timespec xTime;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &xTime);
+
+    return ((uint64_t)xTime.tv_sec * 1000000000ULL) + (uint64_t)xTime.tv_nsec;
+}
+
+/* EOF */
@@ -0,0 +1,146 @@
+/**
+ * @file    host_wav.c
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Minimal 16 bit PCM WAV file writer for host tools.
+ * @version 0.1
+ * @date    2021-11-28
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_wav.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+
+/* RIFF header up to first data byte */
+#define WAV_HEADER_SIZE             ( 44U )
+
+/* Bytes per sample */
+#define WAV_SAMPLE_BYTES            ( 2U )
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief Store little endian value in buffer.
+ *
+ * @param pu8Out output buffer.
+ * @param u32Value value to store.
+ * @param u32Bytes number of bytes.
+ */
+static void wav_put_le(uint8_t *pu8Out, uint32_t u32Value, uint32_t u32Bytes);
+
+/**
+ * @brief Write RIFF header for current number of frames.
+ *
+ * @param pxWav wav handler.
+ * @return true on success.
+ */
+static bool wav_write_header(host_wav_t *pxWav);
+
+/* Private function definition -----------------------------------------------*/
+
+static void wav_put_le(uint8_t *pu8Out, uint32_t u32Value, uint32_t u32Bytes)
+{
+    for ( uint32_t i = 0U; i < u32Bytes; i++ )
+    {
+        pu8Out[i] = (uint8_t)(u32Value >> (8U * i));
+    }
+}
+
+static bool wav_write_header(host_wav_t *pxWav)
+{
+    uint8_t pu8Header[WAV_HEADER_SIZE] = {
+        'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E',
+        'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0,
+    };
+    uint32_t u32BlockAlign = (uint32_t)pxWav->u16Channels * WAV_SAMPLE_BYTES;
+    uint32_t u32DataSize = pxWav->u32Frames * u32BlockAlign;
+
+    wav_put_le(&pu8Header[4U], (WAV_HEADER_SIZE - 8U) + u32DataSize, 4U);
+    wav_put_le(&pu8Header[22U], pxWav->u16Channels, 2U);
+    wav_put_le(&pu8Header[24U], pxWav->u32SampleRate, 4U);
+    wav_put_le(&pu8Header[28U], pxWav->u32SampleRate * u32BlockAlign, 4U);
+    wav_put_le(&pu8Header[32U], u32BlockAlign, 2U);
+    wav_put_le(&pu8Header[34U], WAV_SAMPLE_BYTES * 8U, 2U);
+    pu8Header[36U] = 'd';
+    pu8Header[37U] = 'a';
+    pu8Header[38U] = 't';
+    pu8Header[39U] = 'a';
+    wav_put_le(&pu8Header[40U], u32DataSize, 4U);
+
+    return (fseek(pxWav->pxFile, 0L, SEEK_SET) == 0) &&
+           (fwrite(pu8Header, 1U, sizeof(pu8Header), pxWav->pxFile) == sizeof(pu8Header));
+}
+
+/* Public function definition ------------------------------------------------*/
+
+bool HOST_WAV_open(host_wav_t *pxWav, const char *pcPath, uint32_t u32SampleRate, uint16_t u16Channels)
+{
+    bool bRetval = false;
+
+    pxWav->pxFile = fopen(pcPath, "wb");
+    pxWav->u32SampleRate = u32SampleRate;
+    pxWav->u16Channels = u16Channels;
+    pxWav->u32Frames = 0U;
+
+    if ( pxWav->pxFile != NULL )
+    {
+        bRetval = wav_write_header(pxWav);
+    }
+
+    return bRetval;
+}
+
+bool HOST_WAV_write(host_wav_t *pxWav, const int16_t *pi16Data, uint32_t u32Frames)
+{
+    uint32_t u32Samples = u32Frames * pxWav->u16Channels;
+    uint8_t pu8Chunk[256U];
+    bool bRetval = true;
+
+    /* Convert in small chunks, output is little endian on any host */
+    for ( uint32_t i = 0U; (i < u32Samples) && bRetval; i += sizeof(pu8Chunk) / WAV_SAMPLE_BYTES )
+    {
+        uint32_t u32Num = u32Samples - i;
+
+        if ( u32Num > (sizeof(pu8Chunk) / WAV_SAMPLE_BYTES) )
+        {
+            u32Num = sizeof(pu8Chunk) / WAV_SAMPLE_BYTES;
+        }
+
+        for ( uint32_t j = 0U; j < u32Num; j++ )
+        {
+            wav_put_le(&pu8Chunk[j * WAV_SAMPLE_BYTES], (uint16_t)pi16Data[i + j], WAV_SAMPLE_BYTES);
+        }
+
+        bRetval = (fwrite(pu8Chunk, WAV_SAMPLE_BYTES, u32Num, pxWav->pxFile) == u32Num);
+    }
+
+    if ( bRetval )
+    {
+        pxWav->u32Frames += u32Frames;
+    }
+
+    return bRetval;
+}
+
+bool HOST_WAV_close(host_wav_t *pxWav)
+{
+    bool bRetval = false;
+
+    if ( pxWav->pxFile != NULL )
+    {
+        bRetval = wav_write_header(pxWav);
+        bRetval = (fclose(pxWav->pxFile) == 0) && bRetval;
+        pxWav->pxFile = NULL;
+    }
+
+    return bRetval;
+}
+
+/* EOF */
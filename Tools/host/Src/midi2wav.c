@@ -0,0 +1,470 @@
+/**
+ * @file    midi2wav.c
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Offline render of Standard MIDI Files through the synth engine.
+ * @version 0.1
+ * @date    2021-11-28
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * File events are fed byte by byte to midi_update_fsm, then follow the same
+ * path as firmware: VOICE_update_note and AUDIO_handle_cmd. Event times are
+ * converted to exact sample positions; as in firmware, commands land between
+ * engine blocks, so each event is applied before the block holding its
+ * sample (at most 15 samples early).
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_audio_hal.h"
+#include "host_wav.h"
+
+#include "audio_engine.h"
+#include "audio_wavetable.h"
+
+#include "midi_lib.h"
+#include "midi_voice.h"
+#include "midi_smf.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+
+/* Tool options */
+typedef struct midi2wav_opt {
+    const char *pcMidiPath;
+    const char *pcWavPath;
+    float fTail;
+    float fMaxLen;
+    int32_t i32Channel;
+    int32_t i32Wave;
+    int32_t i32MpeMembers;
+} midi2wav_opt_t;
+
+/* Private define ------------------------------------------------------------*/
+
+/* Engine sample rate */
+#define RENDER_SAMPLE_RATE          ( 48000U )
+
+/* Samples rendered each half transfer */
+#define RENDER_BLOCK_SIZE           ( 16U )
+
+/* Same sizes as midi task */
+#define RENDER_NUM_VOICE            ( 8U )
+#define RENDER_SYSEX_BUFF_SIZE      ( 128U )
+
+/* Default release tail after last event, seconds */
+#define RENDER_DEF_TAIL             ( 1.0F )
+
+/* 7 bit expression full scale */
+#define RENDER_EXPR_MAX             ( 127.0F )
+
+/* CC 74 scale, controller center 64 maps to timbre at rest */
+#define RENDER_TIMBRE_SPAN          ( 128.0F )
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+
+/* Audio engine */
+audio_engine_t RenderAudioEngine;
+
+/* Handler for midi handler engine */
+midi_handler_t RenderMidiEngine;
+
+/* Handler for voice engine */
+midi_voice_handler_t RenderVoiceEngine;
+midi_voice_t RenderVoiceList[RENDER_NUM_VOICE];
+
+/* Midi sys ex buffer */
+uint8_t RenderSysExBuff[RENDER_SYSEX_BUFF_SIZE];
+
+/* Render state */
+bool bRenderSecondHalf = false;
+uint64_t u64RenderedSamples = 0U;
+uint32_t u32RenderNotes = 0U;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void render_cmd_1_cb(uint8_t cmd, uint8_t data);
+static void render_cmd_2_cb(uint8_t cmd, uint8_t data0, uint8_t data1);
+static void render_rt_cb(uint8_t rt_data);
+static void render_sysex_cb(uint8_t *pdata, uint32_t len_data);
+static void render_voice_cb(uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity, midi_voice_state_t eAction);
+static void render_release_cb(uint32_t u32VoiceMask);
+static void render_expr_cb(uint8_t u8Voice, midi_voice_expr_t eExpr, uint16_t u16Value);
+static bool render_until(host_wav_t *pxWav, uint64_t u64Sample);
+static uint32_t render_feed(const midi_smf_event_t *pxEvent);
+static uint8_t *render_load_file(const char *pcPath, uint32_t *pu32Len);
+static bool render_parse_args(int argc, char **argv, midi2wav_opt_t *pxOpt);
+
+/* Private function definition -----------------------------------------------*/
+
+static void render_cmd_1_cb(uint8_t cmd, uint8_t data)
+{
+    (void)VOICE_update_expression(&RenderVoiceEngine, cmd, data, 0U);
+}
+
+static void render_cmd_2_cb(uint8_t cmd, uint8_t data0, uint8_t data1)
+{
+    uint8_t u8Status = MIDI_CMD_GET_STATUS(cmd);
+
+    if ( (u8Status == MIDI_STATUS_NOTE_OFF) || (u8Status == MIDI_STATUS_NOTE_ON) )
+    {
+        (void)VOICE_update_note(&RenderVoiceEngine, cmd, data0, data1);
+    }
+    else if ( VOICE_update_expression(&RenderVoiceEngine, cmd, data0, data1) == midiOk )
+    {
+        /* Per note expression of MPE member channel */
+    }
+    else if ( (RenderVoiceEngine.eMode == MidiMode3) && (MIDI_CMD_GET_CH(cmd) != RenderVoiceEngine.u8MidiCh) )
+    {
+        /* Pedals only on rendered channel */
+    }
+    else if ( (u8Status == MIDI_STATUS_CC) && (data0 == MIDI_CC_SUSTAIN) )
+    {
+        (void)VOICE_set_sustain(&RenderVoiceEngine, data1 >= MIDI_CC_PEDAL_ON);
+    }
+    else if ( (u8Status == MIDI_STATUS_CC) && (data0 == MIDI_CC_SOSTENUTO) )
+    {
+        (void)VOICE_set_sostenuto(&RenderVoiceEngine, data1 >= MIDI_CC_PEDAL_ON);
+    }
+}
+
+static void render_rt_cb(uint8_t rt_data)
+{
+    (void)rt_data;
+}
+
+static void render_sysex_cb(uint8_t *pdata, uint32_t len_data)
+{
+    (void)pdata;
+    (void)len_data;
+}
+
+static void render_voice_cb(uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity, midi_voice_state_t eAction)
+{
+    audio_cmd_t xAudioCmd = { 0U };
+
+    if ( eAction == VOICE_STATE_ON )
+    {
+        xAudioCmd.eCmdId = AUDIO_CMD_SET_MIDI_NOTE;
+        xAudioCmd.xCmdPayload.xSetMidiNote.eVoiceId = (audio_voice_id_t)u8Voice;
+        xAudioCmd.xCmdPayload.xSetMidiNote.u8Note = u8Note;
+        xAudioCmd.xCmdPayload.xSetMidiNote.u8Velocity = u8Velocity;
+        xAudioCmd.xCmdPayload.xSetMidiNote.bActive = true;
+        (void)AUDIO_handle_cmd(&RenderAudioEngine, xAudioCmd);
+
+        u32RenderNotes++;
+    }
+    else if ( eAction == VOICE_STATE_OFF )
+    {
+        xAudioCmd.eCmdId = AUDIO_CMD_ACTIVATE_VOICE;
+        xAudioCmd.xCmdPayload.xActVoice.eVoiceId = (audio_voice_id_t)u8Voice;
+        xAudioCmd.xCmdPayload.xActVoice.bState = false;
+        (void)AUDIO_handle_cmd(&RenderAudioEngine, xAudioCmd);
+    }
+}
+
+static void render_release_cb(uint32_t u32VoiceMask)
+{
+    audio_cmd_t xAudioCmd = { 0U };
+
+    xAudioCmd.eCmdId = AUDIO_CMD_RELEASE_VOICES;
+    xAudioCmd.xCmdPayload.xReleaseVoices.u32VoiceMask = u32VoiceMask;
+    (void)AUDIO_handle_cmd(&RenderAudioEngine, xAudioCmd);
+}
+
+static void render_expr_cb(uint8_t u8Voice, midi_voice_expr_t eExpr, uint16_t u16Value)
+{
+    if ( eExpr == VOICE_EXPR_RESET )
+    {
+        AUDIO_reset_voice_expr(&RenderAudioEngine, (audio_voice_id_t)u8Voice);
+    }
+    else if ( eExpr == VOICE_EXPR_BEND )
+    {
+        float fBend = ((float)u16Value - (float)MIDI_PITCH_BEND_CENTER) / (float)MIDI_PITCH_BEND_CENTER;
+
+        (void)AUDIO_set_voice_expr(&RenderAudioEngine, (audio_voice_id_t)u8Voice, AUDIO_EXPR_BEND, fBend);
+    }
+    else if ( eExpr == VOICE_EXPR_PRESSURE )
+    {
+        (void)AUDIO_set_voice_expr(&RenderAudioEngine, (audio_voice_id_t)u8Voice, AUDIO_EXPR_PRESSURE, (float)u16Value / RENDER_EXPR_MAX);
+    }
+    else if ( eExpr == VOICE_EXPR_TIMBRE )
+    {
+        (void)AUDIO_set_voice_expr(&RenderAudioEngine, (audio_voice_id_t)u8Voice, AUDIO_EXPR_TIMBRE, (float)u16Value / RENDER_TIMBRE_SPAN);
+    }
+}
+
+/**
+ * @brief Render blocks while next block starts before target sample.
+ *
+ * @param pxWav output file.
+ * @param u64Sample target sample position.
+ * @return true on success.
+ */
+static bool render_until(host_wav_t *pxWav, uint64_t u64Sample)
+{
+    int16_t pi16Block[RENDER_BLOCK_SIZE];
+    bool bRetval = true;
+
+    while ( bRetval && ((u64RenderedSamples + RENDER_BLOCK_SIZE) <= u64Sample) )
+    {
+        uint32_t u32Num = HOST_HAL_render_half(pi16Block, bRenderSecondHalf);
+
+        bRenderSecondHalf = !bRenderSecondHalf;
+        u64RenderedSamples += u32Num;
+
+        bRetval = (u32Num == RENDER_BLOCK_SIZE) && HOST_WAV_write(pxWav, pi16Block, u32Num);
+    }
+
+    return bRetval;
+}
+
+/**
+ * @brief Feed file event to midi parser as it would arrive on the wire.
+ *
+ * @param pxEvent file event.
+ * @return uint32_t number of bytes rejected by parser.
+ */
+static uint32_t render_feed(const midi_smf_event_t *pxEvent)
+{
+    uint32_t u32Errors = 0U;
+
+    if ( pxEvent->eType == SMF_EVT_MIDI )
+    {
+        for ( uint32_t i = 0U; i < pxEvent->u8MsgLen; i++ )
+        {
+            u32Errors += (midi_update_fsm(&RenderMidiEngine, pxEvent->pu8Msg[i]) != midiOk) ? 1U : 0U;
+        }
+    }
+    else if ( (pxEvent->eType == SMF_EVT_SYSEX) && (pxEvent->u32DataLen != 0U) )
+    {
+        u32Errors += (midi_update_fsm(&RenderMidiEngine, MIDI_STATUS_SYS_EX_START) != midiOk) ? 1U : 0U;
+
+        for ( uint32_t i = 0U; i < pxEvent->u32DataLen; i++ )
+        {
+            u32Errors += (midi_update_fsm(&RenderMidiEngine, pxEvent->pu8Data[i]) != midiOk) ? 1U : 0U;
+        }
+
+        /* Files usually store the end byte, add it when missing */
+        if ( pxEvent->pu8Data[pxEvent->u32DataLen - 1U] != MIDI_STATUS_SYS_EX_END )
+        {
+            u32Errors += (midi_update_fsm(&RenderMidiEngine, MIDI_STATUS_SYS_EX_END) != midiOk) ? 1U : 0U;
+        }
+    }
+
+    return u32Errors;
+}
+
+static uint8_t *render_load_file(const char *pcPath, uint32_t *pu32Len)
+{
+    uint8_t *pu8Data = NULL;
+    FILE *pxFile = fopen(pcPath, "rb");
+
+    if ( pxFile != NULL )
+    {
+        long lSize = 0;
+
+        if ( (fseek(pxFile, 0L, SEEK_END) == 0) && ((lSize = ftell(pxFile)) > 0) && (fseek(pxFile, 0L, SEEK_SET) == 0) )
+        {
+            pu8Data = malloc((size_t)lSize);
+
+            if ( (pu8Data != NULL) && (fread(pu8Data, 1U, (size_t)lSize, pxFile) != (size_t)lSize) )
+            {
+                free(pu8Data);
+                pu8Data = NULL;
+            }
+
+            *pu32Len = (uint32_t)lSize;
+        }
+
+        (void)fclose(pxFile);
+    }
+
+    return pu8Data;
+}
+
+static bool render_parse_args(int argc, char **argv, midi2wav_opt_t *pxOpt)
+{
+    bool bRetval = true;
+
+    pxOpt->pcMidiPath = NULL;
+    pxOpt->pcWavPath = NULL;
+    pxOpt->fTail = RENDER_DEF_TAIL;
+    pxOpt->fMaxLen = 0.0F;
+    pxOpt->i32Channel = -1;
+    pxOpt->i32Wave = -1;
+    pxOpt->i32MpeMembers = 0;
+
+    for ( int i = 1; (i < argc) && bRetval; i++ )
+    {
+        bool bHasValue = ((i + 1) < argc);
+
+        if ( (strcmp(argv[i], "-c") == 0) && bHasValue )
+        {
+            pxOpt->i32Channel = (int32_t)strtol(argv[++i], NULL, 0);
+            bRetval = (pxOpt->i32Channel >= 0) && (pxOpt->i32Channel <= (int32_t)MIDI_CHANNEL_MAX_VALUE);
+        }
+        else if ( (strcmp(argv[i], "-w") == 0) && bHasValue )
+        {
+            pxOpt->i32Wave = (int32_t)strtol(argv[++i], NULL, 0);
+            bRetval = (pxOpt->i32Wave >= 0) && (pxOpt->i32Wave < (int32_t)AUDIO_WAVE_FACTORY_NUM);
+        }
+        else if ( (strcmp(argv[i], "-z") == 0) && bHasValue )
+        {
+            pxOpt->i32MpeMembers = (int32_t)strtol(argv[++i], NULL, 0);
+            bRetval = (pxOpt->i32MpeMembers >= 0) && (pxOpt->i32MpeMembers < (int32_t)MIDI_VOICE_CH_NUM);
+        }
+        else if ( (strcmp(argv[i], "-t") == 0) && bHasValue )
+        {
+            pxOpt->fTail = strtof(argv[++i], NULL);
+            bRetval = (pxOpt->fTail >= 0.0F);
+        }
+        else if ( (strcmp(argv[i], "-m") == 0) && bHasValue )
+        {
+            pxOpt->fMaxLen = strtof(argv[++i], NULL);
+            bRetval = (pxOpt->fMaxLen >= 0.0F);
+        }
+        else if ( pxOpt->pcMidiPath == NULL )
+        {
+            pxOpt->pcMidiPath = argv[i];
+        }
+        else if ( pxOpt->pcWavPath == NULL )
+        {
+            pxOpt->pcWavPath = argv[i];
+        }
+        else
+        {
+            bRetval = false;
+        }
+    }
+
+    return bRetval && (pxOpt->pcMidiPath != NULL) && (pxOpt->pcWavPath != NULL);
+}
+
+/* Public function definition ------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    midi2wav_opt_t xOpt;
+    midi_smf_t xSmf;
+    midi_smf_event_t xEvent = { 0U };
+    host_wav_t xWav = { 0U };
+    uint8_t *pu8File = NULL;
+    uint32_t u32FileLen = 0U;
+    uint32_t u32Events = 0U;
+    uint32_t u32Errors = 0U;
+    bool bOk = true;
+
+    if ( !render_parse_args(argc, argv, &xOpt) )
+    {
+        (void)fprintf(stderr,
+            "Usage: %s [options] <in.mid> <out.wav>\n"
+            "  -c <ch>      listen only on channel 0-15, default omni\n"
+            "  -w <wave>    factory wave of all voices 0-%u\n"
+            "  -z <num>     MPE lower zone with num member channels, default off\n"
+            "  -t <sec>     render time after last event, default %.1f\n"
+            "  -m <sec>     stop reading events after this time, default no limit\n",
+            argv[0], AUDIO_WAVE_FACTORY_NUM - 1U, (double)RENDER_DEF_TAIL);
+        return EXIT_FAILURE;
+    }
+
+    pu8File = render_load_file(xOpt.pcMidiPath, &u32FileLen);
+
+    if ( (pu8File == NULL) || (SMF_open(&xSmf, pu8File, u32FileLen) != midiOk) )
+    {
+        (void)fprintf(stderr, "Cannot read MIDI file %s\n", xOpt.pcMidiPath);
+        free(pu8File);
+        return EXIT_FAILURE;
+    }
+
+    if ( !HOST_WAV_open(&xWav, xOpt.pcWavPath, RENDER_SAMPLE_RATE, 1U) )
+    {
+        (void)fprintf(stderr, "Cannot create %s\n", xOpt.pcWavPath);
+        free(pu8File);
+        return EXIT_FAILURE;
+    }
+
+    /* Same init sequence as audio and midi tasks */
+    ERR_ASSERT(AUDIO_init(&RenderAudioEngine) == AUDIO_OK);
+    ERR_ASSERT(midi_init(&RenderMidiEngine, RenderSysExBuff, RENDER_SYSEX_BUFF_SIZE, render_sysex_cb, render_cmd_1_cb, render_cmd_2_cb, render_rt_cb) == midiOk);
+    ERR_ASSERT(VOICE_init(&RenderVoiceEngine, RenderVoiceList, RENDER_NUM_VOICE, 0U, render_voice_cb) == midiOk);
+    ERR_ASSERT(VOICE_set_release_cb(&RenderVoiceEngine, render_release_cb) == midiOk);
+    ERR_ASSERT(VOICE_set_expr_cb(&RenderVoiceEngine, render_expr_cb) == midiOk);
+    ERR_ASSERT(VOICE_set_mpe_zone(&RenderVoiceEngine, MIDI_VOICE_MPE_LOWER, (uint8_t)xOpt.i32MpeMembers) == midiOk);
+
+    if ( xOpt.i32Channel >= 0 )
+    {
+        (void)VOICE_update_ch(&RenderVoiceEngine, (uint8_t)xOpt.i32Channel);
+        (void)VOICE_update_mode(&RenderVoiceEngine, MidiMode3);
+    }
+
+    if ( xOpt.i32Wave >= 0 )
+    {
+        audio_cmd_t xAudioCmd = { 0U };
+        xAudioCmd.eCmdId = AUDIO_CMD_SET_WAVEFORM;
+        xAudioCmd.xCmdPayload.xSetWave.eVoiceId = AUDIO_VOICE_NUM;
+        xAudioCmd.xCmdPayload.xSetWave.eWaveId = (audio_wave_id_t)xOpt.i32Wave;
+        (void)AUDIO_handle_cmd(&RenderAudioEngine, xAudioCmd);
+    }
+
+    uint64_t u64MaxSample = (xOpt.fMaxLen > 0.0F) ? (uint64_t)(xOpt.fMaxLen * (float)RENDER_SAMPLE_RATE) : UINT64_MAX;
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    while ( bOk && (xEvent.eType != SMF_EVT_END) )
+    {
+        if ( SMF_next_event(&xSmf, &xEvent) != midiOk )
+        {
+            (void)fprintf(stderr, "Malformed data in track %u, rest of track skipped\n", xEvent.u8Track);
+            u32Errors++;
+        }
+        else
+        {
+            uint64_t u64Sample = ((xEvent.u64TimeUs * RENDER_SAMPLE_RATE) + 500000U) / 1000000U;
+
+            if ( u64Sample > u64MaxSample )
+            {
+                /* Drop rest of file, notes still active go to release */
+                xEvent.eType = SMF_EVT_END;
+                u64Sample = u64MaxSample;
+                render_voice_cb((uint8_t)AUDIO_VOICE_NUM, 0U, 0U, VOICE_STATE_OFF);
+            }
+
+            bOk = render_until(&xWav, u64Sample);
+
+            if ( xEvent.eType != SMF_EVT_END )
+            {
+                u32Errors += render_feed(&xEvent);
+                u32Events++;
+            }
+        }
+    }
+
+    /* Release tail, last partial block is completed */
+    uint64_t u64End = u64RenderedSamples + (uint64_t)(xOpt.fTail * (float)RENDER_SAMPLE_RATE) + RENDER_BLOCK_SIZE - 1U;
+    bOk = bOk && render_until(&xWav, u64End);
+
+    uint64_t u64Elapsed = HOST_HAL_get_time_ns() - u64Start;
+
+    bOk = HOST_WAV_close(&xWav) && bOk;
+    free(pu8File);
+
+    double dAudioSec = (double)u64RenderedSamples / (double)RENDER_SAMPLE_RATE;
+    double dRenderSec = (double)u64Elapsed * 1.0e-9;
+
+    (void)fprintf(stderr, "%u events, %u notes, %u errors, %.2f s audio in %.3f s (%.0fx realtime)\n",
+                  u32Events, u32RenderNotes, u32Errors, dAudioSec, dRenderSec,
+                  (dRenderSec > 0.0) ? (dAudioSec / dRenderSec) : 0.0);
+
+    if ( !bOk )
+    {
+        (void)fprintf(stderr, "Error writing %s\n", xOpt.pcWavPath);
+    }
+
+    return bOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* EOF */
@@ -0,0 +1,1140 @@
+/**
+ * @file    midi_fuzz.c
+ * @author  Sebastián Del Moral Gallardo.
+ * @brief   Host fuzz and throughput harness of midi_lib parser.
+ * @version 0.1
+ * @date    2021-12-13
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Fuzz: random, data heavy and adversarial streams are fed byte by byte to
+ * midi_update_fsm and to a plain reference model of the same parser, every
+ * callback and return value must match at the same byte. Well formed streams
+ * with running status, real time bytes inside messages and sys ex are also
+ * checked against the messages the generator wrote. First mismatch is
+ * reported with seed and offset, exit code is non zero. Standard MIDI File
+ * reader gets truncated tracks and mutated files, it must never read past
+ * a track chunk.
+ *
+ * Bench: typical streams are parsed with counting callbacks, best of several
+ * runs is printed as JSON (ns/byte, bytes/s and load of one 31250 baud port).
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_audio_hal.h"
+
+#include "midi_lib.h"
+#include "midi_smf.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+
+/* Callback kinds */
+typedef enum {
+    FUZZ_EVT_DATA_1 = 0x00,
+    FUZZ_EVT_DATA_2,
+    FUZZ_EVT_RT,
+    FUZZ_EVT_SYSEX,
+} fuzz_evt_type_t;
+
+/* One parser callback, sys ex content kept as hash */
+typedef struct fuzz_evt {
+    uint32_t u32Type;
+    uint32_t u32Status;
+    uint32_t u32Data0;
+    uint32_t u32Data1;
+    uint32_t u32Hash;
+} fuzz_evt_t;
+
+/* Callback log */
+typedef struct fuzz_log {
+    fuzz_evt_t *pxEvt;
+    uint32_t u32Size;
+    uint32_t u32Num;
+} fuzz_log_t;
+
+/* Reference parser states */
+typedef enum {
+    REF_STATE_IDLE = 0x00,
+    REF_STATE_DATA_1,
+    REF_STATE_DATA_2,
+    REF_STATE_ONE,
+    REF_STATE_SYSEX,
+} fuzz_ref_state_t;
+
+/* Reference parser, written from midi_lib behaviour, not from its code */
+typedef struct fuzz_ref {
+    fuzz_ref_state_t eState;
+    uint8_t u8Status;
+    uint8_t u8Data0;
+    uint32_t u32SysExLen;
+    uint32_t u32SysExSize;
+    uint32_t u32Hash;
+} fuzz_ref_t;
+
+/* Stream generator, returns bytes written. Expected log is filled only by well formed generators */
+typedef uint32_t (*fuzz_gen_t)(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect);
+
+/* Generator definition */
+typedef struct fuzz_gen_def {
+    const char *pcName;
+    fuzz_gen_t pGen;
+    bool bExpect;
+} fuzz_gen_def_t;
+
+/* Tool options */
+typedef struct fuzz_opt {
+    const char *pcJsonPath;
+    uint32_t u32Seed;
+    uint32_t u32Iter;
+    uint32_t u32Len;
+    uint32_t u32BenchBytes;
+    uint32_t u32Runs;
+    bool bSkipFuzz;
+    bool bSkipBench;
+} fuzz_opt_t;
+
+/* Private define ------------------------------------------------------------*/
+
+/* Default options */
+#define FUZZ_DEF_SEED               ( 1U )
+#define FUZZ_DEF_ITER               ( 2000U )
+#define FUZZ_DEF_LEN                ( 4096U )
+#define FUZZ_DEF_BENCH_BYTES        ( 1048576U )
+#define FUZZ_DEF_RUNS               ( 7U )
+
+/* Small sys ex buffer so overflow paths are hit often */
+#define FUZZ_SYSEX_SIZE             ( 64U )
+
+/* Bench uses the midi task buffer size */
+#define FUZZ_BENCH_SYSEX_SIZE       ( 512U )
+
+/* Longest stream, each byte gives at most one callback */
+#define FUZZ_MAX_LEN                ( 16U * 1024U * 1024U )
+
+/* Midi line rate, 10 bits per byte at 31250 baud */
+#define FUZZ_LINE_BYTES_PER_S       ( 3125.0 )
+
+/* Hash of sys ex content, FNV-1a */
+#define FUZZ_HASH_INIT              ( 2166136261U )
+#define FUZZ_HASH_PRIME             ( 16777619U )
+
+/* Mutated copies of each SMF case */
+#define FUZZ_SMF_MUTATIONS          ( 64U )
+
+/* Bytes shown around first mismatch */
+#define FUZZ_DUMP_SPAN              ( 16U )
+
+/* Private macro -------------------------------------------------------------*/
+
+#define ARRAY_SIZE(_a)              ( sizeof(_a) / sizeof((_a)[0]) )
+
+/* Private variables ---------------------------------------------------------*/
+
+/* Parser under test */
+midi_handler_t xFuzzMidi;
+uint8_t pu8FuzzSysEx[FUZZ_BENCH_SYSEX_SIZE];
+
+/* Log written by parser callbacks */
+fuzz_log_t *pxFuzzDutLog = NULL;
+
+/* Bench callbacks counters, keep parse work alive */
+volatile uint32_t u32BenchEvents = 0U;
+volatile uint32_t u32BenchSum = 0U;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t fuzz_rand(uint32_t *pu32Rng);
+static uint32_t fuzz_rand_range(uint32_t *pu32Rng, uint32_t u32Max);
+static uint32_t fuzz_hash(uint32_t u32Hash, uint8_t u8Data);
+static void fuzz_log_push(fuzz_log_t *pxLog, fuzz_evt_type_t eType, uint32_t u32Status, uint32_t u32Data0, uint32_t u32Data1, uint32_t u32Hash);
+
+static void fuzz_cb_sysex(uint8_t *pdata, uint32_t len_data);
+static void fuzz_cb_data_1(uint8_t cmd, uint8_t data);
+static void fuzz_cb_data_2(uint8_t cmd, uint8_t data0, uint8_t data1);
+static void fuzz_cb_rt(uint8_t rt_data);
+
+static void fuzz_ref_init(fuzz_ref_t *pxRef, uint32_t u32SysExSize);
+static midiStatus_t fuzz_ref_update(fuzz_ref_t *pxRef, uint8_t u8Data, fuzz_log_t *pxLog);
+
+static uint32_t fuzz_msg_size(uint8_t u8Status);
+static uint8_t fuzz_rand_rt(uint32_t *pu32Rng);
+static uint8_t fuzz_rand_channel_status(uint32_t *pu32Rng);
+static uint32_t fuzz_gen_random(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect);
+static uint32_t fuzz_gen_data_heavy(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect);
+static uint32_t fuzz_gen_adversarial(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect);
+static uint32_t fuzz_gen_valid(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect);
+
+static void fuzz_dump(const uint8_t *pu8Data, uint32_t u32Len, uint32_t u32Pos);
+static bool fuzz_run(const fuzz_gen_def_t *pxGen, const fuzz_opt_t *pxOpt, uint8_t *pu8Data, fuzz_log_t *pxDut, fuzz_log_t *pxRef, fuzz_log_t *pxExpect);
+static bool fuzz_smf_read(const uint8_t *pu8File, uint32_t u32Len, uint32_t *pu32MidiNum);
+static bool fuzz_smf_run(const fuzz_opt_t *pxOpt);
+
+static void bench_cb_sysex(uint8_t *pdata, uint32_t len_data);
+static void bench_cb_data_1(uint8_t cmd, uint8_t data);
+static void bench_cb_data_2(uint8_t cmd, uint8_t data0, uint8_t data1);
+static void bench_cb_rt(uint8_t rt_data);
+static uint32_t bench_gen_notes_rs(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect);
+static uint32_t bench_gen_mixed(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect);
+static uint32_t bench_gen_clock(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect);
+static uint32_t bench_gen_sysex(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect);
+static uint64_t bench_run(const uint8_t *pu8Data, uint32_t u32Len);
+
+static bool fuzz_parse_args(int argc, char **argv, fuzz_opt_t *pxOpt);
+static void fuzz_usage(const char *pcProg);
+
+/* Private variables ---------------------------------------------------------*/
+
+/* Fuzz generators */
+static const fuzz_gen_def_t xFuzzList[] = {
+    { "random",         fuzz_gen_random,        false },
+    { "data_heavy",     fuzz_gen_data_heavy,    false },
+    { "adversarial",    fuzz_gen_adversarial,   false },
+    { "valid",          fuzz_gen_valid,         true },
+};
+
+/* SMF cases, header plus tracks cut at chunk end */
+static const uint8_t pu8SmfTruncDelta[] = {
+    'M', 'T', 'h', 'd', 0x00U, 0x00U, 0x00U, 0x06U, 0x00U, 0x00U, 0x00U, 0x01U, 0x00U, 0x60U,
+    'M', 'T', 'r', 'k', 0x00U, 0x00U, 0x00U, 0x01U, 0x00U,
+};
+
+static const uint8_t pu8SmfTruncRunning[] = {
+    'M', 'T', 'h', 'd', 0x00U, 0x00U, 0x00U, 0x06U, 0x00U, 0x01U, 0x00U, 0x02U, 0x00U, 0x60U,
+    'M', 'T', 'r', 'k', 0x00U, 0x00U, 0x00U, 0x06U, 0x00U, 0x90U, 0x3CU, 0x40U, 0x60U, 0x3CU,
+    'M', 'T', 'r', 'k', 0x00U, 0x00U, 0x00U, 0x05U, 0x00U, 0x90U, 0x40U, 0x40U, 0x81U,
+};
+
+static const uint8_t pu8SmfValid[] = {
+    'M', 'T', 'h', 'd', 0x00U, 0x00U, 0x00U, 0x06U, 0x00U, 0x00U, 0x00U, 0x01U, 0x00U, 0x60U,
+    'M', 'T', 'r', 'k', 0x00U, 0x00U, 0x00U, 0x1AU,
+    0x00U, 0xFFU, 0x51U, 0x03U, 0x07U, 0xA1U, 0x20U,
+    0x00U, 0xF0U, 0x02U, 0x7DU, 0xF7U,
+    0x00U, 0x90U, 0x3CU, 0x40U,
+    0x60U, 0x3CU, 0x00U,
+    0x00U, 0xC0U, 0x05U,
+    0x00U, 0xFFU, 0x2FU, 0x00U,
+};
+
+static const struct {
+    const uint8_t *pu8File;
+    uint32_t u32Len;
+    uint32_t u32MidiNum;
+} xSmfList[] = {
+    { pu8SmfTruncDelta,     sizeof(pu8SmfTruncDelta),   0U },
+    { pu8SmfTruncRunning,   sizeof(pu8SmfTruncRunning), 3U },
+    { pu8SmfValid,          sizeof(pu8SmfValid),        3U },
+};
+
+/* Bench streams */
+static const fuzz_gen_def_t xBenchList[] = {
+    { "notes_rs",       bench_gen_notes_rs,     false },
+    { "mixed",          bench_gen_mixed,        false },
+    { "clock_rt",       bench_gen_clock,        false },
+    { "sysex",          bench_gen_sysex,        false },
+    { "random",         fuzz_gen_random,        false },
+};
+
+/* Private function definition -----------------------------------------------*/
+
+static uint32_t fuzz_rand(uint32_t *pu32Rng)
+{
+    /* xorshift32, state never zero */
+    uint32_t u32X = *pu32Rng;
+
+    u32X ^= u32X << 13U;
+    u32X ^= u32X >> 17U;
+    u32X ^= u32X << 5U;
+    *pu32Rng = u32X;
+
+    return u32X;
+}
+
+static uint32_t fuzz_rand_range(uint32_t *pu32Rng, uint32_t u32Max)
+{
+    return fuzz_rand(pu32Rng) % u32Max;
+}
+
+static uint32_t fuzz_hash(uint32_t u32Hash, uint8_t u8Data)
+{
+    return (u32Hash ^ (uint32_t)u8Data) * FUZZ_HASH_PRIME;
+}
+
+static void fuzz_log_push(fuzz_log_t *pxLog, fuzz_evt_type_t eType, uint32_t u32Status, uint32_t u32Data0, uint32_t u32Data1, uint32_t u32Hash)
+{
+    if ( (pxLog != NULL) && (pxLog->u32Num < pxLog->u32Size) )
+    {
+        fuzz_evt_t *pxEvt = &pxLog->pxEvt[pxLog->u32Num++];
+
+        pxEvt->u32Type = (uint32_t)eType;
+        pxEvt->u32Status = u32Status;
+        pxEvt->u32Data0 = u32Data0;
+        pxEvt->u32Data1 = u32Data1;
+        pxEvt->u32Hash = u32Hash;
+    }
+}
+
+/* Parser under test callbacks -----------------------------------------------*/
+
+static void fuzz_cb_sysex(uint8_t *pdata, uint32_t len_data)
+{
+    uint32_t u32Hash = FUZZ_HASH_INIT;
+
+    for ( uint32_t i = 0U; i < len_data; i++ )
+    {
+        u32Hash = fuzz_hash(u32Hash, pdata[i]);
+    }
+
+    /* Data must be in user buffer, len 1 above size flags overrun */
+    fuzz_log_push(pxFuzzDutLog, FUZZ_EVT_SYSEX, (pdata == pu8FuzzSysEx) ? MIDI_STATUS_SYS_EX_START : 0U, len_data, 0U, u32Hash);
+}
+
+static void fuzz_cb_data_1(uint8_t cmd, uint8_t data)
+{
+    fuzz_log_push(pxFuzzDutLog, FUZZ_EVT_DATA_1, cmd, data, 0U, 0U);
+}
+
+static void fuzz_cb_data_2(uint8_t cmd, uint8_t data0, uint8_t data1)
+{
+    fuzz_log_push(pxFuzzDutLog, FUZZ_EVT_DATA_2, cmd, data0, data1, 0U);
+}
+
+static void fuzz_cb_rt(uint8_t rt_data)
+{
+    fuzz_log_push(pxFuzzDutLog, FUZZ_EVT_RT, rt_data, 0U, 0U, 0U);
+}
+
+/* Reference parser ----------------------------------------------------------*/
+
+static void fuzz_ref_init(fuzz_ref_t *pxRef, uint32_t u32SysExSize)
+{
+    pxRef->eState = REF_STATE_IDLE;
+    pxRef->u8Status = 0U;
+    pxRef->u8Data0 = 0U;
+    pxRef->u32SysExLen = 0U;
+    pxRef->u32SysExSize = u32SysExSize;
+    pxRef->u32Hash = FUZZ_HASH_INIT;
+}
+
+static midiStatus_t fuzz_ref_update(fuzz_ref_t *pxRef, uint8_t u8Data, fuzz_log_t *pxLog)
+{
+    midiStatus_t eRetval = midiOk;
+
+    if ( u8Data >= MIDI_RT_MASK )
+    {
+        /* Real time in any state, message in progress is kept */
+        fuzz_log_push(pxLog, FUZZ_EVT_RT, u8Data, 0U, 0U, 0U);
+    }
+    else if ( (u8Data == MIDI_STATUS_SYS_EX_END) && (pxRef->eState == REF_STATE_SYSEX) )
+    {
+        fuzz_log_push(pxLog, FUZZ_EVT_SYSEX, MIDI_STATUS_SYS_EX_START, pxRef->u32SysExLen, 0U, pxRef->u32Hash);
+        pxRef->u32SysExLen = 0U;
+        pxRef->u8Status = 0U;
+        pxRef->eState = REF_STATE_IDLE;
+    }
+    else if ( u8Data == MIDI_STATUS_SYS_EX_START )
+    {
+        pxRef->u32SysExLen = 0U;
+        pxRef->u32Hash = FUZZ_HASH_INIT;
+        pxRef->u8Status = u8Data;
+        pxRef->eState = REF_STATE_SYSEX;
+    }
+    else if ( (u8Data & 0x80U) != 0U )
+    {
+        uint32_t u32Size = fuzz_msg_size(u8Data);
+
+        if ( (u32Size == 2U) || (u32Size == 3U) )
+        {
+            pxRef->u8Status = u8Data;
+            pxRef->eState = ( u32Size == 2U ) ? REF_STATE_ONE : REF_STATE_DATA_1;
+        }
+        else
+        {
+            /* Undefined and data less status: message dropped, running status kept */
+            pxRef->eState = REF_STATE_IDLE;
+            eRetval = midiError;
+        }
+    }
+    else
+    {
+        switch ( pxRef->eState )
+        {
+            case REF_STATE_DATA_1:
+                pxRef->u8Data0 = u8Data;
+                pxRef->eState = REF_STATE_DATA_2;
+                break;
+
+            case REF_STATE_DATA_2:
+                fuzz_log_push(pxLog, FUZZ_EVT_DATA_2, pxRef->u8Status, pxRef->u8Data0, u8Data, 0U);
+                pxRef->eState = REF_STATE_DATA_1;
+                break;
+
+            case REF_STATE_ONE:
+                fuzz_log_push(pxLog, FUZZ_EVT_DATA_1, pxRef->u8Status, u8Data, 0U, 0U);
+                break;
+
+            case REF_STATE_SYSEX:
+                if ( pxRef->u32SysExLen < pxRef->u32SysExSize )
+                {
+                    pxRef->u32Hash = fuzz_hash(pxRef->u32Hash, u8Data);
+                    pxRef->u32SysExLen++;
+                }
+                else
+                {
+                    /* Overrun drops message, later data is ignored */
+                    pxRef->u32SysExLen = 0U;
+                    pxRef->eState = REF_STATE_IDLE;
+                    eRetval = midiSysExcBuffFull;
+                }
+                break;
+
+            default:
+                /* Data without status */
+                break;
+        }
+    }
+
+    return eRetval;
+}
+
+/* Stream generators ---------------------------------------------------------*/
+
+static uint32_t fuzz_msg_size(uint8_t u8Status)
+{
+    uint32_t u32Retval = 0U;
+    uint8_t u8Cmd = MIDI_CMD_GET_STATUS(u8Status);
+
+    if ( (u8Status & 0x80U) == 0U )
+    {
+        /* Data byte */
+    }
+    else if ( (u8Cmd == MIDI_STATUS_PROG_CHANGE) || (u8Cmd == MIDI_STATUS_CH_PRESS) ||
+              (u8Status == MIDI_STATUS_TIME_CODE) || (u8Status == MIDI_STATUS_SONG_SELECT) )
+    {
+        u32Retval = 2U;
+    }
+    else if ( (u8Cmd != 0xF0U) || (u8Status == MIDI_STATUS_SONG_POS) )
+    {
+        u32Retval = 3U;
+    }
+    else
+    {
+        /* Sys ex, real time, tune request and undefined */
+        u32Retval = 1U;
+    }
+
+    return u32Retval;
+}
+
+static uint8_t fuzz_rand_rt(uint32_t *pu32Rng)
+{
+    /* Whole range, undefined F9 and FD included */
+    return (uint8_t)(MIDI_RT_MASK + fuzz_rand_range(pu32Rng, 8U));
+}
+
+static uint8_t fuzz_rand_channel_status(uint32_t *pu32Rng)
+{
+    return (uint8_t)(0x80U + fuzz_rand_range(pu32Rng, 0x70U));
+}
+
+static uint32_t fuzz_gen_random(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect)
+{
+    (void)pxExpect;
+
+    for ( uint32_t i = 0U; i < u32Size; i++ )
+    {
+        pu8Data[i] = (uint8_t)fuzz_rand(pu32Rng);
+    }
+
+    return u32Size;
+}
+
+static uint32_t fuzz_gen_data_heavy(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect)
+{
+    (void)pxExpect;
+
+    for ( uint32_t i = 0U; i < u32Size; i++ )
+    {
+        uint32_t u32Rand = fuzz_rand(pu32Rng);
+
+        /* One status every ~16 bytes, long runs of running status and sys ex */
+        pu8Data[i] = ( (u32Rand & 0xF00U) == 0U ) ? (uint8_t)(0x80U | u32Rand) : (uint8_t)(u32Rand & 0x7FU);
+    }
+
+    return u32Size;
+}
+
+static uint32_t fuzz_gen_adversarial(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect)
+{
+    static const uint8_t pu8Odd[] = { 0xF4U, 0xF5U, 0xF6U, 0xF7U, 0xF9U, 0xFDU, 0xF0U, 0xF1U, 0xF2U, 0xF3U };
+    uint32_t u32Pos = 0U;
+
+    (void)pxExpect;
+
+    while ( u32Pos < u32Size )
+    {
+        uint32_t u32Left = u32Size - u32Pos;
+        uint32_t u32Len = 0U;
+
+        switch ( fuzz_rand_range(pu32Rng, 6U) )
+        {
+            case 0U:
+            {
+                /* Sys ex around buffer size, maybe unterminated or hit by real time */
+                uint32_t u32Body = (FUZZ_SYSEX_SIZE - 2U) + fuzz_rand_range(pu32Rng, 5U);
+
+                if ( fuzz_rand_range(pu32Rng, 4U) == 0U )
+                {
+                    u32Body = FUZZ_SYSEX_SIZE * 2U;
+                }
+
+                if ( u32Left >= (u32Body + 2U) )
+                {
+                    pu8Data[u32Pos + u32Len++] = MIDI_STATUS_SYS_EX_START;
+
+                    for ( uint32_t i = 0U; i < u32Body; i++ )
+                    {
+                        pu8Data[u32Pos + u32Len++] = ( fuzz_rand_range(pu32Rng, 32U) == 0U ) ? fuzz_rand_rt(pu32Rng) : (uint8_t)(fuzz_rand(pu32Rng) & 0x7FU);
+                    }
+
+                    pu8Data[u32Pos + u32Len++] = ( fuzz_rand_range(pu32Rng, 4U) == 0U ) ? fuzz_rand_channel_status(pu32Rng) : MIDI_STATUS_SYS_EX_END;
+                }
+                break;
+            }
+
+            case 1U:
+                /* Truncated message, new status before last data byte */
+                if ( u32Left >= 2U )
+                {
+                    pu8Data[u32Pos + u32Len++] = fuzz_rand_channel_status(pu32Rng);
+                    pu8Data[u32Pos + u32Len++] = (uint8_t)(fuzz_rand(pu32Rng) & 0x7FU);
+                }
+                break;
+
+            case 2U:
+                /* Undefined and system common status, then data */
+                pu8Data[u32Pos + u32Len++] = pu8Odd[fuzz_rand_range(pu32Rng, (uint32_t)ARRAY_SIZE(pu8Odd))];
+                break;
+
+            case 3U:
+                /* Status storm */
+                while ( (u32Len < u32Left) && (u32Len < 8U) )
+                {
+                    pu8Data[u32Pos + u32Len++] = (uint8_t)(0x80U | fuzz_rand(pu32Rng));
+                }
+                break;
+
+            case 4U:
+                /* Real time burst */
+                while ( (u32Len < u32Left) && (u32Len < 8U) )
+                {
+                    pu8Data[u32Pos + u32Len++] = fuzz_rand_rt(pu32Rng);
+                }
+                break;
+
+            default:
+                /* Data run, continues whatever state parser is in */
+                while ( (u32Len < u32Left) && (u32Len < 7U) )
+                {
+                    pu8Data[u32Pos + u32Len++] = (uint8_t)(fuzz_rand(pu32Rng) & 0x7FU);
+                }
+                break;
+        }
+
+        if ( u32Len == 0U )
+        {
+            pu8Data[u32Pos + u32Len++] = (uint8_t)(fuzz_rand(pu32Rng) & 0x7FU);
+        }
+
+        u32Pos += u32Len;
+    }
+
+    return u32Pos;
+}
+
+static uint32_t fuzz_gen_valid(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect)
+{
+    static const uint8_t pu8SysCommon[] = { MIDI_STATUS_TIME_CODE, MIDI_STATUS_SONG_POS, MIDI_STATUS_SONG_SELECT };
+    uint32_t u32Pos = 0U;
+    uint8_t u8Running = 0U;
+    bool bFits = true;
+
+    while ( bFits )
+    {
+        uint8_t pu8Msg[FUZZ_SYSEX_SIZE + 2U];
+        uint32_t u32MsgLen = 0U;
+        uint32_t u32Kind = fuzz_rand_range(pu32Rng, 16U);
+        bool bSysEx = false;
+
+        if ( u32Kind == 0U )
+        {
+            /* Sys ex that fits buffer, may be empty */
+            uint32_t u32Body = fuzz_rand_range(pu32Rng, FUZZ_SYSEX_SIZE + 1U);
+
+            pu8Msg[u32MsgLen++] = MIDI_STATUS_SYS_EX_START;
+
+            for ( uint32_t i = 0U; i < u32Body; i++ )
+            {
+                pu8Msg[u32MsgLen++] = (uint8_t)(fuzz_rand(pu32Rng) & 0x7FU);
+            }
+
+            pu8Msg[u32MsgLen++] = MIDI_STATUS_SYS_EX_END;
+            bSysEx = true;
+        }
+        else if ( u32Kind == 1U )
+        {
+            pu8Msg[u32MsgLen++] = pu8SysCommon[fuzz_rand_range(pu32Rng, (uint32_t)ARRAY_SIZE(pu8SysCommon))];
+        }
+        else if ( (u32Kind < 12U) && (u8Running != 0U) )
+        {
+            /* Same status again, sent or omitted */
+            pu8Msg[u32MsgLen++] = u8Running;
+        }
+        else
+        {
+            pu8Msg[u32MsgLen++] = fuzz_rand_channel_status(pu32Rng);
+        }
+
+        if ( !bSysEx )
+        {
+            uint32_t u32Data = fuzz_msg_size(pu8Msg[0U]) - 1U;
+
+            for ( uint32_t i = 0U; i < u32Data; i++ )
+            {
+                pu8Msg[u32MsgLen++] = (uint8_t)(fuzz_rand(pu32Rng) & 0x7FU);
+            }
+        }
+
+        /* Worst case each byte gets a real time byte in front */
+        bFits = ( (u32Pos + (2U * u32MsgLen)) <= u32Size );
+
+        if ( bFits )
+        {
+            uint8_t u8Status = pu8Msg[0U];
+            uint32_t u32First = 0U;
+
+            /* Running status only after channel messages */
+            if ( (u8Status == u8Running) && (fuzz_rand_range(pu32Rng, 4U) != 0U) )
+            {
+                u32First = 1U;
+            }
+
+            for ( uint32_t i = u32First; i < u32MsgLen; i++ )
+            {
+                if ( fuzz_rand_range(pu32Rng, 8U) == 0U )
+                {
+                    uint8_t u8Rt = fuzz_rand_rt(pu32Rng);
+
+                    pu8Data[u32Pos++] = u8Rt;
+                    fuzz_log_push(pxExpect, FUZZ_EVT_RT, u8Rt, 0U, 0U, 0U);
+                }
+
+                pu8Data[u32Pos++] = pu8Msg[i];
+            }
+
+            if ( bSysEx )
+            {
+                uint32_t u32Hash = FUZZ_HASH_INIT;
+
+                for ( uint32_t i = 1U; i < (u32MsgLen - 1U); i++ )
+                {
+                    u32Hash = fuzz_hash(u32Hash, pu8Msg[i]);
+                }
+
+                fuzz_log_push(pxExpect, FUZZ_EVT_SYSEX, MIDI_STATUS_SYS_EX_START, u32MsgLen - 2U, 0U, u32Hash);
+                u8Running = 0U;
+            }
+            else if ( u32MsgLen == 2U )
+            {
+                fuzz_log_push(pxExpect, FUZZ_EVT_DATA_1, u8Status, pu8Msg[1U], 0U, 0U);
+            }
+            else
+            {
+                fuzz_log_push(pxExpect, FUZZ_EVT_DATA_2, u8Status, pu8Msg[1U], pu8Msg[2U], 0U);
+            }
+
+            if ( !bSysEx )
+            {
+                u8Running = ( u8Status < 0xF0U ) ? u8Status : 0U;
+            }
+        }
+    }
+
+    return u32Pos;
+}
+
+/* Fuzz run ------------------------------------------------------------------*/
+
+static void fuzz_dump(const uint8_t *pu8Data, uint32_t u32Len, uint32_t u32Pos)
+{
+    uint32_t u32Start = ( u32Pos > FUZZ_DUMP_SPAN ) ? (u32Pos - FUZZ_DUMP_SPAN) : 0U;
+    uint32_t u32End = ( (u32Pos + 2U) < u32Len ) ? (u32Pos + 2U) : u32Len;
+
+    (void)fprintf(stderr, "  bytes %u..%u:", u32Start, u32End - 1U);
+
+    for ( uint32_t i = u32Start; i < u32End; i++ )
+    {
+        (void)fprintf(stderr, ( i == u32Pos ) ? " [%02X]" : " %02X", pu8Data[i]);
+    }
+
+    (void)fprintf(stderr, "\n");
+}
+
+static bool fuzz_run(const fuzz_gen_def_t *pxGen, const fuzz_opt_t *pxOpt, uint8_t *pu8Data, fuzz_log_t *pxDut, fuzz_log_t *pxRef, fuzz_log_t *pxExpect)
+{
+    bool bPass = true;
+
+    for ( uint32_t u32Iter = 0U; (u32Iter < pxOpt->u32Iter) && bPass; u32Iter++ )
+    {
+        /* Every stream is reproducible from tool seed and iteration */
+        uint32_t u32Rng = (pxOpt->u32Seed * 2654435761U) ^ (u32Iter * 40503U) ^ 0x9E3779B9U;
+        fuzz_ref_t xRef;
+
+        u32Rng = ( u32Rng == 0U ) ? 1U : u32Rng;
+        pxDut->u32Num = 0U;
+        pxRef->u32Num = 0U;
+        pxExpect->u32Num = 0U;
+
+        uint32_t u32Len = pxGen->pGen(pu8Data, pxOpt->u32Len, &u32Rng, pxExpect);
+
+        pxFuzzDutLog = pxDut;
+        (void)midi_init(&xFuzzMidi, pu8FuzzSysEx, FUZZ_SYSEX_SIZE, fuzz_cb_sysex, fuzz_cb_data_1, fuzz_cb_data_2, fuzz_cb_rt);
+        fuzz_ref_init(&xRef, FUZZ_SYSEX_SIZE);
+
+        for ( uint32_t i = 0U; (i < u32Len) && bPass; i++ )
+        {
+            midiStatus_t eDut = midi_update_fsm(&xFuzzMidi, pu8Data[i]);
+            midiStatus_t eRef = fuzz_ref_update(&xRef, pu8Data[i], pxRef);
+
+            if ( (eDut != eRef) || (pxDut->u32Num != pxRef->u32Num) ||
+                 ((pxDut->u32Num != 0U) && (memcmp(&pxDut->pxEvt[pxDut->u32Num - 1U], &pxRef->pxEvt[pxRef->u32Num - 1U], sizeof(fuzz_evt_t)) != 0)) )
+            {
+                (void)fprintf(stderr, "%s: mismatch seed %u iter %u byte %u, status %d ref %d, events %u ref %u\n",
+                              pxGen->pcName, pxOpt->u32Seed, u32Iter, i, (int)eDut, (int)eRef, pxDut->u32Num, pxRef->u32Num);
+                fuzz_dump(pu8Data, u32Len, i);
+                bPass = false;
+            }
+        }
+
+        if ( bPass && pxGen->bExpect )
+        {
+            bool bMatch = (pxDut->u32Num == pxExpect->u32Num) &&
+                          (memcmp(pxDut->pxEvt, pxExpect->pxEvt, pxDut->u32Num * sizeof(fuzz_evt_t)) == 0);
+
+            if ( !bMatch )
+            {
+                uint32_t u32Evt = 0U;
+
+                while ( (u32Evt < pxDut->u32Num) && (u32Evt < pxExpect->u32Num) &&
+                        (memcmp(&pxDut->pxEvt[u32Evt], &pxExpect->pxEvt[u32Evt], sizeof(fuzz_evt_t)) == 0) )
+                {
+                    u32Evt++;
+                }
+
+                (void)fprintf(stderr, "%s: wrong messages seed %u iter %u, first bad event %u, events %u expected %u\n",
+                              pxGen->pcName, pxOpt->u32Seed, u32Iter, u32Evt, pxDut->u32Num, pxExpect->u32Num);
+                bPass = false;
+            }
+        }
+    }
+
+    return bPass;
+}
+
+static bool fuzz_smf_read(const uint8_t *pu8File, uint32_t u32Len, uint32_t *pu32MidiNum)
+{
+    bool bPass = true;
+    midi_smf_t xSmf;
+    midi_smf_event_t xEvent = { 0 };
+
+    *pu32MidiNum = 0U;
+
+    if ( SMF_open(&xSmf, pu8File, u32Len) == midiOk )
+    {
+        /* Every event takes at least one byte, reader must end before */
+        for ( uint32_t u32Evt = 0U; (u32Evt <= u32Len) && bPass && (xEvent.eType != SMF_EVT_END); u32Evt++ )
+        {
+            (void)SMF_next_event(&xSmf, &xEvent);
+
+            if ( xEvent.eType == SMF_EVT_MIDI )
+            {
+                (*pu32MidiNum)++;
+            }
+
+            for ( uint32_t i = 0U; i < xSmf.u16TrackNum; i++ )
+            {
+                bPass = bPass && (xSmf.pxTrack[i].pu8Pos <= xSmf.pxTrack[i].pu8End);
+            }
+        }
+
+        bPass = bPass && (xEvent.eType == SMF_EVT_END);
+    }
+
+    return bPass;
+}
+
+static bool fuzz_smf_run(const fuzz_opt_t *pxOpt)
+{
+    bool bPass = true;
+    uint32_t u32Rng = ( pxOpt->u32Seed != 0U ) ? pxOpt->u32Seed : 1U;
+
+    for ( uint32_t u32Case = 0U; (u32Case < ARRAY_SIZE(xSmfList)) && bPass; u32Case++ )
+    {
+        uint32_t u32Len = xSmfList[u32Case].u32Len;
+        uint32_t u32MidiNum = 0U;
+
+        /* Exact size heap copy, so sanitizers see any read past file end */
+        uint8_t *pu8File = malloc(u32Len);
+
+        if ( pu8File == NULL )
+        {
+            bPass = false;
+            break;
+        }
+
+        memcpy(pu8File, xSmfList[u32Case].pu8File, u32Len);
+
+        if ( !fuzz_smf_read(pu8File, u32Len, &u32MidiNum) || (u32MidiNum != xSmfList[u32Case].u32MidiNum) )
+        {
+            (void)fprintf(stderr, "smf: case %u read past track or %u channel events, expected %u\n",
+                          u32Case, u32MidiNum, xSmfList[u32Case].u32MidiNum);
+            bPass = false;
+        }
+
+        for ( uint32_t u32Mut = 0U; (u32Mut < FUZZ_SMF_MUTATIONS) && bPass; u32Mut++ )
+        {
+            /* Header kept, track bytes and file length changed */
+            uint32_t u32MutLen = u32Len - fuzz_rand_range(&u32Rng, 4U);
+
+            memcpy(pu8File, xSmfList[u32Case].pu8File, u32Len);
+
+            for ( uint32_t i = 0U; i < 3U; i++ )
+            {
+                pu8File[14U + fuzz_rand_range(&u32Rng, u32Len - 14U)] = (uint8_t)fuzz_rand(&u32Rng);
+            }
+
+            if ( !fuzz_smf_read(pu8File, u32MutLen, &u32MidiNum) )
+            {
+                (void)fprintf(stderr, "smf: case %u mutation %u seed %u read past track\n", u32Case, u32Mut, pxOpt->u32Seed);
+                bPass = false;
+            }
+        }
+
+        free(pu8File);
+    }
+
+    return bPass;
+}
+
+/* Bench ---------------------------------------------------------------------*/
+
+static void bench_cb_sysex(uint8_t *pdata, uint32_t len_data)
+{
+    u32BenchEvents++;
+    u32BenchSum += len_data + ((len_data != 0U) ? pdata[0U] : 0U);
+}
+
+static void bench_cb_data_1(uint8_t cmd, uint8_t data)
+{
+    u32BenchEvents++;
+    u32BenchSum += (uint32_t)cmd + data;
+}
+
+static void bench_cb_data_2(uint8_t cmd, uint8_t data0, uint8_t data1)
+{
+    u32BenchEvents++;
+    u32BenchSum += (uint32_t)cmd + data0 + data1;
+}
+
+static void bench_cb_rt(uint8_t rt_data)
+{
+    u32BenchEvents++;
+    u32BenchSum += rt_data;
+}
+
+static uint32_t bench_gen_notes_rs(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect)
+{
+    uint32_t u32Pos = 0U;
+
+    (void)pxExpect;
+
+    /* Single status then note on/off pairs, velocity 0 as note off */
+    pu8Data[u32Pos++] = MIDI_STATUS_NOTE_ON;
+
+    while ( (u32Pos + 2U) <= u32Size )
+    {
+        pu8Data[u32Pos++] = (uint8_t)(36U + fuzz_rand_range(pu32Rng, 48U));
+        pu8Data[u32Pos++] = (uint8_t)(fuzz_rand(pu32Rng) & 0x7FU);
+    }
+
+    return u32Pos;
+}
+
+static uint32_t bench_gen_mixed(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect)
+{
+    static const uint8_t pu8Cmd[] = { MIDI_STATUS_NOTE_ON, MIDI_STATUS_NOTE_OFF, MIDI_STATUS_CC, MIDI_STATUS_PITCH_BEND, MIDI_STATUS_CH_PRESS, MIDI_STATUS_PROG_CHANGE };
+    uint32_t u32Pos = 0U;
+
+    (void)pxExpect;
+
+    /* Status on every message, several channels */
+    while ( (u32Pos + 3U) <= u32Size )
+    {
+        uint8_t u8Status = (uint8_t)(pu8Cmd[fuzz_rand_range(pu32Rng, (uint32_t)ARRAY_SIZE(pu8Cmd))] | fuzz_rand_range(pu32Rng, 4U));
+        uint32_t u32Msg = fuzz_msg_size(u8Status);
+
+        pu8Data[u32Pos++] = u8Status;
+
+        for ( uint32_t i = 1U; i < u32Msg; i++ )
+        {
+            pu8Data[u32Pos++] = (uint8_t)(fuzz_rand(pu32Rng) & 0x7FU);
+        }
+    }
+
+    return u32Pos;
+}
+
+static uint32_t bench_gen_clock(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect)
+{
+    uint32_t u32Len = bench_gen_notes_rs(pu8Data, u32Size, pu32Rng, pxExpect);
+
+    /* Timing clock on one byte of four, lands inside messages */
+    for ( uint32_t i = 3U; i < u32Len; i += 4U )
+    {
+        pu8Data[i] = MIDI_RT_CLK;
+    }
+
+    return u32Len;
+}
+
+static uint32_t bench_gen_sysex(uint8_t *pu8Data, uint32_t u32Size, uint32_t *pu32Rng, fuzz_log_t *pxExpect)
+{
+    uint32_t u32Body = FUZZ_BENCH_SYSEX_SIZE - 12U;
+    uint32_t u32Pos = 0U;
+
+    (void)pxExpect;
+
+    /* Bulk transfers just under buffer size, as wave and file uploads */
+    while ( (u32Pos + u32Body + 2U) <= u32Size )
+    {
+        pu8Data[u32Pos++] = MIDI_STATUS_SYS_EX_START;
+
+        for ( uint32_t i = 0U; i < u32Body; i++ )
+        {
+            pu8Data[u32Pos++] = (uint8_t)(fuzz_rand(pu32Rng) & 0x7FU);
+        }
+
+        pu8Data[u32Pos++] = MIDI_STATUS_SYS_EX_END;
+    }
+
+    return u32Pos;
+}
+
+static uint64_t bench_run(const uint8_t *pu8Data, uint32_t u32Len)
+{
+    (void)midi_init(&xFuzzMidi, pu8FuzzSysEx, FUZZ_BENCH_SYSEX_SIZE, bench_cb_sysex, bench_cb_data_1, bench_cb_data_2, bench_cb_rt);
+
+    uint64_t u64Start = HOST_HAL_get_time_ns();
+
+    for ( uint32_t i = 0U; i < u32Len; i++ )
+    {
+        (void)midi_update_fsm(&xFuzzMidi, pu8Data[i]);
+    }
+
+    return HOST_HAL_get_time_ns() - u64Start;
+}
+
+/* Options -------------------------------------------------------------------*/
+
+static void fuzz_usage(const char *pcProg)
+{
+    (void)fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  -o <file>          write JSON report to file, default stdout\n"
+        "  -s <seed>          fuzz seed, default %u\n"
+        "  -i <streams>       streams per fuzz generator, default %u\n"
+        "  -l <bytes>         fuzz stream length, default %u\n"
+        "  -n <bytes>         bench stream length, default %u\n"
+        "  -r <runs>          runs per bench, best is reported, default %u\n"
+        "  --no-fuzz          skip fuzz checks\n"
+        "  --no-bench         skip throughput benchmarks\n",
+        pcProg, FUZZ_DEF_SEED, FUZZ_DEF_ITER, FUZZ_DEF_LEN, FUZZ_DEF_BENCH_BYTES, FUZZ_DEF_RUNS);
+}
+
+static bool fuzz_parse_args(int argc, char **argv, fuzz_opt_t *pxOpt)
+{
+    bool bRetval = true;
+
+    pxOpt->pcJsonPath = NULL;
+    pxOpt->u32Seed = FUZZ_DEF_SEED;
+    pxOpt->u32Iter = FUZZ_DEF_ITER;
+    pxOpt->u32Len = FUZZ_DEF_LEN;
+    pxOpt->u32BenchBytes = FUZZ_DEF_BENCH_BYTES;
+    pxOpt->u32Runs = FUZZ_DEF_RUNS;
+    pxOpt->bSkipFuzz = false;
+    pxOpt->bSkipBench = false;
+
+    for ( int i = 1; (i < argc) && bRetval; i++ )
+    {
+        bool bHasValue = ((i + 1) < argc);
+
+        if ( strcmp(argv[i], "--no-fuzz") == 0 )
+        {
+            pxOpt->bSkipFuzz = true;
+        }
+        else if ( strcmp(argv[i], "--no-bench") == 0 )
+        {
+            pxOpt->bSkipBench = true;
+        }
+        else if ( (strcmp(argv[i], "-o") == 0) && bHasValue )
+        {
+            pxOpt->pcJsonPath = argv[++i];
+        }
+        else if ( (strcmp(argv[i], "-s") == 0) && bHasValue )
+        {
+            pxOpt->u32Seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (strcmp(argv[i], "-i") == 0) && bHasValue )
+        {
+            pxOpt->u32Iter = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (strcmp(argv[i], "-l") == 0) && bHasValue )
+        {
+            pxOpt->u32Len = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (strcmp(argv[i], "-n") == 0) && bHasValue )
+        {
+            pxOpt->u32BenchBytes = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (strcmp(argv[i], "-r") == 0) && bHasValue )
+        {
+            pxOpt->u32Runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            bRetval = false;
+        }
+    }
+
+    /* Bench streams need room for one sys ex transfer */
+    if ( (pxOpt->u32Len == 0U) || (pxOpt->u32Len > FUZZ_MAX_LEN) ||
+         (pxOpt->u32BenchBytes < FUZZ_BENCH_SYSEX_SIZE) || (pxOpt->u32BenchBytes > FUZZ_MAX_LEN) ||
+         (pxOpt->u32Runs == 0U) )
+    {
+        bRetval = false;
+    }
+
+    return bRetval;
+}
+
+/* Public function definition ------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    fuzz_opt_t xOpt;
+    bool bFuzzPass = true;
+
+    if ( !fuzz_parse_args(argc, argv, &xOpt) )
+    {
+        fuzz_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    uint32_t u32BuffLen = ( xOpt.u32Len > xOpt.u32BenchBytes ) ? xOpt.u32Len : xOpt.u32BenchBytes;
+    uint8_t *pu8Data = malloc(u32BuffLen);
+    fuzz_evt_t *pxEvt = malloc(3U * (size_t)xOpt.u32Len * sizeof(fuzz_evt_t));
+
+    if ( (pu8Data == NULL) || (pxEvt == NULL) )
+    {
+        (void)fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    /* One callback per byte at most, logs never fill */
+    fuzz_log_t xDutLog = { &pxEvt[0U], xOpt.u32Len, 0U };
+    fuzz_log_t xRefLog = { &pxEvt[xOpt.u32Len], xOpt.u32Len, 0U };
+    fuzz_log_t xExpectLog = { &pxEvt[2U * xOpt.u32Len], xOpt.u32Len, 0U };
+
+    FILE *pxJson = stdout;
+
+    if ( xOpt.pcJsonPath != NULL )
+    {
+        pxJson = fopen(xOpt.pcJsonPath, "w");
+
+        if ( pxJson == NULL )
+        {
+            (void)fprintf(stderr, "Cannot open %s\n", xOpt.pcJsonPath);
+            return EXIT_FAILURE;
+        }
+    }
+
+    (void)fprintf(pxJson, "{\n  \"seed\": %u,\n  \"streams\": %u,\n  \"stream_len\": %u,\n  \"fuzz\": [",
+                  xOpt.u32Seed, xOpt.u32Iter, xOpt.u32Len);
+
+    const char *pcSep = "\n";
+
+    for ( uint32_t u32Gen = 0U; (u32Gen < ARRAY_SIZE(xFuzzList)) && !xOpt.bSkipFuzz; u32Gen++ )
+    {
+        bool bPass = fuzz_run(&xFuzzList[u32Gen], &xOpt, pu8Data, &xDutLog, &xRefLog, &xExpectLog);
+
+        (void)fprintf(pxJson, "%s    { \"name\": \"%s\", \"pass\": %s }", pcSep, xFuzzList[u32Gen].pcName, bPass ? "true" : "false");
+        pcSep = ",\n";
+        bFuzzPass = bFuzzPass && bPass;
+    }
+
+    if ( !xOpt.bSkipFuzz )
+    {
+        bool bPass = fuzz_smf_run(&xOpt);
+
+        (void)fprintf(pxJson, "%s    { \"name\": \"smf\", \"pass\": %s }", pcSep, bPass ? "true" : "false");
+        bFuzzPass = bFuzzPass && bPass;
+    }
+
+    (void)fprintf(pxJson, "\n  ],\n  \"bytes\": %u,\n  \"runs\": %u,\n  \"benchmarks\": [", xOpt.u32BenchBytes, xOpt.u32Runs);
+
+    pcSep = "\n";
+
+    for ( uint32_t u32Bench = 0U; (u32Bench < ARRAY_SIZE(xBenchList)) && !xOpt.bSkipBench; u32Bench++ )
+    {
+        uint32_t u32Rng = FUZZ_HASH_INIT;
+        uint32_t u32Len = xBenchList[u32Bench].pGen(pu8Data, xOpt.u32BenchBytes, &u32Rng, NULL);
+
+        /* Best run filters scheduler noise */
+        uint64_t u64Best = UINT64_MAX;
+
+        for ( uint32_t u32Run = 0U; u32Run < xOpt.u32Runs; u32Run++ )
+        {
+            uint64_t u64Elapsed = bench_run(pu8Data, u32Len);
+
+            if ( u64Elapsed < u64Best )
+            {
+                u64Best = u64Elapsed;
+            }
+        }
+
+        double dNsPerByte = (double)u64Best / (double)u32Len;
+        double dBytesPerSec = (dNsPerByte > 0.0) ? (1.0e9 / dNsPerByte) : 0.0;
+
+        (void)fprintf(pxJson, "%s    { \"name\": \"%s\", \"ns_per_byte\": %.3f, \"bytes_per_s\": %.0f, \"line_x\": %.1f }",
+                      pcSep, xBenchList[u32Bench].pcName, dNsPerByte, dBytesPerSec, dBytesPerSec / FUZZ_LINE_BYTES_PER_S);
+        pcSep = ",\n";
+    }
+
+    (void)fprintf(pxJson, "\n  ]\n}\n");
+
+    if ( pxJson != stdout )
+    {
+        (void)fclose(pxJson);
+    }
+
+    free(pxEvt);
+    free(pu8Data);
+
+    return bFuzzPass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* EOF */
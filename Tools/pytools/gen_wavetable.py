@@ -1,28 +1,37 @@
-
 #!/usr/bin/python
 import math
 import matplotlib.pyplot as plt
 
 f = open('wave_out.c','w')
 
-dac_data_wide = 24
-dac_max_range = 2**dac_data_wide - 1
-signal_amplitude = 1.0
 num_steps = 256
 
+# Tables are stored as Q15, full scale is 1.0
+q15_scale = 32768
+q15_max = 32767
+q15_min = -32768
+
+def to_q15(data_val):
+    return max(q15_min, min(q15_max, int(round(data_val * q15_scale))))
+
+def write_frame(wave_id, data):
+    f.write( "    [%s] = {" % wave_id )
+    f.write( ",".join("%d" % to_q15(data_val) for data_val in data) )
+    f.write( "},\n" )
+
+f.write( "const audio_wave_sample_t wave_factory_frames[AUDIO_WAVE_FACTORY_NUM][WAVE_TABLE_SIZE] = {\n" )
+
 # Saw waveform
 x=[]
 y=[]
 signal_amplitude = 2.0
 step_val = signal_amplitude/num_steps
 data_val = -1.0
-f.write( "const float saw_wave[%d] = {" % (num_steps) )
 for step in range(num_steps):
     data_val = data_val + step_val
-    f.write( "%fF," % data_val )
     x.append(step)
     y.append(data_val)
-f.write( "};\n" )
+write_frame("AUDIO_WAVE_SAW", y)
 fig_saw = plt.plot(x, y, label='Saw')
 
 # Reverse saw waveform
@@ -31,35 +40,25 @@ y=[]
 signal_amplitude = 2.0
 step_val = signal_amplitude/num_steps
 data_val = 1.0
-f.write( "const float rsaw_wave[%d] = {" % (num_steps) )
 for step in range(num_steps):
     data_val = data_val - step_val
-    f.write( "%fF" % data_val )
-    if step < num_steps - 1:
-        f.write( "," )
     x.append(step)
     y.append(data_val)
-f.write( "};\n" )
+write_frame("AUDIO_WAVE_RSAW", y)
 fig_saw = plt.plot(x, y, label='Reverse saw')
 
 # Square waveform
 x=[]
 y=[]
 signal_amplitude = 1.0
-step_val = signal_amplitude/num_steps
-data_val = 0.0
-f.write( "const float square_wave[%d] = {" % (num_steps) )
 for step in range(num_steps):
     if step < ( num_steps / 2 ):
         data_val = signal_amplitude
     else:
         data_val = -1.0 * signal_amplitude
-    f.write( "%fF" % data_val )
-    if step < num_steps - 1:
-        f.write( "," )
     x.append(step)
     y.append(data_val)
-f.write( "};\n" )
+write_frame("AUDIO_WAVE_SQR", y)
 fig_saw = plt.plot(x, y, label='Square')
 
 # Sine waveform
@@ -67,15 +66,11 @@ x=[]
 y=[]
 signal_amplitude = 1.0
 step_val = 2*math.pi/num_steps
-f.write( "const float sin_wave[%d] = {" % (num_steps) )
 for step in range(num_steps):
     data_val = signal_amplitude * math.sin(step_val*step)
-    f.write( "%fF" % data_val )
-    if step < num_steps - 1:
-        f.write( "," )
     x.append(step)
     y.append(data_val)
-f.write( "};\n" )
+write_frame("AUDIO_WAVE_SIN", y)
 fig_sin = plt.plot(x, y, label='Sin')
 
 # Triagle waveform
@@ -84,20 +79,17 @@ y=[]
 signal_amplitude = 4.0
 delta_step = signal_amplitude / num_steps
 data_val = -1.0
-f.write( "const float tri_wave[%d] = {" % (num_steps) )
 for step in range(num_steps):
     if step < ( num_steps / 2 ):
         data_val = data_val + delta_step
     else:
         data_val = data_val - delta_step
-    f.write( "%fF" % data_val )
-    if step < num_steps - 1:
-        f.write( "," )
     x.append(step)
     y.append(data_val)
-f.write( "};\n" )
+write_frame("AUDIO_WAVE_TRI", y)
 fig_tri = plt.plot(x, y, label='Tri')
 
+f.write( "};\n" )
 f.close()
 
 plt.grid()
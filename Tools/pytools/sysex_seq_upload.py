@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""
+File name:    sysex_seq_upload.py
+Description:  Upload a Standard MIDI File to synth sequencer RAM over midi sys ex and control playback.
+Author:       Sebastián DEl Moral Gallardo
+Date:         04-12-2021
+"""
+
+import rtmidi
+import sys
+import argparse
+import logging
+import time
+from logging import critical, error, info, warning, debug
+
+# Sys ex framing
+SYSEX_START = 0xF0
+SYSEX_END = 0xF7
+SYSEX_MANUFACTURER_ID = 0x7D
+SYSEX_DEV_ID_ALL = 0x7F
+
+# Sequencer commands
+SYSEX_CMD_SEQ_BEGIN = 0x20
+SYSEX_CMD_SEQ_DATA = 0x21
+SYSEX_CMD_SEQ_END = 0x22
+SYSEX_CMD_SEQ_PLAY = 0x23
+SYSEX_CMD_SEQ_STOP = 0x24
+
+# Play sources
+SYSEX_SEQ_SRC_FLASH = 0x00
+SYSEX_SEQ_SRC_USER = 0x01
+
+# File layout
+SEQ_CHUNK_BYTES = 64
+SEQ_USER_SIZE = 4096
+
+
+def parse_arguments():
+    """Read arguments from a command line."""
+    parser = argparse.ArgumentParser(description='Arguments get parsed via --commands')
+    parser.add_argument('-v', metavar='verbosity', type=int, default=3,
+        help='Verbosity of logging: 0 -critical, 1- error, 2 -warning, 3 -info, 4 -debug')
+    parser.add_argument('-p', metavar='port', type=int, default=1,
+        help='Midi output port index')
+    parser.add_argument('-d', metavar='device', type=int, default=SYSEX_DEV_ID_ALL,
+        help='Sys ex device id')
+    parser.add_argument('-f', metavar='file', type=str, default=None,
+        help='Standard MIDI File to upload, play flash song if not given')
+    parser.add_argument('-l', action='store_true',
+        help='Loop playback')
+    parser.add_argument('-s', action='store_true',
+        help='Stop playback and exit')
+    parser.add_argument('-t', metavar='delay', type=float, default=0.005,
+        help='Delay in seconds between chunks')
+
+    args = parser.parse_args()
+    verbose = {0: logging.CRITICAL, 1: logging.ERROR, 2: logging.WARNING, 3: logging.INFO, 4: logging.DEBUG}
+    logging.basicConfig(format='%(message)s', level=verbose[args.v], stream=sys.stdout)
+
+    return args
+
+
+def pack_7bit(data):
+    """Pack bytes in 7 bit groups, MSB byte first, bit i for byte i of group"""
+    packed = bytearray()
+    for i in range(0, len(data), 7):
+        group = data[i:i + 7]
+        msb = 0
+        for j, byte in enumerate(group):
+            msb |= ((byte >> 7) & 0x01) << j
+        packed.append(msb)
+        packed.extend(byte & 0x7F for byte in group)
+    return packed
+
+
+def checksum(data):
+    """Checksum, sum of data and checksum is 0 modulo 128"""
+    return (128 - (sum(data) % 128)) & 0x7F
+
+
+def gen_sysex(device, cmd, payload):
+    body = bytearray([cmd]) + bytearray(payload)
+    msg = bytearray([SYSEX_START, SYSEX_MANUFACTURER_ID, device & 0x7F])
+    msg.extend(body)
+    msg.append(checksum(body))
+    msg.append(SYSEX_END)
+    return msg
+
+
+def seq_upload(midiOut, device, data, delay):
+    """Send begin, all file chunks with their offset and end"""
+    info("Upload %d bytes" % len(data))
+    midiOut.send_message(gen_sysex(device, SYSEX_CMD_SEQ_BEGIN, []))
+
+    for offset in range(0, len(data), SEQ_CHUNK_BYTES):
+        raw = data[offset:offset + SEQ_CHUNK_BYTES]
+        msg = gen_sysex(device, SYSEX_CMD_SEQ_DATA, bytearray([offset & 0x7F, (offset >> 7) & 0x7F]) + pack_7bit(raw))
+        debug("Offset %d: %d bytes" % (offset, len(msg)))
+        midiOut.send_message(msg)
+        time.sleep(delay)
+
+    midiOut.send_message(gen_sysex(device, SYSEX_CMD_SEQ_END, []))
+
+
+def main(args):
+    midiOut = rtmidi.MidiOut()
+    info(midiOut.get_ports())
+    midiOut.open_port(args.p)
+
+    if args.s:
+        midiOut.send_message(gen_sysex(args.d, SYSEX_CMD_SEQ_STOP, []))
+        info("Playback stopped")
+    elif args.f is None:
+        midiOut.send_message(gen_sysex(args.d, SYSEX_CMD_SEQ_PLAY, [SYSEX_SEQ_SRC_FLASH, int(args.l)]))
+        info("Play flash song")
+    else:
+        with open(args.f, 'rb') as f:
+            data = f.read()
+        if len(data) > SEQ_USER_SIZE:
+            error("File too big, max %d bytes" % SEQ_USER_SIZE)
+        else:
+            seq_upload(midiOut, args.d, data, args.t)
+            midiOut.send_message(gen_sysex(args.d, SYSEX_CMD_SEQ_PLAY, [SYSEX_SEQ_SRC_USER, int(args.l)]))
+            info("Play uploaded file")
+
+    del midiOut
+
+
+if __name__ == '__main__':
+    args = parse_arguments()
+    main(args)
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""
+File name:    sysex_tuning.py
+Description:  Send historical temperaments to synth as MIDI Tuning Standard scale/octave messages.
+Author:       Sebastián DEl Moral Gallardo
+Date:         13-12-2021
+"""
+
+import rtmidi
+import sys
+import argparse
+import logging
+from logging import critical, error, info, warning, debug
+
+# Sys ex framing
+SYSEX_START = 0xF0
+SYSEX_END = 0xF7
+SYSEX_UNIVERSAL_RT = 0x7F
+SYSEX_DEV_ID_ALL = 0x7F
+
+# Tuning messages
+MTS_SUB_ID = 0x08
+MTS_SCALE_OCTAVE_2 = 0x09
+
+# Scale/octave 2 byte data, 14 bit value centered at 0x2000 for +-100 cents
+MTS_SCALE_2_CENTER = 0x2000
+MTS_SCALE_2_MAX = 0x3FFF
+
+# Cents offset from equal temperament of each pitch class, C to B
+TEMPERAMENTS = {
+    'equal':       [0.0] * 12,
+    'just':        [0.0, 11.7, 3.9, 15.6, -13.7, -2.0, -9.8, 2.0, 13.7, -15.6, 17.6, -11.7],
+    'pythagorean': [0.0, 13.7, 3.9, -5.9, 7.8, -2.0, 11.7, 2.0, 15.6, 5.9, -3.9, 9.8],
+    'meantone':    [0.0, -24.0, -6.8, 10.3, -13.7, 3.4, -20.5, -3.4, -27.4, -10.3, 6.8, -17.1],
+    'werckmeister': [0.0, -9.8, -7.8, -5.9, -9.8, -2.0, -11.7, -3.9, -7.8, -11.7, -3.9, -7.8],
+}
+
+
+def parse_arguments():
+    """Read arguments from a command line."""
+    parser = argparse.ArgumentParser(description='Arguments get parsed via --commands')
+    parser.add_argument('-v', metavar='verbosity', type=int, default=3,
+        help='Verbosity of logging: 0 -critical, 1- error, 2 -warning, 3 -info, 4 -debug')
+    parser.add_argument('-p', metavar='port', type=int, default=1,
+        help='Midi output port index')
+    parser.add_argument('-d', metavar='device', type=int, default=SYSEX_DEV_ID_ALL,
+        help='Sys ex device id')
+    parser.add_argument('-t', metavar='temperament', type=str, default='equal',
+        choices=sorted(TEMPERAMENTS.keys()), help='Temperament to send')
+    parser.add_argument('-k', metavar='key', type=int, default=0,
+        help='Pitch class of temperament root, 0 C to 11 B')
+
+    args = parser.parse_args()
+    verbose = {0: logging.CRITICAL, 1: logging.ERROR, 2: logging.WARNING, 3: logging.INFO, 4: logging.DEBUG}
+    logging.basicConfig(format='%(message)s', level=verbose[args.v], stream=sys.stdout)
+
+    return args
+
+
+def gen_scale_octave(device, cents):
+    """Scale/octave message addressed to all channels"""
+    msg = bytearray([SYSEX_START, SYSEX_UNIVERSAL_RT, device & 0x7F, MTS_SUB_ID, MTS_SCALE_OCTAVE_2])
+    msg.extend([0x03, 0x7F, 0x7F])
+    for value in cents:
+        word = int(round(MTS_SCALE_2_CENTER + (value * MTS_SCALE_2_CENTER / 100.0)))
+        word = min(max(word, 0), MTS_SCALE_2_MAX)
+        msg.extend([(word >> 7) & 0x7F, word & 0x7F])
+    msg.append(SYSEX_END)
+    return msg
+
+
+def main(args):
+    midiOut = rtmidi.MidiOut()
+    info(midiOut.get_ports())
+    midiOut.open_port(args.p)
+
+    # Rotate table so temperament is built on selected root
+    base = TEMPERAMENTS[args.t]
+    key = args.k % 12
+    cents = [base[(i - key) % 12] for i in range(12)]
+    debug("Cents: %s" % cents)
+
+    midiOut.send_message(gen_scale_octave(args.d, cents))
+    info("Sent %s temperament on key %d" % (args.t, key))
+
+    del midiOut
+
+
+if __name__ == '__main__':
+    args = parse_arguments()
+    main(args)
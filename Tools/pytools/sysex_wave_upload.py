@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""
+File name:    sysex_wave_upload.py
+Description:  Upload user wavetable frames to synth RAM bank over midi sys ex.
+Author:       Sebastián DEl Moral Gallardo
+Date:         20-11-2021
+"""
+
+import rtmidi
+import sys
+import math
+import argparse
+import logging
+import time
+from logging import critical, error, info, warning, debug
+
+# Sys ex framing
+SYSEX_START = 0xF0
+SYSEX_END = 0xF7
+SYSEX_MANUFACTURER_ID = 0x7D
+SYSEX_DEV_ID_ALL = 0x7F
+
+# Wave upload commands
+SYSEX_CMD_WAVE_BEGIN = 0x10
+SYSEX_CMD_WAVE_DATA = 0x11
+SYSEX_CMD_WAVE_END = 0x12
+
+# Frame layout
+WAVE_FRAME_SIZE = 256
+WAVE_CHUNK_SAMPLES = 32
+WAVE_USER_SLOTS = 4
+
+
+def parse_arguments():
+    """Read arguments from a command line."""
+    parser = argparse.ArgumentParser(description='Arguments get parsed via --commands')
+    parser.add_argument('-v', metavar='verbosity', type=int, default=3,
+        help='Verbosity of logging: 0 -critical, 1- error, 2 -warning, 3 -info, 4 -debug')
+    parser.add_argument('-p', metavar='port', type=int, default=1,
+        help='Midi output port index')
+    parser.add_argument('-s', metavar='slot', type=int, default=0,
+        help='User wave slot [0-3], selected as wave id 5 + slot')
+    parser.add_argument('-d', metavar='device', type=int, default=SYSEX_DEV_ID_ALL,
+        help='Sys ex device id')
+    parser.add_argument('-w', metavar='wave', type=str, default='sine3',
+        help='Wave to generate: sine3, pulse25 or a file with one sample (-1.0 to 1.0) per line')
+    parser.add_argument('-t', metavar='delay', type=float, default=0.005,
+        help='Delay in seconds between chunks')
+
+    args = parser.parse_args()
+    verbose = {0: logging.CRITICAL, 1: logging.ERROR, 2: logging.WARNING, 3: logging.INFO, 4: logging.DEBUG}
+    logging.basicConfig(format='%(message)s', level=verbose[args.v], stream=sys.stdout)
+
+    return args
+
+
+def pack_7bit(data):
+    """Pack bytes in 7 bit groups, MSB byte first, bit i for byte i of group"""
+    packed = bytearray()
+    for i in range(0, len(data), 7):
+        group = data[i:i + 7]
+        msb = 0
+        for j, byte in enumerate(group):
+            msb |= ((byte >> 7) & 0x01) << j
+        packed.append(msb)
+        packed.extend(byte & 0x7F for byte in group)
+    return packed
+
+
+def checksum(data):
+    """Checksum, sum of data and checksum is 0 modulo 128"""
+    return (128 - (sum(data) % 128)) & 0x7F
+
+
+def gen_sysex(device, cmd, payload):
+    body = bytearray([cmd]) + bytearray(payload)
+    msg = bytearray([SYSEX_START, SYSEX_MANUFACTURER_ID, device & 0x7F])
+    msg.extend(body)
+    msg.append(checksum(body))
+    msg.append(SYSEX_END)
+    return msg
+
+
+def gen_wave(name):
+    if name == 'sine3':
+        samples = [0.6 * math.sin(2 * math.pi * i / WAVE_FRAME_SIZE) +
+                   0.4 * math.sin(6 * math.pi * i / WAVE_FRAME_SIZE) for i in range(WAVE_FRAME_SIZE)]
+    elif name == 'pulse25':
+        samples = [1.0 if i < (WAVE_FRAME_SIZE // 4) else -1.0 for i in range(WAVE_FRAME_SIZE)]
+    else:
+        with open(name) as f:
+            samples = [float(line) for line in f if line.strip()]
+    if len(samples) != WAVE_FRAME_SIZE:
+        raise ValueError("Wave must have %d samples" % WAVE_FRAME_SIZE)
+    return [max(-32768, min(32767, int(round(s * 32767)))) for s in samples]
+
+
+def wave_upload(port, device, slot, wave, delay):
+    """Send begin, all data chunks and end of one user wave"""
+    midiOut = rtmidi.MidiOut()
+    midi_ports = midiOut.get_ports()
+    info(midi_ports)
+    midiOut.open_port(port)
+
+    info("Upload wave to slot %d" % slot)
+    midiOut.send_message(gen_sysex(device, SYSEX_CMD_WAVE_BEGIN, [slot]))
+
+    for chunk in range(WAVE_FRAME_SIZE // WAVE_CHUNK_SAMPLES):
+        raw = bytearray()
+        for sample in wave[chunk * WAVE_CHUNK_SAMPLES:(chunk + 1) * WAVE_CHUNK_SAMPLES]:
+            raw.extend((sample & 0xFFFF).to_bytes(2, 'little'))
+        msg = gen_sysex(device, SYSEX_CMD_WAVE_DATA, bytearray([slot, chunk]) + pack_7bit(raw))
+        debug("Chunk %d: %d bytes" % (chunk, len(msg)))
+        midiOut.send_message(msg)
+        time.sleep(delay)
+
+    midiOut.send_message(gen_sysex(device, SYSEX_CMD_WAVE_END, [slot]))
+    info("End wave upload, select it with wave id %d" % (5 + slot))
+
+    del midiOut
+
+
+def main(args):
+    if not (0 <= args.s < WAVE_USER_SLOTS):
+        error("Not valid slot")
+        return
+    wave_upload(args.p, args.d, args.s, gen_wave(args.w), args.t)
+
+
+if __name__ == '__main__':
+    args = parse_arguments()
+    main(args)